@@ -11,9 +11,6 @@
 #include <sys/types.h>
 
 
-static constexpr int RunCount = 500;
-
-
 static constexpr int PNGAdlerBase = 65521;
 
 
@@ -370,9 +367,15 @@ static double TimestampInMilliseconds()
 
 double Benchmark::Run(const VectorImage &vg, const double scale, const char *op)
 {
-    ASSERT(scale > DBL_EPSILON);
+    return Run(vg.GetGeometries(), vg.GetGeometryCount(), vg.GetBounds(),
+        scale, op);
+}
 
-    const IntRect bounds = vg.GetBounds();
+
+double Benchmark::Run(const Geometry *geometries, const int geometryCount,
+    const IntRect &bounds, const double scale, const char *op)
+{
+    ASSERT(scale > DBL_EPSILON);
 
     const int minx = int(Floor(double(bounds.MinX) * scale));
     const int miny = int(Floor(double(bounds.MinY) * scale));
@@ -385,15 +388,17 @@ double Benchmark::Run(const VectorImage &vg, const double scale, const char *op)
     Matrix matrix = Matrix::CreateScale(scale);
     matrix.PreTranslate(-minx, -miny);
 
-    const int a = h * 4;
-    const int bytesPerRow = (a + 127) & ~127;
+    const int a = h * GetBytesPerPixel();
+    // Rows are padded to the widest tile width, rasterizer may write up to
+    // the right edge of the last tile column.
+    const int bytesPerRow = (a + 255) & ~255;
     const int byteCount = bytesPerRow * v;
 
     unsigned char *p = static_cast<unsigned char *>(malloc(byteCount));
 
     const ImageData image(p, h, v, bytesPerRow);
 
-    Prepare(vg.GetGeometries(), vg.GetGeometryCount());
+    Prepare(geometries, geometryCount);
 
     double times[RunCount];
 
@@ -10,8 +10,24 @@ public:
     virtual ~Benchmark() {
     }
 public:
+
+    /**
+     * A number of frames rendered by each Run call.
+     */
+    static constexpr int RunCount = 500;
+public:
     double Run(const VectorImage &vg, const double scale, const char *op);
+    double Run(const Geometry *geometries, const int geometryCount,
+        const IntRect &bounds, const double scale, const char *op);
 public:
     virtual void Prepare(const Geometry *geometries, const int geometryCount) = 0;
     virtual void RenderOnce(const Matrix &matrix, const ImageData &image) = 0;
+
+    /**
+     * Returns a number of bytes one pixel of destination image takes.
+     * Output image is saved as RGBA8 regardless.
+     */
+    virtual int GetBytesPerPixel() const {
+        return 4;
+    }
 };
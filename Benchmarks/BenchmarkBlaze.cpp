@@ -1,11 +1,19 @@
 
 #include "BenchmarkBlaze.h"
+#include <cstdarg>
+#include <cstdio>
 
 
 BenchmarkBlaze::BenchmarkBlaze() {
 }
 
 
+BenchmarkBlaze::BenchmarkBlaze(const RasterizerOptions &options)
+:   mOptions(options)
+{
+}
+
+
 void BenchmarkBlaze::Prepare(const Geometry *geometries,
     const int geometryCount)
 {
@@ -16,8 +24,101 @@ void BenchmarkBlaze::Prepare(const Geometry *geometries,
 
 void BenchmarkBlaze::RenderOnce(const Matrix &matrix, const ImageData &image)
 {
-    Rasterize<TileDescriptor_8x16>(mGeometries, mGeometryCount, matrix, mThreads, image);
+    Rasterize<TileDescriptor_8x16>(mGeometries, mGeometryCount, matrix, mThreads, image, mOptions);
+
+    // Free all the memory allocated by threads.
+    mThreads.ResetFrameMemory();
+}
+
+
+BenchmarkBlazeRuntime::BenchmarkBlazeRuntime() {
+}
+
+
+BenchmarkBlazeRuntime::BenchmarkBlazeRuntime(const RasterizerOptions &options)
+:   mOptions(options)
+{
+}
+
+
+void BenchmarkBlazeRuntime::Prepare(const Geometry *geometries,
+    const int geometryCount)
+{
+    mGeometries = geometries;
+    mGeometryCount = geometryCount;
+}
+
+
+void BenchmarkBlazeRuntime::RenderOnce(const Matrix &matrix,
+    const ImageData &image)
+{
+    mTileShape = Rasterize(mGeometries, mGeometryCount, matrix, mThreads, image, mOptions);
 
     // Free all the memory allocated by threads.
     mThreads.ResetFrameMemory();
 }
+
+
+TileShape BenchmarkBlazeRuntime::GetTileShape() const
+{
+    return mTileShape;
+}
+
+
+ImagePath::ImagePath(const char *format, ...)
+{
+    ASSERT(format != nullptr);
+
+    va_list arguments;
+
+    va_start(arguments, format);
+
+    vsnprintf(mPath, SIZE_OF(mPath), format, arguments);
+
+    va_end(arguments);
+}
+
+
+ImagePath::operator const char *() const
+{
+    return mPath;
+}
+
+
+void BeginSceneBenchmark(const Geometry *geometries, const int geometryCount,
+    const char *name, const double scale, const char *title)
+{
+    ASSERT(geometries != nullptr);
+    ASSERT(geometryCount > 0);
+    ASSERT(name != nullptr);
+
+    if (title != nullptr) {
+        printf("%s, scale %.2f, %s\n", name, scale, title);
+    } else {
+        printf("%s, scale %.2f\n", name, scale);
+    }
+}
+
+
+double Measure(const Geometry *geometries, const int geometryCount,
+    const IntRect &bounds, const double scale, const char *path,
+    const RasterizerOptions &options)
+{
+    BenchmarkBlaze benchmark(options);
+
+    return benchmark.Run(geometries, geometryCount, bounds, scale, path);
+}
+
+
+void PrintFrameTime(const char *label, const double time,
+    const double baseline)
+{
+    ASSERT(label != nullptr);
+
+    if (baseline > 0) {
+        printf("    %-22s %8.3f ms, relative cost: %.2f\n", label, time,
+            time / baseline);
+    } else {
+        printf("    %-22s %8.3f ms\n", label, time);
+    }
+}
@@ -1,18 +1,87 @@
-
 #pragma once
 
 
 #include "Benchmark.h"
 
 
+/**
+ * Renders with TileDescriptor_8x16 selected at compile time.
+ */
 class BenchmarkBlaze : public Benchmark {
 public:
     BenchmarkBlaze();
+    explicit BenchmarkBlaze(const RasterizerOptions &options);
 public:
     virtual void Prepare(const Geometry *geometries, const int geometryCount) override;
     virtual void RenderOnce(const Matrix &matrix, const ImageData &image) override;
 private:
     Threads mThreads;
+    RasterizerOptions mOptions;
+    const Geometry *mGeometries = nullptr;
+    int mGeometryCount = 0;
+};
+
+
+/**
+ * Renders with tile descriptor selected for each frame at runtime, see
+ * RasterizerOptions::Shape.
+ */
+class BenchmarkBlazeRuntime : public Benchmark {
+public:
+    BenchmarkBlazeRuntime();
+    explicit BenchmarkBlazeRuntime(const RasterizerOptions &options);
+public:
+    virtual void Prepare(const Geometry *geometries, const int geometryCount) override;
+    virtual void RenderOnce(const Matrix &matrix, const ImageData &image) override;
+
+    /**
+     * Returns tile shape the last frame was rendered with.
+     */
+    TileShape GetTileShape() const;
+private:
+    Threads mThreads;
+    RasterizerOptions mOptions;
     const Geometry *mGeometries = nullptr;
     int mGeometryCount = 0;
+    TileShape mTileShape = TileShape::Automatic;
 };
+
+
+/**
+ * Path of an output image formatted like printf does.
+ */
+class ImagePath final {
+public:
+    explicit ImagePath(const char *format, ...);
+public:
+    operator const char *() const;
+private:
+    char mPath[256];
+};
+
+
+/**
+ * Checks arguments every scene benchmark takes and prints a line naming the
+ * scene, its scale and what is measured.
+ *
+ * @param title Name of the benchmark printed after scale, can be nullptr.
+ */
+void BeginSceneBenchmark(const Geometry *geometries, const int geometryCount,
+    const char *name, const double scale, const char *title);
+
+
+/**
+ * Renders a scene with BenchmarkBlaze and given options, saves the last
+ * frame to a given path and returns average frame time in milliseconds.
+ */
+double Measure(const Geometry *geometries, const int geometryCount,
+    const IntRect &bounds, const double scale, const char *path,
+    const RasterizerOptions &options = RasterizerOptions());
+
+
+/**
+ * Prints one measured frame time. If baseline is greater than zero, time
+ * relative to it is printed as well.
+ */
+void PrintFrameTime(const char *label, const double time,
+    const double baseline = 0);
@@ -0,0 +1,412 @@
+#include "BenchmarkBlendModes.h"
+#include "BenchmarkBlaze.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+
+// Indexed by BlendMode.
+static const char *BlendModeNames[] = {
+    "source over",
+    "clear",
+    "source",
+    "destination",
+    "destination over",
+    "source in",
+    "destination in",
+    "source out",
+    "destination out",
+    "source atop",
+    "destination atop",
+    "xor",
+    "plus",
+    "multiply",
+    "screen",
+    "overlay",
+    "darken",
+    "lighten",
+    "hard light",
+    "difference",
+    "exclusion"
+};
+
+
+// Alpha values of test colors, including both ends of the range and values
+// around half.
+static constexpr int32 TestAlphas[] = {
+    0, 1, 2, 64, 127, 128, 191, 254, 255
+};
+
+
+static constexpr int32 TestCoverages[] = {
+    0, 1, 127, 128, 254, 255
+};
+
+
+// Kernels round each product to integer, reference formulas round only the
+// result.
+static constexpr int32 MaximumDifference = 2;
+
+
+static constexpr int TestColorCount = SIZE_OF(TestAlphas) /
+    SIZE_OF(TestAlphas[0]) * 4;
+
+
+static constexpr int TestCoverageCount = SIZE_OF(TestCoverages) /
+    SIZE_OF(TestCoverages[0]);
+
+
+/**
+ * Returns premultiplied test color with a given index. Each alpha value is
+ * combined with four sets of color channels, from black to fully saturated.
+ */
+static uint32 GetTestColor(const int index)
+{
+    ASSERT(index >= 0);
+    ASSERT(index < TestColorCount);
+
+    const int32 a = TestAlphas[index / 4];
+    const int32 k = index % 4;
+
+    const int32 r = (a * k) / 3;
+    const int32 g = (a * (3 - k)) / 3;
+    const int32 b = (a * k) / 7;
+
+    return (uint32(a) << 24) | (uint32(b) << 16) | (uint32(g) << 8) |
+        uint32(r);
+}
+
+
+/**
+ * Separable blend function B(Cb, Cs) of W3C compositing specification, in
+ * terms of colors which are not premultiplied.
+ */
+static double BlendFunction(const BlendMode mode, const double cb,
+    const double cs)
+{
+    switch (mode) {
+        case BlendMode::Multiply:
+            return cb * cs;
+
+        case BlendMode::Screen:
+            return cb + cs - (cb * cs);
+
+        case BlendMode::Overlay:
+            return BlendFunction(BlendMode::HardLight, cs, cb);
+
+        case BlendMode::Darken:
+            return Min(cb, cs);
+
+        case BlendMode::Lighten:
+            return Max(cb, cs);
+
+        case BlendMode::HardLight:
+            if (cs <= 0.5) {
+                return BlendFunction(BlendMode::Multiply, cb, cs * 2.0);
+            }
+
+            return BlendFunction(BlendMode::Screen, cb, (cs * 2.0) - 1.0);
+
+        case BlendMode::Difference:
+            return Abs(cb - cs);
+
+        case BlendMode::Exclusion:
+            return cb + cs - (2.0 * cb * cs);
+
+        default:
+            ASSERT(false);
+            return 0;
+    }
+}
+
+
+/**
+ * Returns fractions of source and destination of Porter-Duff operator.
+ * Returns false if blend mode is not a Porter-Duff operator.
+ */
+static bool GetPorterDuffFractions(const BlendMode mode, const double as,
+    const double ab, double &fa, double &fb)
+{
+    switch (mode) {
+        case BlendMode::SourceOver:
+            fa = 1;
+            fb = 1 - as;
+            return true;
+
+        case BlendMode::Clear:
+            fa = 0;
+            fb = 0;
+            return true;
+
+        case BlendMode::Source:
+            fa = 1;
+            fb = 0;
+            return true;
+
+        case BlendMode::Destination:
+            fa = 0;
+            fb = 1;
+            return true;
+
+        case BlendMode::DestinationOver:
+            fa = 1 - ab;
+            fb = 1;
+            return true;
+
+        case BlendMode::SourceIn:
+            fa = ab;
+            fb = 0;
+            return true;
+
+        case BlendMode::DestinationIn:
+            fa = 0;
+            fb = as;
+            return true;
+
+        case BlendMode::SourceOut:
+            fa = 1 - ab;
+            fb = 0;
+            return true;
+
+        case BlendMode::DestinationOut:
+            fa = 0;
+            fb = 1 - as;
+            return true;
+
+        case BlendMode::SourceAtop:
+            fa = ab;
+            fb = 1 - as;
+            return true;
+
+        case BlendMode::DestinationAtop:
+            fa = 1 - ab;
+            fb = as;
+            return true;
+
+        case BlendMode::Xor:
+            fa = 1 - ab;
+            fb = 1 - as;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+/**
+ * Composites one premultiplied source pixel with destination pixel using
+ * reference formulas evaluated in floating point. Partially covered pixels
+ * are interpolated between destination and blended pixel.
+ */
+static uint32 BlendReference(const BlendMode mode, const uint32 d,
+    const uint32 s, const int32 alpha)
+{
+    const double as = double(s >> 24) / 255.0;
+    const double ab = double(d >> 24) / 255.0;
+    const double coverage = double(alpha) / 255.0;
+
+    uint32 result = 0;
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        const double cs = double((s >> shift) & 0xff) / 255.0;
+        const double cb = double((d >> shift) & 0xff) / 255.0;
+
+        double fa = 0;
+        double fb = 0;
+        double co = 0;
+
+        if (GetPorterDuffFractions(mode, as, ab, fa, fb)) {
+            co = (cs * fa) + (cb * fb);
+        } else if (mode == BlendMode::Plus) {
+            co = cs + cb;
+        } else if (shift == 24) {
+            // Alpha of separable blend modes is source over.
+            co = as + ab - (as * ab);
+        } else {
+            const double ucs = as > 0 ? cs / as : 0;
+            const double ucb = ab > 0 ? cb / ab : 0;
+
+            co = (cs * (1 - ab)) + (cb * (1 - as)) +
+                (as * ab * BlendFunction(mode, ucb, ucs));
+        }
+
+        co = Clamp(co, 0.0, 1.0);
+
+        const double c = (co * coverage) + (cb * (1 - coverage));
+
+        result |= uint32(Clamp(int(Round(c * 255.0)), 0, 255)) << shift;
+    }
+
+    return result;
+}
+
+
+/**
+ * Returns the largest difference between channels of two pixels.
+ */
+static int32 PixelDifference(const uint32 a, const uint32 b)
+{
+    int32 difference = 0;
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        const int32 ca = int32((a >> shift) & 0xff);
+        const int32 cb = int32((b >> shift) & 0xff);
+
+        difference = Max(difference, Abs(ca - cb));
+    }
+
+    return difference;
+}
+
+
+/**
+ * Returns true if result of an edge case does not match expected pixel
+ * exactly. Returns false for pixels which are not edge cases.
+ */
+static bool IsEdgeCaseFailure(const BlendMode mode, const uint32 d,
+    const uint32 s, const int32 alpha, const uint32 result)
+{
+    if (alpha == 0 or mode == BlendMode::Destination) {
+        return result != d;
+    }
+
+    if (alpha == 255 and mode == BlendMode::Clear) {
+        return result != 0;
+    }
+
+    if (alpha == 255 and mode == BlendMode::Source) {
+        return result != s;
+    }
+
+    return false;
+}
+
+
+/**
+ * Checks solid color and pixel span kernels of one blend mode. Spans start
+ * at index 1 so vector versions also handle unaligned start.
+ */
+static void CheckBlendMode(const BlendMode mode, int32 &maxDifference,
+    int &edgeCaseFailures)
+{
+    const BlendModeKernels &kernels = GetBlendModeKernels(mode);
+
+    uint32 colors[TestColorCount];
+    uint32 d[TestColorCount + 1];
+
+    for (int i = 0; i < TestColorCount; i++) {
+        colors[i] = GetTestColor(i);
+    }
+
+    maxDifference = 0;
+    edgeCaseFailures = 0;
+
+    for (int c = 0; c < TestCoverageCount; c++) {
+        const int32 alpha = TestCoverages[c];
+
+        for (int j = 0; j < TestColorCount; j++) {
+            // Each destination color with one source color.
+            for (int i = 0; i < TestColorCount; i++) {
+                d[i + 1] = colors[i];
+            }
+
+            kernels.CompositeColorSpan(1, TestColorCount + 1, d, alpha,
+                colors[j]);
+
+            for (int i = 0; i < TestColorCount; i++) {
+                const uint32 expected = BlendReference(mode, colors[i],
+                    colors[j], alpha);
+
+                maxDifference = Max(maxDifference,
+                    PixelDifference(d[i + 1], expected));
+
+                if (IsEdgeCaseFailure(mode, colors[i], colors[j], alpha,
+                    d[i + 1]))
+                {
+                    edgeCaseFailures++;
+                }
+            }
+
+            // One destination color with each source color.
+            for (int i = 0; i < TestColorCount; i++) {
+                d[i + 1] = colors[j];
+            }
+
+            kernels.CompositePixelSpan(1, TestColorCount + 1, d, alpha,
+                colors);
+
+            for (int i = 0; i < TestColorCount; i++) {
+                const uint32 expected = BlendReference(mode, colors[j],
+                    colors[i], alpha);
+
+                maxDifference = Max(maxDifference,
+                    PixelDifference(d[i + 1], expected));
+
+                if (IsEdgeCaseFailure(mode, colors[j], colors[i], alpha,
+                    d[i + 1]))
+                {
+                    edgeCaseFailures++;
+                }
+            }
+        }
+    }
+}
+
+
+void RunBlendModeBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name)
+{
+    STATIC_ASSERT(SIZE_OF(BlendModeNames) / SIZE_OF(BlendModeNames[0]) ==
+        BlendModeCount);
+
+    printf("blend mode kernels compared to reference formulas\n");
+
+    for (int i = 0; i < BlendModeCount; i++) {
+        int32 maxDifference = 0;
+        int edgeCaseFailures = 0;
+
+        CheckBlendMode(BlendMode(i), maxDifference, edgeCaseFailures);
+
+        const bool passed = maxDifference <= MaximumDifference and
+            edgeCaseFailures == 0;
+
+        printf("    %-16s %s, differs by up to %d, %d edge case failures\n",
+            BlendModeNames[i], passed ? "ok" : "FAILED", maxDifference,
+            edgeCaseFailures);
+    }
+
+    BeginSceneBenchmark(geometries, geometryCount, name, scale, nullptr);
+
+    // The first geometry keeps source over so there is something to blend
+    // with. Clear, source and destination would hide or skip geometries,
+    // other modes are assigned in turn.
+    constexpr int FirstMode = int(BlendMode::DestinationOver);
+    constexpr int ModeCount = BlendModeCount - FirstMode;
+
+    Geometry *blended = static_cast<Geometry *>(
+        malloc(SIZE_OF(Geometry) * geometryCount));
+
+    for (int i = 0; i < geometryCount; i++) {
+        const Geometry &g = geometries[i];
+
+        const BlendMode mode = i == 0 ? BlendMode::SourceOver :
+            BlendMode(FirstMode + (i % ModeCount));
+
+        new (blended + i) Geometry(g.PathBounds, g.Tags, g.Points, g.TM,
+            g.TagCount, g.PointCount, g.Color, g.Rule, g.Paint, mode, g.Clip,
+            g.Layer, g.Stroke);
+    }
+
+    const double timeSourceOver = Measure(geometries, geometryCount, bounds,
+        scale, ImagePath("%s-blend-source-over.png", name));
+
+    const double timeModes = Measure(blended, geometryCount, bounds, scale,
+        ImagePath("%s-blend-modes.png", name));
+
+    free(blended);
+
+    PrintFrameTime("source over:", timeSourceOver);
+    PrintFrameTime("blend modes:", timeModes, timeSourceOver);
+}
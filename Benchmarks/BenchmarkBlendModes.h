@@ -0,0 +1,25 @@
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Compares span composition kernel of each blend mode to reference formulas
+ * evaluated in floating point, W3C compositing formulas for Porter-Duff
+ * operators and separable blend functions. Both solid color and pixel span
+ * kernels are checked with a range of premultiplied colors and coverage
+ * values. Differences of up to two steps come from integer rounding. Edge
+ * cases must match exactly: zero coverage and destination mode keep
+ * destination, fully covered clear and source write zero and source color.
+ *
+ * Then renders a given scene with source over and with blend mode of each
+ * geometry cycling through the other modes. Prints average frame time of
+ * both runs.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunBlendModeBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name);
@@ -0,0 +1,217 @@
+#include "BenchmarkClipPaths.h"
+#include "BenchmarkBlaze.h"
+#include "SyntheticScene.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+
+/**
+ * Destination of one frame rendered with the same transformation as
+ * Benchmark::Run.
+ */
+struct SceneImage final {
+    SceneImage(const IntRect &bounds, const double scale,
+        const int bytesPerPixel);
+   ~SceneImage();
+
+    ImageData GetImageData() const;
+
+    Matrix TM;
+    int Width = 0;
+    int Height = 0;
+    int BytesPerRow = 0;
+    uint8 *Pixels = nullptr;
+private:
+    DISABLE_COPY_AND_ASSIGN(SceneImage);
+};
+
+
+SceneImage::SceneImage(const IntRect &bounds, const double scale,
+    const int bytesPerPixel)
+:   TM(Matrix::CreateScale(scale))
+{
+    const int minx = int(Floor(double(bounds.MinX) * scale));
+    const int miny = int(Floor(double(bounds.MinY) * scale));
+    const int maxx = int(Ceil(double(bounds.MaxX) * scale));
+    const int maxy = int(Ceil(double(bounds.MaxY) * scale));
+
+    Width = maxx - minx;
+    Height = maxy - miny;
+
+    TM.PreTranslate(-minx, -miny);
+
+    // Rows are padded to the widest tile width, rasterizer may write up to
+    // the right edge of the last tile column.
+    BytesPerRow = ((Width * bytesPerPixel) + 255) & ~255;
+
+    Pixels = static_cast<uint8 *>(malloc(BytesPerRow * Height));
+
+    memset(Pixels, 0, BytesPerRow * Height);
+}
+
+
+SceneImage::~SceneImage()
+{
+    free(Pixels);
+}
+
+
+ImageData SceneImage::GetImageData() const {
+    return ImageData(Pixels, Width, Height, BytesPerRow);
+}
+
+
+/**
+ * Returns copies of geometries clipped by a given clip path. Returned memory
+ * must be freed by caller.
+ */
+static Geometry *CreateClippedGeometries(const Geometry *geometries,
+    const int geometryCount, const Geometry *clip)
+{
+    Geometry *clipped = static_cast<Geometry *>(
+        malloc(SIZE_OF(Geometry) * geometryCount));
+
+    for (int i = 0; i < geometryCount; i++) {
+        const Geometry &g = geometries[i];
+
+        new (clipped + i) Geometry(g.PathBounds, g.Tags, g.Points, g.TM,
+            g.TagCount, g.PointCount, g.Color, g.Rule, g.Paint, g.Mode, clip,
+            g.Layer, g.Stroke);
+    }
+
+    return clipped;
+}
+
+
+/**
+ * Renders a rectangle clipped by rectangles touching each of its sides and
+ * returns a number of composited tiles, which is expected to be zero.
+ */
+static int CountTilesOfTouchingClips()
+{
+    SyntheticScene scene;
+
+    // Covers pixels 13 to 44 in both directions, not aligned to tile
+    // boundaries.
+    scene.AddRectangle(13, 13, 32, 32, 0xff000000);
+
+    SyntheticScene clips;
+
+    clips.AddRectangle(45, 13, 32, 32, 0xff000000);
+    clips.AddRectangle(0, 13, 13, 32, 0xff000000);
+    clips.AddRectangle(13, 45, 32, 32, 0xff000000);
+    clips.AddRectangle(13, 0, 32, 13, 0xff000000);
+
+    SceneImage image(IntRect(0, 0, 96, 96), 1.0, 4);
+
+    int tileCount = 0;
+
+    for (int i = 0; i < clips.GetGeometryCount(); i++) {
+        const Geometry *clip = clips.GetGeometries() + i;
+
+        Geometry *clipped = CreateClippedGeometries(scene.GetGeometries(),
+            1, clip);
+
+        RasterizerStatistics statistics;
+        RasterizerOptions options;
+
+        options.Statistics = &statistics;
+
+        BenchmarkBlaze benchmark(options);
+
+        benchmark.Prepare(clipped, 1);
+        benchmark.RenderOnce(image.TM, image.GetImageData());
+
+        tileCount += statistics.CompositedTileCount;
+
+        free(clipped);
+    }
+
+    return tileCount;
+}
+
+
+void RunClipPathBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name)
+{
+    BeginSceneBenchmark(geometries, geometryCount, name, scale, nullptr);
+
+    // Clip path with straight edges and curved corners, inset by a quarter
+    // of scene size on every side.
+    const double w = double(bounds.MaxX - bounds.MinX);
+    const double h = double(bounds.MaxY - bounds.MinY);
+
+    SyntheticScene clips;
+
+    clips.AddRoundedRectangle(bounds.MinX + (w * 0.25),
+        bounds.MinY + (h * 0.25), w * 0.5, h * 0.5, Min(w, h) * 0.125,
+        0xff000000);
+
+    const Geometry *clip = clips.GetGeometries();
+
+    Geometry *clipped = CreateClippedGeometries(geometries, geometryCount,
+        clip);
+
+    const double timeUnclipped = Measure(geometries, geometryCount, bounds,
+        scale, ImagePath("%s-clip-none.png", name));
+
+    const double timeClipped = Measure(clipped, geometryCount, bounds, scale,
+        ImagePath("%s-clip-rounded.png", name));
+
+    // Render one more frame of each and clip coverage.
+    SceneImage unclipped(bounds, scale, 4);
+    SceneImage result(bounds, scale, 4);
+    SceneImage mask(bounds, scale, 1);
+
+    BenchmarkBlaze benchmark;
+
+    benchmark.Prepare(geometries, geometryCount);
+    benchmark.RenderOnce(unclipped.TM, unclipped.GetImageData());
+
+    benchmark.Prepare(clipped, geometryCount);
+    benchmark.RenderOnce(result.TM, result.GetImageData());
+
+    Threads threads;
+
+    RasterizeMask<TileDescriptor_8x16, SpanWriterMaskMax>(clip, 1, mask.TM,
+        threads, mask.GetImageData());
+
+    int differentPixelCount = 0;
+    int edgePixelCount = 0;
+
+    for (int y = 0; y < result.Height; y++) {
+        const uint32 *r = reinterpret_cast<const uint32 *>(
+            result.Pixels + (y * result.BytesPerRow));
+        const uint32 *u = reinterpret_cast<const uint32 *>(
+            unclipped.Pixels + (y * unclipped.BytesPerRow));
+        const uint8 *m = mask.Pixels + (y * mask.BytesPerRow);
+
+        for (int x = 0; x < result.Width; x++) {
+            if (m[x] == 0) {
+                // Background is transparent black.
+                if (r[x] != 0) {
+                    differentPixelCount++;
+                }
+            } else if (m[x] == 255) {
+                if (r[x] != u[x]) {
+                    differentPixelCount++;
+                }
+            } else {
+                edgePixelCount++;
+            }
+        }
+    }
+
+    free(clipped);
+
+    PrintFrameTime("unclipped:", timeUnclipped);
+    PrintFrameTime("clipped:", timeClipped, timeUnclipped);
+    printf("    %d tiles composited with clips only touching geometry\n",
+        CountTilesOfTouchingClips());
+    printf("    %d pixels differ from masked unclipped output\n",
+        differentPixelCount);
+    printf("    %d pixels along clip edge not compared\n", edgePixelCount);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Renders a given scene without clipping and then with every geometry
+ * clipped by a rounded rectangle inset from scene bounds. Prints average
+ * frame time for both runs and relative cost of clipping.
+ *
+ * Clipped output is compared to unclipped output masked by clip coverage
+ * rendered with RasterizeMask. Pixels outside of the clip path must keep
+ * background and pixels fully inside must match unclipped output exactly.
+ * Pixels along clip path edge are composited with coverage of each item
+ * scaled by clip coverage, so they are counted, but not compared. Before
+ * that, geometries with bounds only touching bounds of their clip path are
+ * checked to composite no tiles at all.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunClipPathBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name);
@@ -0,0 +1,174 @@
+
+#include "BenchmarkImagePattern.h"
+#include "BenchmarkBlaze.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+
+static constexpr int PatternSize = 256;
+
+
+/**
+ * Composites image pattern over the whole destination image row by row,
+ * then rasterizes geometries on top of it.
+ */
+class BenchmarkSeparatePass final : public Benchmark {
+public:
+    explicit BenchmarkSeparatePass(const Paint &pattern);
+public:
+    virtual void Prepare(const Geometry *geometries, const int geometryCount) override;
+    virtual void RenderOnce(const Matrix &matrix, const ImageData &image) override;
+private:
+    Threads mThreads;
+    const Paint &mPattern;
+    const Geometry *mGeometries = nullptr;
+    int mGeometryCount = 0;
+};
+
+
+BenchmarkSeparatePass::BenchmarkSeparatePass(const Paint &pattern)
+:   mPattern(pattern)
+{
+}
+
+
+void BenchmarkSeparatePass::Prepare(const Geometry *geometries,
+    const int geometryCount)
+{
+    mGeometries = geometries;
+    mGeometryCount = geometryCount;
+}
+
+
+template <ImageFilter Filter>
+static void CompositePattern(Threads &threads, const PaintShader &shader,
+    const ImageData &image)
+{
+    threads.ParallelFor(image.Height, [&](const int y, ThreadMemory &) {
+        uint32 *row = reinterpret_cast<uint32 *>(
+            image.Data + (y * image.BytesPerRow));
+
+        const SpanBlenderImage<Filter> blender(shader, y);
+
+        blender.CompositeSpan(0, image.Width, row, 255);
+    });
+}
+
+
+void BenchmarkSeparatePass::RenderOnce(const Matrix &matrix,
+    const ImageData &image)
+{
+    PaintShader shader;
+
+    InitializePaintShader(shader, mPattern, matrix, BlendMode::SourceOver);
+
+    if (mPattern.Filter == ImageFilter::Nearest) {
+        CompositePattern<ImageFilter::Nearest>(mThreads, shader, image);
+    } else {
+        CompositePattern<ImageFilter::Bilinear>(mThreads, shader, image);
+    }
+
+    Rasterize(mGeometries, mGeometryCount, matrix, mThreads, image);
+
+    // Free all the memory allocated by threads.
+    mThreads.ResetFrameMemory();
+}
+
+
+/**
+ * Fills opaque pattern with color ramps and a checkerboard, so neighbouring
+ * pixels differ and bilinear filter has to interpolate all of them.
+ */
+static void GeneratePattern(uint32 *pixels) {
+    for (int y = 0; y < PatternSize; y++) {
+        for (int x = 0; x < PatternSize; x++) {
+            const uint32 b = (((x >> 4) ^ (y >> 4)) & 1) != 0 ? 0xc0 : 0x40;
+
+            pixels[(y * PatternSize) + x] = 0xff000000 | (b << 16) |
+                (uint32(y) << 8) | uint32(x);
+        }
+    }
+}
+
+
+static void MeasureWithFilter(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name, const ImageData &pattern, const ImageFilter filter,
+    const char *filterName)
+{
+    // Rotate and scale pattern so that rows of destination image do not
+    // map to rows of pattern.
+    Matrix transform = Matrix::CreateTranslation(bounds.MinX, bounds.MinY);
+
+    transform.PreRotate(10);
+    transform.PreScale(1.5);
+
+    const Paint paint = Paint::CreateImagePattern(pattern, transform, filter,
+        PaintSpread::Repeat);
+
+    static const PathTag Tags[] = {
+        PathTag::Move,
+        PathTag::Line,
+        PathTag::Line,
+        PathTag::Line,
+        PathTag::Close
+    };
+
+    const FloatPoint points[] = {
+        FloatPoint { double(bounds.MinX), double(bounds.MinY) },
+        FloatPoint { double(bounds.MaxX), double(bounds.MinY) },
+        FloatPoint { double(bounds.MaxX), double(bounds.MaxY) },
+        FloatPoint { double(bounds.MinX), double(bounds.MaxY) }
+    };
+
+    // Rectangle filled with pattern goes below the scene.
+    Geometry *all = static_cast<Geometry *>(
+        malloc(SIZE_OF(Geometry) * (geometryCount + 1)));
+
+    new (all) Geometry(bounds, Tags, points, Matrix::Identity, 5, 4, 0,
+        FillRule::NonZero, &paint);
+
+    for (int i = 0; i < geometryCount; i++) {
+        new (all + i + 1) Geometry(geometries[i]);
+    }
+
+    const double timeSpans = Measure(all, geometryCount + 1, bounds, scale,
+        ImagePath("%s-pattern-%s-spans.png", name, filterName));
+
+    BenchmarkSeparatePass separate(paint);
+
+    const double timeSeparate = separate.Run(geometries, geometryCount,
+        bounds, scale, ImagePath("%s-pattern-%s-separate.png", name,
+        filterName));
+
+    printf("    %-8s in spans: %8.3f ms, separate pass: %8.3f ms\n",
+        filterName, timeSpans, timeSeparate);
+
+    free(all);
+}
+
+
+void RunImagePatternBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name)
+{
+    BeginSceneBenchmark(geometries, geometryCount, name, scale,
+        "image pattern");
+
+    uint32 *pixels = static_cast<uint32 *>(
+        malloc(SIZE_OF(uint32) * PatternSize * PatternSize));
+
+    GeneratePattern(pixels);
+
+    const ImageData pattern(reinterpret_cast<uint8 *>(pixels), PatternSize,
+        PatternSize, PatternSize * 4);
+
+    MeasureWithFilter(geometries, geometryCount, bounds, scale, name,
+        pattern, ImageFilter::Nearest, "nearest");
+
+    MeasureWithFilter(geometries, geometryCount, bounds, scale, name,
+        pattern, ImageFilter::Bilinear, "bilinear");
+
+    free(pixels);
+}
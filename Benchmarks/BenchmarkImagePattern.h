@@ -0,0 +1,20 @@
+
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Renders a given scene on top of a rectangle filled with image pattern,
+ * with nearest and bilinear filtering. Prints average frame time when
+ * pattern is sampled inside rasterizer spans and when pattern is composited
+ * over the whole destination image in a separate pass before rasterizing
+ * the scene.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunImagePatternBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name);
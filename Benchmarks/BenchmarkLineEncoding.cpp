@@ -0,0 +1,118 @@
+
+#include "BenchmarkLineEncoding.h"
+#include "BenchmarkBlaze.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+/**
+ * Renders one frame of a given scene with a given line encoding into newly
+ * allocated RGBA8 pixels, using the same transformation as Benchmark::Run.
+ * Returned memory must be freed by caller.
+ */
+static uint8 *RenderWithEncoding(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const LineEncoding encoding, int &byteCount)
+{
+    const int minx = int(Floor(double(bounds.MinX) * scale));
+    const int miny = int(Floor(double(bounds.MinY) * scale));
+    const int maxx = int(Ceil(double(bounds.MaxX) * scale));
+    const int maxy = int(Ceil(double(bounds.MaxY) * scale));
+
+    const int width = maxx - minx;
+    const int height = maxy - miny;
+
+    Matrix matrix = Matrix::CreateScale(scale);
+    matrix.PreTranslate(-minx, -miny);
+
+    const int bytesPerRow = ((width * 4) + 255) & ~255;
+
+    byteCount = bytesPerRow * height;
+
+    uint8 *pixels = static_cast<uint8 *>(malloc(byteCount));
+
+    memset(pixels, 0, byteCount);
+
+    RasterizerOptions options;
+
+    options.Encoding = encoding;
+
+    BenchmarkBlaze benchmark(options);
+
+    benchmark.Prepare(geometries, geometryCount);
+    benchmark.RenderOnce(matrix, ImageData(pixels, width, height,
+        bytesPerRow));
+
+    return pixels;
+}
+
+
+static void MeasureWithEncoding(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name, const LineEncoding encoding, const char *encodingName,
+    const uint8 *fixedPixels)
+{
+    RasterizerStatistics statistics;
+    RasterizerOptions options;
+
+    options.Encoding = encoding;
+    options.Statistics = &statistics;
+
+    const double time = Measure(geometries, geometryCount, bounds, scale,
+        ImagePath("%s-encoding-%s.png", name, encodingName), options);
+
+    const double bytes = double(statistics.LineBlockBytes) /
+        double(Benchmark::RunCount);
+
+    // Compare output to fixed size lines, which store line coordinates
+    // unchanged.
+    int byteCount = 0;
+
+    uint8 *pixels = RenderWithEncoding(geometries, geometryCount, bounds,
+        scale, encoding, byteCount);
+
+    int differentBytes = 0;
+    int maximumDifference = 0;
+
+    for (int i = 0; i < byteCount; i++) {
+        const int difference = Abs(int(pixels[i]) - int(fixedPixels[i]));
+
+        differentBytes += difference != 0;
+        maximumDifference = Max(maximumDifference, difference);
+    }
+
+    free(pixels);
+
+    printf("    %-9s %8.3f ms, %10.0f bytes of line blocks per frame, "
+        "%d bytes differ from fixed by up to %d\n", encodingName, time,
+        bytes, differentBytes, maximumDifference);
+}
+
+
+void RunLineEncodingBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name)
+{
+    BeginSceneBenchmark(geometries, geometryCount, name, scale,
+        "line encoding");
+
+    int byteCount = 0;
+
+    uint8 *fixedPixels = RenderWithEncoding(geometries, geometryCount,
+        bounds, scale, LineEncoding::Fixed, byteCount);
+
+    MeasureWithEncoding(geometries, geometryCount, bounds, scale, name,
+        LineEncoding::Fixed, "fixed", fixedPixels);
+
+    MeasureWithEncoding(geometries, geometryCount, bounds, scale, name,
+        LineEncoding::Delta, "delta", fixedPixels);
+
+    MeasureWithEncoding(geometries, geometryCount, bounds, scale, name,
+        LineEncoding::Tiled, "tiled", fixedPixels);
+
+    MeasureWithEncoding(geometries, geometryCount, bounds, scale, name,
+        LineEncoding::Automatic, "automatic", fixedPixels);
+
+    free(fixedPixels);
+}
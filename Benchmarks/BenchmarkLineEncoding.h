@@ -0,0 +1,20 @@
+
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Renders a given scene with each line encoding. Prints average frame time
+ * and average number of bytes taken by line blocks in one frame for each
+ * encoding. Output of each encoding is also compared to output of fixed
+ * size lines. Only tiled lines are expected to differ, and only by a few
+ * steps of alpha.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunLineEncodingBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name);
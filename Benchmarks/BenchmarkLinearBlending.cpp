@@ -0,0 +1,23 @@
+#include "BenchmarkLinearBlending.h"
+#include "BenchmarkBlaze.h"
+
+
+void RunLinearBlendingBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name)
+{
+    BeginSceneBenchmark(geometries, geometryCount, name, scale, nullptr);
+
+    RasterizerOptions options;
+
+    const double timeSRGB = Measure(geometries, geometryCount, bounds, scale,
+        ImagePath("%s-blending-srgb.png", name), options);
+
+    options.LinearBlending = true;
+
+    const double timeLinear = Measure(geometries, geometryCount, bounds,
+        scale, ImagePath("%s-blending-linear.png", name), options);
+
+    PrintFrameTime("srgb blending:", timeSRGB);
+    PrintFrameTime("linear blending:", timeLinear, timeSRGB);
+}
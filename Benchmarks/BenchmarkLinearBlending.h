@@ -0,0 +1,17 @@
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Renders a given scene with default blending and then with blending in
+ * linear light, see RasterizerOptions::LinearBlending. Prints average frame
+ * time for both runs and relative cost of linear blending.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunLinearBlendingBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name);
@@ -0,0 +1,190 @@
+
+#include "BenchmarkLinearizer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+
+// A number of times all geometries are linearized for each measurement.
+static constexpr int LinearizerRunCount = 20;
+
+
+// A number of cover arrays and a number of times each of them is processed
+// for each cover operation measurement.
+static constexpr int CoverArrayCount = 256;
+static constexpr int CoverOpRunCount = 4000;
+
+
+/**
+ * Returns average time, in milliseconds, it takes to linearize all
+ * geometries.
+ */
+template <typename T, typename L>
+static double MeasureLinearizer(const Geometry *geometries,
+    const int geometryCount, const IntSize imageSize, ThreadMemory &memory)
+{
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (int run = 0; run < LinearizerRunCount; run++) {
+        for (int i = 0; i < geometryCount; i++) {
+            const Geometry *geometry = geometries + i;
+            const IntRect b = geometry->PathBounds;
+
+            // Clip the same way rasterizer does.
+            const int minx = Max(0, b.MinX);
+            const int miny = Max(0, b.MinY);
+            const int maxx = Min(imageSize.Width, b.MaxX + 1);
+            const int maxy = Min(imageSize.Height, b.MaxY);
+
+            if (geometry->TagCount < 1 or minx >= maxx or miny >= maxy) {
+                continue;
+            }
+
+            const TileBounds bounds =
+                CalculateTileBounds<T>(minx, miny, maxx, maxy);
+
+            const bool contains =
+                b.MinX >= 0 and
+                b.MinY >= 0 and
+                b.MaxX <= imageSize.Width and
+                b.MaxY <= imageSize.Height;
+
+            Linearizer<T, L>::Create(memory, bounds, contains, geometry);
+
+            memory.ResetTaskMemory();
+        }
+
+        memory.ResetFrameMemory();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - begin).count() /
+        double(LinearizerRunCount);
+}
+
+
+template <typename T>
+static void MeasureTileDescriptor(const Geometry *geometries,
+    const int geometryCount, const IntSize imageSize, ThreadMemory &memory,
+    const char *name)
+{
+    const double x16 = MeasureLinearizer<T, LineArrayX16Y16>(geometries,
+        geometryCount, imageSize, memory);
+
+    const double x32 = MeasureLinearizer<T, LineArrayX32Y16>(geometries,
+        geometryCount, imageSize, memory);
+
+    const double delta = MeasureLinearizer<T, LineArrayDelta>(geometries,
+        geometryCount, imageSize, memory);
+
+    printf("    %-6s X16Y16 %8.3f ms, X32Y16 %8.3f ms, Delta %8.3f ms\n",
+        name, x16, x32, delta);
+}
+
+
+/**
+ * Returns average time, in nanoseconds, it takes to fill, accumulate and
+ * check for zeroes one cover array of a given size. Operations run over
+ * many cover arrays the way linearizer processes consecutive tile rows.
+ */
+template <int Count, bool Generic>
+static double MeasureCoverOps(int32 *covers)
+{
+    int zeroes = 0;
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (int run = 0; run < CoverOpRunCount; run++) {
+        // Each operation makes a separate pass over all cover arrays so that
+        // compiler cannot merge them.
+        for (int i = 0; i < CoverArrayCount; i++) {
+            if constexpr (Generic) {
+                FillCovers_generic<Count>(covers + (i * Count), run);
+            } else {
+                FillCovers<Count>(covers + (i * Count), run);
+            }
+        }
+
+        for (int i = 0; i < CoverArrayCount; i++) {
+            if constexpr (Generic) {
+                AccumulateCovers_generic<Count>(covers + (i * Count), -i);
+            } else {
+                AccumulateCovers<Count>(covers + (i * Count), -i);
+            }
+        }
+
+        for (int i = 0; i < CoverArrayCount; i++) {
+            if constexpr (Generic) {
+                zeroes += CoversContainOnlyZeroes_generic<Count>(
+                    covers + (i * Count));
+            } else {
+                zeroes += CoversContainOnlyZeroes<Count>(
+                    covers + (i * Count));
+            }
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    // Each row is all zeroes exactly once.
+    if (zeroes != Min(CoverOpRunCount, CoverArrayCount)) {
+        printf("    %d covers: unexpected result\n", Count);
+    }
+
+    return std::chrono::duration<double, std::nano>(end - begin).count() /
+        (double(CoverOpRunCount) * double(CoverArrayCount));
+}
+
+
+template <int Count>
+static void MeasureCoverOps(int32 *covers)
+{
+    const double g = MeasureCoverOps<Count, true>(covers);
+    const double s = MeasureCoverOps<Count, false>(covers);
+
+    printf("    %2d covers: generic %6.3f ns, selected %6.3f ns\n", Count, g,
+        s);
+}
+
+
+void RunLinearizerBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntSize imageSize, const char *name)
+{
+    ASSERT(geometries != nullptr);
+    ASSERT(geometryCount > 0);
+    ASSERT(imageSize.Width > 0);
+    ASSERT(imageSize.Height > 0);
+    ASSERT(name != nullptr);
+
+    ThreadMemory memory;
+
+    printf("%s, %d geometries, linearization per frame\n", name,
+        geometryCount);
+
+    MeasureTileDescriptor<TileDescriptor_8x8>(geometries, geometryCount,
+        imageSize, memory, "8x8");
+
+    MeasureTileDescriptor<TileDescriptor_16x8>(geometries, geometryCount,
+        imageSize, memory, "16x8");
+
+    MeasureTileDescriptor<TileDescriptor_8x16>(geometries, geometryCount,
+        imageSize, memory, "8x16");
+
+    MeasureTileDescriptor<TileDescriptor_64x16>(geometries, geometryCount,
+        imageSize, memory, "64x16");
+
+    MeasureTileDescriptor<TileDescriptor_8x32>(geometries, geometryCount,
+        imageSize, memory, "8x32");
+
+    int32 *covers = static_cast<int32 *>(
+        malloc(SIZE_OF(int32) * 32 * CoverArrayCount));
+
+    printf("Start cover operations, fill, accumulate and check per row\n");
+
+    MeasureCoverOps<8>(covers);
+    MeasureCoverOps<16>(covers);
+    MeasureCoverOps<32>(covers);
+
+    free(covers);
+}
@@ -0,0 +1,23 @@
+
+#pragma once
+
+
+#include <Blaze/Blaze.h>
+
+
+/**
+ * Measures linearization of given geometries with each tile descriptor and
+ * start cover operations used by linearizer, both generic versions and
+ * versions selected for current processor. Geometries are expected to be
+ * already transformed to destination image coordinates.
+ *
+ * Linearization time includes all SIMD kernels selected at compile time. To
+ * see how much they save, compare output of this benchmark built with and
+ * without SIMD_GENERIC.
+ *
+ * @param imageSize Destination image size geometries are clipped to.
+ *
+ * @param name Scene name used when printing results.
+ */
+void RunLinearizerBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntSize imageSize, const char *name);
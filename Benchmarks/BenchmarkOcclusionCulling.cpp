@@ -0,0 +1,50 @@
+
+#include "BenchmarkOcclusionCulling.h"
+#include "BenchmarkBlaze.h"
+#include <cstdio>
+
+
+static double MeasureWithCulling(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *path, const bool occlusionCulling, double &tilesPerFrame)
+{
+    RasterizerStatistics statistics;
+    RasterizerOptions options;
+
+    options.OcclusionCulling = occlusionCulling;
+    options.Statistics = &statistics;
+
+    const double time = Measure(geometries, geometryCount, bounds, scale,
+        path, options);
+
+    tilesPerFrame = double(statistics.CompositedTileCount) /
+        double(Benchmark::RunCount);
+
+    return time;
+}
+
+
+void RunOcclusionCullingBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name)
+{
+    BeginSceneBenchmark(geometries, geometryCount, name, scale, nullptr);
+
+    double tilesOff = 0;
+    double tilesOn = 0;
+
+    const double timeOff = MeasureWithCulling(geometries, geometryCount,
+        bounds, scale, ImagePath("%s-culling-off.png", name), false,
+        tilesOff);
+
+    const double timeOn = MeasureWithCulling(geometries, geometryCount,
+        bounds, scale, ImagePath("%s-culling-on.png", name), true, tilesOn);
+
+    const double reduction = tilesOff > 0 ?
+        (1.0 - (tilesOn / tilesOff)) * 100.0 : 0.0;
+
+    printf("    culling off: %8.3f ms, %10.0f tiles composited per frame\n",
+        timeOff, tilesOff);
+    printf("    culling on:  %8.3f ms, %10.0f tiles composited per frame "
+        "(%.1f%% less overdraw)\n", timeOn, tilesOn, reduction);
+}
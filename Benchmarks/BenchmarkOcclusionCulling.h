@@ -0,0 +1,18 @@
+
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Renders a given scene with occlusion culling disabled and then enabled.
+ * Prints average frame time and the number of tiles composited per frame for
+ * both runs.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunOcclusionCullingBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name);
@@ -0,0 +1,316 @@
+
+#include "BenchmarkPixelFormat.h"
+#include "BenchmarkBlaze.h"
+#include "SyntheticScene.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+
+static constexpr int CheckImageSize = 256;
+
+
+/**
+ * Rasterizes directly into destination image of pixel format F.
+ */
+template <PixelFormat F>
+class BenchmarkDirect final : public Benchmark {
+public:
+    virtual void Prepare(const Geometry *geometries, const int geometryCount) override;
+    virtual void RenderOnce(const Matrix &matrix, const ImageData &image) override;
+    virtual int GetBytesPerPixel() const override;
+private:
+    Threads mThreads;
+    const Geometry *mGeometries = nullptr;
+    int mGeometryCount = 0;
+};
+
+
+template <PixelFormat F>
+void BenchmarkDirect<F>::Prepare(const Geometry *geometries,
+    const int geometryCount)
+{
+    mGeometries = geometries;
+    mGeometryCount = geometryCount;
+}
+
+
+template <PixelFormat F>
+void BenchmarkDirect<F>::RenderOnce(const Matrix &matrix,
+    const ImageData &image)
+{
+    RasterizeInFormat<F>(mGeometries, mGeometryCount, matrix, mThreads,
+        image);
+
+    // Free all the memory allocated by threads.
+    mThreads.ResetFrameMemory();
+}
+
+
+template <PixelFormat F>
+int BenchmarkDirect<F>::GetBytesPerPixel() const
+{
+    return BytesPerPixelForFormat(F);
+}
+
+
+/**
+ * Converts one row of premultiplied RGBA8 pixels to pixel format F.
+ */
+template <PixelFormat F>
+static void ConvertRow(const uint32 *s, uint8 *d, const int width) {
+    for (int x = 0; x < width; x++) {
+        if constexpr (F == PixelFormat::BGRA8) {
+            reinterpret_cast<uint32 *>(d)[x] = SwapRedBlue(s[x]);
+        } else if constexpr (F == PixelFormat::RGB565) {
+            reinterpret_cast<uint16 *>(d)[x] = PackRGB565(
+                BlendSourceOver(0xff000000, s[x]));
+        } else if constexpr (F == PixelFormat::RGBA8Straight) {
+            reinterpret_cast<uint32 *>(d)[x] = UnpremultiplyAlpha(s[x]);
+        } else if constexpr (F == PixelFormat::RGBA16) {
+            reinterpret_cast<uint64 *>(d)[x] = ExpandRGBA8ToRGBA16(s[x]);
+        } else {
+            reinterpret_cast<uint32 *>(d)[x] = s[x];
+        }
+    }
+}
+
+
+/**
+ * Rasterizes into RGBA8 image and converts it to pixel format F in a
+ * separate pass, one row per task.
+ */
+template <PixelFormat F>
+class BenchmarkConverted final : public Benchmark {
+public:
+    BenchmarkConverted();
+   ~BenchmarkConverted();
+public:
+    virtual void Prepare(const Geometry *geometries, const int geometryCount) override;
+    virtual void RenderOnce(const Matrix &matrix, const ImageData &image) override;
+private:
+    Threads mThreads;
+    const Geometry *mGeometries = nullptr;
+    int mGeometryCount = 0;
+    uint8 *mConverted = nullptr;
+    int mConvertedSize = 0;
+private:
+    DISABLE_COPY_AND_ASSIGN(BenchmarkConverted);
+};
+
+
+template <PixelFormat F>
+BenchmarkConverted<F>::BenchmarkConverted()
+{
+}
+
+
+template <PixelFormat F>
+BenchmarkConverted<F>::~BenchmarkConverted()
+{
+    free(mConverted);
+}
+
+
+template <PixelFormat F>
+void BenchmarkConverted<F>::Prepare(const Geometry *geometries,
+    const int geometryCount)
+{
+    mGeometries = geometries;
+    mGeometryCount = geometryCount;
+}
+
+
+template <PixelFormat F>
+void BenchmarkConverted<F>::RenderOnce(const Matrix &matrix,
+    const ImageData &image)
+{
+    const int bytesPerRow = image.Width * BytesPerPixelForFormat(F);
+    const int size = bytesPerRow * image.Height;
+
+    if (size > mConvertedSize) {
+        free(mConverted);
+
+        mConverted = static_cast<uint8 *>(malloc(size));
+        mConvertedSize = size;
+    }
+
+    Rasterize(mGeometries, mGeometryCount, matrix, mThreads, image);
+
+    mThreads.ParallelFor(image.Height, [&](const int y, ThreadMemory &) {
+        ConvertRow<F>(reinterpret_cast<const uint32 *>(
+            image.Data + (y * image.BytesPerRow)),
+            mConverted + (y * bytesPerRow), image.Width);
+    });
+
+    // Free all the memory allocated by threads.
+    mThreads.ResetFrameMemory();
+}
+
+
+/**
+ * Measures one pixel format and prints frame times. Returns time of direct
+ * rendering.
+ *
+ * @param rgba8 Time of direct rendering into RGBA8 image, throughput is
+ * printed relative to it. Zero when measuring RGBA8 itself.
+ */
+template <PixelFormat F>
+static double MeasureFormat(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name, const double rgba8)
+{
+    const char *formatName = GetPixelFormatName(F);
+
+    BenchmarkDirect<F> direct;
+
+    const double timeDirect = direct.Run(geometries, geometryCount, bounds,
+        scale, ImagePath("%s-format-%s-direct.png", name, formatName));
+
+    BenchmarkConverted<F> converted;
+
+    const double timeConverted = converted.Run(geometries, geometryCount,
+        bounds, scale, ImagePath("%s-format-%s-converted.png", name,
+        formatName));
+
+    const double reference = rgba8 > 0 ? rgba8 : timeDirect;
+
+    printf("    %-14s direct: %8.3f ms, rgba8 and conversion: %8.3f ms, "
+        "throughput relative to rgba8: %.2f\n", formatName, timeDirect,
+        timeConverted, reference / timeDirect);
+
+    return timeDirect;
+}
+
+
+/**
+ * Renders geometries into RGBA8 and BGRA8 images and returns a number of
+ * pixels which differ other than by order of red and blue components.
+ */
+static int CountBGRA8Differences(const Geometry *geometries,
+    const int geometryCount)
+{
+    constexpr int S = CheckImageSize;
+
+    uint32 *rgba = static_cast<uint32 *>(calloc(S * S, SIZE_OF(uint32)));
+    uint32 *bgra = static_cast<uint32 *>(calloc(S * S, SIZE_OF(uint32)));
+
+    Threads threads;
+
+    Rasterize(geometries, geometryCount, Matrix::Identity, threads,
+        ImageData(reinterpret_cast<uint8 *>(rgba), S, S, S * 4));
+
+    threads.ResetFrameMemory();
+
+    RasterizeInFormat<PixelFormat::BGRA8>(geometries, geometryCount,
+        Matrix::Identity, threads,
+        ImageData(reinterpret_cast<uint8 *>(bgra), S, S, S * 4));
+
+    threads.ResetFrameMemory();
+
+    int count = 0;
+
+    for (int i = 0; i < S * S; i++) {
+        if (bgra[i] != SwapRedBlue(rgba[i])) {
+            count++;
+        }
+    }
+
+    free(rgba);
+    free(bgra);
+
+    return count;
+}
+
+
+/**
+ * Checks that BGRA8 images are composited with every span blender RGBA8
+ * images are. Overlapping translucent rectangles of different colors are
+ * rendered with plain colors, which swaps colors of geometries, and then
+ * with gradient, blend modes and layer assigned in turn, which swaps red and
+ * blue of destination tile rows. Returns the number of different pixels.
+ */
+static int CheckBGRA8()
+{
+    constexpr int Count = 24;
+    constexpr double Step = double(CheckImageSize) / 8.0;
+
+    SyntheticScene scene;
+
+    for (int i = 0; i < Count; i++) {
+        const uint32 r = uint32(i * 10);
+        const uint32 b = uint32(255 - (i * 10));
+        const uint32 a = (i % 3) == 0 ? 255 : 192;
+
+        // Premultiplied, so components may not exceed alpha.
+        const uint32 color = (a << 24) | (Min(b, a) << 16) | (64 << 8) |
+            Min(r, a);
+
+        scene.AddRectangle((double(i % 6) * Step) + 3.3,
+            (double(i / 6) * Step) + 5.7, Step * 2.5, Step * 1.5, color);
+    }
+
+    const Geometry *geometries = scene.GetGeometries();
+
+    int count = CountBGRA8Differences(geometries, Count);
+
+    const GradientStop stops[] = {
+        { 0, 0xff0000ff },
+        { 0.5, 0x80008000 },
+        { 1, 0xffff0000 }
+    };
+
+    const Paint gradient = Paint::CreateLinearGradient(FloatPoint(0, 0),
+        FloatPoint(CheckImageSize, CheckImageSize), stops, 3);
+
+    const Layer layer(160, BlendMode::Multiply);
+
+    Geometry *assigned = static_cast<Geometry *>(
+        malloc(SIZE_OF(Geometry) * Count));
+
+    for (int i = 0; i < Count; i++) {
+        const Geometry &g = geometries[i];
+
+        const Paint *paint = (i % 4) == 1 ? &gradient : nullptr;
+        const BlendMode mode = (i % 4) == 2 ? BlendMode::Screen :
+            BlendMode::SourceOver;
+        const Layer *l = (i >= 16 and i < 20) ? &layer : nullptr;
+
+        new (assigned + i) Geometry(g.PathBounds, g.Tags, g.Points, g.TM,
+            g.TagCount, g.PointCount, g.Color, g.Rule, paint, mode, nullptr,
+            l);
+    }
+
+    count += CountBGRA8Differences(assigned, Count);
+
+    free(assigned);
+
+    return count;
+}
+
+
+void RunPixelFormatBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name)
+{
+    const int bgra8Differences = CheckBGRA8();
+
+    BeginSceneBenchmark(geometries, geometryCount, name, scale,
+        "pixel formats");
+
+    printf("    bgra8 compared to rgba8 with red and blue swapped: %s, %d "
+        "pixels differ\n", bgra8Differences == 0 ? "ok" : "FAILED",
+        bgra8Differences);
+
+    const double rgba8 = MeasureFormat<PixelFormat::RGBA8>(geometries,
+        geometryCount, bounds, scale, name, 0);
+
+    MeasureFormat<PixelFormat::BGRA8>(geometries, geometryCount, bounds,
+        scale, name, rgba8);
+    MeasureFormat<PixelFormat::RGB565>(geometries, geometryCount, bounds,
+        scale, name, rgba8);
+    MeasureFormat<PixelFormat::RGBA8Straight>(geometries, geometryCount,
+        bounds, scale, name, rgba8);
+    MeasureFormat<PixelFormat::RGBA16>(geometries, geometryCount, bounds,
+        scale, name, rgba8);
+}
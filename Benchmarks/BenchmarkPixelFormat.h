@@ -0,0 +1,25 @@
+
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Renders a given scene into destination image of each pixel format. Prints
+ * average frame time when pixels are composited in destination format
+ * directly and when scene is rasterized into RGBA8 image and converted to
+ * destination format in a separate pass, as well as throughput of direct
+ * rendering relative to RGBA8.
+ *
+ * Output images contain raw pixels of each format, so only RGBA8 images
+ * look right. Before that, BGRA8 output of a test scene with plain colors,
+ * gradient, blend modes and layer is checked to match RGBA8 output with red
+ * and blue swapped.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunPixelFormatBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name);
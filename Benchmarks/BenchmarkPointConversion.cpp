@@ -0,0 +1,156 @@
+
+#include "BenchmarkPointConversion.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+
+// A number of times all points are converted for each measurement.
+static constexpr int PointConversionRunCount = 200;
+
+
+using PointConversionFunction = void (*)(const Matrix &, F24Dot8Point *,
+    const FloatPoint *, const int, const F24Dot8Point, const F24Dot8Point);
+
+
+static void ConvertGeneric(const Matrix &matrix, F24Dot8Point *dst,
+    const FloatPoint *src, const int count, const F24Dot8Point origin,
+    const F24Dot8Point size)
+{
+    FloatPointsToF24Dot8Points_generic(matrix, dst, src, count, origin,
+        size);
+}
+
+
+static void ConvertSelected(const Matrix &matrix, F24Dot8Point *dst,
+    const FloatPoint *src, const int count, const F24Dot8Point origin,
+    const F24Dot8Point size)
+{
+    FloatPointsToF24Dot8Points(matrix, dst, src, count, origin, size);
+}
+
+
+/**
+ * Returns average time, in nanoseconds, it takes to convert one point.
+ */
+static double MeasureConversion(const PointConversionFunction fn,
+    const Matrix &matrix, F24Dot8Point *dst, const FloatPoint *src,
+    const int count)
+{
+    const F24Dot8Point origin = { 0, 0 };
+    const F24Dot8Point size = { 1 << 28, 1 << 28 };
+
+    // Warm up caches.
+    fn(matrix, dst, src, count, origin, size);
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < PointConversionRunCount; i++) {
+        fn(matrix, dst, src, count, origin, size);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(
+        end - begin).count();
+
+    return ns / (double(count) * double(PointConversionRunCount));
+}
+
+
+void RunPointConversionBenchmark(const Geometry *geometries,
+    const int geometryCount, const char *name)
+{
+    ASSERT(geometries != nullptr);
+    ASSERT(geometryCount > 0);
+    ASSERT(name != nullptr);
+
+    int count = 0;
+
+    for (int i = 0; i < geometryCount; i++) {
+        count += geometries[i].PointCount;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    // Put all points into one array so that time spent in conversion
+    // dominates.
+    FloatPoint *src = static_cast<FloatPoint *>(
+        malloc(SIZE_OF(FloatPoint) * count));
+
+    F24Dot8Point *generic = static_cast<F24Dot8Point *>(
+        malloc(SIZE_OF(F24Dot8Point) * count));
+
+    F24Dot8Point *selected = static_cast<F24Dot8Point *>(
+        malloc(SIZE_OF(F24Dot8Point) * count));
+
+    FloatPoint *p = src;
+
+    for (int i = 0; i < geometryCount; i++) {
+        memcpy(p, geometries[i].Points,
+            SIZE_OF(FloatPoint) * geometries[i].PointCount);
+
+        p += geometries[i].PointCount;
+    }
+
+    Matrix translationScale = Matrix::CreateScale(1.7, 1.3);
+    Matrix complex = Matrix::CreateRotation(30);
+
+    translationScale.PostTranslate(13.3, 7.7);
+    complex.PostTranslate(13.3, 7.7);
+
+    struct {
+        const char *Name;
+        Matrix M;
+    } const matrices[] = {
+        { "identity", Matrix::Identity },
+        { "translation only", Matrix::CreateTranslation(13.3, 7.7) },
+        { "scale only", Matrix::CreateScale(1.7, 1.3) },
+        { "translation and scale", translationScale },
+        { "complex", complex }
+    };
+
+    const InstructionSet initial = GetInstructionSet();
+    const InstructionSet best = DetectInstructionSet();
+
+    printf("%s, %d points\n", name, count);
+
+    for (const auto &m : matrices) {
+        const double g = MeasureConversion(ConvertGeneric, m.M, generic,
+            src, count);
+
+        printf("    %-22s generic %6.3f ns", m.Name, g);
+
+        // Measure kernels selected for every instruction set processor
+        // supports. Without runtime dispatch this measures kernels selected
+        // at compile time.
+        const int first = int(Min(InstructionSet::SSE41, best));
+
+        for (int i = first; i <= int(best); i++) {
+            const InstructionSet set = SelectInstructionSet(
+                InstructionSet(i));
+
+            const char *label = set == InstructionSet::Generic ?
+                "selected" : GetInstructionSetName(set);
+
+            const double s = MeasureConversion(ConvertSelected, m.M,
+                selected, src, count);
+
+            const bool identical = memcmp(generic, selected,
+                SIZE_OF(F24Dot8Point) * count) == 0;
+
+            printf(", %s %6.3f ns%s", label, s,
+                identical ? "" : " (OUTPUT DIFFERS)");
+        }
+
+        printf("\n");
+    }
+
+    SelectInstructionSet(initial);
+
+    free(src);
+    free(generic);
+    free(selected);
+}
@@ -0,0 +1,19 @@
+
+#pragma once
+
+
+#include <Blaze/Blaze.h>
+
+
+/**
+ * Measures conversion of geometry points to F24Dot8 format, which is the
+ * first thing linearizer does with each geometry. All points of given
+ * geometries are converted by generic version and by kernels of each
+ * instruction set processor supports, once for each matrix complexity.
+ * Prints time per point and checks that all kernels produce output identical
+ * to generic version.
+ *
+ * @param name Scene name used when printing results.
+ */
+void RunPointConversionBenchmark(const Geometry *geometries,
+    const int geometryCount, const char *name);
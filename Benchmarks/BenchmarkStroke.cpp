@@ -0,0 +1,377 @@
+
+#include "BenchmarkStroke.h"
+#include "BenchmarkBlaze.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+
+// Coverage of stroked test paths is compared to the same paths rendered at
+// this scale and averaged over blocks of pixels.
+static constexpr int SupersamplingScale = 16;
+
+
+// Rounding of averaged reference coverage and of coverage itself.
+static constexpr int MaximumCoverageExcess = 2;
+
+
+static constexpr int CoverageTestSize = 128;
+
+
+static const char *LineJoinNames[] = {
+    "miter",
+    "round",
+    "bevel"
+};
+
+
+static const char *LineCapNames[] = {
+    "butt",
+    "round",
+    "square"
+};
+
+
+/**
+ * Collects stroke outline polygons into one growing path.
+ */
+struct OutlineSink final {
+    void AddPolygon(const FloatPoint *points, const int count);
+
+    PathTag *Tags = nullptr;
+    FloatPoint *Points = nullptr;
+    int TagCount = 0;
+    int PointCount = 0;
+    int TagCapacity = 0;
+    int PointCapacity = 0;
+};
+
+
+void OutlineSink::AddPolygon(const FloatPoint *points, const int count)
+{
+    if (TagCount + count + 1 > TagCapacity) {
+        TagCapacity = Max(TagCapacity * 2, TagCount + count + 1);
+        Tags = static_cast<PathTag *>(
+            realloc(Tags, SIZE_OF(PathTag) * TagCapacity));
+    }
+
+    if (PointCount + count > PointCapacity) {
+        PointCapacity = Max(PointCapacity * 2, PointCount + count);
+        Points = static_cast<FloatPoint *>(
+            realloc(Points, SIZE_OF(FloatPoint) * PointCapacity));
+    }
+
+    for (int i = 0; i < count; i++) {
+        Tags[TagCount++] = i == 0 ? PathTag::Move : PathTag::Line;
+        Points[PointCount++] = points[i];
+    }
+
+    Tags[TagCount++] = PathTag::Close;
+}
+
+
+/**
+ * Converts all strokes into outlines in device coordinates before each frame
+ * and then rasterizes outlines as regular paths.
+ */
+class BenchmarkPreStroked final : public Benchmark {
+public:
+    BenchmarkPreStroked();
+   ~BenchmarkPreStroked();
+public:
+    virtual void Prepare(const Geometry *geometries, const int geometryCount) override;
+    virtual void RenderOnce(const Matrix &matrix, const ImageData &image) override;
+private:
+    Threads mThreads;
+    OutlineSink mSink;
+    const Geometry *mGeometries = nullptr;
+    int mGeometryCount = 0;
+
+    // Outline geometries and offsets of their tags and points in sink,
+    // rebuilt every frame.
+    Geometry *mOutlines = nullptr;
+    int *mTagOffsets = nullptr;
+    int *mPointOffsets = nullptr;
+private:
+    DISABLE_COPY_AND_ASSIGN(BenchmarkPreStroked);
+};
+
+
+BenchmarkPreStroked::BenchmarkPreStroked()
+{
+}
+
+
+BenchmarkPreStroked::~BenchmarkPreStroked()
+{
+    free(mSink.Tags);
+    free(mSink.Points);
+    free(mOutlines);
+    free(mTagOffsets);
+    free(mPointOffsets);
+}
+
+
+void BenchmarkPreStroked::Prepare(const Geometry *geometries,
+    const int geometryCount)
+{
+    mGeometries = geometries;
+    mGeometryCount = geometryCount;
+
+    // Geometry is not trivially copyable, previous outlines are discarded and
+    // new ones are constructed in place every frame.
+    free(mOutlines);
+
+    mOutlines = static_cast<Geometry *>(
+        malloc(SIZE_OF(Geometry) * geometryCount));
+    mTagOffsets = static_cast<int *>(
+        realloc(mTagOffsets, SIZE_OF(int) * (geometryCount + 1)));
+    mPointOffsets = static_cast<int *>(
+        realloc(mPointOffsets, SIZE_OF(int) * (geometryCount + 1)));
+}
+
+
+void BenchmarkPreStroked::RenderOnce(const Matrix &matrix,
+    const ImageData &image)
+{
+    mSink.TagCount = 0;
+    mSink.PointCount = 0;
+
+    for (int i = 0; i < mGeometryCount; i++) {
+        const Geometry &g = mGeometries[i];
+
+        mTagOffsets[i] = mSink.TagCount;
+        mPointOffsets[i] = mSink.PointCount;
+
+        if (g.Stroke == nullptr) {
+            continue;
+        }
+
+        Matrix tm(g.TM);
+
+        tm.PreMultiply(matrix);
+
+        Stroker<OutlineSink> stroker(mSink, *g.Stroke, tm);
+
+        stroker.StrokePath(g.Tags, g.Points, g.TagCount);
+    }
+
+    mTagOffsets[mGeometryCount] = mSink.TagCount;
+    mPointOffsets[mGeometryCount] = mSink.PointCount;
+
+    // Sink may have moved its buffers while growing, so geometries are
+    // created only after all outlines are complete.
+    int count = 0;
+
+    for (int i = 0; i < mGeometryCount; i++) {
+        const int tagCount = mTagOffsets[i + 1] - mTagOffsets[i];
+        const int pointCount = mPointOffsets[i + 1] - mPointOffsets[i];
+
+        if (tagCount == 0) {
+            continue;
+        }
+
+        const FloatPoint *points = mSink.Points + mPointOffsets[i];
+
+        double minx = points[0].X;
+        double miny = points[0].Y;
+        double maxx = points[0].X;
+        double maxy = points[0].Y;
+
+        for (int j = 1; j < pointCount; j++) {
+            minx = Min(minx, points[j].X);
+            miny = Min(miny, points[j].Y);
+            maxx = Max(maxx, points[j].X);
+            maxy = Max(maxy, points[j].Y);
+        }
+
+        const FloatRect bounds(minx, miny, maxx - minx, maxy - miny);
+
+        new (mOutlines + count) Geometry(bounds.ToExpandedIntRect(),
+            mSink.Tags + mTagOffsets[i], points, Matrix::Identity, tagCount,
+            pointCount, mGeometries[i].Color, FillRule::NonZero);
+
+        count++;
+    }
+
+    Rasterize(mOutlines, count, Matrix::Identity, mThreads, image);
+
+    // Free all the memory allocated by threads.
+    mThreads.ResetFrameMemory();
+}
+
+
+/**
+ * Builds test paths into given arrays and returns number of tags, which is
+ * also the number of points. Open zigzags turn in alternating directions by
+ * 30, 90 and 150 degrees, so no segment crosses other segments, and the
+ * last path is a closed triangle.
+ */
+static int CreateCoverageTestPaths(PathTag *tags, FloatPoint *points)
+{
+    static constexpr double Turns[] = { 30, 90, 150 };
+    static constexpr int SegmentCount = 4;
+    static constexpr double SegmentLength = 20;
+
+    int count = 0;
+
+    for (int i = 0; i < 3; i++) {
+        const double a = (Turns[i] * 0.5) * (3.1415926535897932 / 180.0);
+        const double dx = SegmentLength * Cos(a);
+        const double dy = SegmentLength * Sin(a);
+
+        // Fractional start so edges do not fall on pixel boundaries.
+        FloatPoint p(8.3, (double(i) * 32.0) + 24.7);
+
+        tags[count] = PathTag::Move;
+        points[count++] = p;
+
+        for (int j = 0; j < SegmentCount; j++) {
+            p.X += dx;
+            p.Y += (j & 1) == 0 ? -dy : dy;
+
+            tags[count] = PathTag::Line;
+            points[count++] = p;
+        }
+    }
+
+    tags[count] = PathTag::Move;
+    points[count++] = FloatPoint(16.6, 120.2);
+    tags[count] = PathTag::Line;
+    points[count++] = FloatPoint(40.6, 120.2);
+    tags[count] = PathTag::Line;
+    points[count++] = FloatPoint(28.6, 99.4);
+    tags[count] = PathTag::Close;
+    points[count++] = FloatPoint(28.6, 99.4);
+
+    return count;
+}
+
+
+/**
+ * Renders coverage of a given stroked geometry scaled by a given factor into
+ * square mask of a given size.
+ */
+static void RenderCoverage(const Geometry &geometry, const int scale,
+    const int size, uint8 *mask, Threads &threads)
+{
+    memset(mask, 0, size * size);
+
+    RasterizeMask<TileDescriptor_8x16, SpanWriterMaskMax>(&geometry, 1,
+        Matrix::CreateScale(scale), threads,
+        ImageData(mask, size, size, size));
+
+    threads.ResetFrameMemory();
+}
+
+
+/**
+ * Strokes test paths with one combination of join, cap and width, and
+ * returns the largest amount by which coverage exceeds supersampled
+ * reference.
+ */
+static int MeasureCoverageExcess(const Stroke &stroke, uint8 *mask,
+    uint8 *reference, Threads &threads)
+{
+    PathTag tags[32];
+    FloatPoint points[32];
+
+    const int count = CreateCoverageTestPaths(tags, points);
+
+    const Geometry geometry(IntRect(0, 0, CoverageTestSize,
+        CoverageTestSize), tags, points, Matrix::Identity, count, count,
+        0xff000000, FillRule::NonZero, nullptr, BlendMode::SourceOver,
+        nullptr, nullptr, &stroke);
+
+    constexpr int S = SupersamplingScale;
+    constexpr int ReferenceSize = CoverageTestSize * S;
+
+    RenderCoverage(geometry, 1, CoverageTestSize, mask, threads);
+    RenderCoverage(geometry, S, ReferenceSize, reference, threads);
+
+    int excess = 0;
+
+    for (int y = 0; y < CoverageTestSize; y++) {
+        for (int x = 0; x < CoverageTestSize; x++) {
+            int sum = 0;
+
+            for (int i = 0; i < S; i++) {
+                const uint8 *r = reference + (((y * S) + i) * ReferenceSize) +
+                    (x * S);
+
+                for (int j = 0; j < S; j++) {
+                    sum += r[j];
+                }
+            }
+
+            const int expected = (sum + ((S * S) / 2)) / (S * S);
+
+            excess = Max(excess,
+                int(mask[(y * CoverageTestSize) + x]) - expected);
+        }
+    }
+
+    return excess;
+}
+
+
+/**
+ * Checks that stroke outline polygons do not overlap at joins and caps.
+ * Overlapping polygons both having edges in the same pixel make it darker
+ * than it should be. Curves are flattened with fewer points at lower scale,
+ * so coverage is only checked not to exceed the reference.
+ */
+static void CheckStrokeCoverage()
+{
+    constexpr int ReferenceSize = CoverageTestSize * SupersamplingScale;
+
+    uint8 *mask = static_cast<uint8 *>(
+        malloc(CoverageTestSize * CoverageTestSize));
+    uint8 *reference = static_cast<uint8 *>(
+        malloc(ReferenceSize * ReferenceSize));
+
+    Threads threads;
+
+    printf("stroke coverage compared to %dx supersampled reference\n",
+        SupersamplingScale);
+
+    for (int join = 0; join < 3; join++) {
+        for (int cap = 0; cap < 3; cap++) {
+            for (const double width : { 1.0, 4.0 }) {
+                const Stroke stroke(width, LineJoin(join), LineCap(cap));
+
+                const int excess = MeasureCoverageExcess(stroke, mask,
+                    reference, threads);
+
+                printf("    %-5s join, %-6s cap, width %.1f: %s, exceeds by "
+                    "up to %d\n", LineJoinNames[join], LineCapNames[cap],
+                    width, excess <= MaximumCoverageExcess ? "ok" : "FAILED",
+                    excess);
+            }
+        }
+    }
+
+    free(mask);
+    free(reference);
+}
+
+
+void RunStrokeBenchmark(const Geometry *geometries, const int geometryCount,
+    const IntRect &bounds, const double scale, const char *name)
+{
+    CheckStrokeCoverage();
+
+    BeginSceneBenchmark(geometries, geometryCount, name, scale, "strokes");
+
+    const double timeRasterizer = Measure(geometries, geometryCount, bounds,
+        scale, ImagePath("%s-stroke-rasterizer.png", name));
+
+    BenchmarkPreStroked preStroked;
+
+    const double timePreStroked = preStroked.Run(geometries, geometryCount,
+        bounds, scale, ImagePath("%s-stroke-prestroked.png", name));
+
+    PrintFrameTime("stroked in rasterizer:", timeRasterizer);
+    PrintFrameTime("stroked before frame:", timePreStroked, timeRasterizer);
+}
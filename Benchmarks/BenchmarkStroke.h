@@ -0,0 +1,25 @@
+
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Checks coverage of strokes with each join and cap against the same
+ * strokes rendered at 16 times the scale and averaged. Test paths turn in
+ * alternating directions and never cross themselves, so outline polygons
+ * must not overlap and coverage must not exceed reference by more than
+ * rounding.
+ *
+ * Then renders a given scene of stroked geometries twice. First, strokes are
+ * converted into outlines by rasterizer itself, in parallel, while
+ * linearizing geometries. Then outlines of all strokes are built on the main
+ * thread before each frame and filled as regular paths. Prints average frame
+ * time of both runs.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunStrokeBenchmark(const Geometry *geometries, const int geometryCount,
+    const IntRect &bounds, const double scale, const char *name);
@@ -0,0 +1,65 @@
+
+#include "BenchmarkTileShape.h"
+#include "BenchmarkBlaze.h"
+#include <cstdio>
+
+
+static double MeasureWithTileShape(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name, const TileShape shape, TileShape &selected)
+{
+    RasterizerOptions options;
+
+    options.Shape = shape;
+
+    BenchmarkBlazeRuntime benchmark(options);
+
+    const double time = benchmark.Run(geometries, geometryCount, bounds,
+        scale, ImagePath("%s-tiles-%s.png", name, GetTileShapeName(shape)));
+
+    selected = benchmark.GetTileShape();
+
+    return time;
+}
+
+
+void RunTileShapeBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name)
+{
+    BeginSceneBenchmark(geometries, geometryCount, name, scale,
+        "tile shape");
+
+    static constexpr TileShape Shapes[] = {
+        TileShape::Tiles8x8,
+        TileShape::Tiles8x16,
+        TileShape::Tiles8x32,
+        TileShape::Tiles16x8,
+        TileShape::Tiles64x16
+    };
+
+    TileShape fastest = TileShape::Automatic;
+    double fastestTime = 0;
+
+    for (const TileShape shape : Shapes) {
+        TileShape selected;
+
+        const double time = MeasureWithTileShape(geometries, geometryCount,
+            bounds, scale, name, shape, selected);
+
+        printf("    %-9s %8.3f ms\n", GetTileShapeName(shape), time);
+
+        if (fastest == TileShape::Automatic or time < fastestTime) {
+            fastest = shape;
+            fastestTime = time;
+        }
+    }
+
+    TileShape selected;
+
+    const double time = MeasureWithTileShape(geometries, geometryCount,
+        bounds, scale, name, TileShape::Automatic, selected);
+
+    printf("    %-9s %8.3f ms, selected %s, fastest %s\n", "automatic", time,
+        GetTileShapeName(selected), GetTileShapeName(fastest));
+}
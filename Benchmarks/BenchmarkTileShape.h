@@ -0,0 +1,18 @@
+
+#pragma once
+
+
+#include "Benchmark.h"
+
+
+/**
+ * Renders a given scene with each tile shape and with tile shape selected
+ * automatically. Prints average frame time for each of them, the fastest
+ * tile shape and tile shape automatic selection picked.
+ *
+ * @param name Scene name used when printing results and naming output
+ * images.
+ */
+void RunTileShapeBenchmark(const Geometry *geometries,
+    const int geometryCount, const IntRect &bounds, const double scale,
+    const char *name);
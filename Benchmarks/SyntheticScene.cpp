@@ -0,0 +1,405 @@
+
+#include "SyntheticScene.h"
+#include <new>
+
+
+SyntheticScene::SyntheticScene()
+:   mBounds(0, 0, 0, 0)
+{
+}
+
+
+SyntheticScene::~SyntheticScene()
+{
+    Free();
+}
+
+
+void SyntheticScene::AddRectangle(const double x, const double y,
+    const double width, const double height, const uint32 color)
+{
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    PathTag *tags = static_cast<PathTag *>(malloc(SIZE_OF(PathTag) * 5));
+    FloatPoint *points = static_cast<FloatPoint *>(
+        malloc(SIZE_OF(FloatPoint) * 4));
+
+    tags[0] = PathTag::Move;
+    tags[1] = PathTag::Line;
+    tags[2] = PathTag::Line;
+    tags[3] = PathTag::Line;
+    tags[4] = PathTag::Close;
+
+    points[0] = FloatPoint { x, y };
+    points[1] = FloatPoint { x + width, y };
+    points[2] = FloatPoint { x + width, y + height };
+    points[3] = FloatPoint { x, y + height };
+
+    const FloatRect bounds(x, y, width, height);
+
+    AddGeometry(bounds.ToExpandedIntRect(), tags, points, 5, 4, color);
+}
+
+
+void SyntheticScene::AddRoundedRectangle(const double x, const double y,
+    const double width, const double height, const double radius,
+    const uint32 color)
+{
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    const double r = Min(radius, Min(width, height) * 0.5);
+
+    if (r <= 0) {
+        AddRectangle(x, y, width, height, color);
+        return;
+    }
+
+    // Distance of cubic control points from corner start and end points
+    // approximating quarter of a circle.
+    const double k = r * 0.5522847498;
+
+    const double minx = x;
+    const double miny = y;
+    const double maxx = x + width;
+    const double maxy = y + height;
+
+    PathTag *tags = static_cast<PathTag *>(malloc(SIZE_OF(PathTag) * 10));
+    FloatPoint *points = static_cast<FloatPoint *>(
+        malloc(SIZE_OF(FloatPoint) * 17));
+
+    tags[0] = PathTag::Move;
+    tags[1] = PathTag::Line;
+    tags[2] = PathTag::Cubic;
+    tags[3] = PathTag::Line;
+    tags[4] = PathTag::Cubic;
+    tags[5] = PathTag::Line;
+    tags[6] = PathTag::Cubic;
+    tags[7] = PathTag::Line;
+    tags[8] = PathTag::Cubic;
+    tags[9] = PathTag::Close;
+
+    points[0] = FloatPoint { minx + r, miny };
+    points[1] = FloatPoint { maxx - r, miny };
+    points[2] = FloatPoint { maxx - r + k, miny };
+    points[3] = FloatPoint { maxx, miny + r - k };
+    points[4] = FloatPoint { maxx, miny + r };
+    points[5] = FloatPoint { maxx, maxy - r };
+    points[6] = FloatPoint { maxx, maxy - r + k };
+    points[7] = FloatPoint { maxx - r + k, maxy };
+    points[8] = FloatPoint { maxx - r, maxy };
+    points[9] = FloatPoint { minx + r, maxy };
+    points[10] = FloatPoint { minx + r - k, maxy };
+    points[11] = FloatPoint { minx, maxy - r + k };
+    points[12] = FloatPoint { minx, maxy - r };
+    points[13] = FloatPoint { minx, miny + r };
+    points[14] = FloatPoint { minx, miny + r - k };
+    points[15] = FloatPoint { minx + r - k, miny };
+    points[16] = FloatPoint { minx + r, miny };
+
+    const FloatRect bounds(x, y, width, height);
+
+    AddGeometry(bounds.ToExpandedIntRect(), tags, points, 10, 17, color);
+}
+
+
+void SyntheticScene::AddPolyline(const FloatPoint *points,
+    const int pointCount, const Stroke *stroke, const uint32 color)
+{
+    ASSERT(points != nullptr);
+    ASSERT(pointCount > 1);
+    ASSERT(stroke != nullptr);
+
+    PathTag *tags = static_cast<PathTag *>(
+        malloc(SIZE_OF(PathTag) * pointCount));
+    FloatPoint *copy = static_cast<FloatPoint *>(
+        malloc(SIZE_OF(FloatPoint) * pointCount));
+
+    double minx = points[0].X;
+    double miny = points[0].Y;
+    double maxx = points[0].X;
+    double maxy = points[0].Y;
+
+    for (int i = 0; i < pointCount; i++) {
+        tags[i] = i == 0 ? PathTag::Move : PathTag::Line;
+        copy[i] = points[i];
+
+        minx = Min(minx, points[i].X);
+        miny = Min(miny, points[i].Y);
+        maxx = Max(maxx, points[i].X);
+        maxy = Max(maxy, points[i].Y);
+    }
+
+    const FloatRect bounds(minx, miny, maxx - minx, maxy - miny);
+
+    AddGeometry(bounds.ToExpandedIntRect(), tags, copy, pointCount,
+        pointCount, color, stroke);
+}
+
+
+void SyntheticScene::CreateUserInterface(SyntheticScene &scene,
+    const int width, const int height)
+{
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    // Simple linear congruential generator so the scene is the same on every
+    // run.
+    uint32 seed = 12345;
+
+    auto random = [&seed](const double min, const double max) {
+        seed = seed * 1103515245 + 12345;
+
+        const double t = double((seed >> 8) & 0xffff) / 65535.0;
+
+        return min + ((max - min) * t);
+    };
+
+    const double w = width;
+    const double h = height;
+
+    // Window background.
+    scene.AddRectangle(0, 0, w, h, 0xfff0f0f0);
+
+    // Header and sidebar.
+    const double headerHeight = 64;
+    const double sidebarWidth = Min(w * 0.2, 280.0);
+
+    scene.AddRectangle(0, 0, w, headerHeight, 0xff303030);
+    scene.AddRectangle(0, headerHeight, sidebarWidth, h - headerHeight,
+        0xffe0e0e0);
+
+    for (double y = headerHeight + 16; y + 32 < h; y += 44) {
+        scene.AddRoundedRectangle(12, y, sidebarWidth - 24, 32, 6,
+            0xffd0d0d0);
+        scene.AddRectangle(24, y + 12, random(60, sidebarWidth - 60), 8,
+            0xff606060);
+    }
+
+    // Content area filled with a grid of cards.
+    const double contentX = sidebarWidth;
+    const double contentY = headerHeight;
+    const double contentWidth = w - sidebarWidth;
+
+    scene.AddRectangle(contentX, contentY, contentWidth, h - contentY,
+        0xffffffff);
+
+    static constexpr double CardWidth = 300;
+    static constexpr double CardHeight = 200;
+    static constexpr double Gap = 24;
+
+    for (double y = contentY + Gap; y < h; y += CardHeight + Gap) {
+        for (double x = contentX + Gap; x < w; x += CardWidth + Gap) {
+            // Shadow.
+            scene.AddRoundedRectangle(x + 2, y + 4, CardWidth, CardHeight,
+                12, 0x30000000);
+
+            // Card.
+            scene.AddRoundedRectangle(x, y, CardWidth, CardHeight, 12,
+                0xfffafafa);
+
+            // Image placeholder.
+            scene.AddRectangle(x, y, CardWidth, 96, 0xff8090a0);
+
+            // Rows of text-like shapes.
+            for (double ty = y + 112; ty < y + CardHeight - 40; ty += 18) {
+                double tx = x + 16;
+
+                while (tx < x + CardWidth - 40) {
+                    const double gw = random(12, 40);
+
+                    scene.AddRectangle(tx, ty, gw, 10, 0xff202020);
+
+                    tx += gw + 6;
+                }
+            }
+
+            // Button.
+            scene.AddRoundedRectangle(x + CardWidth - 96, y + CardHeight - 36,
+                80, 24, 12, 0xff2060e0);
+        }
+    }
+
+    // Translucent modal dialog on top.
+    scene.AddRectangle(0, 0, w, h, 0x60000000);
+    scene.AddRoundedRectangle(w * 0.3, h * 0.3, w * 0.4, h * 0.4, 16,
+        0xffffffff);
+}
+
+
+void SyntheticScene::CreateTallPaths(SyntheticScene &scene,
+    const int width, const int height)
+{
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    uint32 seed = 54321;
+
+    auto random = [&seed](const double min, const double max) {
+        seed = seed * 1103515245 + 12345;
+
+        const double t = double((seed >> 8) & 0xffff) / 65535.0;
+
+        return min + ((max - min) * t);
+    };
+
+    const double w = width;
+    const double h = height;
+
+    for (int i = 0; i < 500; i++) {
+        const double x = random(-w * 0.5, w * 0.1);
+        const double y = random(-h * 0.1, h * 0.1);
+        const double sw = random(w * 0.2, w * 0.8);
+        const double sh = random(h * 0.8, h * 1.2);
+        const uint32 a = uint32(random(16, 64));
+
+        scene.AddRoundedRectangle(x, y, sw, sh, random(4, 64),
+            (a << 24) | (a << 16) | (a >> 1));
+    }
+}
+
+
+void SyntheticScene::CreateMap(SyntheticScene &scene, const int width,
+    const int height)
+{
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    static constexpr Stroke RoadCasing(9, LineJoin::Round, LineCap::Round);
+    static constexpr Stroke Road(6, LineJoin::Round, LineCap::Round);
+    static constexpr Stroke Contour(1, LineJoin::Bevel, LineCap::Butt);
+    static constexpr Stroke Building(1.5, LineJoin::Miter, LineCap::Butt);
+
+    uint32 seed = 24680;
+
+    auto random = [&seed](const double min, const double max) {
+        seed = seed * 1103515245 + 12345;
+
+        const double t = double((seed >> 8) & 0xffff) / 65535.0;
+
+        return min + ((max - min) * t);
+    };
+
+    const double w = width;
+    const double h = height;
+
+    static constexpr int MaxPointCount = 64;
+
+    FloatPoint points[MaxPointCount];
+
+    // Contour lines, long and thin, spanning the whole map.
+    for (int i = 0; i < 100; i++) {
+        const int count = MaxPointCount;
+
+        double y = random(0, h);
+
+        for (int j = 0; j < count; j++) {
+            y += random(-6, 6);
+
+            points[j] = FloatPoint {
+                (w * j) / (count - 1),
+                y
+            };
+        }
+
+        scene.AddPolyline(points, count, &Contour, 0xff90a890);
+    }
+
+    // Building outlines, closed by repeating the first point.
+    for (int i = 0; i < 1000; i++) {
+        const double x = random(0, w);
+        const double y = random(0, h);
+        const double bw = random(6, 24);
+        const double bh = random(6, 24);
+
+        points[0] = FloatPoint { x, y };
+        points[1] = FloatPoint { x + bw, y };
+        points[2] = FloatPoint { x + bw, y + bh };
+        points[3] = FloatPoint { x + (bw * 0.5), y + bh };
+        points[4] = FloatPoint { x + (bw * 0.5), y + (bh * 0.5) };
+        points[5] = FloatPoint { x, y + (bh * 0.5) };
+        points[6] = FloatPoint { x, y };
+
+        scene.AddPolyline(points, 7, &Building, 0xff707070);
+    }
+
+    // Roads. Each road is a random walk with gently changing direction,
+    // drawn twice with casing below.
+    for (int i = 0; i < 500; i++) {
+        const int count = int(random(8, MaxPointCount));
+
+        double x = random(0, w);
+        double y = random(0, h);
+        double angle = random(0, 6.283185307179586);
+
+        for (int j = 0; j < count; j++) {
+            points[j] = FloatPoint { x, y };
+
+            angle += random(-0.5, 0.5);
+
+            const double step = random(8, 32);
+
+            x += Cos(angle) * step;
+            y += Sin(angle) * step;
+        }
+
+        scene.AddPolyline(points, count, &RoadCasing, 0xff404040);
+        scene.AddPolyline(points, count, &Road, 0xfff0e0a0);
+    }
+}
+
+
+void SyntheticScene::AddGeometry(const IntRect &bounds, PathTag *tags,
+    FloatPoint *points, const int tagCount, const int pointCount,
+    const uint32 color, const Stroke *stroke)
+{
+    if (mGeometryCount == mGeometryCapacity) {
+        mGeometryCapacity = Max(mGeometryCapacity * 2, 64);
+
+        // Geometry is not trivially copyable, so existing geometries are
+        // copy constructed into new memory instead of using realloc.
+        Geometry *geometries = static_cast<Geometry *>(malloc(
+            SIZE_OF(Geometry) * mGeometryCapacity));
+
+        for (int i = 0; i < mGeometryCount; i++) {
+            new (geometries + i) Geometry(mGeometries[i]);
+        }
+
+        free(mGeometries);
+
+        mGeometries = geometries;
+    }
+
+    new (mGeometries + mGeometryCount) Geometry(bounds, tags, points,
+        Matrix::Identity, tagCount, pointCount, color, FillRule::NonZero,
+        nullptr, BlendMode::SourceOver, nullptr, nullptr, stroke);
+
+    mGeometryCount++;
+
+    if (mGeometryCount == 1) {
+        mBounds = bounds;
+    } else {
+        mBounds.MinX = Min(mBounds.MinX, bounds.MinX);
+        mBounds.MinY = Min(mBounds.MinY, bounds.MinY);
+        mBounds.MaxX = Max(mBounds.MaxX, bounds.MaxX);
+        mBounds.MaxY = Max(mBounds.MaxY, bounds.MaxY);
+    }
+}
+
+
+void SyntheticScene::Free()
+{
+    const int count = mGeometryCount;
+
+    for (int i = 0; i < count; i++) {
+        free((void *)mGeometries[i].Tags);
+        free((void *)mGeometries[i].Points);
+    }
+
+    free(mGeometries);
+
+    mGeometries = nullptr;
+    mGeometryCount = 0;
+    mGeometryCapacity = 0;
+}
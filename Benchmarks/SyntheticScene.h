@@ -0,0 +1,112 @@
+
+#pragma once
+
+
+#include <Blaze/Blaze.h>
+
+
+/**
+ * Builds simple scenes out of basic shapes. These scenes are meant to
+ * reproduce typical workloads for benchmarks measuring specific parts of
+ * rasterizer, not to look good.
+ */
+class SyntheticScene final {
+public:
+    SyntheticScene();
+   ~SyntheticScene();
+public:
+
+    /**
+     * Appends axis-aligned rectangle.
+     *
+     * @param color RGBA color, 8 bits per channel, color components
+     * premultiplied by alpha.
+     */
+    void AddRectangle(const double x, const double y, const double width,
+        const double height, const uint32 color);
+
+
+    /**
+     * Appends rectangle with rounded corners. Corners are approximated with
+     * cubic curves.
+     *
+     * @param color RGBA color, 8 bits per channel, color components
+     * premultiplied by alpha.
+     */
+    void AddRoundedRectangle(const double x, const double y,
+        const double width, const double height, const double radius,
+        const uint32 color);
+
+
+    /**
+     * Appends open polyline drawn with a given stroke. Stroke is not copied
+     * and must stay alive as long as the scene.
+     *
+     * @param color RGBA color, 8 bits per channel, color components
+     * premultiplied by alpha.
+     */
+    void AddPolyline(const FloatPoint *points, const int pointCount,
+        const Stroke *stroke, const uint32 color);
+
+    int GetGeometryCount() const;
+    IntRect GetBounds() const;
+    const Geometry *GetGeometries() const;
+
+public:
+
+    /**
+     * Creates a scene resembling application user interface. Opaque window
+     * background covered by opaque panels and cards, each card having a
+     * translucent shadow and a few rows of small text-like shapes. Most
+     * of the scene is drawn several times over.
+     */
+    static void CreateUserInterface(SyntheticScene &scene, const int width,
+        const int height);
+
+
+    /**
+     * Creates a scene of tall translucent shapes spanning entire height of
+     * the image. Most of them start to the left of the image, so linearizer
+     * has to keep start covers for every tile row they cross.
+     */
+    static void CreateTallPaths(SyntheticScene &scene, const int width,
+        const int height);
+
+
+    /**
+     * Creates a scene resembling street map. Hundreds of winding roads,
+     * each drawn as wide dark casing below narrower light fill with round
+     * joins and caps, thin contour lines with bevel joins and building
+     * outlines with miter joins. Every geometry is stroked.
+     */
+    static void CreateMap(SyntheticScene &scene, const int width,
+        const int height);
+
+private:
+    void AddGeometry(const IntRect &bounds, PathTag *tags,
+        FloatPoint *points, const int tagCount, const int pointCount,
+        const uint32 color, const Stroke *stroke = nullptr);
+    void Free();
+private:
+    Geometry *mGeometries = nullptr;
+    int mGeometryCount = 0;
+    int mGeometryCapacity = 0;
+    IntRect mBounds;
+private:
+    DISABLE_COPY_AND_ASSIGN(SyntheticScene);
+};
+
+
+FORCE_INLINE int SyntheticScene::GetGeometryCount() const {
+    return mGeometryCount;
+}
+
+
+FORCE_INLINE IntRect SyntheticScene::GetBounds() const {
+    return mBounds;
+}
+
+
+FORCE_INLINE const Geometry *SyntheticScene::GetGeometries() const {
+    return mGeometries;
+}
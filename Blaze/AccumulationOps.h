@@ -0,0 +1,112 @@
+
+#pragma once
+
+
+#include "Dispatch.h"
+#include "RasterizerUtils.h"
+
+
+// Operations on dense rows of cover/area pairs, used when many pixels in a
+// row have edges. Unlike rows tracked by bit vectors, every cover/area pair
+// in a dense row is valid, pixels without edges simply have zero cover and
+// area. This way alpha can be calculated for all pixels at once, keeping
+// cover accumulation as a prefix sum of covers. Vectorized for every SIMD
+// backend, AVX2 version processing twice as many pixels is selected at
+// runtime when available.
+
+#ifdef SIMD_NEON
+#include "AccumulationOps_neon.h"
+#elif defined SIMD_WASM
+#include "AccumulationOps_wasm.h"
+#elif defined SIMD_SSE2
+#include "AccumulationOps_x86.h"
+#endif
+
+
+/**
+ * A maximum number of pixels ResolveAccumulatedAlphas processes at once.
+ */
+static constexpr int AccumulationChunkSize = 32;
+
+
+/**
+ * Calculates alpha of each pixel from dense row of cover/area pairs. Plain
+ * C++ version.
+ */
+template <FillRuleFn ApplyFillRule>
+static FORCE_INLINE uint32 ResolveAccumulatedAlphas_generic(uint8 *alphas,
+    const int32 *coverArea, const int count, int32 &cover,
+    const uint32 previousAlpha)
+{
+    ASSERT(alphas != nullptr);
+    ASSERT(coverArea != nullptr);
+
+    uint32 changes = 0;
+    uint32 previous = previousAlpha;
+    int32 c = cover;
+
+    for (int i = 0; i < count; i++) {
+        const uint32 alpha = ApplyFillRule(coverArea[(i << 1) + 1] + (c << 9));
+
+        c += coverArea[i << 1];
+
+        changes |= uint32(alpha != previous) << i;
+        alphas[i] = uint8(alpha);
+        previous = alpha;
+    }
+
+    cover = c;
+
+    return changes;
+}
+
+
+/**
+ * Calculates alpha of each pixel from dense row of cover/area pairs.
+ *
+ * @param alphas Destination for alpha values, one for each pixel.
+ *
+ * @param coverArea Cover and area pairs, one for each pixel.
+ *
+ * @param count A number of pixels to process. Must be a multiple of 4 and
+ * must not exceed AccumulationChunkSize.
+ *
+ * @param cover Cover accumulated before the first pixel. Receives cover
+ * accumulated after the last pixel.
+ *
+ * @param previousAlpha Alpha of pixel just before the first one.
+ *
+ * @return Bit mask with one bit for each pixel which is set if alpha of that
+ * pixel is different from alpha of pixel before it.
+ */
+template <FillRuleFn ApplyFillRule>
+static FORCE_INLINE uint32 ResolveAccumulatedAlphas(uint8 *alphas,
+    const int32 *coverArea, const int count, int32 &cover,
+    const uint32 previousAlpha)
+{
+    STATIC_ASSERT(AccumulationChunkSize <= BIT_SIZE_OF(uint32));
+
+    ASSERT((count & 3) == 0);
+    ASSERT(count <= AccumulationChunkSize);
+
+#ifdef SIMD_NEON
+    return ResolveAccumulatedAlphas_neon<ApplyFillRule>(alphas, coverArea,
+        count, cover, previousAlpha);
+#elif defined SIMD_WASM
+    return ResolveAccumulatedAlphas_wasm<ApplyFillRule>(alphas, coverArea,
+        count, cover, previousAlpha);
+#elif defined SIMD_SSE2
+    constexpr int rule = ApplyFillRule == AreaToAlphaNonZero ? 0 : 1;
+
+    if (Dispatch.ResolveAccumulatedAlphas[rule] != nullptr) {
+        return Dispatch.ResolveAccumulatedAlphas[rule](alphas, coverArea,
+            count, cover, previousAlpha);
+    }
+
+    return ResolveAccumulatedAlphas_sse2<ApplyFillRule>(alphas, coverArea,
+        count, cover, previousAlpha);
+#else
+    return ResolveAccumulatedAlphas_generic<ApplyFillRule>(alphas, coverArea,
+        count, cover, previousAlpha);
+#endif
+}
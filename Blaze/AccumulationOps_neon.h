@@ -0,0 +1,80 @@
+
+// This must only be included from AccumulationOps.h
+
+
+#include <arm_neon.h>
+
+
+/**
+ * Converts four areas to alpha values according to fill rule. Results are
+ * in range 0-255, one in each 32 bit lane.
+ */
+template <FillRuleFn ApplyFillRule>
+static FORCE_INLINE int32x4_t AreaToAlpha_neon(const int32x4_t area) {
+    const int32x4_t aaabs = vabsq_s32(vshrq_n_s32(area, 9));
+
+    if constexpr (ApplyFillRule == AreaToAlphaNonZero) {
+        return vminq_s32(aaabs, vdupq_n_s32(255));
+    } else {
+        STATIC_ASSERT(ApplyFillRule == AreaToAlphaEvenOdd);
+
+        const int32x4_t aac = vandq_s32(aaabs, vdupq_n_s32(511));
+        const uint32x4_t over = vcgtq_s32(aac, vdupq_n_s32(256));
+        const int32x4_t mirrored = vsubq_s32(vdupq_n_s32(512), aac);
+
+        return vminq_s32(vbslq_s32(over, mirrored, aac), vdupq_n_s32(255));
+    }
+}
+
+
+template <FillRuleFn ApplyFillRule>
+static FORCE_INLINE uint32 ResolveAccumulatedAlphas_neon(uint8 *alphas,
+    const int32 *coverArea, const int count, int32 &cover,
+    const uint32 previousAlpha)
+{
+    ASSERT(alphas != nullptr);
+    ASSERT(coverArea != nullptr);
+
+    const int32x4_t zero = vdupq_n_s32(0);
+    const uint32x4_t lanes = { 1, 2, 4, 8 };
+
+    int32x4_t c = vdupq_n_s32(cover);
+    int32x4_t previous = vdupq_n_s32(int32(previousAlpha));
+
+    uint32 changes = 0;
+
+    for (int i = 0; i < count; i += 4) {
+        // Load pairs split into covers and areas.
+        const int32x4x2_t v = vld2q_s32(coverArea + (i << 1));
+
+        // Inclusive prefix sum of covers.
+        int32x4_t sum = vaddq_s32(v.val[0], vextq_s32(zero, v.val[0], 3));
+
+        sum = vaddq_s32(sum, vextq_s32(zero, sum, 2));
+
+        // Cover accumulated before each pixel.
+        const int32x4_t before = vaddq_s32(c, vsubq_s32(sum, v.val[0]));
+
+        const int32x4_t alpha = AreaToAlpha_neon<ApplyFillRule>(
+            vaddq_s32(v.val[1], vshlq_n_s32(before, 9)));
+
+        // Alpha of pixel before each pixel.
+        const int32x4_t shifted = vextq_s32(previous, alpha, 3);
+
+        changes |= vaddvq_u32(vbicq_u32(lanes,
+            vceqq_s32(alpha, shifted))) << i;
+
+        const uint16x4_t w = vmovn_u32(vreinterpretq_u32_s32(alpha));
+        const uint8x8_t b = vmovn_u16(vcombine_u16(w, w));
+
+        vst1_lane_u32(reinterpret_cast<uint32_t *>(alphas + i),
+            vreinterpret_u32_u8(b), 0);
+
+        c = vaddq_s32(c, vdupq_laneq_s32(sum, 3));
+        previous = alpha;
+    }
+
+    cover = vgetq_lane_s32(c, 0);
+
+    return changes;
+}
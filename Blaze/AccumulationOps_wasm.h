@@ -0,0 +1,83 @@
+
+// This must only be included from AccumulationOps.h
+
+
+#include <wasm_simd128.h>
+
+
+/**
+ * Converts four areas to alpha values according to fill rule. Results are
+ * in range 0-255, one in each 32 bit lane.
+ */
+template <FillRuleFn ApplyFillRule>
+static FORCE_INLINE v128_t AreaToAlpha_wasm(const v128_t area) {
+    const v128_t aaabs = wasm_i32x4_abs(wasm_i32x4_shr(area, 9));
+
+    if constexpr (ApplyFillRule == AreaToAlphaNonZero) {
+        return wasm_i32x4_min(aaabs, wasm_i32x4_splat(255));
+    } else {
+        STATIC_ASSERT(ApplyFillRule == AreaToAlphaEvenOdd);
+
+        const v128_t aac = wasm_v128_and(aaabs, wasm_i32x4_splat(511));
+        const v128_t over = wasm_i32x4_gt(aac, wasm_i32x4_splat(256));
+        const v128_t mirrored = wasm_i32x4_sub(wasm_i32x4_splat(512), aac);
+
+        return wasm_i32x4_min(wasm_v128_bitselect(mirrored, aac, over),
+            wasm_i32x4_splat(255));
+    }
+}
+
+
+template <FillRuleFn ApplyFillRule>
+static FORCE_INLINE uint32 ResolveAccumulatedAlphas_wasm(uint8 *alphas,
+    const int32 *coverArea, const int count, int32 &cover,
+    const uint32 previousAlpha)
+{
+    ASSERT(alphas != nullptr);
+    ASSERT(coverArea != nullptr);
+
+    const v128_t zero = wasm_i32x4_splat(0);
+
+    v128_t c = wasm_i32x4_splat(cover);
+    v128_t previous = wasm_i32x4_splat(int32(previousAlpha));
+
+    uint32 changes = 0;
+
+    for (int i = 0; i < count; i += 4) {
+        const v128_t v0 = wasm_v128_load(coverArea + (i << 1));
+        const v128_t v1 = wasm_v128_load(coverArea + (i << 1) + 4);
+
+        const v128_t covers = wasm_i32x4_shuffle(v0, v1, 0, 2, 4, 6);
+        const v128_t areas = wasm_i32x4_shuffle(v0, v1, 1, 3, 5, 7);
+
+        // Inclusive prefix sum of covers.
+        v128_t sum = wasm_i32x4_add(covers,
+            wasm_i32x4_shuffle(zero, covers, 0, 4, 5, 6));
+
+        sum = wasm_i32x4_add(sum, wasm_i32x4_shuffle(zero, sum, 0, 1, 4, 5));
+
+        // Cover accumulated before each pixel.
+        const v128_t before = wasm_i32x4_add(c, wasm_i32x4_sub(sum, covers));
+
+        const v128_t alpha = AreaToAlpha_wasm<ApplyFillRule>(
+            wasm_i32x4_add(areas, wasm_i32x4_shl(before, 9)));
+
+        // Alpha of pixel before each pixel.
+        const v128_t shifted = wasm_i32x4_shuffle(previous, alpha, 3, 4, 5,
+            6);
+
+        changes |= uint32(wasm_i32x4_bitmask(
+            wasm_i32x4_ne(alpha, shifted))) << i;
+
+        const v128_t w = wasm_u16x8_narrow_i32x4(alpha, alpha);
+
+        wasm_v128_store32_lane(alphas + i, wasm_u8x16_narrow_i16x8(w, w), 0);
+
+        c = wasm_i32x4_add(c, wasm_i32x4_shuffle(sum, sum, 3, 3, 3, 3));
+        previous = alpha;
+    }
+
+    cover = wasm_i32x4_extract_lane(c, 0);
+
+    return changes;
+}
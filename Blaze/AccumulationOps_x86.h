@@ -0,0 +1,220 @@
+
+// This must only be included from AccumulationOps.h
+
+
+#include <immintrin.h>
+
+
+/**
+ * Converts four areas to alpha values according to fill rule. Results are
+ * in range 0-255, one in each 32 bit lane.
+ */
+template <FillRuleFn ApplyFillRule>
+static FORCE_INLINE __m128i AreaToAlpha_sse2(const __m128i area) {
+    const __m128i aa = _mm_srai_epi32(area, 9);
+
+    // Find absolute area value.
+    const __m128i mask = _mm_srai_epi32(aa, 31);
+    const __m128i aaabs = _mm_sub_epi32(_mm_xor_si128(aa, mask), mask);
+
+    if constexpr (ApplyFillRule == AreaToAlphaNonZero) {
+        // Clamp to be 255 or less by saturating twice.
+        const __m128i w = _mm_packs_epi32(aaabs, aaabs);
+
+        return _mm_unpacklo_epi16(_mm_min_epi16(w, _mm_set1_epi16(255)),
+            _mm_setzero_si128());
+    } else {
+        STATIC_ASSERT(ApplyFillRule == AreaToAlphaEvenOdd);
+
+        const __m128i aac = _mm_and_si128(aaabs, _mm_set1_epi32(511));
+        const __m128i over = _mm_cmpgt_epi32(aac, _mm_set1_epi32(256));
+        const __m128i mirrored = _mm_sub_epi32(_mm_set1_epi32(512), aac);
+
+        const __m128i a = _mm_or_si128(_mm_and_si128(over, mirrored),
+            _mm_andnot_si128(over, aac));
+
+        return _mm_min_epi16(a, _mm_set1_epi32(255));
+    }
+}
+
+
+template <FillRuleFn ApplyFillRule>
+static FORCE_INLINE uint32 ResolveAccumulatedAlphas_sse2(uint8 *alphas,
+    const int32 *coverArea, const int count, int32 &cover,
+    const uint32 previousAlpha)
+{
+    ASSERT(alphas != nullptr);
+    ASSERT(coverArea != nullptr);
+
+    __m128i c = _mm_set1_epi32(cover);
+    __m128i previous = _mm_set1_epi32(int32(previousAlpha));
+
+    uint32 changes = 0;
+
+    for (int i = 0; i < count; i += 4) {
+        const __m128 v0 = _mm_castsi128_ps(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(coverArea + (i << 1))));
+
+        const __m128 v1 = _mm_castsi128_ps(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(coverArea + (i << 1) + 4)));
+
+        const __m128i covers = _mm_castps_si128(
+            _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+
+        const __m128i areas = _mm_castps_si128(
+            _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+
+        // Inclusive prefix sum of covers.
+        __m128i sum = _mm_add_epi32(covers, _mm_slli_si128(covers, 4));
+
+        sum = _mm_add_epi32(sum, _mm_slli_si128(sum, 8));
+
+        // Cover accumulated before each pixel.
+        const __m128i before = _mm_add_epi32(c, _mm_sub_epi32(sum, covers));
+
+        const __m128i alpha = AreaToAlpha_sse2<ApplyFillRule>(
+            _mm_add_epi32(areas, _mm_slli_epi32(before, 9)));
+
+        // Alpha of pixel before each pixel.
+        const __m128i shifted = _mm_or_si128(_mm_slli_si128(alpha, 4),
+            _mm_srli_si128(previous, 12));
+
+        const int same = _mm_movemask_ps(_mm_castsi128_ps(
+            _mm_cmpeq_epi32(alpha, shifted)));
+
+        changes |= uint32(same ^ 15) << i;
+
+        const __m128i w = _mm_packs_epi32(alpha, alpha);
+
+        const int32 packed = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+
+        memcpy(alphas + i, &packed, 4);
+
+        c = _mm_add_epi32(c, _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 3, 3, 3)));
+        previous = alpha;
+    }
+
+    cover = _mm_cvtsi128_si32(c);
+
+    return changes;
+}
+
+
+/**
+ * Converts eight areas to alpha values according to fill rule. Results are
+ * in range 0-255, one in each 32 bit lane.
+ */
+template <FillRuleFn ApplyFillRule>
+TARGET("avx2")
+static FORCE_INLINE __m256i AreaToAlpha_avx2(const __m256i area) {
+    const __m256i aaabs = _mm256_abs_epi32(_mm256_srai_epi32(area, 9));
+
+    if constexpr (ApplyFillRule == AreaToAlphaNonZero) {
+        return _mm256_min_epi32(aaabs, _mm256_set1_epi32(255));
+    } else {
+        STATIC_ASSERT(ApplyFillRule == AreaToAlphaEvenOdd);
+
+        const __m256i aac = _mm256_and_si256(aaabs, _mm256_set1_epi32(511));
+        const __m256i over = _mm256_cmpgt_epi32(aac, _mm256_set1_epi32(256));
+        const __m256i mirrored = _mm256_sub_epi32(_mm256_set1_epi32(512), aac);
+
+        return _mm256_min_epi32(_mm256_blendv_epi8(aac, mirrored, over),
+            _mm256_set1_epi32(255));
+    }
+}
+
+
+/**
+ * The same as ResolveAccumulatedAlphas_sse2, but processes eight pixels per
+ * iteration. Selected at runtime, see Dispatch.h.
+ */
+template <FillRuleFn ApplyFillRule>
+TARGET("avx2")
+static uint32 ResolveAccumulatedAlphas_avx2(uint8 *alphas,
+    const int32 *coverArea, const int count, int32 &cover,
+    const uint32 previousAlpha)
+{
+    ASSERT(alphas != nullptr);
+    ASSERT(coverArea != nullptr);
+
+    // Moves each lane one position up, the first lane receives the last
+    // one.
+    const __m256i rotate = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+    const __m256i last = _mm256_set1_epi32(7);
+
+    __m256i c = _mm256_set1_epi32(cover);
+    __m256i previous = _mm256_set1_epi32(int32(previousAlpha));
+
+    uint32 changes = 0;
+
+    int i = 0;
+
+    for (; i <= count - 8; i += 8) {
+        const __m256 v0 = _mm256_castsi256_ps(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(coverArea + (i << 1))));
+
+        const __m256 v1 = _mm256_castsi256_ps(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(coverArea + (i << 1) + 8)));
+
+        // Shuffles work within 128 bit halves, so pairs of pixels end up in
+        // 0, 1, 4, 5, 2, 3, 6, 7 order and are permuted back.
+        const __m256i covers = _mm256_permute4x64_epi64(_mm256_castps_si256(
+            _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0))),
+            _MM_SHUFFLE(3, 1, 2, 0));
+
+        const __m256i areas = _mm256_permute4x64_epi64(_mm256_castps_si256(
+            _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1))),
+            _MM_SHUFFLE(3, 1, 2, 0));
+
+        // Inclusive prefix sum of covers within each half, then the sum of
+        // the lower half is added to the upper one.
+        __m256i sum = _mm256_add_epi32(covers, _mm256_slli_si256(covers, 4));
+
+        sum = _mm256_add_epi32(sum, _mm256_slli_si256(sum, 8));
+
+        sum = _mm256_add_epi32(sum, _mm256_shuffle_epi32(
+            _mm256_permute2x128_si256(sum, sum, 0x08),
+            _MM_SHUFFLE(3, 3, 3, 3)));
+
+        // Cover accumulated before each pixel.
+        const __m256i before = _mm256_add_epi32(c, _mm256_sub_epi32(sum,
+            covers));
+
+        const __m256i alpha = AreaToAlpha_avx2<ApplyFillRule>(
+            _mm256_add_epi32(areas, _mm256_slli_epi32(before, 9)));
+
+        // Alpha of pixel before each pixel.
+        const __m256i shifted = _mm256_blend_epi32(
+            _mm256_permutevar8x32_epi32(alpha, rotate),
+            _mm256_permutevar8x32_epi32(previous, rotate), 1);
+
+        const int same = _mm256_movemask_ps(_mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(alpha, shifted)));
+
+        changes |= uint32(same ^ 255) << i;
+
+        // Pack to bytes, each half holds four of them.
+        const __m256i w = _mm256_packs_epi32(alpha, alpha);
+        const __m256i b = _mm256_packus_epi16(w, w);
+
+        const int32 lo = _mm256_cvtsi256_si32(b);
+        const int32 hi = _mm256_extract_epi32(b, 4);
+
+        memcpy(alphas + i, &lo, 4);
+        memcpy(alphas + i + 4, &hi, 4);
+
+        c = _mm256_add_epi32(c, _mm256_permutevar8x32_epi32(sum, last));
+        previous = alpha;
+    }
+
+    cover = _mm256_cvtsi256_si32(c);
+
+    if (i < count) {
+        // Count is a multiple of 4, so there are exactly 4 pixels left.
+        changes |= ResolveAccumulatedAlphas_sse2<ApplyFillRule>(alphas + i,
+            coverArea + (i << 1), count - i, cover,
+            uint32(_mm256_extract_epi32(previous, 7))) << i;
+    }
+
+    return changes;
+}
@@ -36,15 +36,19 @@ static constexpr int CountBits(const T v) {
 
     ASSERT(v != 0);
 
-    int num = 0;
+    // Count bits in pairs, then in groups of 4 and 8 bits and finally add
+    // all 8 bit groups together using multiplication.
+    constexpr T m1 = T(0x5555555555555555ull);
+    constexpr T m2 = T(0x3333333333333333ull);
+    constexpr T m4 = T(0x0f0f0f0f0f0f0f0full);
+    constexpr T h = T(0x0101010101010101ull);
 
-    for (int i = 0; i < BIT_SIZE_OF(T); i++) {
-        const T bit = v >> i;
+    T x = v - ((v >> 1) & m1);
 
-        num += static_cast<int>(bit & 1);
-    }
+    x = (x & m2) + ((x >> 2) & m2);
+    x = (x + (x >> 4)) & m4;
 
-    return num;
+    return static_cast<int>((x * h) >> (BIT_SIZE_OF(T) - 8));
 }
 
 
@@ -75,6 +79,33 @@ static constexpr int CountTrailingZeroes(const T v) {
 }
 
 
+/**
+ * Returns the number of leading zero bits in a given value, starting at the
+ * most significant bit position.
+ *
+ * @param v Value to count leading zeroes for. Must not be 0.
+ */
+template <typename T>
+static constexpr int CountLeadingZeroes(const T v) {
+    STATIC_ASSERT_UNSIGNED_TYPE(T);
+
+    ASSERT(v != 0);
+
+    int i = 0;
+
+    for ( ; i < BIT_SIZE_OF(T); i++) {
+        const T bit = v >> (BIT_SIZE_OF(T) - 1 - i);
+        const int m = static_cast<int>(bit & 1);
+
+        if (m != 0) {
+            return i;
+        }
+    }
+
+    return i;
+}
+
+
 // Include compiler-specific bit ops.
 
 
@@ -179,3 +210,95 @@ static constexpr int FindFirstNonZeroBitVector(const BitVector *vec, const int m
 
     return i;
 }
+
+
+/**
+ * Sets all bits in a given range to 1.
+ *
+ * @param vec Bit vector array. Must not be nullptr and must contain at least
+ * end amount of bits.
+ *
+ * @param begin Index of the first bit to set. Must be at least 0.
+ *
+ * @param end Index of the bit after the last bit to set. Must be at least
+ * begin.
+ */
+static constexpr void SetBitRange(BitVector *vec, const int begin, const int end) {
+    ASSERT(vec != nullptr);
+    ASSERT(begin >= 0);
+    ASSERT(begin <= end);
+
+    if (begin == end) {
+        return;
+    }
+
+    constexpr int N = BIT_SIZE_OF(BitVector);
+
+    const int first = begin / N;
+    const int last = (end - 1) / N;
+
+    const BitVector firstMask = ~BitVector(0) << (begin % N);
+    const BitVector lastMask = ~BitVector(0) >> (N - 1 - ((end - 1) % N));
+
+    if (first == last) {
+        vec[first] |= firstMask & lastMask;
+        return;
+    }
+
+    vec[first] |= firstMask;
+
+    for (int i = first + 1; i < last; i++) {
+        vec[i] = ~BitVector(0);
+    }
+
+    vec[last] |= lastMask;
+}
+
+
+/**
+ * Returns true if all bits in a given range are set to 1. Empty range is
+ * considered to be set.
+ *
+ * @param vec Bit vector array. Must not be nullptr and must contain at least
+ * end amount of bits.
+ *
+ * @param begin Index of the first bit to test. Must be at least 0.
+ *
+ * @param end Index of the bit after the last bit to test. Must be at least
+ * begin.
+ */
+static constexpr bool BitRangeIsSet(const BitVector *vec, const int begin, const int end) {
+    ASSERT(vec != nullptr);
+    ASSERT(begin >= 0);
+    ASSERT(begin <= end);
+
+    if (begin == end) {
+        return true;
+    }
+
+    constexpr int N = BIT_SIZE_OF(BitVector);
+
+    const int first = begin / N;
+    const int last = (end - 1) / N;
+
+    const BitVector firstMask = ~BitVector(0) << (begin % N);
+    const BitVector lastMask = ~BitVector(0) >> (N - 1 - ((end - 1) % N));
+
+    if (first == last) {
+        const BitVector mask = firstMask & lastMask;
+
+        return (vec[first] & mask) == mask;
+    }
+
+    if ((vec[first] & firstMask) != firstMask) {
+        return false;
+    }
+
+    for (int i = first + 1; i < last; i++) {
+        if (vec[i] != ~BitVector(0)) {
+            return false;
+        }
+    }
+
+    return (vec[last] & lastMask) == lastMask;
+}
@@ -5,6 +5,10 @@
 #include "Utils.h"
 
 
+// Without population count instruction GCC calls a library function for
+// __builtin_popcount, which is slower than generic version.
+#if defined __POPCNT__ or not (defined __x86_64__ or defined __i386__)
+
 template <>
 constexpr int CountBits<uint32>(const uint32 v) {
     ASSERT(v != 0);
@@ -20,6 +24,8 @@ constexpr int CountBits<uint64>(const uint64 v) {
     return __builtin_popcountl(v);
 }
 
+#endif
+
 
 template <>
 constexpr int CountTrailingZeroes<uint32>(const uint32 v) {
@@ -35,3 +41,19 @@ constexpr int CountTrailingZeroes<uint64>(const uint64 v) {
 
     return __builtin_ctzl(v);
 }
+
+
+template <>
+constexpr int CountLeadingZeroes<uint32>(const uint32 v) {
+    ASSERT(v != 0);
+
+    return __builtin_clz(v);
+}
+
+
+template <>
+constexpr int CountLeadingZeroes<uint64>(const uint64 v) {
+    ASSERT(v != 0);
+
+    return __builtin_clzl(v);
+}
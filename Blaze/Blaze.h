@@ -2,12 +2,18 @@
 #pragma once
 
 
+#include "AccumulationOps.h"
 #include "BitOps.h"
+#include "BlendMode.h"
+#include "BlendOps.h"
 #include "BumpAllocator.h"
+#include "CellOps.h"
 #include "ClipBounds.h"
 #include "CompositionOps.h"
+#include "CoverOps.h"
 #include "CurveUtils.h"
 #include "DestinationImage.h"
+#include "Dispatch.h"
 #include "F8Dot8.h"
 #include "F24Dot8.h"
 #include "FillRule.h"
@@ -17,16 +23,25 @@
 #include "ImageData.h"
 #include "IntRect.h"
 #include "IntSize.h"
+#include "Layer.h"
+#include "LinearBlendOps.h"
 #include "Linearizer.h"
 #include "LinearizerUtils.h"
 #include "LineArray.h"
 #include "LineBlockAllocator.h"
+#include "MaskOps.h"
 #include "Matrix.h"
+#include "Paint.h"
+#include "PaintOps.h"
 #include "PathTag.h"
+#include "PixelFormat.h"
 #include "Rasterizer.h"
+#include "RasterizerOptions.h"
 #include "RasterizerUtils.h"
 #include "RowItemList.h"
 #include "SIMD.h"
+#include "Stroke.h"
+#include "Stroker.h"
 #include "ThreadMemory.h"
 #include "Threads.h"
 #include "TileBounds.h"
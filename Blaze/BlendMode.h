@@ -0,0 +1,134 @@
+
+#pragma once
+
+
+#include "Utils.h"
+
+
+/**
+ * Determines how geometry color is combined with destination pixels. Colors
+ * are premultiplied by alpha. In formulas below S and D are source and
+ * destination channel values in range 0-1, Sa and Da are source and
+ * destination alpha. Unless noted otherwise, the same formula gives the
+ * resulting alpha with S = Sa and D = Da.
+ *
+ * Blend modes only change pixels covered by geometry. Partially covered
+ * pixels are interpolated between destination and blended color.
+ */
+enum class BlendMode : uint8 {
+
+    /**
+     * Source over destination, S + D × (1 - Sa).
+     */
+    SourceOver = 0,
+
+    /**
+     * Clears destination, 0.
+     */
+    Clear,
+
+    /**
+     * Replaces destination, S.
+     */
+    Source,
+
+    /**
+     * Keeps destination, D. Geometries using this mode are skipped.
+     */
+    Destination,
+
+    /**
+     * Destination over source, S × (1 - Da) + D.
+     */
+    DestinationOver,
+
+    /**
+     * Source where destination is, S × Da.
+     */
+    SourceIn,
+
+    /**
+     * Destination where source is, D × Sa.
+     */
+    DestinationIn,
+
+    /**
+     * Source where destination is not, S × (1 - Da).
+     */
+    SourceOut,
+
+    /**
+     * Destination where source is not, D × (1 - Sa).
+     */
+    DestinationOut,
+
+    /**
+     * Source over destination where destination is, S × Da + D × (1 - Sa).
+     */
+    SourceAtop,
+
+    /**
+     * Destination over source where source is, S × (1 - Da) + D × Sa.
+     */
+    DestinationAtop,
+
+    /**
+     * Source or destination where the other is not,
+     * S × (1 - Da) + D × (1 - Sa).
+     */
+    Xor,
+
+    /**
+     * Sum of source and destination, Min(S + D, 1).
+     */
+    Plus,
+
+    /**
+     * S × D + S × (1 - Da) + D × (1 - Sa).
+     */
+    Multiply,
+
+    /**
+     * S + D - S × D.
+     */
+    Screen,
+
+    /**
+     * Multiply or screen depending on destination, HardLight with source
+     * and destination swapped.
+     */
+    Overlay,
+
+    /**
+     * S + D - Max(S × Da, D × Sa).
+     */
+    Darken,
+
+    /**
+     * S + D - Min(S × Da, D × Sa).
+     */
+    Lighten,
+
+    /**
+     * Multiply or screen depending on source. If 2 × S <= Sa, then
+     * 2 × S × D, otherwise Sa × Da - 2 × (Da - D) × (Sa - S). Plus
+     * S × (1 - Da) + D × (1 - Sa) in both cases.
+     */
+    HardLight,
+
+    /**
+     * S + D - 2 × Min(S × Da, D × Sa). Alpha is Sa + Da - Sa × Da.
+     */
+    Difference,
+
+    /**
+     * S + D - 2 × S × D. Alpha is Sa + Da - Sa × Da.
+     */
+    Exclusion
+};
+
+
+/**
+ * A number of blend modes.
+ */
+static constexpr int BlendModeCount = int(BlendMode::Exclusion) + 1;
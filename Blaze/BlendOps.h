@@ -0,0 +1,335 @@
+
+#pragma once
+
+
+#include "BlendMode.h"
+#include "CompositionOps.h"
+
+
+// Span composition with blend modes other than source over. Each blend mode
+// has its own kernel, so blend mode is not checked for every pixel. Channels
+// are blended in 16 bit vector lanes using the same integer arithmetic as
+// plain C++ version, so results are identical on every backend.
+
+
+/**
+ * Multiplies two values in range 0-255 and divides result by 255, rounding
+ * the same way as ApplyAlpha.
+ */
+static FORCE_INLINE int32 Mul255(const int32 a, const int32 b) {
+    const int32 t = a * b;
+
+    return (t + (t >> 8) + 128) >> 8;
+}
+
+
+/**
+ * Blends one channel of premultiplied source and destination pixels. Result
+ * is not clamped and can be outside of range 0-255.
+ *
+ * @param s Source channel.
+ *
+ * @param d Destination channel.
+ *
+ * @param sa Source alpha.
+ *
+ * @param da Destination alpha.
+ */
+template <BlendMode Mode>
+static FORCE_INLINE int32 BlendChannel(const int32 s, const int32 d,
+    const int32 sa, const int32 da)
+{
+    if constexpr (Mode == BlendMode::SourceOver) {
+        return s + Mul255(d, 255 - sa);
+    } else if constexpr (Mode == BlendMode::Clear) {
+        return 0;
+    } else if constexpr (Mode == BlendMode::Source) {
+        return s;
+    } else if constexpr (Mode == BlendMode::Destination) {
+        return d;
+    } else if constexpr (Mode == BlendMode::DestinationOver) {
+        return Mul255(s, 255 - da) + d;
+    } else if constexpr (Mode == BlendMode::SourceIn) {
+        return Mul255(s, da);
+    } else if constexpr (Mode == BlendMode::DestinationIn) {
+        return Mul255(d, sa);
+    } else if constexpr (Mode == BlendMode::SourceOut) {
+        return Mul255(s, 255 - da);
+    } else if constexpr (Mode == BlendMode::DestinationOut) {
+        return Mul255(d, 255 - sa);
+    } else if constexpr (Mode == BlendMode::SourceAtop) {
+        return Mul255(s, da) + Mul255(d, 255 - sa);
+    } else if constexpr (Mode == BlendMode::DestinationAtop) {
+        return Mul255(s, 255 - da) + Mul255(d, sa);
+    } else if constexpr (Mode == BlendMode::Xor) {
+        return Mul255(s, 255 - da) + Mul255(d, 255 - sa);
+    } else if constexpr (Mode == BlendMode::Plus) {
+        return s + d;
+    } else if constexpr (Mode == BlendMode::Multiply) {
+        return Mul255(s, d) + Mul255(s, 255 - da) + Mul255(d, 255 - sa);
+    } else if constexpr (Mode == BlendMode::Screen) {
+        return s + d - Mul255(s, d);
+    } else if constexpr (Mode == BlendMode::Overlay or
+        Mode == BlendMode::HardLight)
+    {
+        // Overlay is hard light with source and destination swapped.
+        const bool multiply = Mode == BlendMode::Overlay ?
+            (d + d) <= da : (s + s) <= sa;
+
+        const int32 b = multiply ? 2 * Mul255(s, d) :
+            Mul255(sa, da) - (2 * Mul255(Max(da - d, 0), Max(sa - s, 0)));
+
+        return b + Mul255(s, 255 - da) + Mul255(d, 255 - sa);
+    } else if constexpr (Mode == BlendMode::Darken) {
+        return s + d - Max(Mul255(s, da), Mul255(d, sa));
+    } else if constexpr (Mode == BlendMode::Lighten) {
+        return s + d - Min(Mul255(s, da), Mul255(d, sa));
+    } else if constexpr (Mode == BlendMode::Difference) {
+        return s + d - (2 * Min(Mul255(s, da), Mul255(d, sa)));
+    } else {
+        STATIC_ASSERT(Mode == BlendMode::Exclusion);
+
+        return s + d - (2 * Mul255(s, d));
+    }
+}
+
+
+/**
+ * Returns true if alpha channel of blend mode is not calculated by the same
+ * formula as color channels.
+ */
+static constexpr bool BlendModeHasSeparateAlpha(const BlendMode mode) {
+    return mode == BlendMode::Difference or mode == BlendMode::Exclusion;
+}
+
+
+/**
+ * Blends premultiplied source pixel with destination pixel. Partially
+ * covered pixels are interpolated between destination and blended pixel.
+ *
+ * @param alpha Coverage, in range 0-255.
+ */
+template <BlendMode Mode>
+static FORCE_INLINE uint32 BlendPixel(const uint32 d, const uint32 s,
+    const int32 alpha)
+{
+    const int32 sa = int32(s >> 24);
+    const int32 da = int32(d >> 24);
+
+    uint32 result = 0;
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        const int32 sc = int32((s >> shift) & 0xff);
+        const int32 dc = int32((d >> shift) & 0xff);
+
+        int32 c;
+
+        if (BlendModeHasSeparateAlpha(Mode) and shift == 24) {
+            c = sa + da - Mul255(sa, da);
+        } else {
+            c = BlendChannel<Mode>(sc, dc, sa, da);
+        }
+
+        c = Clamp(c, 0, 255);
+
+        if (alpha < 255) {
+            c = Min(Mul255(c, alpha) + Mul255(dc, 255 - alpha), 255);
+        }
+
+        result |= uint32(c) << shift;
+    }
+
+    return result;
+}
+
+
+/**
+ * Composites span of pixels with a given color using blend mode, one pixel
+ * at a time. Plain C++ version.
+ */
+template <BlendMode Mode>
+static FORCE_INLINE void CompositeColorSpan_generic(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 color)
+{
+    for (int x = pos; x < end; x++) {
+        d[x] = BlendPixel<Mode>(d[x], color, alpha);
+    }
+}
+
+
+/**
+ * Composites span of pixels with source pixels using blend mode, one pixel
+ * at a time. Plain C++ version.
+ *
+ * @param s Source pixels, the first one corresponds to destination pixel at
+ * pos.
+ */
+template <BlendMode Mode>
+static FORCE_INLINE void CompositePixelSpan_generic(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 *s)
+{
+    for (int x = pos; x < end; x++) {
+        d[x] = BlendPixel<Mode>(d[x], s[x - pos], alpha);
+    }
+}
+
+
+// Vector versions process span tails with the plain C++ functions above.
+#ifdef SIMD_NEON
+#include "BlendOps_neon.h"
+#elif defined SIMD_WASM
+#include "BlendOps_wasm.h"
+#elif defined SIMD_SSE2
+#include "BlendOps_x86.h"
+#endif
+
+
+/**
+ * Composites span of pixels with a given color using blend mode.
+ */
+template <BlendMode Mode>
+static void CompositeColorSpan(const int pos, const int end, uint32 *d,
+    const int32 alpha, const uint32 color)
+{
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+    ASSERT(alpha <= 255);
+
+    // Fully covered spans which do not depend on destination are only
+    // written to.
+    if constexpr (Mode == BlendMode::Clear or Mode == BlendMode::Source) {
+        if (alpha == 255) {
+            FillSpanWide(d, pos, end, Mode == BlendMode::Clear ? 0 : color);
+            return;
+        }
+    }
+
+#ifdef SIMD_NEON
+    CompositeColorSpan_neon<Mode>(pos, end, d, alpha, color);
+#elif defined SIMD_WASM
+    CompositeColorSpan_wasm<Mode>(pos, end, d, alpha, color);
+#elif defined SIMD_SSE2
+    CompositeColorSpan_sse2<Mode>(pos, end, d, alpha, color);
+#else
+    CompositeColorSpan_generic<Mode>(pos, end, d, alpha, color);
+#endif
+}
+
+
+/**
+ * Composites span of pixels with source pixels using blend mode.
+ *
+ * @param s Source pixels, the first one corresponds to destination pixel at
+ * pos.
+ */
+template <BlendMode Mode>
+static void CompositePixelSpan(const int pos, const int end, uint32 *d,
+    const int32 alpha, const uint32 *s)
+{
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+    ASSERT(s != nullptr);
+    ASSERT(alpha <= 255);
+
+#ifdef SIMD_NEON
+    CompositePixelSpan_neon<Mode>(pos, end, d, alpha, s);
+#elif defined SIMD_WASM
+    CompositePixelSpan_wasm<Mode>(pos, end, d, alpha, s);
+#elif defined SIMD_SSE2
+    CompositePixelSpan_sse2<Mode>(pos, end, d, alpha, s);
+#else
+    CompositePixelSpan_generic<Mode>(pos, end, d, alpha, s);
+#endif
+}
+
+
+using BlendColorSpanKernel = void (*)(const int pos, const int end,
+    uint32 *d, const int32 alpha, const uint32 color);
+
+using BlendPixelSpanKernel = void (*)(const int pos, const int end,
+    uint32 *d, const int32 alpha, const uint32 *s);
+
+
+/**
+ * Span composition kernels of one blend mode.
+ */
+struct BlendModeKernels final {
+    BlendColorSpanKernel CompositeColorSpan;
+    BlendPixelSpanKernel CompositePixelSpan;
+};
+
+
+template <BlendMode Mode>
+static constexpr BlendModeKernels MakeBlendModeKernels() {
+    return { CompositeColorSpan<Mode>, CompositePixelSpan<Mode> };
+}
+
+
+/**
+ * Returns span composition kernels for a given blend mode.
+ */
+static FORCE_INLINE const BlendModeKernels &GetBlendModeKernels(const BlendMode mode) {
+    // Indexed by BlendMode.
+    static constexpr BlendModeKernels Kernels[] = {
+        MakeBlendModeKernels<BlendMode::SourceOver>(),
+        MakeBlendModeKernels<BlendMode::Clear>(),
+        MakeBlendModeKernels<BlendMode::Source>(),
+        MakeBlendModeKernels<BlendMode::Destination>(),
+        MakeBlendModeKernels<BlendMode::DestinationOver>(),
+        MakeBlendModeKernels<BlendMode::SourceIn>(),
+        MakeBlendModeKernels<BlendMode::DestinationIn>(),
+        MakeBlendModeKernels<BlendMode::SourceOut>(),
+        MakeBlendModeKernels<BlendMode::DestinationOut>(),
+        MakeBlendModeKernels<BlendMode::SourceAtop>(),
+        MakeBlendModeKernels<BlendMode::DestinationAtop>(),
+        MakeBlendModeKernels<BlendMode::Xor>(),
+        MakeBlendModeKernels<BlendMode::Plus>(),
+        MakeBlendModeKernels<BlendMode::Multiply>(),
+        MakeBlendModeKernels<BlendMode::Screen>(),
+        MakeBlendModeKernels<BlendMode::Overlay>(),
+        MakeBlendModeKernels<BlendMode::Darken>(),
+        MakeBlendModeKernels<BlendMode::Lighten>(),
+        MakeBlendModeKernels<BlendMode::HardLight>(),
+        MakeBlendModeKernels<BlendMode::Difference>(),
+        MakeBlendModeKernels<BlendMode::Exclusion>()
+    };
+
+    STATIC_ASSERT(SIZE_OF(Kernels) / SIZE_OF(Kernels[0]) == BlendModeCount);
+
+    ASSERT(int(mode) < BlendModeCount);
+
+    return Kernels[int(mode)];
+}
+
+
+/**
+ * Span blender for solid color and blend modes other than source over. Span
+ * composition kernel is selected for each scanline instead of compiling
+ * rasterizer for every blend mode, there are no branches on blend mode
+ * within spans. One indirect call per span is not measurable in frame time,
+ * while instantiating rasterizer for each blend mode grows its code by half.
+ */
+struct SpanBlenderWithMode final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = true;
+
+
+    SpanBlenderWithMode(const uint32 color, const BlendMode mode)
+    :   Kernel(GetBlendModeKernels(mode).CompositeColorSpan),
+        Color(color)
+    {
+    }
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+
+    const BlendColorSpanKernel Kernel = nullptr;
+    const uint32 Color = 0;
+};
+
+
+FORCE_INLINE void SpanBlenderWithMode::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    Kernel(pos, end, d, alpha, Color);
+}
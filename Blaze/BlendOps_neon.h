@@ -0,0 +1,218 @@
+
+// This must only be included from BlendOps.h
+
+
+#include <arm_neon.h>
+
+
+/**
+ * Multiplies each channel of four pixels by alpha in corresponding 8 bit
+ * lane of a, the same way as ApplyAlpha does.
+ */
+static FORCE_INLINE uint8x16_t ApplyAlpha_neon(const uint8x16_t x, const uint8x16_t a) {
+    const uint16x8_t half = vdupq_n_u16(128);
+
+    const uint16x8_t lo0 = vmull_u8(vget_low_u8(x), vget_low_u8(a));
+    const uint16x8_t hi0 = vmull_high_u8(x, a);
+
+    const uint16x8_t lo1 = vshrq_n_u16(vaddq_u16(
+        vaddq_u16(lo0, vshrq_n_u16(lo0, 8)), half), 8);
+
+    const uint16x8_t hi1 = vshrq_n_u16(vaddq_u16(
+        vaddq_u16(hi0, vshrq_n_u16(hi0, 8)), half), 8);
+
+    return vcombine_u8(vmovn_u16(lo1), vmovn_u16(hi1));
+}
+
+
+/**
+ * Mul255 of each 16 bit lane. Lanes must be in range 0-255.
+ */
+static FORCE_INLINE uint16x8_t Mul255_neon(const uint16x8_t a, const uint16x8_t b) {
+    const uint16x8_t t = vmulq_u16(a, b);
+
+    return vshrq_n_u16(vaddq_u16(vaddq_u16(t, vshrq_n_u16(t, 8)),
+        vdupq_n_u16(128)), 8);
+}
+
+
+/**
+ * Blends channels of two pixels unpacked to 16 bit lanes, see
+ * BlendChannel. Lanes of result are signed.
+ */
+template <BlendMode Mode>
+static FORCE_INLINE uint16x8_t BlendChannels_neon(const uint16x8_t s, const uint16x8_t d, const uint16x8_t sa, const uint16x8_t da) {
+    const uint16x8_t full = vdupq_n_u16(255);
+
+    if constexpr (Mode == BlendMode::SourceOver) {
+        return vaddq_u16(s, Mul255_neon(d, vsubq_u16(full, sa)));
+    } else if constexpr (Mode == BlendMode::Clear) {
+        return vdupq_n_u16(0);
+    } else if constexpr (Mode == BlendMode::Source) {
+        return s;
+    } else if constexpr (Mode == BlendMode::Destination) {
+        return d;
+    } else if constexpr (Mode == BlendMode::DestinationOver) {
+        return vaddq_u16(Mul255_neon(s, vsubq_u16(full, da)), d);
+    } else if constexpr (Mode == BlendMode::SourceIn) {
+        return Mul255_neon(s, da);
+    } else if constexpr (Mode == BlendMode::DestinationIn) {
+        return Mul255_neon(d, sa);
+    } else if constexpr (Mode == BlendMode::SourceOut) {
+        return Mul255_neon(s, vsubq_u16(full, da));
+    } else if constexpr (Mode == BlendMode::DestinationOut) {
+        return Mul255_neon(d, vsubq_u16(full, sa));
+    } else if constexpr (Mode == BlendMode::SourceAtop) {
+        return vaddq_u16(Mul255_neon(s, da),
+            Mul255_neon(d, vsubq_u16(full, sa)));
+    } else if constexpr (Mode == BlendMode::DestinationAtop) {
+        return vaddq_u16(Mul255_neon(s, vsubq_u16(full, da)),
+            Mul255_neon(d, sa));
+    } else if constexpr (Mode == BlendMode::Xor) {
+        return vaddq_u16(Mul255_neon(s, vsubq_u16(full, da)),
+            Mul255_neon(d, vsubq_u16(full, sa)));
+    } else if constexpr (Mode == BlendMode::Plus) {
+        return vaddq_u16(s, d);
+    } else if constexpr (Mode == BlendMode::Multiply) {
+        return vaddq_u16(Mul255_neon(s, d), vaddq_u16(
+            Mul255_neon(s, vsubq_u16(full, da)),
+            Mul255_neon(d, vsubq_u16(full, sa))));
+    } else if constexpr (Mode == BlendMode::Screen) {
+        return vsubq_u16(vaddq_u16(s, d), Mul255_neon(s, d));
+    } else if constexpr (Mode == BlendMode::Overlay or
+        Mode == BlendMode::HardLight)
+    {
+        // Lanes where 2 × S > Sa for hard light or 2 × D > Da for overlay
+        // use screen.
+        const uint16x8_t screen = Mode == BlendMode::Overlay ?
+            vcgtq_u16(vaddq_u16(d, d), da) : vcgtq_u16(vaddq_u16(s, s), sa);
+
+        const uint16x8_t sd = Mul255_neon(s, d);
+
+        const uint16x8_t b = vbslq_u16(screen, vsubq_u16(
+            Mul255_neon(sa, da), vshlq_n_u16(Mul255_neon(
+            vqsubq_u16(da, d), vqsubq_u16(sa, s)), 1)),
+            vshlq_n_u16(sd, 1));
+
+        return vaddq_u16(b, vaddq_u16(Mul255_neon(s, vsubq_u16(full, da)),
+            Mul255_neon(d, vsubq_u16(full, sa))));
+    } else if constexpr (Mode == BlendMode::Darken) {
+        return vsubq_u16(vaddq_u16(s, d), vmaxq_u16(Mul255_neon(s, da),
+            Mul255_neon(d, sa)));
+    } else if constexpr (Mode == BlendMode::Lighten) {
+        return vsubq_u16(vaddq_u16(s, d), vminq_u16(Mul255_neon(s, da),
+            Mul255_neon(d, sa)));
+    } else if constexpr (Mode == BlendMode::Difference) {
+        return vsubq_u16(vaddq_u16(s, d), vshlq_n_u16(vminq_u16(
+            Mul255_neon(s, da), Mul255_neon(d, sa)), 1));
+    } else {
+        STATIC_ASSERT(Mode == BlendMode::Exclusion);
+
+        return vsubq_u16(vaddq_u16(s, d), vshlq_n_u16(Mul255_neon(s, d),
+            1));
+    }
+}
+
+
+/**
+ * Blends two pixels unpacked to 16 bit lanes, see BlendPixel.
+ *
+ * @param alpha Coverage repeated in every lane.
+ */
+template <BlendMode Mode, bool Partial>
+static FORCE_INLINE uint16x8_t BlendPixels16_neon(const uint16x8_t s, const uint16x8_t d, const uint16x8_t alpha) {
+    const uint16x8_t full = vdupq_n_u16(255);
+
+    // Alpha of each pixel repeated in all four channels.
+    const uint8x16_t index = {
+        6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15
+    };
+
+    const uint16x8_t sa = vreinterpretq_u16_u8(vqtbl1q_u8(
+        vreinterpretq_u8_u16(s), index));
+
+    const uint16x8_t da = vreinterpretq_u16_u8(vqtbl1q_u8(
+        vreinterpretq_u8_u16(d), index));
+
+    uint16x8_t b = BlendChannels_neon<Mode>(s, d, sa, da);
+
+    if constexpr (BlendModeHasSeparateAlpha(Mode)) {
+        const uint16x8_t mask = { 0, 0, 0, 0xffff, 0, 0, 0, 0xffff };
+
+        b = vbslq_u16(mask, vsubq_u16(vaddq_u16(sa, da),
+            Mul255_neon(sa, da)), b);
+    }
+
+    b = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(vreinterpretq_s16_u16(b),
+        vdupq_n_s16(0)), vdupq_n_s16(255)));
+
+    if constexpr (Partial) {
+        b = vaddq_u16(Mul255_neon(b, alpha), Mul255_neon(d,
+            vsubq_u16(full, alpha)));
+    }
+
+    return b;
+}
+
+
+template <BlendMode Mode, bool Partial, bool Solid>
+static FORCE_INLINE void CompositeSpanWithMode_neon(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 *s)
+{
+    const uint16x8_t a = vdupq_n_u16(uint16(alpha));
+    const uint8x16_t color = vreinterpretq_u8_u32(vdupq_n_u32(s[0]));
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        uint32 *p = d + x;
+
+        const uint8x16_t sp = Solid ? color :
+            vreinterpretq_u8_u32(vld1q_u32(s + (x - pos)));
+
+        const uint8x16_t dp = vreinterpretq_u8_u32(vld1q_u32(p));
+
+        const uint16x8_t lo = BlendPixels16_neon<Mode, Partial>(
+            vmovl_u8(vget_low_u8(sp)), vmovl_u8(vget_low_u8(dp)), a);
+
+        const uint16x8_t hi = BlendPixels16_neon<Mode, Partial>(
+            vmovl_high_u8(sp), vmovl_high_u8(dp), a);
+
+        vst1q_u32(p, vreinterpretq_u32_u8(vcombine_u8(vqmovn_u16(lo),
+            vqmovn_u16(hi))));
+    }
+
+    if (x < end) {
+        if constexpr (Solid) {
+            CompositeColorSpan_generic<Mode>(x, end, d, alpha, s[0]);
+        } else {
+            CompositePixelSpan_generic<Mode>(x, end, d, alpha, s + (x - pos));
+        }
+    }
+}
+
+
+template <BlendMode Mode>
+static FORCE_INLINE void CompositeColorSpan_neon(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 color)
+{
+    if (alpha == 255) {
+        CompositeSpanWithMode_neon<Mode, false, true>(pos, end, d, alpha,
+            &color);
+    } else {
+        CompositeSpanWithMode_neon<Mode, true, true>(pos, end, d, alpha,
+            &color);
+    }
+}
+
+
+template <BlendMode Mode>
+static FORCE_INLINE void CompositePixelSpan_neon(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 *s)
+{
+    if (alpha == 255) {
+        CompositeSpanWithMode_neon<Mode, false, false>(pos, end, d, alpha, s);
+    } else {
+        CompositeSpanWithMode_neon<Mode, true, false>(pos, end, d, alpha, s);
+    }
+}
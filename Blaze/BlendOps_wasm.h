@@ -0,0 +1,214 @@
+
+// This must only be included from BlendOps.h
+
+
+#include <wasm_simd128.h>
+
+
+/**
+ * Multiplies each channel of four pixels by alpha in corresponding 8 bit
+ * lane of a, the same way as ApplyAlpha does.
+ */
+static FORCE_INLINE v128_t ApplyAlphaLanes_wasm(const v128_t x, const v128_t a) {
+    const v128_t half = wasm_i16x8_splat(128);
+
+    const v128_t lo0 = wasm_i16x8_mul(wasm_u16x8_extend_low_u8x16(x),
+        wasm_u16x8_extend_low_u8x16(a));
+
+    const v128_t hi0 = wasm_i16x8_mul(wasm_u16x8_extend_high_u8x16(x),
+        wasm_u16x8_extend_high_u8x16(a));
+
+    const v128_t lo1 = wasm_u16x8_shr(wasm_i16x8_add(
+        wasm_i16x8_add(lo0, wasm_u16x8_shr(lo0, 8)), half), 8);
+
+    const v128_t hi1 = wasm_u16x8_shr(wasm_i16x8_add(
+        wasm_i16x8_add(hi0, wasm_u16x8_shr(hi0, 8)), half), 8);
+
+    return wasm_u8x16_narrow_i16x8(lo1, hi1);
+}
+
+
+/**
+ * Mul255 of each 16 bit lane. Lanes must be in range 0-255.
+ */
+static FORCE_INLINE v128_t Mul255_wasm(const v128_t a, const v128_t b) {
+    const v128_t t = wasm_i16x8_mul(a, b);
+
+    return wasm_u16x8_shr(wasm_i16x8_add(wasm_i16x8_add(t,
+        wasm_u16x8_shr(t, 8)), wasm_i16x8_splat(128)), 8);
+}
+
+
+/**
+ * Blends channels of two pixels unpacked to 16 bit lanes, see
+ * BlendChannel.
+ */
+template <BlendMode Mode>
+static FORCE_INLINE v128_t BlendChannels_wasm(const v128_t s, const v128_t d, const v128_t sa, const v128_t da) {
+    const v128_t full = wasm_i16x8_splat(255);
+
+    if constexpr (Mode == BlendMode::SourceOver) {
+        return wasm_i16x8_add(s, Mul255_wasm(d, wasm_i16x8_sub(full, sa)));
+    } else if constexpr (Mode == BlendMode::Clear) {
+        return wasm_i16x8_splat(0);
+    } else if constexpr (Mode == BlendMode::Source) {
+        return s;
+    } else if constexpr (Mode == BlendMode::Destination) {
+        return d;
+    } else if constexpr (Mode == BlendMode::DestinationOver) {
+        return wasm_i16x8_add(Mul255_wasm(s, wasm_i16x8_sub(full, da)), d);
+    } else if constexpr (Mode == BlendMode::SourceIn) {
+        return Mul255_wasm(s, da);
+    } else if constexpr (Mode == BlendMode::DestinationIn) {
+        return Mul255_wasm(d, sa);
+    } else if constexpr (Mode == BlendMode::SourceOut) {
+        return Mul255_wasm(s, wasm_i16x8_sub(full, da));
+    } else if constexpr (Mode == BlendMode::DestinationOut) {
+        return Mul255_wasm(d, wasm_i16x8_sub(full, sa));
+    } else if constexpr (Mode == BlendMode::SourceAtop) {
+        return wasm_i16x8_add(Mul255_wasm(s, da),
+            Mul255_wasm(d, wasm_i16x8_sub(full, sa)));
+    } else if constexpr (Mode == BlendMode::DestinationAtop) {
+        return wasm_i16x8_add(Mul255_wasm(s, wasm_i16x8_sub(full, da)),
+            Mul255_wasm(d, sa));
+    } else if constexpr (Mode == BlendMode::Xor) {
+        return wasm_i16x8_add(Mul255_wasm(s, wasm_i16x8_sub(full, da)),
+            Mul255_wasm(d, wasm_i16x8_sub(full, sa)));
+    } else if constexpr (Mode == BlendMode::Plus) {
+        return wasm_i16x8_add(s, d);
+    } else if constexpr (Mode == BlendMode::Multiply) {
+        return wasm_i16x8_add(Mul255_wasm(s, d), wasm_i16x8_add(
+            Mul255_wasm(s, wasm_i16x8_sub(full, da)),
+            Mul255_wasm(d, wasm_i16x8_sub(full, sa))));
+    } else if constexpr (Mode == BlendMode::Screen) {
+        return wasm_i16x8_sub(wasm_i16x8_add(s, d), Mul255_wasm(s, d));
+    } else if constexpr (Mode == BlendMode::Overlay or
+        Mode == BlendMode::HardLight)
+    {
+        // Lanes where 2 × S > Sa for hard light or 2 × D > Da for overlay
+        // use screen.
+        const v128_t screen = Mode == BlendMode::Overlay ?
+            wasm_i16x8_gt(wasm_i16x8_add(d, d), da) :
+            wasm_i16x8_gt(wasm_i16x8_add(s, s), sa);
+
+        const v128_t sd = Mul255_wasm(s, d);
+
+        const v128_t b = wasm_v128_bitselect(wasm_i16x8_sub(
+            Mul255_wasm(sa, da), wasm_i16x8_shl(Mul255_wasm(
+            wasm_u16x8_sub_sat(da, d), wasm_u16x8_sub_sat(sa, s)), 1)),
+            wasm_i16x8_shl(sd, 1), screen);
+
+        return wasm_i16x8_add(b, wasm_i16x8_add(
+            Mul255_wasm(s, wasm_i16x8_sub(full, da)),
+            Mul255_wasm(d, wasm_i16x8_sub(full, sa))));
+    } else if constexpr (Mode == BlendMode::Darken) {
+        return wasm_i16x8_sub(wasm_i16x8_add(s, d), wasm_i16x8_max(
+            Mul255_wasm(s, da), Mul255_wasm(d, sa)));
+    } else if constexpr (Mode == BlendMode::Lighten) {
+        return wasm_i16x8_sub(wasm_i16x8_add(s, d), wasm_i16x8_min(
+            Mul255_wasm(s, da), Mul255_wasm(d, sa)));
+    } else if constexpr (Mode == BlendMode::Difference) {
+        return wasm_i16x8_sub(wasm_i16x8_add(s, d), wasm_i16x8_shl(
+            wasm_i16x8_min(Mul255_wasm(s, da), Mul255_wasm(d, sa)), 1));
+    } else {
+        STATIC_ASSERT(Mode == BlendMode::Exclusion);
+
+        return wasm_i16x8_sub(wasm_i16x8_add(s, d), wasm_i16x8_shl(
+            Mul255_wasm(s, d), 1));
+    }
+}
+
+
+/**
+ * Blends two pixels unpacked to 16 bit lanes, see BlendPixel.
+ *
+ * @param alpha Coverage repeated in every lane.
+ */
+template <BlendMode Mode, bool Partial>
+static FORCE_INLINE v128_t BlendPixels16_wasm(const v128_t s, const v128_t d, const v128_t alpha) {
+    const v128_t full = wasm_i16x8_splat(255);
+
+    // Alpha of each pixel repeated in all four channels.
+    const v128_t sa = wasm_i16x8_shuffle(s, s, 3, 3, 3, 3, 7, 7, 7, 7);
+    const v128_t da = wasm_i16x8_shuffle(d, d, 3, 3, 3, 3, 7, 7, 7, 7);
+
+    v128_t b = BlendChannels_wasm<Mode>(s, d, sa, da);
+
+    if constexpr (BlendModeHasSeparateAlpha(Mode)) {
+        const v128_t mask = wasm_i16x8_make(0, 0, 0, -1, 0, 0, 0, -1);
+
+        b = wasm_v128_bitselect(wasm_i16x8_sub(wasm_i16x8_add(sa, da),
+            Mul255_wasm(sa, da)), b, mask);
+    }
+
+    b = wasm_i16x8_min(wasm_i16x8_max(b, wasm_i16x8_splat(0)), full);
+
+    if constexpr (Partial) {
+        b = wasm_i16x8_add(Mul255_wasm(b, alpha), Mul255_wasm(d,
+            wasm_i16x8_sub(full, alpha)));
+    }
+
+    return b;
+}
+
+
+template <BlendMode Mode, bool Partial, bool Solid>
+static FORCE_INLINE void CompositeSpanWithMode_wasm(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 *s)
+{
+    const v128_t a = wasm_i16x8_splat(short(alpha));
+    const v128_t color = wasm_i32x4_splat(int(s[0]));
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        uint32 *p = d + x;
+
+        const v128_t sp = Solid ? color : wasm_v128_load(s + (x - pos));
+        const v128_t dp = wasm_v128_load(p);
+
+        const v128_t lo = BlendPixels16_wasm<Mode, Partial>(
+            wasm_u16x8_extend_low_u8x16(sp),
+            wasm_u16x8_extend_low_u8x16(dp), a);
+
+        const v128_t hi = BlendPixels16_wasm<Mode, Partial>(
+            wasm_u16x8_extend_high_u8x16(sp),
+            wasm_u16x8_extend_high_u8x16(dp), a);
+
+        wasm_v128_store(p, wasm_u8x16_narrow_i16x8(lo, hi));
+    }
+
+    if (x < end) {
+        if constexpr (Solid) {
+            CompositeColorSpan_generic<Mode>(x, end, d, alpha, s[0]);
+        } else {
+            CompositePixelSpan_generic<Mode>(x, end, d, alpha, s + (x - pos));
+        }
+    }
+}
+
+
+template <BlendMode Mode>
+static FORCE_INLINE void CompositeColorSpan_wasm(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 color)
+{
+    if (alpha == 255) {
+        CompositeSpanWithMode_wasm<Mode, false, true>(pos, end, d, alpha,
+            &color);
+    } else {
+        CompositeSpanWithMode_wasm<Mode, true, true>(pos, end, d, alpha,
+            &color);
+    }
+}
+
+
+template <BlendMode Mode>
+static FORCE_INLINE void CompositePixelSpan_wasm(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 *s)
+{
+    if (alpha == 255) {
+        CompositeSpanWithMode_wasm<Mode, false, false>(pos, end, d, alpha, s);
+    } else {
+        CompositeSpanWithMode_wasm<Mode, true, false>(pos, end, d, alpha, s);
+    }
+}
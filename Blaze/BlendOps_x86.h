@@ -0,0 +1,225 @@
+
+// This must only be included from BlendOps.h
+
+
+#include <emmintrin.h>
+
+
+/**
+ * Multiplies each channel of four pixels by alpha in corresponding 8 bit
+ * lane of a, the same way as ApplyAlpha does.
+ */
+static FORCE_INLINE __m128i ApplyAlpha_sse2(const __m128i x, const __m128i a) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+
+    const __m128i lo0 = _mm_mullo_epi16(_mm_unpacklo_epi8(x, zero),
+        _mm_unpacklo_epi8(a, zero));
+
+    const __m128i hi0 = _mm_mullo_epi16(_mm_unpackhi_epi8(x, zero),
+        _mm_unpackhi_epi8(a, zero));
+
+    const __m128i lo1 = _mm_srli_epi16(_mm_add_epi16(
+        _mm_add_epi16(lo0, _mm_srli_epi16(lo0, 8)), half), 8);
+
+    const __m128i hi1 = _mm_srli_epi16(_mm_add_epi16(
+        _mm_add_epi16(hi0, _mm_srli_epi16(hi0, 8)), half), 8);
+
+    return _mm_packus_epi16(lo1, hi1);
+}
+
+
+/**
+ * Mul255 of each 16 bit lane. Lanes must be in range 0-255.
+ */
+static FORCE_INLINE __m128i Mul255_sse2(const __m128i a, const __m128i b) {
+    const __m128i t = _mm_mullo_epi16(a, b);
+
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(t,
+        _mm_srli_epi16(t, 8)), _mm_set1_epi16(128)), 8);
+}
+
+
+/**
+ * Selects lanes of a where mask is set and lanes of b elsewhere.
+ */
+static FORCE_INLINE __m128i Select_sse2(const __m128i mask, const __m128i a, const __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+
+/**
+ * Blends channels of two pixels unpacked to 16 bit lanes, see
+ * BlendChannel.
+ */
+template <BlendMode Mode>
+static FORCE_INLINE __m128i BlendChannels_sse2(const __m128i s, const __m128i d, const __m128i sa, const __m128i da) {
+    const __m128i full = _mm_set1_epi16(255);
+
+    if constexpr (Mode == BlendMode::SourceOver) {
+        return _mm_add_epi16(s, Mul255_sse2(d, _mm_sub_epi16(full, sa)));
+    } else if constexpr (Mode == BlendMode::Clear) {
+        return _mm_setzero_si128();
+    } else if constexpr (Mode == BlendMode::Source) {
+        return s;
+    } else if constexpr (Mode == BlendMode::Destination) {
+        return d;
+    } else if constexpr (Mode == BlendMode::DestinationOver) {
+        return _mm_add_epi16(Mul255_sse2(s, _mm_sub_epi16(full, da)), d);
+    } else if constexpr (Mode == BlendMode::SourceIn) {
+        return Mul255_sse2(s, da);
+    } else if constexpr (Mode == BlendMode::DestinationIn) {
+        return Mul255_sse2(d, sa);
+    } else if constexpr (Mode == BlendMode::SourceOut) {
+        return Mul255_sse2(s, _mm_sub_epi16(full, da));
+    } else if constexpr (Mode == BlendMode::DestinationOut) {
+        return Mul255_sse2(d, _mm_sub_epi16(full, sa));
+    } else if constexpr (Mode == BlendMode::SourceAtop) {
+        return _mm_add_epi16(Mul255_sse2(s, da),
+            Mul255_sse2(d, _mm_sub_epi16(full, sa)));
+    } else if constexpr (Mode == BlendMode::DestinationAtop) {
+        return _mm_add_epi16(Mul255_sse2(s, _mm_sub_epi16(full, da)),
+            Mul255_sse2(d, sa));
+    } else if constexpr (Mode == BlendMode::Xor) {
+        return _mm_add_epi16(Mul255_sse2(s, _mm_sub_epi16(full, da)),
+            Mul255_sse2(d, _mm_sub_epi16(full, sa)));
+    } else if constexpr (Mode == BlendMode::Plus) {
+        return _mm_add_epi16(s, d);
+    } else if constexpr (Mode == BlendMode::Multiply) {
+        return _mm_add_epi16(Mul255_sse2(s, d), _mm_add_epi16(
+            Mul255_sse2(s, _mm_sub_epi16(full, da)),
+            Mul255_sse2(d, _mm_sub_epi16(full, sa))));
+    } else if constexpr (Mode == BlendMode::Screen) {
+        return _mm_sub_epi16(_mm_add_epi16(s, d), Mul255_sse2(s, d));
+    } else if constexpr (Mode == BlendMode::Overlay or
+        Mode == BlendMode::HardLight)
+    {
+        // Lanes where 2 × S > Sa for hard light or 2 × D > Da for overlay
+        // use screen.
+        const __m128i screen = Mode == BlendMode::Overlay ?
+            _mm_cmpgt_epi16(_mm_add_epi16(d, d), da) :
+            _mm_cmpgt_epi16(_mm_add_epi16(s, s), sa);
+
+        const __m128i sd = Mul255_sse2(s, d);
+
+        const __m128i b = Select_sse2(screen, _mm_sub_epi16(
+            Mul255_sse2(sa, da), _mm_slli_epi16(Mul255_sse2(
+            _mm_subs_epu16(da, d), _mm_subs_epu16(sa, s)), 1)),
+            _mm_slli_epi16(sd, 1));
+
+        return _mm_add_epi16(b, _mm_add_epi16(
+            Mul255_sse2(s, _mm_sub_epi16(full, da)),
+            Mul255_sse2(d, _mm_sub_epi16(full, sa))));
+    } else if constexpr (Mode == BlendMode::Darken) {
+        return _mm_sub_epi16(_mm_add_epi16(s, d), _mm_max_epi16(
+            Mul255_sse2(s, da), Mul255_sse2(d, sa)));
+    } else if constexpr (Mode == BlendMode::Lighten) {
+        return _mm_sub_epi16(_mm_add_epi16(s, d), _mm_min_epi16(
+            Mul255_sse2(s, da), Mul255_sse2(d, sa)));
+    } else if constexpr (Mode == BlendMode::Difference) {
+        return _mm_sub_epi16(_mm_add_epi16(s, d), _mm_slli_epi16(
+            _mm_min_epi16(Mul255_sse2(s, da), Mul255_sse2(d, sa)), 1));
+    } else {
+        STATIC_ASSERT(Mode == BlendMode::Exclusion);
+
+        return _mm_sub_epi16(_mm_add_epi16(s, d), _mm_slli_epi16(
+            Mul255_sse2(s, d), 1));
+    }
+}
+
+
+/**
+ * Blends two pixels unpacked to 16 bit lanes, see BlendPixel.
+ *
+ * @param alpha Coverage repeated in every lane.
+ */
+template <BlendMode Mode, bool Partial>
+static FORCE_INLINE __m128i BlendPixels16_sse2(const __m128i s, const __m128i d, const __m128i alpha) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+
+    // Alpha of each pixel repeated in all four channels.
+    const __m128i sa = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xff), 0xff);
+    const __m128i da = _mm_shufflehi_epi16(_mm_shufflelo_epi16(d, 0xff), 0xff);
+
+    __m128i b = BlendChannels_sse2<Mode>(s, d, sa, da);
+
+    if constexpr (BlendModeHasSeparateAlpha(Mode)) {
+        const __m128i mask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+
+        b = Select_sse2(mask, _mm_sub_epi16(_mm_add_epi16(sa, da),
+            Mul255_sse2(sa, da)), b);
+    }
+
+    b = _mm_min_epi16(_mm_max_epi16(b, zero), full);
+
+    if constexpr (Partial) {
+        b = _mm_add_epi16(Mul255_sse2(b, alpha),
+            Mul255_sse2(d, _mm_sub_epi16(full, alpha)));
+    }
+
+    return b;
+}
+
+
+template <BlendMode Mode, bool Partial, bool Solid>
+static FORCE_INLINE void CompositeSpanWithMode_sse2(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 *s)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a = _mm_set1_epi16(short(alpha));
+    const __m128i color = _mm_set1_epi32(int(s[0]));
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        __m128i *p = reinterpret_cast<__m128i *>(d + x);
+
+        const __m128i sp = Solid ? color : _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(s + (x - pos)));
+
+        const __m128i dp = _mm_loadu_si128(p);
+
+        const __m128i lo = BlendPixels16_sse2<Mode, Partial>(
+            _mm_unpacklo_epi8(sp, zero), _mm_unpacklo_epi8(dp, zero), a);
+
+        const __m128i hi = BlendPixels16_sse2<Mode, Partial>(
+            _mm_unpackhi_epi8(sp, zero), _mm_unpackhi_epi8(dp, zero), a);
+
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+
+    if (x < end) {
+        if constexpr (Solid) {
+            CompositeColorSpan_generic<Mode>(x, end, d, alpha, s[0]);
+        } else {
+            CompositePixelSpan_generic<Mode>(x, end, d, alpha, s + (x - pos));
+        }
+    }
+}
+
+
+template <BlendMode Mode>
+static FORCE_INLINE void CompositeColorSpan_sse2(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 color)
+{
+    if (alpha == 255) {
+        CompositeSpanWithMode_sse2<Mode, false, true>(pos, end, d, alpha,
+            &color);
+    } else {
+        CompositeSpanWithMode_sse2<Mode, true, true>(pos, end, d, alpha,
+            &color);
+    }
+}
+
+
+template <BlendMode Mode>
+static FORCE_INLINE void CompositePixelSpan_sse2(const int pos,
+    const int end, uint32 *d, const int32 alpha, const uint32 *s)
+{
+    if (alpha == 255) {
+        CompositeSpanWithMode_sse2<Mode, false, false>(pos, end, d, alpha, s);
+    } else {
+        CompositeSpanWithMode_sse2<Mode, true, false>(pos, end, d, alpha, s);
+    }
+}
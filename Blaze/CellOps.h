@@ -0,0 +1,118 @@
+
+#pragma once
+
+
+#include "Dispatch.h"
+#include "F24Dot8.h"
+#include "Utils.h"
+
+
+// Operations on batches of lines decoded from one line block. Most lines of
+// text and small curves do not leave a single pixel. Contribution of such
+// line to cover/area table is just one cell, which can be calculated for
+// several lines at once, without branching on line direction. Vectorized for
+// every SIMD backend.
+
+#ifdef SIMD_NEON
+#include "CellOps_neon.h"
+#elif defined SIMD_WASM
+#include "CellOps_wasm.h"
+#elif defined SIMD_SSE2
+#include "CellOps_x86.h"
+#endif
+
+
+/**
+ * A maximum number of lines FindSingleCellLines processes at once.
+ */
+static constexpr int CellBatchSize = 32;
+
+
+/**
+ * Finds lines which are completely within one pixel and calculates cover and
+ * area they add to that pixel. Plain C++ version.
+ */
+static FORCE_INLINE uint32 FindSingleCellLines_generic(int32 *px, int32 *py,
+    int32 *cover, int32 *area, const F24Dot8 *x0, const F24Dot8 *y0,
+    const F24Dot8 *x1, const F24Dot8 *y1, const int count)
+{
+    ASSERT(px != nullptr);
+    ASSERT(py != nullptr);
+    ASSERT(cover != nullptr);
+    ASSERT(area != nullptr);
+
+    uint32 single = 0;
+
+    for (int i = 0; i < count; i++) {
+        const F24Dot8 minx = Min(x0[i], x1[i]);
+        const F24Dot8 maxx = Max(x0[i], x1[i]);
+        const F24Dot8 miny = Min(y0[i], y1[i]);
+        const F24Dot8 maxy = Max(y0[i], y1[i]);
+
+        // The first and the last pixel touched by line in each direction,
+        // the same way as RasterizeLine finds them.
+        const int32 c0 = minx >> 8;
+        const int32 c1 = (maxx - 1) >> 8;
+        const int32 r0 = miny >> 8;
+        const int32 r1 = (maxy - 1) >> 8;
+
+        const F24Dot8 delta = y0[i] - y1[i];
+
+        single |= uint32(c0 == c1 and r0 == r1) << i;
+
+        // Area of lines spanning several pixels is not used and can
+        // overflow, so it is calculated as unsigned.
+        const int32 w = F24Dot8_2 - x0[i] - x1[i] + (c0 << 9);
+
+        px[i] = c0;
+        py[i] = r0;
+        cover[i] = delta;
+        area[i] = int32(uint32(delta) * uint32(w));
+    }
+
+    return single;
+}
+
+
+/**
+ * Finds lines which are completely within one pixel and calculates cover and
+ * area they add to that pixel. Values calculated for other lines are
+ * undefined.
+ *
+ * @param px Destination for pixel column index of each line.
+ *
+ * @param py Destination for pixel row index of each line.
+ *
+ * @param cover Destination for cover each line adds to its pixel.
+ *
+ * @param area Destination for area each line adds to its pixel.
+ *
+ * @param count A number of lines to process. Must be a multiple of 4 and
+ * must not exceed CellBatchSize.
+ *
+ * @return Bit mask with one bit for each line which is set if line is
+ * completely within one pixel.
+ */
+static FORCE_INLINE uint32 FindSingleCellLines(int32 *px, int32 *py,
+    int32 *cover, int32 *area, const F24Dot8 *x0, const F24Dot8 *y0,
+    const F24Dot8 *x1, const F24Dot8 *y1, const int count)
+{
+    STATIC_ASSERT(CellBatchSize <= BIT_SIZE_OF(uint32));
+
+    ASSERT((count & 3) == 0);
+    ASSERT(count <= CellBatchSize);
+
+#ifdef SIMD_NEON
+    return FindSingleCellLines_neon(px, py, cover, area, x0, y0, x1, y1,
+        count);
+#elif defined SIMD_WASM
+    return FindSingleCellLines_wasm(px, py, cover, area, x0, y0, x1, y1,
+        count);
+#elif defined SIMD_SSE2
+    return FindSingleCellLines_sse2(px, py, cover, area, x0, y0, x1, y1,
+        count);
+#else
+    return FindSingleCellLines_generic(px, py, cover, area, x0, y0, x1, y1,
+        count);
+#endif
+}
@@ -0,0 +1,53 @@
+
+// This must only be included from CellOps.h
+
+
+#include <arm_neon.h>
+
+
+static FORCE_INLINE uint32 FindSingleCellLines_neon(int32 *px, int32 *py,
+    int32 *cover, int32 *area, const F24Dot8 *x0, const F24Dot8 *y0,
+    const F24Dot8 *x1, const F24Dot8 *y1, const int count)
+{
+    ASSERT(px != nullptr);
+    ASSERT(py != nullptr);
+    ASSERT(cover != nullptr);
+    ASSERT(area != nullptr);
+
+    const int32x4_t one = vdupq_n_s32(1);
+    const int32x4_t two = vdupq_n_s32(F24Dot8_2);
+    const uint32x4_t lanes = { 1, 2, 4, 8 };
+
+    uint32 single = 0;
+
+    for (int i = 0; i < count; i += 4) {
+        const int32x4_t vx0 = vld1q_s32(x0 + i);
+        const int32x4_t vy0 = vld1q_s32(y0 + i);
+        const int32x4_t vx1 = vld1q_s32(x1 + i);
+        const int32x4_t vy1 = vld1q_s32(y1 + i);
+
+        const int32x4_t c0 = vshrq_n_s32(vminq_s32(vx0, vx1), 8);
+        const int32x4_t c1 = vshrq_n_s32(
+            vsubq_s32(vmaxq_s32(vx0, vx1), one), 8);
+        const int32x4_t r0 = vshrq_n_s32(vminq_s32(vy0, vy1), 8);
+        const int32x4_t r1 = vshrq_n_s32(
+            vsubq_s32(vmaxq_s32(vy0, vy1), one), 8);
+
+        const uint32x4_t mask = vandq_u32(vceqq_s32(c0, c1),
+            vceqq_s32(r0, r1));
+
+        single |= vaddvq_u32(vandq_u32(mask, lanes)) << i;
+
+        const int32x4_t delta = vsubq_s32(vy0, vy1);
+
+        const int32x4_t w = vaddq_s32(vsubq_s32(two, vaddq_s32(vx0, vx1)),
+            vshlq_n_s32(c0, 9));
+
+        vst1q_s32(px + i, c0);
+        vst1q_s32(py + i, r0);
+        vst1q_s32(cover + i, delta);
+        vst1q_s32(area + i, vmulq_s32(delta, w));
+    }
+
+    return single;
+}
@@ -0,0 +1,52 @@
+
+// This must only be included from CellOps.h
+
+
+#include <wasm_simd128.h>
+
+
+static FORCE_INLINE uint32 FindSingleCellLines_wasm(int32 *px, int32 *py,
+    int32 *cover, int32 *area, const F24Dot8 *x0, const F24Dot8 *y0,
+    const F24Dot8 *x1, const F24Dot8 *y1, const int count)
+{
+    ASSERT(px != nullptr);
+    ASSERT(py != nullptr);
+    ASSERT(cover != nullptr);
+    ASSERT(area != nullptr);
+
+    const v128_t one = wasm_i32x4_splat(1);
+    const v128_t two = wasm_i32x4_splat(F24Dot8_2);
+
+    uint32 single = 0;
+
+    for (int i = 0; i < count; i += 4) {
+        const v128_t vx0 = wasm_v128_load(x0 + i);
+        const v128_t vy0 = wasm_v128_load(y0 + i);
+        const v128_t vx1 = wasm_v128_load(x1 + i);
+        const v128_t vy1 = wasm_v128_load(y1 + i);
+
+        const v128_t c0 = wasm_i32x4_shr(wasm_i32x4_min(vx0, vx1), 8);
+        const v128_t c1 = wasm_i32x4_shr(
+            wasm_i32x4_sub(wasm_i32x4_max(vx0, vx1), one), 8);
+        const v128_t r0 = wasm_i32x4_shr(wasm_i32x4_min(vy0, vy1), 8);
+        const v128_t r1 = wasm_i32x4_shr(
+            wasm_i32x4_sub(wasm_i32x4_max(vy0, vy1), one), 8);
+
+        const v128_t mask = wasm_v128_and(wasm_i32x4_eq(c0, c1),
+            wasm_i32x4_eq(r0, r1));
+
+        single |= uint32(wasm_i32x4_bitmask(mask)) << i;
+
+        const v128_t delta = wasm_i32x4_sub(vy0, vy1);
+
+        const v128_t w = wasm_i32x4_add(wasm_i32x4_sub(two,
+            wasm_i32x4_add(vx0, vx1)), wasm_i32x4_shl(c0, 9));
+
+        wasm_v128_store(px + i, c0);
+        wasm_v128_store(py + i, r0);
+        wasm_v128_store(cover + i, delta);
+        wasm_v128_store(area + i, wasm_i32x4_mul(delta, w));
+    }
+
+    return single;
+}
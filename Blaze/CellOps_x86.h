@@ -0,0 +1,82 @@
+
+// This must only be included from CellOps.h
+
+
+#include <emmintrin.h>
+
+
+/**
+ * Finds lane-wise minimum and maximum of two vectors. SSE2 has no
+ * instructions for 32 bit minimum and maximum.
+ */
+static FORCE_INLINE void MinMax_sse2(__m128i &min, __m128i &max,
+    const __m128i a, const __m128i b)
+{
+    const __m128i gt = _mm_cmpgt_epi32(a, b);
+
+    min = _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+    max = _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+}
+
+
+static FORCE_INLINE uint32 FindSingleCellLines_sse2(int32 *px, int32 *py,
+    int32 *cover, int32 *area, const F24Dot8 *x0, const F24Dot8 *y0,
+    const F24Dot8 *x1, const F24Dot8 *y1, const int count)
+{
+    ASSERT(px != nullptr);
+    ASSERT(py != nullptr);
+    ASSERT(cover != nullptr);
+    ASSERT(area != nullptr);
+
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(F24Dot8_2);
+
+    uint32 single = 0;
+
+    for (int i = 0; i < count; i += 4) {
+        const __m128i vx0 = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(x0 + i));
+        const __m128i vy0 = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(y0 + i));
+        const __m128i vx1 = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(x1 + i));
+        const __m128i vy1 = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(y1 + i));
+
+        __m128i minx;
+        __m128i maxx;
+        __m128i miny;
+        __m128i maxy;
+
+        MinMax_sse2(minx, maxx, vx0, vx1);
+        MinMax_sse2(miny, maxy, vy0, vy1);
+
+        const __m128i c0 = _mm_srai_epi32(minx, 8);
+        const __m128i c1 = _mm_srai_epi32(_mm_sub_epi32(maxx, one), 8);
+        const __m128i r0 = _mm_srai_epi32(miny, 8);
+        const __m128i r1 = _mm_srai_epi32(_mm_sub_epi32(maxy, one), 8);
+
+        const __m128i mask = _mm_and_si128(_mm_cmpeq_epi32(c0, c1),
+            _mm_cmpeq_epi32(r0, r1));
+
+        single |= uint32(_mm_movemask_ps(_mm_castsi128_ps(mask))) << i;
+
+        const __m128i delta = _mm_sub_epi32(vy0, vy1);
+
+        const __m128i w = _mm_add_epi32(_mm_sub_epi32(two,
+            _mm_add_epi32(vx0, vx1)), _mm_slli_epi32(c0, 9));
+
+        // For lines within one pixel delta fits into 16 bits and w is in
+        // range 0-512, so multiplying lower halves of each lane gives the
+        // full product. Upper half of w is zero, so sign bits of delta in
+        // upper half do not contribute anything.
+        const __m128i a = _mm_madd_epi16(delta, w);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(px + i), c0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(py + i), r0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(cover + i), delta);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(area + i), a);
+    }
+
+    return single;
+}
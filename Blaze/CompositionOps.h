@@ -2,6 +2,8 @@
 #pragma once
 
 
+#include "Dispatch.h"
+#include "PixelFormat.h"
 #include "Utils.h"
 
 
@@ -13,12 +15,66 @@
 #error I don't know about register size.
 #endif
 
+#ifdef SIMD_WASM
+#include "CompositionOps_wasm.h"
+#endif
+
 
 static FORCE_INLINE uint32 BlendSourceOver(const uint32 d, const uint32 s) {
     return s + ApplyAlpha(d, 255 - (s >> 24));
 }
 
 
+/**
+ * Composites span of pixels with premultiplied color using source over
+ * operator, using vector instructions for longer spans if available.
+ */
+static FORCE_INLINE void BlendSpanSourceOver(const int pos, const int end, uint32 *d, const uint32 color) {
+#ifdef RUNTIME_DISPATCH
+    if ((end - pos) >= 8 and Dispatch.BlendSpanSourceOver != nullptr) {
+        Dispatch.BlendSpanSourceOver(pos, end, d, color);
+        return;
+    }
+#elif defined SIMD_WASM
+    if ((end - pos) >= 4) {
+        BlendSpanSourceOver_wasm(pos, end, d, color);
+        return;
+    }
+#endif
+
+    for (int x = pos; x < end; x++) {
+        const uint32 dd = d[x];
+
+        if (dd == 0) {
+            d[x] = color;
+        } else {
+            d[x] = BlendSourceOver(dd, color);
+        }
+    }
+}
+
+
+/**
+ * Fills span of pixels with a given color, using the widest stores
+ * available.
+ */
+static FORCE_INLINE void FillSpanWide(uint32 *d, const int pos, const int end, const uint32 color) {
+#ifdef RUNTIME_DISPATCH
+    if ((end - pos) >= 8 and Dispatch.FillSpan != nullptr) {
+        Dispatch.FillSpan(d, pos, end, color);
+        return;
+    }
+#elif defined SIMD_WASM
+    if ((end - pos) >= 4) {
+        FillSpan_wasm(d, pos, end, color);
+        return;
+    }
+#endif
+
+    FillSpan(d, pos, end, color);
+}
+
+
 static FORCE_INLINE void CompositeSpanSourceOver(const int pos, const int end, uint32 *d, const int32 alpha, const uint32 color) {
     ASSERT(pos >= 0);
     ASSERT(pos < end);
@@ -28,18 +84,9 @@ static FORCE_INLINE void CompositeSpanSourceOver(const int pos, const int end, u
     // For opaque colors, use opaque span composition version.
     ASSERT((color >> 24) < 255);
 
-    const int e = end;
     const uint32 cba = ApplyAlpha(color, alpha);
 
-    for (int x = pos; x < e; x++) {
-        const uint32 dd = d[x];
-
-        if (dd == 0) {
-            d[x] = cba;
-        } else {
-            d[x] = BlendSourceOver(dd, cba);
-        }
-    }
+    BlendSpanSourceOver(pos, end, d, cba);
 }
 
 
@@ -50,31 +97,23 @@ static FORCE_INLINE void CompositeSpanSourceOverOpaque(const int pos, const int
     ASSERT(alpha <= 255);
     ASSERT((color >> 24) == 255);
 
-    const int e = end;
-
     if (alpha == 255) {
         // Solid span, write only.
-        for (int x = pos; x < e; x++) {
-            d[x] = color;
-        }
+        FillSpanWide(d, pos, end, color);
     } else {
         // Transparent span.
         const uint32 cba = ApplyAlpha(color, alpha);
 
-        for (int x = pos; x < e; x++) {
-            const uint32 dd = d[x];
-
-            if (dd == 0) {
-                d[x] = cba;
-            } else {
-                d[x] = BlendSourceOver(dd, cba);
-            }
-        }
+        BlendSpanSourceOver(pos, end, d, cba);
     }
 }
 
 
 struct SpanBlender final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = false;
+
+
     constexpr explicit SpanBlender(const uint32 color)
     :   Color(color)
     {
@@ -99,6 +138,10 @@ STATIC_ASSERT(SIZE_OF(SpanBlender) == 4);
  * Span blender which assumes source color is opaque.
  */
 struct SpanBlenderOpaque final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = false;
+
+
     constexpr explicit SpanBlenderOpaque(const uint32 color)
     :   Color(color)
     {
@@ -117,3 +160,272 @@ FORCE_INLINE void SpanBlenderOpaque::CompositeSpan(const int pos, const int end,
 
 
 STATIC_ASSERT(SIZE_OF(SpanBlenderOpaque) == 4);
+
+
+/**
+ * Span blender which writes coverage of each pixel instead of compositing
+ * color. Used for clip paths and clipped geometries, color does not matter.
+ */
+struct SpanBlenderCoverage final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = false;
+
+
+    constexpr explicit SpanBlenderCoverage(const uint32)
+    {
+    }
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+};
+
+
+FORCE_INLINE void SpanBlenderCoverage::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    FillSpanWide(d, pos, end, uint32(alpha));
+}
+
+
+/**
+ * Swaps red and blue components of 32 bit pixel, converting RGBA8 to BGRA8
+ * and back.
+ */
+static constexpr uint32 SwapRedBlue(const uint32 c) {
+    return (c & 0xff00ff00) | ((c >> 16) & 0xff) | ((c & 0xff) << 16);
+}
+
+
+/**
+ * Converts opaque premultiplied RGBA8 pixel to RGB565, rounding each
+ * component to the nearest value.
+ */
+static FORCE_INLINE uint16 PackRGB565(const uint32 c) {
+    const uint32 r = ((c & 0xff) * 31 + 127) / 255;
+    const uint32 g = (((c >> 8) & 0xff) * 63 + 127) / 255;
+    const uint32 b = (((c >> 16) & 0xff) * 31 + 127) / 255;
+
+    return uint16((r << 11) | (g << 5) | b);
+}
+
+
+/**
+ * Converts straight alpha RGBA8 pixel to premultiplied one.
+ */
+static FORCE_INLINE uint32 PremultiplyAlpha(const uint32 c) {
+    return ApplyAlpha(c | 0xff000000, c >> 24);
+}
+
+
+/**
+ * Converts premultiplied RGBA8 pixel to straight alpha one. Divides by alpha
+ * once and multiplies each component by the reciprocal.
+ */
+static FORCE_INLINE uint32 UnpremultiplyAlpha(const uint32 c) {
+    const uint32 a = c >> 24;
+
+    if (a == 255 or a == 0) {
+        return c;
+    }
+
+    const uint32 reciprocal = ((255u << 16) + (a >> 1)) / a;
+    const uint32 r = Min(((c & 0xff) * reciprocal + 0x8000) >> 16, 255u);
+    const uint32 g = Min((((c >> 8) & 0xff) * reciprocal + 0x8000) >> 16, 255u);
+    const uint32 b = Min((((c >> 16) & 0xff) * reciprocal + 0x8000) >> 16, 255u);
+
+    return (a << 24) | (b << 16) | (g << 8) | r;
+}
+
+
+/**
+ * Spreads components of RGB565 pixel into 16 bit lanes of 64 bit integer,
+ * blue in the lowest one. Each component then has enough room to be
+ * multiplied by 8 bit alpha without overlapping others.
+ */
+static FORCE_INLINE uint64 ExpandRGB565(const uint16 p) {
+    return uint64(p & 0x1f) | (uint64((p >> 5) & 0x3f) << 16) |
+        (uint64(p >> 11) << 32);
+}
+
+
+static FORCE_INLINE uint16 CompactRGB565(const uint64 e) {
+    return uint16((e & 0x1f) | (((e >> 16) & 0x3f) << 5) |
+        ((e >> 32) << 11));
+}
+
+
+/**
+ * Multiplies 16 bit value by 16 bit alpha, dividing by 65535 with rounding
+ * the same way Mul255 does for 8 bit values.
+ */
+static FORCE_INLINE uint32 Mul65535(const uint32 v, const uint32 a) {
+    const uint32 t = v * a;
+
+    return (t + (t >> 16) + 32768) >> 16;
+}
+
+
+/**
+ * Converts RGBA8 pixel to RGBA16 by replicating each byte.
+ */
+static FORCE_INLINE uint64 ExpandRGBA8ToRGBA16(const uint32 c) {
+    const uint64 r = c & 0xff;
+    const uint64 g = (c >> 8) & 0xff;
+    const uint64 b = (c >> 16) & 0xff;
+    const uint64 a = c >> 24;
+
+    return (r | (g << 16) | (b << 32) | (a << 48)) * 257;
+}
+
+
+/**
+ * Multiplies all components of RGBA16 pixel by 16 bit alpha.
+ */
+static FORCE_INLINE uint64 ApplyAlpha16(const uint64 x, const uint32 a) {
+    uint64 r = 0;
+
+    for (int i = 0; i < 64; i += 16) {
+        r |= uint64(Mul65535(uint32(x >> i) & 0xffff, a)) << i;
+    }
+
+    return r;
+}
+
+
+static FORCE_INLINE uint64 BlendSourceOver16(const uint64 d, const uint64 s) {
+    return s + ApplyAlpha16(d, 65535 - uint32(s >> 48));
+}
+
+
+/**
+ * Composites span of RGBA16 pixels with premultiplied color using source
+ * over operator, using vector instructions for longer spans if available.
+ */
+static FORCE_INLINE void BlendSpanSourceOver16(const int pos, const int end, uint64 *d, const uint64 color) {
+#ifdef RUNTIME_DISPATCH
+    if ((end - pos) >= 4 and Dispatch.BlendSpanSourceOver16 != nullptr) {
+        Dispatch.BlendSpanSourceOver16(pos, end, d, color);
+        return;
+    }
+#endif
+
+    for (int x = pos; x < end; x++) {
+        const uint64 dd = d[x];
+
+        if (dd == 0) {
+            d[x] = color;
+        } else {
+            d[x] = BlendSourceOver16(dd, color);
+        }
+    }
+}
+
+
+/**
+ * Span blender compositing color with source over operator into destination
+ * image of pixel format F. Destination pixels are read and written in that
+ * format directly. RGBA8 and BGRA8 images do not use it, they are composited
+ * with span blender of each geometry, see Rasterizer::RasterizeFrame. RGB565
+ * pixels are blended on components spread apart within 64 bit integer,
+ * avoiding conversion to RGBA8. Straight alpha pixels are
+ * converted to premultiplied RGBA8, blended and converted back one at a
+ * time, unless destination is opaque. RGBA16 expands color to 16 bits per
+ * component and receives 16 bit alpha of each span, see MaximumAlpha.
+ */
+template <PixelFormat F>
+struct SpanBlenderFormat final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = false;
+    static constexpr bool SingleBlender = true;
+    static constexpr int BytesPerPixel = BytesPerPixelForFormat(F);
+    static constexpr int32 MaximumAlpha = F == PixelFormat::RGBA16 ?
+        65535 : 255;
+
+
+    STATIC_ASSERT(F != PixelFormat::RGBA8 and F != PixelFormat::BGRA8);
+
+
+    constexpr explicit SpanBlenderFormat(const uint32 color)
+    :   Color(color)
+    {
+    }
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+
+    const uint32 Color = 0;
+};
+
+
+template <PixelFormat F>
+FORCE_INLINE void SpanBlenderFormat<F>::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+    ASSERT(alpha <= MaximumAlpha);
+
+    if constexpr (F == PixelFormat::RGB565) {
+        uint16 *p = reinterpret_cast<uint16 *>(d);
+
+        const uint32 s = ApplyAlpha(Color, alpha);
+        const uint16 c = PackRGB565(s);
+
+        if ((s >> 24) == 255) {
+            for (int x = pos; x < end; x++) {
+                p[x] = c;
+            }
+        } else {
+            // Destination components are multiplied by inverse alpha and
+            // divided by 255 with rounding, all three at once. Source
+            // components are rounded to the nearest as well, so their sum
+            // never overflows.
+            const uint64 ia = 255 - (s >> 24);
+            const uint64 e = ExpandRGB565(c);
+
+            for (int x = pos; x < end; x++) {
+                uint64 dd = ExpandRGB565(p[x]) * ia + 0x0000008000800080ull;
+
+                dd = ((dd + ((dd >> 8) & 0x000000ff00ff00ffull)) >> 8) &
+                    0x000000ff00ff00ffull;
+
+                p[x] = CompactRGB565(dd + e);
+            }
+        }
+    } else if constexpr (F == PixelFormat::RGBA16) {
+        uint64 *p = reinterpret_cast<uint64 *>(d);
+
+        const uint64 s = ApplyAlpha16(ExpandRGBA8ToRGBA16(Color),
+            uint32(alpha));
+
+        if ((s >> 48) == 65535) {
+            for (int x = pos; x < end; x++) {
+                p[x] = s;
+            }
+        } else {
+            BlendSpanSourceOver16(pos, end, p, s);
+        }
+    } else {
+        const uint32 s = ApplyAlpha(Color, alpha);
+
+        if ((s >> 24) == 255) {
+            // Opaque pixels are the same in both forms.
+            FillSpanWide(d, pos, end, s);
+        } else {
+            const uint32 straight = UnpremultiplyAlpha(s);
+
+            for (int x = pos; x < end; x++) {
+                const uint32 dd = d[x];
+
+                if (dd == 0) {
+                    d[x] = straight;
+                } else if ((dd >> 24) == 255) {
+                    d[x] = BlendSourceOver(dd, s);
+                } else {
+                    d[x] = UnpremultiplyAlpha(
+                        BlendSourceOver(PremultiplyAlpha(dd), s));
+                }
+            }
+        }
+    }
+}
+
+
+STATIC_ASSERT(SIZE_OF(SpanBlenderFormat<PixelFormat::RGB565>) == 4);
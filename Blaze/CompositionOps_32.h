@@ -13,3 +13,13 @@ static uint32 ApplyAlpha(const uint32 x, const uint32 a) {
 
     return a2 | b2;
 }
+
+
+/**
+ * Fills pixels from pos to end with a given color.
+ */
+static FORCE_INLINE void FillSpan(uint32 *d, const int pos, const int end, const uint32 color) {
+    for (int x = pos; x < end; x++) {
+        d[x] = color;
+    }
+}
@@ -9,3 +9,27 @@ static uint32 ApplyAlpha(const uint32 x, const uint32 a) {
 
     return (uint32(a2)) | (uint32(a2 >> 24));
 }
+
+
+/**
+ * Fills pixels from pos to end with a given color. Pixels are written in
+ * pairs using 64-bit stores once destination is aligned.
+ */
+static FORCE_INLINE void FillSpan(uint32 *d, const int pos, const int end, const uint32 color) {
+    int x = pos;
+
+    if (x < end and (reinterpret_cast<uintptr_t>(d + x) & 7) != 0) {
+        d[x++] = color;
+    }
+
+    const uint64 c2 = uint64(color) | (uint64(color) << 32);
+    const int e2 = x + ((end - x) & ~1);
+
+    for (; x < e2; x += 2) {
+        memcpy(d + x, &c2, SIZE_OF(uint64));
+    }
+
+    if (x < end) {
+        d[x] = color;
+    }
+}
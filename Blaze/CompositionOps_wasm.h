@@ -0,0 +1,88 @@
+
+// This must only be included from CompositionOps.h
+
+
+#include <wasm_simd128.h>
+
+
+// Span composition kernels for WebAssembly with SIMD128 extension processing
+// 4 pixels per iteration. Each channel is blended using 16-bit lanes the
+// same way as in CompositionOps_x86.h, so results are identical to scalar
+// version. Span tails shorter than 4 pixels are processed one pixel at a
+// time.
+
+
+static FORCE_INLINE v128_t ApplyAlpha_wasm(const v128_t x, const v128_t a) {
+    const v128_t half = wasm_i16x8_splat(128);
+
+    const v128_t lo0 = wasm_i16x8_mul(wasm_u16x8_extend_low_u8x16(x), a);
+    const v128_t hi0 = wasm_i16x8_mul(wasm_u16x8_extend_high_u8x16(x), a);
+
+    const v128_t lo1 = wasm_u16x8_shr(wasm_i16x8_add(
+        wasm_i16x8_add(lo0, wasm_u16x8_shr(lo0, 8)), half), 8);
+
+    const v128_t hi1 = wasm_u16x8_shr(wasm_i16x8_add(
+        wasm_i16x8_add(hi0, wasm_u16x8_shr(hi0, 8)), half), 8);
+
+    return wasm_u8x16_narrow_i16x8(lo1, hi1);
+}
+
+
+/**
+ * Composites span of pixels with premultiplied color using source over
+ * operator. Result is identical to calling BlendSourceOver for each pixel.
+ */
+static void BlendSpanSourceOver_wasm(const int pos, const int end, uint32 *d, const uint32 color) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    const v128_t s = wasm_i32x4_splat(int(color));
+    const v128_t ia = wasm_i16x8_splat(short(255 - (color >> 24)));
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        uint32 *p = d + x;
+
+        const v128_t dd = wasm_v128_load(p);
+
+        if (not wasm_v128_any_true(dd)) {
+            wasm_v128_store(p, s);
+        } else {
+            wasm_v128_store(p, wasm_i32x4_add(s, ApplyAlpha_wasm(dd, ia)));
+        }
+    }
+
+    for (; x < end; x++) {
+        const uint32 dd = d[x];
+
+        if (dd == 0) {
+            d[x] = color;
+        } else {
+            d[x] = color + ApplyAlpha(dd, 255 - (color >> 24));
+        }
+    }
+}
+
+
+/**
+ * Fills span of pixels with a given color.
+ */
+static void FillSpan_wasm(uint32 *d, const int pos, const int end, const uint32 color) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    const v128_t s = wasm_i32x4_splat(int(color));
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        wasm_v128_store(d + x, s);
+    }
+
+    for (; x < end; x++) {
+        d[x] = color;
+    }
+}
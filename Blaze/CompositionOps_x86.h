@@ -0,0 +1,420 @@
+
+// This must only be included from Dispatch.cpp
+
+
+#include <immintrin.h>
+
+
+// Span composition kernels for x86-64 processing 8 (AVX2) or 16 (AVX-512)
+// pixels per iteration. Kernels are selected at runtime, see Dispatch.h.
+//
+// Source over with premultiplied source color s and constant inverse alpha
+// ia = 255 - (s >> 24) is d = s + ApplyAlpha(d, ia). ApplyAlpha computes
+// ((t + (t >> 8) + 128) >> 8) for t = c * a of each channel c. These steps
+// never overflow 16 bits, so doing the same with 16-bit vector lanes gives
+// exactly the same result as scalar version. Adding source color is done
+// with 32-bit lanes to match scalar addition as well.
+//
+// Note that destination pixels equal to zero blend to s. Vectors consisting
+// only of such pixels are written without blending and span tails shorter
+// than vector use masked loads and stores.
+
+
+TARGET("avx2")
+static FORCE_INLINE __m256i ApplyAlpha_avx2(const __m256i x, const __m256i a) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i half = _mm256_set1_epi16(128);
+
+    const __m256i lo0 = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero), a);
+    const __m256i hi0 = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), a);
+
+    const __m256i lo1 = _mm256_srli_epi16(_mm256_add_epi16(
+        _mm256_add_epi16(lo0, _mm256_srli_epi16(lo0, 8)), half), 8);
+
+    const __m256i hi1 = _mm256_srli_epi16(_mm256_add_epi16(
+        _mm256_add_epi16(hi0, _mm256_srli_epi16(hi0, 8)), half), 8);
+
+    return _mm256_packus_epi16(lo1, hi1);
+}
+
+
+/**
+ * Composites span of pixels with premultiplied color using source over
+ * operator. Result is identical to calling BlendSourceOver for each pixel.
+ */
+TARGET("avx2")
+static void BlendSpanSourceOver_avx2(const int pos, const int end, uint32 *d, const uint32 color) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    const __m256i s = _mm256_set1_epi32(int(color));
+    const __m256i ia = _mm256_set1_epi16(short(255 - (color >> 24)));
+
+    int x = pos;
+
+    for (; x <= end - 8; x += 8) {
+        __m256i *p = reinterpret_cast<__m256i *>(d + x);
+
+        const __m256i dd = _mm256_loadu_si256(p);
+
+        if (_mm256_testz_si256(dd, dd)) {
+            _mm256_storeu_si256(p, s);
+        } else {
+            _mm256_storeu_si256(p, _mm256_add_epi32(s,
+                ApplyAlpha_avx2(dd, ia)));
+        }
+    }
+
+    if (x < end) {
+        int *p = reinterpret_cast<int *>(d + x);
+
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(end - x),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+        const __m256i dd = _mm256_maskload_epi32(p, mask);
+
+        _mm256_maskstore_epi32(p, mask, _mm256_add_epi32(s,
+            ApplyAlpha_avx2(dd, ia)));
+    }
+}
+
+
+/**
+ * Fills span of pixels with a given color.
+ */
+TARGET("avx2")
+static void FillSpan_avx2(uint32 *d, const int pos, const int end, const uint32 color) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    const __m256i s = _mm256_set1_epi32(int(color));
+
+    int x = pos;
+
+    for (; x <= end - 8; x += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + x), s);
+    }
+
+    if (x < end) {
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(end - x),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+        _mm256_maskstore_epi32(reinterpret_cast<int *>(d + x), mask, s);
+    }
+}
+
+
+TARGET("avx2,avx512f,avx512bw")
+static FORCE_INLINE __m512i ApplyAlpha_avx512(const __m512i x, const __m512i a) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i half = _mm512_set1_epi16(128);
+
+    const __m512i lo0 = _mm512_mullo_epi16(_mm512_unpacklo_epi8(x, zero), a);
+    const __m512i hi0 = _mm512_mullo_epi16(_mm512_unpackhi_epi8(x, zero), a);
+
+    const __m512i lo1 = _mm512_srli_epi16(_mm512_add_epi16(
+        _mm512_add_epi16(lo0, _mm512_srli_epi16(lo0, 8)), half), 8);
+
+    const __m512i hi1 = _mm512_srli_epi16(_mm512_add_epi16(
+        _mm512_add_epi16(hi0, _mm512_srli_epi16(hi0, 8)), half), 8);
+
+    return _mm512_packus_epi16(lo1, hi1);
+}
+
+
+/**
+ * Composites span of pixels with premultiplied color using source over
+ * operator. Result is identical to calling BlendSourceOver for each pixel.
+ */
+TARGET("avx2,avx512f,avx512bw")
+static void BlendSpanSourceOver_avx512(const int pos, const int end, uint32 *d, const uint32 color) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    const __m512i s = _mm512_set1_epi32(int(color));
+    const __m512i ia = _mm512_set1_epi16(short(255 - (color >> 24)));
+
+    int x = pos;
+
+    for (; x <= end - 16; x += 16) {
+        uint32 *p = d + x;
+
+        const __m512i dd = _mm512_loadu_si512(p);
+
+        if (_mm512_test_epi32_mask(dd, dd) == 0) {
+            _mm512_storeu_si512(p, s);
+        } else {
+            _mm512_storeu_si512(p, _mm512_add_epi32(s,
+                ApplyAlpha_avx512(dd, ia)));
+        }
+    }
+
+    if (x < end) {
+        uint32 *p = d + x;
+
+        const __mmask16 mask = __mmask16((1u << (end - x)) - 1);
+
+        const __m512i dd = _mm512_maskz_loadu_epi32(mask, p);
+
+        _mm512_mask_storeu_epi32(p, mask, _mm512_add_epi32(s,
+            ApplyAlpha_avx512(dd, ia)));
+    }
+}
+
+
+/**
+ * Fills span of pixels with a given color.
+ */
+TARGET("avx2,avx512f,avx512bw")
+static void FillSpan_avx512(uint32 *d, const int pos, const int end, const uint32 color) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    const __m512i s = _mm512_set1_epi32(int(color));
+
+    int x = pos;
+
+    for (; x <= end - 16; x += 16) {
+        _mm512_storeu_si512(d + x, s);
+    }
+
+    if (x < end) {
+        const __mmask16 mask = __mmask16((1u << (end - x)) - 1);
+
+        _mm512_mask_storeu_epi32(d + x, mask, s);
+    }
+}
+
+
+// Kernels for RGBA16 pixels processing 4 (AVX2) or 8 (AVX-512) pixels per
+// iteration. Each 16 bit component is widened to 32 bits, multiplied by
+// inverse alpha and divided by 65535 as ((t + (t >> 16) + 32768) >> 16),
+// which does not overflow 32 bits and gives the same result as Mul65535.
+
+
+TARGET("avx2")
+static FORCE_INLINE __m256i ApplyAlpha16_avx2(const __m256i x, const __m256i a) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i half = _mm256_set1_epi32(32768);
+
+    const __m256i lo0 = _mm256_mullo_epi32(_mm256_unpacklo_epi16(x, zero), a);
+    const __m256i hi0 = _mm256_mullo_epi32(_mm256_unpackhi_epi16(x, zero), a);
+
+    const __m256i lo1 = _mm256_srli_epi32(_mm256_add_epi32(
+        _mm256_add_epi32(lo0, _mm256_srli_epi32(lo0, 16)), half), 16);
+
+    const __m256i hi1 = _mm256_srli_epi32(_mm256_add_epi32(
+        _mm256_add_epi32(hi0, _mm256_srli_epi32(hi0, 16)), half), 16);
+
+    return _mm256_packus_epi32(lo1, hi1);
+}
+
+
+/**
+ * Composites span of RGBA16 pixels with premultiplied color using source
+ * over operator. Result is identical to calling BlendSourceOver16 for each
+ * pixel.
+ */
+TARGET("avx2")
+static void BlendSpanSourceOver16_avx2(const int pos, const int end, uint64 *d, const uint64 color) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    const __m256i s = _mm256_set1_epi64x(int64(color));
+    const __m256i ia = _mm256_set1_epi32(int(65535 - (color >> 48)));
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        __m256i *p = reinterpret_cast<__m256i *>(d + x);
+
+        const __m256i dd = _mm256_loadu_si256(p);
+
+        if (_mm256_testz_si256(dd, dd)) {
+            _mm256_storeu_si256(p, s);
+        } else {
+            _mm256_storeu_si256(p, _mm256_add_epi16(s,
+                ApplyAlpha16_avx2(dd, ia)));
+        }
+    }
+
+    if (x < end) {
+        long long *p = reinterpret_cast<long long *>(d + x);
+
+        const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(end - x),
+            _mm256_setr_epi64x(0, 1, 2, 3));
+
+        const __m256i dd = _mm256_maskload_epi64(p, mask);
+
+        _mm256_maskstore_epi64(p, mask, _mm256_add_epi16(s,
+            ApplyAlpha16_avx2(dd, ia)));
+    }
+}
+
+
+TARGET("avx2,avx512f,avx512bw")
+static FORCE_INLINE __m512i ApplyAlpha16_avx512(const __m512i x, const __m512i a) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i half = _mm512_set1_epi32(32768);
+
+    const __m512i lo0 = _mm512_mullo_epi32(_mm512_unpacklo_epi16(x, zero), a);
+    const __m512i hi0 = _mm512_mullo_epi32(_mm512_unpackhi_epi16(x, zero), a);
+
+    const __m512i lo1 = _mm512_srli_epi32(_mm512_add_epi32(
+        _mm512_add_epi32(lo0, _mm512_srli_epi32(lo0, 16)), half), 16);
+
+    const __m512i hi1 = _mm512_srli_epi32(_mm512_add_epi32(
+        _mm512_add_epi32(hi0, _mm512_srli_epi32(hi0, 16)), half), 16);
+
+    return _mm512_packus_epi32(lo1, hi1);
+}
+
+
+/**
+ * Composites span of RGBA16 pixels with premultiplied color using source
+ * over operator. Result is identical to calling BlendSourceOver16 for each
+ * pixel.
+ */
+TARGET("avx2,avx512f,avx512bw")
+static void BlendSpanSourceOver16_avx512(const int pos, const int end, uint64 *d, const uint64 color) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    const __m512i s = _mm512_set1_epi64(int64(color));
+    const __m512i ia = _mm512_set1_epi32(int(65535 - (color >> 48)));
+
+    int x = pos;
+
+    for (; x <= end - 8; x += 8) {
+        uint64 *p = d + x;
+
+        const __m512i dd = _mm512_loadu_si512(p);
+
+        if (_mm512_test_epi64_mask(dd, dd) == 0) {
+            _mm512_storeu_si512(p, s);
+        } else {
+            _mm512_storeu_si512(p, _mm512_add_epi16(s,
+                ApplyAlpha16_avx512(dd, ia)));
+        }
+    }
+
+    if (x < end) {
+        uint64 *p = d + x;
+
+        const __mmask8 mask = __mmask8((1u << (end - x)) - 1);
+
+        const __m512i dd = _mm512_maskz_loadu_epi64(mask, p);
+
+        _mm512_mask_storeu_epi64(p, mask, _mm512_add_epi16(s,
+            ApplyAlpha16_avx512(dd, ia)));
+    }
+}
+
+
+/**
+ * Composites span of pixels in linear light, see LinearBlendOps.h. Groups of
+ * 8 opaque destination pixels are converted with table lookups done by
+ * gather instructions. Groups containing translucent pixels are composited
+ * one pixel at a time. Result is identical to calling BlendSourceOverLinear
+ * for each pixel.
+ */
+TARGET("avx2")
+static void BlendSpanSourceOverLinear_avx2(const int pos, const int end, uint32 *d, const LinearSpanSource &s) {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    // Tables are read with 32 bit loads, only the lowest bits are used.
+    const int *toLinear = reinterpret_cast<const int *>(SRGBTables.ToLinear);
+    const int *toSRGB = reinterpret_cast<const int *>(SRGBTables.ToSRGB);
+
+    const __m256i opaque = _mm256_set1_epi32(int(0xff000000));
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256i wordMask = _mm256_set1_epi32(0xffff);
+    const __m256i half = _mm256_set1_epi32(32768);
+    const __m256i m257 = _mm256_set1_epi32(257);
+    const __m256i ia = _mm256_set1_epi32(int(s.InverseAlpha));
+
+    const __m256i source[3] = {
+        _mm256_set1_epi32(int(s.Components[0])),
+        _mm256_set1_epi32(int(s.Components[1])),
+        _mm256_set1_epi32(int(s.Components[2]))
+    };
+
+    // Last composited pixel, uniform runs of destination reuse it.
+    uint32 previous = d[pos];
+    uint32 previousResult = BlendSourceOverLinear(previous, s);
+
+    int x = pos;
+
+    for (; x <= end - 8; x += 8) {
+        __m256i *p = reinterpret_cast<__m256i *>(d + x);
+
+        const __m256i dd = _mm256_loadu_si256(p);
+
+        const uint32 first = d[x];
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(dd,
+            _mm256_set1_epi32(int(first)))) == -1)
+        {
+            if (first != previous) {
+                previous = first;
+                previousResult = BlendSourceOverLinear(first, s);
+            }
+
+            _mm256_storeu_si256(p, _mm256_set1_epi32(int(previousResult)));
+            continue;
+        }
+
+        const int opaqueMask = _mm256_movemask_epi8(_mm256_cmpeq_epi32(
+            _mm256_and_si256(dd, opaque), opaque));
+
+        if (opaqueMask != -1) {
+            for (int i = 0; i < 8; i++) {
+                d[x + i] = BlendSourceOverLinear(d[x + i], s);
+            }
+
+            continue;
+        }
+
+        __m256i r = opaque;
+
+        for (int i = 0; i < 3; i++) {
+            const __m256i index = _mm256_and_si256(_mm256_srli_epi32(dd,
+                i * 8), byteMask);
+
+            const __m256i c = _mm256_and_si256(_mm256_i32gather_epi32(
+                toLinear, index, 2), wordMask);
+
+            const __m256i v = _mm256_add_epi32(source[i],
+                _mm256_mullo_epi32(c, ia));
+
+            const __m256i l = _mm256_srli_epi32(_mm256_add_epi32(
+                _mm256_mullo_epi32(v, m257), half), 16);
+
+            const __m256i e = _mm256_and_si256(_mm256_i32gather_epi32(
+                toSRGB, l, 1), byteMask);
+
+            r = _mm256_or_si256(r, _mm256_slli_epi32(e, i * 8));
+        }
+
+        _mm256_storeu_si256(p, r);
+    }
+
+    for (; x < end; x++) {
+        const uint32 v = d[x];
+
+        if (v != previous) {
+            previous = v;
+            previousResult = BlendSourceOverLinear(v, s);
+        }
+
+        d[x] = previousResult;
+    }
+}
@@ -0,0 +1,124 @@
+
+#pragma once
+
+
+#include "Dispatch.h"
+#include "Utils.h"
+
+
+// Operations on start cover arrays, used by tile descriptors. Each array
+// holds one cover value per tile row, so Count is tile height, which is
+// always a multiple of 4. These are called for every tile row of every
+// geometry crossing left edge of destination image, so they are vectorized
+// for every SIMD backend. Each call is only 2 to 8 vector instructions,
+// inlined into tile descriptor code, so these are not dispatched at
+// runtime. Calling AVX2 versions through DispatchTable costs about as much
+// as it saves.
+
+#ifdef SIMD_NEON
+#include "CoverOps_neon.h"
+#elif defined SIMD_WASM
+#include "CoverOps_wasm.h"
+#elif defined SIMD_SSE2
+#include "CoverOps_x86.h"
+#endif
+
+
+/**
+ * Sets all covers to a given value. Plain C++ version.
+ */
+template <int Count>
+static FORCE_INLINE void FillCovers_generic(int32 *p, const int32 value) {
+    ASSERT(p != nullptr);
+
+    for (int i = 0; i < Count; i++) {
+        p[i] = value;
+    }
+}
+
+
+/**
+ * Adds a given value to all covers. Plain C++ version.
+ */
+template <int Count>
+static FORCE_INLINE void AccumulateCovers_generic(int32 *p, const int32 value) {
+    ASSERT(p != nullptr);
+
+    for (int i = 0; i < Count; i++) {
+        p[i] += value;
+    }
+}
+
+
+/**
+ * Returns true if all covers are zero. Plain C++ version.
+ */
+template <int Count>
+static FORCE_INLINE bool CoversContainOnlyZeroes_generic(const int32 *t) {
+    ASSERT(t != nullptr);
+
+    int32 v = 0;
+
+    for (int i = 0; i < Count; i++) {
+        v |= t[i];
+    }
+
+    return v == 0;
+}
+
+
+/**
+ * Sets all covers to a given value.
+ */
+template <int Count>
+static FORCE_INLINE void FillCovers(int32 *p, const int32 value) {
+    STATIC_ASSERT((Count & 3) == 0);
+
+#ifdef SIMD_NEON
+    FillCovers_neon<Count>(p, value);
+#elif defined SIMD_WASM
+    FillCovers_wasm<Count>(p, value);
+#elif defined SIMD_SSE2
+    FillCovers_sse2<Count>(p, value);
+#else
+    FillCovers_generic<Count>(p, value);
+#endif
+}
+
+
+/**
+ * Adds a given value to all covers.
+ */
+template <int Count>
+static FORCE_INLINE void AccumulateCovers(int32 *p, const int32 value) {
+    STATIC_ASSERT((Count & 3) == 0);
+
+#ifdef SIMD_NEON
+    AccumulateCovers_neon<Count>(p, value);
+#elif defined SIMD_WASM
+    AccumulateCovers_wasm<Count>(p, value);
+#elif defined SIMD_SSE2
+    AccumulateCovers_sse2<Count>(p, value);
+#else
+    AccumulateCovers_generic<Count>(p, value);
+#endif
+}
+
+
+/**
+ * Returns true if all covers are zero.
+ */
+template <int Count>
+static FORCE_INLINE bool CoversContainOnlyZeroes(const int32 *t) {
+    STATIC_ASSERT((Count & 3) == 0);
+
+#ifdef SIMD_NEON
+    return CoversContainOnlyZeroes_neon<Count>(t);
+#elif defined SIMD_WASM
+    return CoversContainOnlyZeroes_wasm<Count>(t);
+#elif defined SIMD_SSE2
+    return CoversContainOnlyZeroes_sse2<Count>(t);
+#else
+    return CoversContainOnlyZeroes_generic<Count>(t);
+#endif
+}
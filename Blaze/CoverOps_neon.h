@@ -0,0 +1,43 @@
+
+// This must only be included from CoverOps.h
+
+
+#include <arm_neon.h>
+
+
+template <int Count>
+static FORCE_INLINE void FillCovers_neon(int32 *p, const int32 value) {
+    ASSERT(p != nullptr);
+
+    const int32x4_t v = vdupq_n_s32(value);
+
+    for (int i = 0; i < Count; i += 4) {
+        vst1q_s32(p + i, v);
+    }
+}
+
+
+template <int Count>
+static FORCE_INLINE void AccumulateCovers_neon(int32 *p, const int32 value) {
+    ASSERT(p != nullptr);
+
+    const int32x4_t v = vdupq_n_s32(value);
+
+    for (int i = 0; i < Count; i += 4) {
+        vst1q_s32(p + i, vaddq_s32(vld1q_s32(p + i), v));
+    }
+}
+
+
+template <int Count>
+static FORCE_INLINE bool CoversContainOnlyZeroes_neon(const int32 *t) {
+    ASSERT(t != nullptr);
+
+    int32x4_t v = vld1q_s32(t);
+
+    for (int i = 4; i < Count; i += 4) {
+        v = vorrq_s32(v, vld1q_s32(t + i));
+    }
+
+    return vmaxvq_u32(vreinterpretq_u32_s32(v)) == 0;
+}
@@ -0,0 +1,43 @@
+
+// This must only be included from CoverOps.h
+
+
+#include <wasm_simd128.h>
+
+
+template <int Count>
+static FORCE_INLINE void FillCovers_wasm(int32 *p, const int32 value) {
+    ASSERT(p != nullptr);
+
+    const v128_t v = wasm_i32x4_splat(value);
+
+    for (int i = 0; i < Count; i += 4) {
+        wasm_v128_store(p + i, v);
+    }
+}
+
+
+template <int Count>
+static FORCE_INLINE void AccumulateCovers_wasm(int32 *p, const int32 value) {
+    ASSERT(p != nullptr);
+
+    const v128_t v = wasm_i32x4_splat(value);
+
+    for (int i = 0; i < Count; i += 4) {
+        wasm_v128_store(p + i, wasm_i32x4_add(wasm_v128_load(p + i), v));
+    }
+}
+
+
+template <int Count>
+static FORCE_INLINE bool CoversContainOnlyZeroes_wasm(const int32 *t) {
+    ASSERT(t != nullptr);
+
+    v128_t v = wasm_v128_load(t);
+
+    for (int i = 4; i < Count; i += 4) {
+        v = wasm_v128_or(v, wasm_v128_load(t + i));
+    }
+
+    return not wasm_v128_any_true(v);
+}
@@ -0,0 +1,48 @@
+
+// This must only be included from CoverOps.h
+
+
+#include <emmintrin.h>
+
+
+template <int Count>
+static FORCE_INLINE void FillCovers_sse2(int32 *p, const int32 value) {
+    ASSERT(p != nullptr);
+
+    const __m128i v = _mm_set1_epi32(value);
+
+    for (int i = 0; i < Count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i), v);
+    }
+}
+
+
+template <int Count>
+static FORCE_INLINE void AccumulateCovers_sse2(int32 *p, const int32 value) {
+    ASSERT(p != nullptr);
+
+    const __m128i v = _mm_set1_epi32(value);
+
+    for (int i = 0; i < Count; i += 4) {
+        __m128i *c = reinterpret_cast<__m128i *>(p + i);
+
+        _mm_storeu_si128(c, _mm_add_epi32(_mm_loadu_si128(c), v));
+    }
+}
+
+
+template <int Count>
+static FORCE_INLINE bool CoversContainOnlyZeroes_sse2(const int32 *t) {
+    ASSERT(t != nullptr);
+
+    const __m128i *c = reinterpret_cast<const __m128i *>(t);
+
+    __m128i v = _mm_loadu_si128(c);
+
+    for (int i = 1; i < (Count / 4); i++) {
+        v = _mm_or_si128(v, _mm_loadu_si128(c + i));
+    }
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(v, _mm_setzero_si128())) ==
+        0xffff;
+}
@@ -13,9 +13,9 @@
 
 
 /**
- * A helper class for managing an image to draw on.
+ * A helper class for managing an image to draw on. Tile descriptor is
+ * selected for each frame at runtime, see SelectTileShape.
  */
-template <typename T>
 class DestinationImage final {
 public:
 
@@ -38,6 +38,9 @@ public:
     uint8 *GetImageData() const;
     int GetBytesPerRow() const;
 
+private:
+    static constexpr int WidthRounding = TileDescriptor_64x16::TileW;
+    static constexpr int WidthRoundingMask = WidthRounding - 1;
 private:
     uint8 *mImageData = nullptr;
     IntSize mImageSize;
@@ -49,19 +52,18 @@ private:
 };
 
 
-template <typename T>
-FORCE_INLINE DestinationImage<T>::~DestinationImage() {
+FORCE_INLINE DestinationImage::~DestinationImage() {
     free(mImageData);
 }
 
 
-template <typename T>
-FORCE_INLINE IntSize DestinationImage<T>::UpdateSize(const IntSize &size) {
+FORCE_INLINE IntSize DestinationImage::UpdateSize(const IntSize &size) {
     ASSERT(size.Width > 0);
     ASSERT(size.Height > 0);
 
-    // Round-up width to tile width.
-    const TileIndex w = CalculateColumnCount<T>(size.Width) * T::TileW;
+    // Round-up width to the widest tile width, so image can be rasterized
+    // with any tile descriptor.
+    const int w = (size.Width + WidthRoundingMask) & ~WidthRoundingMask;
 
     // Calculate how many bytes are required for the image.
     const int bytes = w * 4 * size.Height;
@@ -88,14 +90,12 @@ FORCE_INLINE IntSize DestinationImage<T>::UpdateSize(const IntSize &size) {
 }
 
 
-template <typename T>
-FORCE_INLINE void DestinationImage<T>::ClearImage() {
+FORCE_INLINE void DestinationImage::ClearImage() {
     memset(mImageData, 0, mImageSize.Width * 4 * mImageSize.Height);
 }
 
 
-template <typename T>
-FORCE_INLINE void DestinationImage<T>::DrawImage(const VectorImage &image, const Matrix &matrix) {
+FORCE_INLINE void DestinationImage::DrawImage(const VectorImage &image, const Matrix &matrix) {
     if (image.GetGeometryCount() < 1) {
         return;
     }
@@ -103,7 +103,7 @@ FORCE_INLINE void DestinationImage<T>::DrawImage(const VectorImage &image, const
     const ImageData d(mImageData, mImageSize.Width, mImageSize.Height,
         mBytesPerRow);
 
-    Rasterize<T>(image.GetGeometries(), image.GetGeometryCount(), matrix,
+    Rasterize(image.GetGeometries(), image.GetGeometryCount(), matrix,
         mThreads, d);
 
     // Free all the memory allocated by threads.
@@ -111,31 +111,26 @@ FORCE_INLINE void DestinationImage<T>::DrawImage(const VectorImage &image, const
 }
 
 
-template <typename T>
-FORCE_INLINE IntSize DestinationImage<T>::GetImageSize() const {
+FORCE_INLINE IntSize DestinationImage::GetImageSize() const {
     return mImageSize;
 }
 
 
-template <typename T>
-FORCE_INLINE int DestinationImage<T>::GetImageWidth() const {
+FORCE_INLINE int DestinationImage::GetImageWidth() const {
     return mImageSize.Width;
 }
 
 
-template <typename T>
-FORCE_INLINE int DestinationImage<T>::GetImageHeight() const {
+FORCE_INLINE int DestinationImage::GetImageHeight() const {
     return mImageSize.Height;
 }
 
 
-template <typename T>
-FORCE_INLINE uint8 *DestinationImage<T>::GetImageData() const {
+FORCE_INLINE uint8 *DestinationImage::GetImageData() const {
     return mImageData;
 }
 
 
-template <typename T>
-FORCE_INLINE int DestinationImage<T>::GetBytesPerRow() const {
+FORCE_INLINE int DestinationImage::GetBytesPerRow() const {
     return mBytesPerRow;
 }
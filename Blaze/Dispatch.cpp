@@ -0,0 +1,193 @@
+
+#include <cstdlib>
+#include <cstring>
+#include "AccumulationOps.h"
+#include "CompositionOps.h"
+#include "Dispatch.h"
+#include "LinearBlendOps.h"
+#include "SIMD.h"
+
+#ifdef RUNTIME_DISPATCH
+#include "CompositionOps_x86.h"
+#endif
+
+
+static InstructionSet CurrentInstructionSet = InstructionSet::Generic;
+
+
+#ifdef RUNTIME_DISPATCH
+
+static void GenericPointConversion(const Matrix &matrix, F24Dot8Point *dst,
+    const FloatPoint *src, const int count, const F24Dot8Point origin,
+    const F24Dot8Point size)
+{
+    FloatPointsToF24Dot8Points_generic(matrix, dst, src, count, origin,
+        size);
+}
+
+
+static constexpr DispatchTable GenericKernels = {
+    {
+        GenericPointConversion,
+        GenericPointConversion,
+        GenericPointConversion,
+        GenericPointConversion,
+        GenericPointConversion
+    },
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    {
+        nullptr,
+        nullptr
+    }
+};
+
+
+// Generic kernels are used until kernels for processor are selected during
+// static initialization.
+DispatchTable Dispatch = GenericKernels;
+
+
+static void SetKernels(const InstructionSet set) {
+    DispatchTable table = GenericKernels;
+
+    PointConversionKernel *pc = table.FloatPointsToF24Dot8Points;
+
+    // There are no AVX-512 point conversion kernels, AVX2 ones are used
+    // instead.
+    if (set >= InstructionSet::AVX2) {
+        pc[0] = FloatPointsToF24Dot8Points_avx2<MatrixComplexity::Identity>;
+        pc[1] = FloatPointsToF24Dot8Points_avx2<MatrixComplexity::TranslationOnly>;
+        pc[2] = FloatPointsToF24Dot8Points_avx2<MatrixComplexity::ScaleOnly>;
+        pc[3] = FloatPointsToF24Dot8Points_avx2<MatrixComplexity::TranslationScale>;
+        pc[4] = FloatPointsToF24Dot8Points_avx2<MatrixComplexity::Complex>;
+    } else if (set >= InstructionSet::SSE41) {
+        pc[0] = FloatPointsToF24Dot8Points_sse41<MatrixComplexity::Identity>;
+        pc[1] = FloatPointsToF24Dot8Points_sse41<MatrixComplexity::TranslationOnly>;
+        pc[2] = FloatPointsToF24Dot8Points_sse41<MatrixComplexity::ScaleOnly>;
+        pc[3] = FloatPointsToF24Dot8Points_sse41<MatrixComplexity::TranslationScale>;
+        pc[4] = FloatPointsToF24Dot8Points_sse41<MatrixComplexity::Complex>;
+    }
+
+    if (set >= InstructionSet::AVX512) {
+        table.BlendSpanSourceOver = BlendSpanSourceOver_avx512;
+        table.FillSpan = FillSpan_avx512;
+        table.BlendSpanSourceOver16 = BlendSpanSourceOver16_avx512;
+
+        // There is no AVX-512 linear light kernel, AVX2 one is used instead.
+        table.BlendSpanSourceOverLinear = BlendSpanSourceOverLinear_avx2;
+    } else if (set >= InstructionSet::AVX2) {
+        table.BlendSpanSourceOver = BlendSpanSourceOver_avx2;
+        table.FillSpan = FillSpan_avx2;
+        table.BlendSpanSourceOver16 = BlendSpanSourceOver16_avx2;
+        table.BlendSpanSourceOverLinear = BlendSpanSourceOverLinear_avx2;
+    }
+
+    // Cover accumulation processes at most AccumulationChunkSize pixels per
+    // call, there is no benefit from wider AVX-512 vectors.
+    if (set >= InstructionSet::AVX2) {
+        table.ResolveAccumulatedAlphas[0] =
+            ResolveAccumulatedAlphas_avx2<AreaToAlphaNonZero>;
+        table.ResolveAccumulatedAlphas[1] =
+            ResolveAccumulatedAlphas_avx2<AreaToAlphaEvenOdd>;
+    }
+
+    Dispatch = table;
+}
+
+#endif // RUNTIME_DISPATCH
+
+
+/**
+ * Returns instruction set requested by BLAZE_INSTRUCTION_SET environment
+ * variable or the best instruction set processor supports if environment
+ * variable is not set or not recognized.
+ */
+static InstructionSet RequestedInstructionSet() {
+    const char *value = getenv("BLAZE_INSTRUCTION_SET");
+
+    if (value != nullptr) {
+        for (int i = 0; i <= int(InstructionSet::AVX512); i++) {
+            const InstructionSet set = InstructionSet(i);
+
+            if (strcmp(value, GetInstructionSetName(set)) == 0) {
+                return set;
+            }
+        }
+    }
+
+    return DetectInstructionSet();
+}
+
+
+static InstructionSet InitializeInstructionSet() {
+    return SelectInstructionSet(RequestedInstructionSet());
+}
+
+
+// Kernels are selected once at startup.
+static const InstructionSet InitialInstructionSet = InitializeInstructionSet();
+
+
+InstructionSet DetectInstructionSet()
+{
+#if defined RUNTIME_DISPATCH and defined __GNUC__
+    // This may run before constructors of runtime library.
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") and
+        __builtin_cpu_supports("avx512bw") and
+        __builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+
+    if (__builtin_cpu_supports("sse4.1")) {
+        return InstructionSet::SSE41;
+    }
+#endif
+
+    return InstructionSet::Generic;
+}
+
+
+InstructionSet GetInstructionSet()
+{
+    return CurrentInstructionSet;
+}
+
+
+InstructionSet SelectInstructionSet(const InstructionSet set)
+{
+    const InstructionSet selected = Min(set, DetectInstructionSet());
+
+#ifdef RUNTIME_DISPATCH
+    SetKernels(selected);
+#endif
+
+    CurrentInstructionSet = selected;
+
+    return selected;
+}
+
+
+const char *GetInstructionSetName(const InstructionSet set)
+{
+    switch (set) {
+        case InstructionSet::Generic:
+            return "generic";
+        case InstructionSet::SSE41:
+            return "sse4.1";
+        case InstructionSet::AVX2:
+            return "avx2";
+        case InstructionSet::AVX512:
+            return "avx512";
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,136 @@
+
+#pragma once
+
+
+#include "F24Dot8Point.h"
+#include "Matrix.h"
+
+
+// On x86-64 processors vector kernels are selected at runtime, once, based
+// on instruction sets processor supports. This way the same binary uses
+// AVX-512 kernels where available and still runs on processors without it.
+// Kernels for other processors are selected at compile time. Defining
+// SIMD_GENERIC disables vector kernels altogether.
+//
+// SSE2 is part of x86-64, so SSE2 kernels are compiled in directly and
+// selected with SIMD_SSE2 like kernels of other processors. They are used
+// for operations which are not dispatched and as fallback of dispatched
+// ones on processors without SSE4.1.
+//
+// Point conversion, span composition and cover accumulation of dense rows
+// are dispatched. Start cover operations stay inlined SSE2, see CoverOps.h,
+// and so do single cell lines, paint shading and blend modes other than
+// source over, which have no wider versions.
+// Bit vectors are scanned one word at a time with count trailing zeroes
+// instruction, there is no wider version to select.
+#if defined __x86_64__ and not defined SIMD_GENERIC
+#define RUNTIME_DISPATCH
+#define SIMD_SSE2
+#endif
+
+
+/**
+ * Instruction sets kernels can be selected for. Each instruction set
+ * includes all instruction sets before it.
+ */
+enum class InstructionSet : uint8 {
+    Generic = 0,
+    SSE41,
+    AVX2,
+    AVX512
+};
+
+
+/**
+ * Returns the best instruction set supported by processor. Always returns
+ * InstructionSet::Generic when runtime dispatch is not available.
+ */
+InstructionSet DetectInstructionSet();
+
+
+/**
+ * Returns instruction set kernels are currently selected for.
+ *
+ * At startup this is the best instruction set supported by processor. If
+ * BLAZE_INSTRUCTION_SET environment variable is set to "generic", "sse4.1",
+ * "avx2" or "avx512", that instruction set is used instead, as long as
+ * processor supports it.
+ */
+InstructionSet GetInstructionSet();
+
+
+/**
+ * Selects kernels for a given instruction set. If processor does not
+ * support it, the best supported instruction set is selected instead.
+ * Returns instruction set that was selected. Must not be called while
+ * rasterizing.
+ *
+ * @param set Requested instruction set.
+ */
+InstructionSet SelectInstructionSet(const InstructionSet set);
+
+
+/**
+ * Returns name of a given instruction set as accepted by
+ * BLAZE_INSTRUCTION_SET environment variable.
+ */
+const char *GetInstructionSetName(const InstructionSet set);
+
+
+#ifdef RUNTIME_DISPATCH
+
+using PointConversionKernel = void (*)(const Matrix &matrix,
+    F24Dot8Point *dst, const FloatPoint *src, const int count,
+    const F24Dot8Point origin, const F24Dot8Point size);
+
+using BlendSpanKernel = void (*)(const int pos, const int end, uint32 *d,
+    const uint32 color);
+
+using FillSpanKernel = void (*)(uint32 *d, const int pos, const int end,
+    const uint32 color);
+
+using BlendSpan16Kernel = void (*)(const int pos, const int end, uint64 *d,
+    const uint64 color);
+
+using ResolveAlphasKernel = uint32 (*)(uint8 *alphas,
+    const int32 *coverArea, const int count, int32 &cover,
+    const uint32 previousAlpha);
+
+struct LinearSpanSource;
+
+using BlendSpanLinearKernel = void (*)(const int pos, const int end,
+    uint32 *d, const LinearSpanSource &source);
+
+
+/**
+ * Kernels selected for current instruction set.
+ */
+struct DispatchTable final {
+
+    // Point conversion for each matrix complexity, indexed by
+    // MatrixComplexity.
+    PointConversionKernel FloatPointsToF24Dot8Points[5];
+
+    // Span composition. These are nullptr if there are no vector kernels
+    // for current instruction set and scalar code should be used.
+    BlendSpanKernel BlendSpanSourceOver;
+    FillSpanKernel FillSpan;
+
+    // Span composition for RGBA16 pixels, nullptr if there are no vector
+    // kernels for current instruction set.
+    BlendSpan16Kernel BlendSpanSourceOver16;
+
+    // Span composition in linear light, nullptr if there are no vector
+    // kernels for current instruction set.
+    BlendSpanLinearKernel BlendSpanSourceOverLinear;
+
+    // Alpha calculation for dense rows of cover/area pairs, see
+    // ResolveAccumulatedAlphas, for non-zero and even-odd fill rules in this
+    // order. nullptr if SSE2 version should be used.
+    ResolveAlphasKernel ResolveAccumulatedAlphas[2];
+};
+
+
+extern DispatchTable Dispatch;
+
+#endif // RUNTIME_DISPATCH
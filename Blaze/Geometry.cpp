@@ -4,7 +4,9 @@
 
 Geometry::Geometry(const IntRect &pathBounds, const PathTag *tags,
     const FloatPoint *points, const Matrix &tm, const int tagCount,
-    const int pointCount, const uint32 color, const FillRule rule)
+    const int pointCount, const uint32 color, const FillRule rule,
+    const ::Paint *paint, const BlendMode mode, const Geometry *clip,
+    const ::Layer *layer, const ::Stroke *stroke)
 :   PathBounds(pathBounds),
     Tags(tags),
     Points(points),
@@ -12,7 +14,12 @@ Geometry::Geometry(const IntRect &pathBounds, const PathTag *tags,
     TagCount(tagCount),
     PointCount(pointCount),
     Color(color),
-    Rule(rule)
+    Rule(rule),
+    Paint(paint),
+    Mode(mode),
+    Clip(clip),
+    Layer(layer),
+    Stroke(stroke)
 {
     ASSERT(tags != nullptr);
     ASSERT(points != nullptr);
@@ -2,11 +2,15 @@
 #pragma once
 
 
+#include "BlendMode.h"
 #include "FillRule.h"
 #include "FloatPoint.h"
 #include "IntRect.h"
+#include "Layer.h"
 #include "Matrix.h"
+#include "Paint.h"
 #include "PathTag.h"
+#include "Stroke.h"
 
 
 /**
@@ -33,10 +37,36 @@ struct Geometry final {
      * premultiplied by alpha.
      *
      * @param rule Fill rule to use.
+     *
+     * @param paint Optional gradient or image pattern to fill geometry with.
+     * If not nullptr, color is not used. Paint is not copied and must stay
+     * alive until geometry is rasterized.
+     *
+     * @param mode Blend mode to combine geometry with destination pixels.
+     *
+     * @param clip Optional geometry to clip this geometry with. Only path,
+     * transformation matrix and fill rule of clip geometry are used. It is
+     * transformed by the same matrix as geometries passed to Rasterize.
+     * Geometries pointing to the same clip geometry share its rasterized
+     * path. Clip of clip geometry is ignored.
+     *
+     * @param layer Optional layer this geometry is composited into, see
+     * Layer. Layer is not copied and must stay alive until geometry is
+     * rasterized.
+     *
+     * @param stroke Optional stroke. If not nullptr, outline of path stroke
+     * is filled with non-zero fill rule instead of path itself and rule is
+     * ignored. Stroke is not copied and must stay alive until geometry is
+     * rasterized. Stroke of clip geometry is ignored.
      */
     Geometry(const IntRect &pathBounds, const PathTag *tags,
         const FloatPoint *points, const Matrix &tm, const int tagCount,
-        const int pointCount, const uint32 color, const FillRule rule);
+        const int pointCount, const uint32 color, const FillRule rule,
+        const ::Paint *paint = nullptr,
+        const BlendMode mode = BlendMode::SourceOver,
+        const Geometry *clip = nullptr,
+        const ::Layer *layer = nullptr,
+        const ::Stroke *stroke = nullptr);
 
 
     const IntRect PathBounds;
@@ -47,4 +77,9 @@ struct Geometry final {
     const int PointCount = 0;
     const uint32 Color = 0;
     const FillRule Rule = FillRule::NonZero;
+    const ::Paint *Paint = nullptr;
+    const BlendMode Mode = BlendMode::SourceOver;
+    const Geometry *Clip = nullptr;
+    const ::Layer *Layer = nullptr;
+    const ::Stroke *Stroke = nullptr;
 };
@@ -0,0 +1,42 @@
+#pragma once
+
+
+#include "BlendMode.h"
+#include "Utils.h"
+
+
+/**
+ * Isolated group of geometries. Geometries of a layer are composited into
+ * transparent scratch pixels first, and the result is then composited into
+ * destination image with layer opacity and blend mode, as if the whole group
+ * was a single geometry. Scratch pixels only span one tile row, so layers
+ * do not need an offscreen image.
+ *
+ * Consecutive geometries pointing to the same layer form one group. Group
+ * begins with the first of them and ends with the last one. Geometries
+ * pointing to the same layer further in geometry array form another group.
+ * Layers do not nest.
+ *
+ * Layer only changes destination pixels where its scratch pixels are not
+ * fully transparent.
+ */
+struct Layer final {
+
+    /**
+     * Constructs layer.
+     *
+     * @param opacity Opacity of the whole group, in range 0-255.
+     *
+     * @param mode Blend mode to combine group with destination pixels.
+     */
+    constexpr explicit Layer(const uint8 opacity,
+        const BlendMode mode = BlendMode::SourceOver)
+    :   Opacity(opacity),
+        Mode(mode)
+    {
+    }
+
+
+    const uint8 Opacity = 255;
+    const BlendMode Mode = BlendMode::SourceOver;
+};
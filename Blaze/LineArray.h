@@ -3,6 +3,7 @@
 
 
 // Class declarations.
+#include "LineArrayDelta.h"
 #include "LineArrayTiled.h"
 #include "LineArrayX16Y16.h"
 #include "LineArrayX32Y16.h"
@@ -12,6 +13,7 @@
 #include "ThreadMemory.h"
 
 // Method implementations for line arrays.
+#include "LineArrayDeltaInlines.h"
 #include "LineArrayTiledInlines.h"
 #include "LineArrayX16Y16Inlines.h"
 #include "LineArrayX32Y16Inlines.h"
@@ -0,0 +1,93 @@
+
+#pragma once
+
+
+#include "F8Dot8.h"
+#include "F24Dot8.h"
+#include "TileBounds.h"
+
+
+class ThreadMemory;
+
+
+/**
+ * Block of lines encoded as a stream of 16 bit words. Linearizer emits lines
+ * of each contour one after another, so most lines start where the previous
+ * line in the same row ended. Such line is stored as two words, Y delta
+ * followed by X delta. Any other line is stored as escape record of seven
+ * words: zero (Y delta of stored line is never zero), Y0, Y1, lower and upper
+ * halves of X0 and lower and upper halves of X1.
+ *
+ * The first line of each block is always stored as escape record, so each
+ * block can be decoded on its own.
+ */
+struct LineArrayDeltaBlock final {
+    constexpr explicit LineArrayDeltaBlock(LineArrayDeltaBlock *next)
+    :   Next(next)
+    {
+    }
+
+
+    static constexpr int WordsPerBlock = 122;
+    static constexpr int WordsPerContinuation = 2;
+    static constexpr int WordsPerEscape = 7;
+
+    // Maximum number of lines one block can contain.
+    static constexpr int MaximumLinesPerBlock =
+        1 + ((WordsPerBlock - WordsPerEscape) / WordsPerContinuation);
+
+
+    int16 Words[WordsPerBlock];
+
+    // A number of lines in this block. Only valid when this block is not the
+    // front block of its row. For front block, use
+    // LineArrayDelta::GetFrontBlockLineCount.
+    int32 LineCount;
+
+    // Pointer to the next block of lines in the same row.
+    LineArrayDeltaBlock *Next = nullptr;
+private:
+    LineArrayDeltaBlock() = delete;
+private:
+    DISABLE_COPY_AND_ASSIGN(LineArrayDeltaBlock);
+};
+
+
+struct LineArrayDelta final {
+    LineArrayDelta() {
+    }
+
+public:
+
+    static void Construct(LineArrayDelta *placement,
+        const TileIndex rowCount, const TileIndex columnCount,
+        ThreadMemory &memory);
+
+    LineArrayDeltaBlock *GetFrontBlock() const;
+    int GetFrontBlockLineCount() const;
+
+public:
+
+    void AppendVerticalLine(ThreadMemory &memory, const F24Dot8 x, const F24Dot8 y0, const F24Dot8 y1);
+    void AppendLineDownR_V(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
+    void AppendLineUpR_V(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
+    void AppendLineDownL_V(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
+    void AppendLineUpL_V(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
+    void AppendLineDownRL(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
+    void AppendLineUpRL(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
+
+private:
+    void AppendLine(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
+    void AppendEscape(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
+private:
+    LineArrayDeltaBlock *mCurrent = nullptr;
+    int mWordCount = LineArrayDeltaBlock::WordsPerBlock;
+    int mLineCount = 0;
+
+    // End point of the last line. Y is never negative for stored lines, so
+    // initial value never matches start of any line.
+    F24Dot8 mX = 0;
+    F24Dot8 mY = -1;
+private:
+    DISABLE_COPY_AND_ASSIGN(LineArrayDelta);
+};
@@ -0,0 +1,127 @@
+
+#pragma once
+
+
+FORCE_INLINE void LineArrayDelta::Construct(LineArrayDelta *placement,
+    const TileIndex rowCount, const TileIndex, ThreadMemory &)
+{
+    ASSERT(placement != nullptr);
+    ASSERT(rowCount > 0);
+
+    for (TileIndex i = 0; i < rowCount; i++) {
+        new (placement + i) LineArrayDelta();
+    }
+}
+
+
+FORCE_INLINE LineArrayDeltaBlock *LineArrayDelta::GetFrontBlock() const {
+    return mCurrent;
+}
+
+
+FORCE_INLINE int LineArrayDelta::GetFrontBlockLineCount() const {
+    return mLineCount;
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendVerticalLine(ThreadMemory &memory, const F24Dot8 x, const F24Dot8 y0, const F24Dot8 y1) {
+    AppendLine(memory, x, y0, x, y1);
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendLineDownR_V(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1) {
+    AppendLine(memory, x0, y0, x1, y1);
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendLineUpR_V(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1) {
+    AppendLine(memory, x0, y0, x1, y1);
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendLineDownL_V(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1) {
+    AppendLine(memory, x0, y0, x1, y1);
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendLineUpL_V(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1)  {
+    AppendLine(memory, x0, y0, x1, y1);
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendLineDownRL(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1)  {
+    AppendLine(memory, x0, y0, x1, y1);
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendLineUpRL(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1)  {
+    AppendLine(memory, x0, y0, x1, y1);
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendLine(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1) {
+    if (y0 == y1) {
+        return;
+    }
+
+    const F24Dot8 dx = x1 - x0;
+    const int count = mWordCount;
+
+    if (x0 == mX and y0 == mY and dx >= -32768 and dx <= 32767 and
+        count <= (LineArrayDeltaBlock::WordsPerBlock -
+            LineArrayDeltaBlock::WordsPerContinuation))
+    {
+        // Most common, line continues the previous one.
+        int16 *w = mCurrent->Words + count;
+
+        w[0] = int16(y1 - y0);
+        w[1] = int16(dx);
+
+        mWordCount = count + LineArrayDeltaBlock::WordsPerContinuation;
+        mLineCount++;
+        mX = x1;
+        mY = y1;
+    } else {
+        AppendEscape(memory, x0, y0, x1, y1);
+    }
+}
+
+
+FORCE_INLINE void LineArrayDelta::AppendEscape(ThreadMemory &memory, const F24Dot8 x0, const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1) {
+    ASSERT(y0 != y1);
+
+    int count = mWordCount;
+
+    if (count > (LineArrayDeltaBlock::WordsPerBlock -
+        LineArrayDeltaBlock::WordsPerEscape))
+    {
+        LineArrayDeltaBlock *current = mCurrent;
+
+        if (current != nullptr) {
+            current->LineCount = mLineCount;
+        }
+
+        mCurrent = memory.FrameNewDeltaBlock(current);
+        mLineCount = 0;
+
+        count = 0;
+    }
+
+    int16 *w = mCurrent->Words + count;
+
+    const uint32 ux0 = uint32(x0);
+    const uint32 ux1 = uint32(x1);
+
+    w[0] = 0;
+    w[1] = int16(y0);
+    w[2] = int16(y1);
+    w[3] = int16(uint16(ux0));
+    w[4] = int16(uint16(ux0 >> 16));
+    w[5] = int16(uint16(ux1));
+    w[6] = int16(uint16(ux1 >> 16));
+
+    mWordCount = count + LineArrayDeltaBlock::WordsPerEscape;
+    mLineCount++;
+    mX = x1;
+    mY = y1;
+}
@@ -56,7 +56,8 @@ void LineBlockAllocator::NewArena()
 
     mCurrent = p->Memory + SIZE_OF(Arena::Links);
     mEnd = p->Memory + Arena::Size -
-        Max3(SIZE_OF(LineArrayX32Y16Block),
+        Max4(SIZE_OF(LineArrayX32Y16Block),
              SIZE_OF(LineArrayX16Y16Block),
-             SIZE_OF(LineArrayTiledBlock));
+             SIZE_OF(LineArrayTiledBlock),
+             SIZE_OF(LineArrayDeltaBlock));
 }
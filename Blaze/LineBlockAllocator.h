@@ -2,6 +2,7 @@
 #pragma once
 
 
+#include "LineArrayDelta.h"
 #include "LineArrayTiled.h"
 #include "LineArrayX16Y16.h"
 #include "LineArrayX32Y16.h"
@@ -38,6 +39,13 @@ public:
     LineArrayX32Y16Block *NewX32Y16Block(LineArrayX32Y16Block *next);
 
 
+    /**
+     * Returns new delta encoded line array block. Returned memory is not
+     * zero-filled.
+     */
+    LineArrayDeltaBlock *NewDeltaBlock(LineArrayDeltaBlock *next);
+
+
     /**
      * Resets this allocator to initial state. Should be called
      * after frame ends.
@@ -51,6 +59,7 @@ private:
     STATIC_ASSERT(SIZE_OF(LineArrayTiledBlock) <= 1024);
     STATIC_ASSERT(SIZE_OF(LineArrayX16Y16Block) <= 1024);
     STATIC_ASSERT(SIZE_OF(LineArrayX32Y16Block) <= 1024);
+    STATIC_ASSERT(SIZE_OF(LineArrayDeltaBlock) <= 1024);
 
     // Points to the current arena.
     uint8 *mCurrent = nullptr;
@@ -107,6 +116,11 @@ FORCE_INLINE LineArrayX32Y16Block *LineBlockAllocator::NewX32Y16Block(LineArrayX
 }
 
 
+FORCE_INLINE LineArrayDeltaBlock *LineBlockAllocator::NewDeltaBlock(LineArrayDeltaBlock *next) {
+    return NewBlock<LineArrayDeltaBlock>(next);
+}
+
+
 template <typename T>
 FORCE_INLINE T *LineBlockAllocator::NewBlock(T *next) {
     uint8 *current = mCurrent;
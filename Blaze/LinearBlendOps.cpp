@@ -0,0 +1,42 @@
+
+#include "LinearBlendOps.h"
+
+
+static double SRGBToLinear(const double c) {
+    if (c <= 0.04045) {
+        return c / 12.92;
+    }
+
+    return Pow((c + 0.055) / 1.055, 2.4);
+}
+
+
+static double LinearToSRGB(const double c) {
+    if (c <= 0.0031308) {
+        return c * 12.92;
+    }
+
+    return (1.055 * Pow(c, 1.0 / 2.4)) - 0.055;
+}
+
+
+static SRGBLookupTables CreateSRGBLookupTables() {
+    SRGBLookupTables tables = {};
+
+    for (int i = 0; i < 256; i++) {
+        tables.ToLinear[i] = uint16(Round(SRGBToLinear(double(i) / 255.0) *
+            double(LinearComponentMaximum)));
+    }
+
+    for (int i = 0; i <= LinearComponentMaximum; i++) {
+        tables.ToSRGB[i] = uint8(Round(LinearToSRGB(double(i) /
+            double(LinearComponentMaximum)) * 255.0));
+    }
+
+    return tables;
+}
+
+
+// Tables are filled during static initialization, before anything is
+// rasterized.
+const SRGBLookupTables SRGBTables = CreateSRGBLookupTables();
@@ -0,0 +1,216 @@
+#pragma once
+
+
+#include "BlendOps.h"
+#include "Utils.h"
+
+
+// Source over composition in linear light, see
+// RasterizerOptions::LinearBlending. Pixels are stored as premultiplied sRGB
+// encoded RGBA8 as usual. While compositing, color components are converted
+// to linear light with 12 bits of precision using lookup tables, blended and
+// converted back. Alpha is not encoded and is blended the same way as
+// always. Both tables together take a little over 4 kilobytes, so they stay
+// in L1 cache and can be read with vector gather instructions.
+
+
+/**
+ * Linear light components are stored in range 0-LinearComponentMaximum.
+ */
+static constexpr int32 LinearComponentMaximum = 4095;
+
+
+/**
+ * Lookup tables converting between sRGB encoded and linear light color
+ * components. Both tables have a few bytes of padding so that 32 bit gather
+ * loads of the last entry stay within the table.
+ */
+struct SRGBLookupTables final {
+
+    // Linear light value of each sRGB encoded component, rounded to the
+    // nearest value.
+    uint16 ToLinear[256 + 2];
+
+    // sRGB encoded value of each linear light component, rounded to the
+    // nearest value.
+    uint8 ToSRGB[LinearComponentMaximum + 1 + 4];
+};
+
+
+extern const SRGBLookupTables SRGBTables;
+
+
+/**
+ * Source color of a span prepared for compositing in linear light.
+ */
+struct LinearSpanSource final {
+
+    // Straight linear light components of source color multiplied by
+    // source alpha, red, green and blue.
+    uint32 Components[3] = {};
+
+    // Alpha of source color with span coverage applied and its inverse.
+    uint32 Alpha = 0;
+    uint32 InverseAlpha = 0;
+
+    // Result of compositing over fully transparent pixel. It does not depend
+    // on color space.
+    uint32 OverTransparent = 0;
+};
+
+
+/**
+ * Divides value by 255, rounding to the nearest. Values used by linear light
+ * blending do not exceed 255 × 4095, for these the result is within 1/16 of
+ * exact one before rounding and the multiplication does not overflow.
+ */
+static FORCE_INLINE uint32 LinearDiv255(const uint32 v) {
+    return (v * 257 + 32768) >> 16;
+}
+
+
+/**
+ * Composites one pixel in linear light.
+ */
+static FORCE_INLINE uint32 BlendSourceOverLinear(const uint32 d,
+    const LinearSpanSource &s)
+{
+    const uint32 da = d >> 24;
+
+    if (da == 0) {
+        return s.OverTransparent;
+    }
+
+    const uint16 *toLinear = SRGBTables.ToLinear;
+    const uint8 *toSRGB = SRGBTables.ToSRGB;
+
+    if (da == 255) {
+        // Opaque destination stays opaque and its components do not need
+        // to be unpremultiplied.
+        uint32 r = 0xff000000;
+
+        for (int i = 0; i < 3; i++) {
+            const uint32 c = toLinear[(d >> (i * 8)) & 0xff];
+
+            r |= uint32(toSRGB[LinearDiv255(s.Components[i] +
+                (c * s.InverseAlpha))]) << (i * 8);
+        }
+
+        return r;
+    }
+
+    const uint32 straight = UnpremultiplyAlpha(d);
+    const uint32 oa = s.Alpha + uint32(Mul255(int32(da),
+        int32(s.InverseAlpha)));
+
+    uint32 r = oa << 24;
+
+    for (int i = 0; i < 3; i++) {
+        const uint32 c = toLinear[(straight >> (i * 8)) & 0xff];
+
+        // Premultiplied result divided by result alpha.
+        const uint32 l = Min(((s.Components[i] * 255) +
+            (c * da * s.InverseAlpha) + ((oa * 255) >> 1)) / (oa * 255),
+            uint32(LinearComponentMaximum));
+
+        r |= uint32(Mul255(toSRGB[l], int32(oa))) << (i * 8);
+    }
+
+    return r;
+}
+
+
+/**
+ * Composites span of pixels in linear light, using vector instructions for
+ * longer spans if available.
+ */
+static FORCE_INLINE void BlendSpanSourceOverLinear(const int pos, const int end, uint32 *d, const LinearSpanSource &s) {
+#ifdef RUNTIME_DISPATCH
+    if ((end - pos) >= 8 and Dispatch.BlendSpanSourceOverLinear != nullptr) {
+        Dispatch.BlendSpanSourceOverLinear(pos, end, d, s);
+        return;
+    }
+#endif
+
+    // Destination often has runs of the same color, composite each run
+    // once.
+    uint32 previous = d[pos];
+    uint32 previousResult = BlendSourceOverLinear(previous, s);
+
+    for (int x = pos; x < end; x++) {
+        const uint32 v = d[x];
+
+        if (v != previous) {
+            previous = v;
+            previousResult = BlendSourceOverLinear(v, s);
+        }
+
+        d[x] = previousResult;
+    }
+}
+
+
+/**
+ * Span blender compositing geometry color with source over operator in
+ * linear light. Works with both opaque and translucent colors.
+ */
+struct SpanBlenderLinear final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = false;
+
+
+    explicit SpanBlenderLinear(const uint32 color);
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+
+    const uint32 Color = 0;
+
+    // Straight linear light components of color, red, green and blue.
+    uint16 Linear[3] = {};
+};
+
+
+FORCE_INLINE SpanBlenderLinear::SpanBlenderLinear(const uint32 color)
+:   Color(color)
+{
+    const uint32 straight = UnpremultiplyAlpha(color);
+
+    for (int i = 0; i < 3; i++) {
+        Linear[i] = SRGBTables.ToLinear[(straight >> (i * 8)) & 0xff];
+    }
+}
+
+
+FORCE_INLINE void SpanBlenderLinear::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+    ASSERT(alpha <= 255);
+
+    const uint32 ca = Color >> 24;
+    const uint32 sa = alpha == 255 ? ca :
+        uint32(Mul255(int32(ca), alpha));
+
+    if (sa == 255) {
+        // Solid span, write only.
+        FillSpanWide(d, pos, end, Color);
+        return;
+    }
+
+    if (sa == 0) {
+        return;
+    }
+
+    LinearSpanSource s;
+
+    for (int i = 0; i < 3; i++) {
+        s.Components[i] = uint32(Linear[i]) * sa;
+    }
+
+    s.Alpha = sa;
+    s.InverseAlpha = 255 - sa;
+    s.OverTransparent = ApplyAlpha(Color, alpha);
+
+    BlendSpanSourceOverLinear(pos, end, d, s);
+}
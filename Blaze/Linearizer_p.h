@@ -8,6 +8,7 @@
 #include "Geometry.h"
 #include "LinearizerUtils.h"
 #include "SIMD.h"
+#include "Stroker.h"
 #include "ThreadMemory.h"
 #include "TileBounds.h"
 
@@ -114,6 +115,15 @@ private:
         const Matrix &matrix);
 
 
+    /**
+     * Processes outline of geometry stroke. Outline polygons are produced by
+     * Stroker one by one and each one is clipped the same way as
+     * ProcessUncontained clips lines.
+     */
+    void ProcessStroke(const Geometry *geometry, ThreadMemory &memory,
+        const ClipBounds &clip, const Matrix &matrix);
+
+
     void AddUncontainedLine(ThreadMemory &memory, const ClipBounds &clip,
         const FloatPoint p0, const FloatPoint p1);
 
@@ -305,6 +315,18 @@ private:
 
 private:
 
+    /**
+     * Receives stroke outline polygons from Stroker and adds their edges.
+     */
+    struct StrokeSink final {
+        void AddPolygon(const FloatPoint *points, const int count);
+
+        Linearizer *Target = nullptr;
+        ThreadMemory &Memory;
+        const ClipBounds &Clip;
+    };
+
+
     // Initialized at the beginning, does not change later.
     const TileBounds mBounds;
 
@@ -327,7 +349,9 @@ FORCE_INLINE Linearizer<T, L> *Linearizer<T, L>::Create(ThreadMemory &memory, co
 
     L::Construct(linearizer->mLA, bounds.RowCount, bounds.ColumnCount, memory);
 
-    if (contains) {
+    // Stroke outline extends past path points, it always goes through
+    // clipping.
+    if (contains and geometry->Stroke == nullptr) {
         linearizer->ProcessContained(geometry, memory);
     } else {
         const int tx = T::TileColumnIndexToPoints(bounds.X);
@@ -340,7 +364,11 @@ FORCE_INLINE Linearizer<T, L> *Linearizer<T, L>::Create(ThreadMemory &memory, co
         Matrix matrix(geometry->TM);
         matrix.PreTranslate(-tx, -ty);
 
-        linearizer->ProcessUncontained(geometry, memory, clip, matrix);
+        if (geometry->Stroke != nullptr) {
+            linearizer->ProcessStroke(geometry, memory, clip, matrix);
+        } else {
+            linearizer->ProcessUncontained(geometry, memory, clip, matrix);
+        }
     }
 
     return linearizer;
@@ -529,6 +557,34 @@ FORCE_INLINE void Linearizer<T, L>::ProcessUncontained(const Geometry *geometry,
 }
 
 
+template <typename T, typename L>
+FORCE_INLINE void Linearizer<T, L>::ProcessStroke(const Geometry *geometry,
+    ThreadMemory &memory, const ClipBounds &clip, const Matrix &matrix)
+{
+    StrokeSink sink { this, memory, clip };
+
+    Stroker<StrokeSink> stroker(sink, *geometry->Stroke, matrix);
+
+    stroker.StrokePath(geometry->Tags, geometry->Points, geometry->TagCount);
+}
+
+
+template <typename T, typename L>
+FORCE_INLINE void Linearizer<T, L>::StrokeSink::AddPolygon(
+    const FloatPoint *points, const int count)
+{
+    ASSERT(points != nullptr);
+    ASSERT(count > 0);
+
+    FloatPoint previous = points[count - 1];
+
+    for (int i = 0; i < count; i++) {
+        Target->AddUncontainedLine(Memory, Clip, previous, points[i]);
+        previous = points[i];
+    }
+}
+
+
 template <typename T, typename L>
 FORCE_INLINE void Linearizer<T, L>::AddUncontainedLine(ThreadMemory &memory,
     const ClipBounds &clip, const FloatPoint p0, const FloatPoint p1)
@@ -1931,8 +1987,8 @@ FORCE_INLINE void Linearizer<T, L>::LineDownR(ThreadMemory &memory,
     const F24Dot8 fy0 = p0.Y - T::TileRowIndexToF24Dot8(rowIndex0);
     const F24Dot8 fy1 = p1.Y - T::TileRowIndexToF24Dot8(rowIndex1);
 
-    F24Dot8 p = (T::TileHF24Dot8 - fy0) * dx;
-    F24Dot8 delta = p / dy;
+    int64 p = int64(T::TileHF24Dot8 - fy0) * dx;
+    F24Dot8 delta = F24Dot8(p / dy);
 
     F24Dot8 cx = p0.X + delta;
 
@@ -1941,12 +1997,12 @@ FORCE_INLINE void Linearizer<T, L>::LineDownR(ThreadMemory &memory,
     TileIndex idy = rowIndex0 + 1;
 
     if (idy != rowIndex1) {
-        F24Dot8 mod = (p % dy) - dy;
+        F24Dot8 mod = F24Dot8(p % dy) - dy;
 
-        p = T::TileHF24Dot8 * dx;
+        p = int64(T::TileHF24Dot8) * dx;
 
-        F24Dot8 lift = p / dy;
-        F24Dot8 rem = p % dy;
+        F24Dot8 lift = F24Dot8(p / dy);
+        F24Dot8 rem = F24Dot8(p % dy);
 
         for ( ; idy != rowIndex1; idy++) {
             delta = lift;
@@ -1982,8 +2038,8 @@ FORCE_INLINE void Linearizer<T, L>::LineUpR(ThreadMemory &memory,
     const F24Dot8 fy0 = p0.Y - T::TileRowIndexToF24Dot8(rowIndex0);
     const F24Dot8 fy1 = p1.Y - T::TileRowIndexToF24Dot8(rowIndex1);
 
-    F24Dot8 p = fy0 * dx;
-    F24Dot8 delta = p / dy;
+    int64 p = int64(fy0) * dx;
+    F24Dot8 delta = F24Dot8(p / dy);
 
     F24Dot8 cx = p0.X + delta;
 
@@ -1992,12 +2048,12 @@ FORCE_INLINE void Linearizer<T, L>::LineUpR(ThreadMemory &memory,
     TileIndex idy = rowIndex0 - 1;
 
     if (idy != rowIndex1) {
-        F24Dot8 mod = (p % dy) - dy;
+        F24Dot8 mod = F24Dot8(p % dy) - dy;
 
-        p = T::TileHF24Dot8 * dx;
+        p = int64(T::TileHF24Dot8) * dx;
 
-        F24Dot8 lift = p / dy;
-        F24Dot8 rem = p % dy;
+        F24Dot8 lift = F24Dot8(p / dy);
+        F24Dot8 rem = F24Dot8(p % dy);
 
         for ( ; idy != rowIndex1; idy--) {
             delta = lift;
@@ -2032,8 +2088,8 @@ FORCE_INLINE void Linearizer<T, L>::LineDownL(ThreadMemory &memory,
     const F24Dot8 fy0 = p0.Y - T::TileRowIndexToF24Dot8(rowIndex0);
     const F24Dot8 fy1 = p1.Y - T::TileRowIndexToF24Dot8(rowIndex1);
 
-    F24Dot8 p = (T::TileHF24Dot8 - fy0) * dx;
-    F24Dot8 delta = p / dy;
+    int64 p = int64(T::TileHF24Dot8 - fy0) * dx;
+    F24Dot8 delta = F24Dot8(p / dy);
 
     F24Dot8 cx = p0.X - delta;
 
@@ -2042,12 +2098,12 @@ FORCE_INLINE void Linearizer<T, L>::LineDownL(ThreadMemory &memory,
     TileIndex idy = rowIndex0 + 1;
 
     if (idy != rowIndex1) {
-        F24Dot8 mod = (p % dy) - dy;
+        F24Dot8 mod = F24Dot8(p % dy) - dy;
 
-        p = T::TileHF24Dot8 * dx;
+        p = int64(T::TileHF24Dot8) * dx;
 
-        F24Dot8 lift = p / dy;
-        F24Dot8 rem = p % dy;
+        F24Dot8 lift = F24Dot8(p / dy);
+        F24Dot8 rem = F24Dot8(p % dy);
 
         for ( ; idy != rowIndex1; idy++) {
             delta = lift;
@@ -2082,8 +2138,8 @@ FORCE_INLINE void Linearizer<T, L>::LineUpL(ThreadMemory &memory,
     const F24Dot8 fy0 = p0.Y - T::TileRowIndexToF24Dot8(rowIndex0);
     const F24Dot8 fy1 = p1.Y - T::TileRowIndexToF24Dot8(rowIndex1);
 
-    F24Dot8 p = fy0 * dx;
-    F24Dot8 delta = p / dy;
+    int64 p = int64(fy0) * dx;
+    F24Dot8 delta = F24Dot8(p / dy);
 
     F24Dot8 cx = p0.X - delta;
 
@@ -2092,12 +2148,12 @@ FORCE_INLINE void Linearizer<T, L>::LineUpL(ThreadMemory &memory,
     TileIndex idy = rowIndex0 - 1;
 
     if (idy != rowIndex1) {
-        F24Dot8 mod = (p % dy) - dy;
+        F24Dot8 mod = F24Dot8(p % dy) - dy;
 
-        p = T::TileHF24Dot8 * dx;
+        p = int64(T::TileHF24Dot8) * dx;
 
-        F24Dot8 lift = p / dy;
-        F24Dot8 rem = p % dy;
+        F24Dot8 lift = F24Dot8(p / dy);
+        F24Dot8 rem = F24Dot8(p % dy);
 
         for ( ; idy != rowIndex1; idy--) {
             delta = lift;
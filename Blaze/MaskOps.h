@@ -0,0 +1,179 @@
+#pragma once
+
+
+#include "BlendOps.h"
+#include "Utils.h"
+
+
+// Span writers for 8 bit coverage masks, see RasterizeMask. Each destination
+// pixel is a single byte holding coverage, or alpha, of geometries written
+// into it. Writers have the same interface as span blenders, so they are
+// used by the same row rendering functions. Rendering functions only pass
+// destination scanline pointer through to span blender without indexing it,
+// so writers reinterpret it as pointer to bytes. Color of each geometry only
+// contributes its alpha.
+
+
+/**
+ * Returns coverage of span scaled by alpha of geometry color.
+ */
+static FORCE_INLINE int32 MaskSpanAlpha(const int32 alpha,
+    const uint32 colorAlpha)
+{
+    ASSERT(alpha <= 255);
+    ASSERT(colorAlpha <= 255);
+
+    if (colorAlpha == 255) {
+        return alpha;
+    }
+
+    return Mul255(alpha, int32(colorAlpha));
+}
+
+
+/**
+ * Keeps the larger of destination and source coverage. Result does not
+ * depend on the order geometries are written in. Suitable for glyph atlases
+ * where glyph outlines overlap themselves.
+ */
+struct SpanWriterMaskMax final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = false;
+    static constexpr bool SingleBlender = true;
+    static constexpr int BytesPerPixel = 1;
+    static constexpr int32 MaximumAlpha = 255;
+
+
+    constexpr explicit SpanWriterMaskMax(const uint32 color)
+    :   Alpha(color >> 24)
+    {
+    }
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+
+    const uint32 Alpha = 0;
+};
+
+
+FORCE_INLINE void SpanWriterMaskMax::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    uint8 *p = reinterpret_cast<uint8 *>(d);
+
+    const int32 a = MaskSpanAlpha(alpha, Alpha);
+
+    if (a == 255) {
+        memset(p + pos, 255, end - pos);
+        return;
+    }
+
+    const uint8 s = uint8(a);
+
+    for (int x = pos; x < end; x++) {
+        p[x] = Max(p[x], s);
+    }
+}
+
+
+STATIC_ASSERT(SIZE_OF(SpanWriterMaskMax) == 4);
+
+
+/**
+ * Adds source coverage to destination, saturating at 255. Result does not
+ * depend on the order geometries are written in. Suitable for accumulating
+ * density, for example heat maps.
+ */
+struct SpanWriterMaskAdd final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = false;
+    static constexpr bool SingleBlender = true;
+    static constexpr int BytesPerPixel = 1;
+    static constexpr int32 MaximumAlpha = 255;
+
+
+    constexpr explicit SpanWriterMaskAdd(const uint32 color)
+    :   Alpha(color >> 24)
+    {
+    }
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+
+    const uint32 Alpha = 0;
+};
+
+
+FORCE_INLINE void SpanWriterMaskAdd::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    uint8 *p = reinterpret_cast<uint8 *>(d);
+
+    const int32 a = MaskSpanAlpha(alpha, Alpha);
+
+    if (a == 255) {
+        memset(p + pos, 255, end - pos);
+        return;
+    }
+
+    for (int x = pos; x < end; x++) {
+        p[x] = uint8(Min(int32(p[x]) + a, 255));
+    }
+}
+
+
+STATIC_ASSERT(SIZE_OF(SpanWriterMaskAdd) == 4);
+
+
+/**
+ * Composites source coverage over destination, the same way source over
+ * operator composites alpha channel of color images. Suitable for shadows
+ * and clip masks built out of several translucent shapes.
+ */
+struct SpanWriterMaskSourceOver final {
+    static constexpr bool UsesShader = false;
+    static constexpr bool UsesBlendMode = false;
+    static constexpr bool SingleBlender = true;
+    static constexpr int BytesPerPixel = 1;
+    static constexpr int32 MaximumAlpha = 255;
+
+
+    constexpr explicit SpanWriterMaskSourceOver(const uint32 color)
+    :   Alpha(color >> 24)
+    {
+    }
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+
+    const uint32 Alpha = 0;
+};
+
+
+FORCE_INLINE void SpanWriterMaskSourceOver::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+
+    uint8 *p = reinterpret_cast<uint8 *>(d);
+
+    const int32 a = MaskSpanAlpha(alpha, Alpha);
+
+    if (a == 255) {
+        memset(p + pos, 255, end - pos);
+        return;
+    }
+
+    const int32 ia = 255 - a;
+
+    for (int x = pos; x < end; x++) {
+        p[x] = uint8(a + Mul255(int32(p[x]), ia));
+    }
+}
+
+
+STATIC_ASSERT(SIZE_OF(SpanWriterMaskSourceOver) == 4);
@@ -0,0 +1,134 @@
+
+#include "Paint.h"
+
+
+static bool StopsAreOpaque(const GradientStop *stops, const int stopCount) {
+    for (int i = 0; i < stopCount; i++) {
+        if (stops[i].Color < 0xff000000) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static bool ImageIsOpaque(const ImageData &image) {
+    for (int y = 0; y < image.Height; y++) {
+        const uint32 *row = reinterpret_cast<const uint32 *>(
+            image.Data + (y * image.BytesPerRow));
+
+        for (int x = 0; x < image.Width; x++) {
+            if (row[x] < 0xff000000) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Interpolates each channel of two colors. Result is rounded to the closest
+ * value.
+ */
+static uint32 LerpColor(const uint32 c0, const uint32 c1, const double t) {
+    uint32 result = 0;
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        const double a = double((c0 >> shift) & 0xff);
+        const double b = double((c1 >> shift) & 0xff);
+        const uint32 c = uint32(Clamp(a + ((b - a) * t) + 0.5, 0.0, 255.0));
+
+        result |= c << shift;
+    }
+
+    return result;
+}
+
+
+Paint Paint::CreateLinearGradient(const FloatPoint &start,
+    const FloatPoint &end, const GradientStop *stops, const int stopCount,
+    const PaintSpread spread)
+{
+    return Paint(PaintType::LinearGradient, spread, start, end, 0, stops,
+        stopCount);
+}
+
+
+Paint Paint::CreateRadialGradient(const FloatPoint &center,
+    const double radius, const GradientStop *stops, const int stopCount,
+    const PaintSpread spread)
+{
+    ASSERT(radius > 0);
+
+    return Paint(PaintType::RadialGradient, spread, center, center, radius,
+        stops, stopCount);
+}
+
+
+Paint Paint::CreateImagePattern(const ImageData &image,
+    const Matrix &transform, const ImageFilter filter,
+    const PaintSpread spread)
+{
+    return Paint(image, transform, filter, spread);
+}
+
+
+Paint::Paint(const PaintType type, const PaintSpread spread,
+    const FloatPoint &start, const FloatPoint &end, const double radius,
+    const GradientStop *stops, const int stopCount)
+:   Type(type),
+    Spread(spread),
+    Opaque(StopsAreOpaque(stops, stopCount)),
+    Start(start),
+    End(end),
+    Radius(radius)
+{
+    ASSERT(stops != nullptr);
+    ASSERT(stopCount > 0);
+
+    int next = 0;
+
+    for (int i = 0; i < LutSize; i++) {
+        const double t = double(i) / double(LutSize - 1);
+
+        // Find the first stop beyond current position.
+        while (next < stopCount and stops[next].Offset <= t) {
+            ASSERT(next == 0 or stops[next - 1].Offset <= stops[next].Offset);
+
+            next++;
+        }
+
+        if (next == 0) {
+            Lut[i] = stops[0].Color;
+        } else if (next == stopCount) {
+            Lut[i] = stops[stopCount - 1].Color;
+        } else {
+            const GradientStop &s0 = stops[next - 1];
+            const GradientStop &s1 = stops[next];
+
+            Lut[i] = LerpColor(s0.Color, s1.Color,
+                (t - s0.Offset) / (s1.Offset - s0.Offset));
+        }
+    }
+}
+
+
+Paint::Paint(const ImageData &image, const Matrix &transform,
+    const ImageFilter filter, const PaintSpread spread)
+:   Type(PaintType::ImagePattern),
+    Spread(spread),
+    Filter(filter),
+    Opaque(ImageIsOpaque(image)),
+    Transform(transform),
+    Pixels(reinterpret_cast<const uint32 *>(image.Data)),
+    ImageWidth(image.Width),
+    ImageHeight(image.Height),
+    PixelsPerRow(image.BytesPerRow / 4)
+{
+    ASSERT(image.Data != nullptr);
+    ASSERT((image.BytesPerRow & 3) == 0);
+    ASSERT(image.BytesPerRow >= (image.Width * 4));
+}
@@ -0,0 +1,208 @@
+
+#pragma once
+
+
+#include "FloatPoint.h"
+#include "ImageData.h"
+#include "Matrix.h"
+#include "Utils.h"
+
+
+/**
+ * Determines how paint finds color of each pixel.
+ */
+enum class PaintType : uint8 {
+
+    /**
+     * Color changes along the line from start point to end point and stays
+     * the same on lines perpendicular to it.
+     */
+    LinearGradient = 0,
+
+    /**
+     * Color changes with the distance from center point and reaches the last
+     * stop on circle of a given radius.
+     */
+    RadialGradient,
+
+    /**
+     * Color is sampled from image.
+     */
+    ImagePattern
+};
+
+
+/**
+ * Determines how paint fills area outside of range from the first to the
+ * last gradient stop or outside of image bounds.
+ */
+enum class PaintSpread : uint8 {
+
+    /**
+     * Area outside of gradient range is filled with the color of the closest
+     * end of gradient. Area outside of image is filled with the closest edge
+     * pixel.
+     */
+    Pad = 0,
+
+    /**
+     * Gradient or image is repeated.
+     */
+    Repeat,
+
+    /**
+     * Gradient or image is repeated, every other repetition is mirrored.
+     */
+    Reflect
+};
+
+
+/**
+ * Determines how image pattern is sampled.
+ */
+enum class ImageFilter : uint8 {
+
+    /**
+     * Each pixel takes color of the closest image pixel.
+     */
+    Nearest = 0,
+
+    /**
+     * Each pixel takes color interpolated from four closest image pixels.
+     */
+    Bilinear
+};
+
+
+/**
+ * Color at a given position of gradient.
+ */
+struct GradientStop final {
+
+    // Position of stop, in range 0-1.
+    double Offset = 0;
+
+    // RGBA color, 8 bits per channel, color components premultiplied by
+    // alpha.
+    uint32 Color = 0;
+};
+
+
+/**
+ * Gradient or image which can be used to fill geometry instead of solid
+ * color. Paint is transformed together with path. Gradient coordinates are
+ * in the same coordinate system as path points, image has its own
+ * transformation matrix mapping image pixels to path coordinates.
+ *
+ * Gradient colors are interpolated when paint is created, rasterizer only
+ * needs to find lookup table entry of each pixel.
+ */
+struct Paint final {
+
+    /**
+     * A number of colors in gradient lookup table.
+     */
+    static constexpr int LutSize = 256;
+
+
+    /**
+     * Creates linear gradient.
+     *
+     * @param start Point where gradient has color of position 0.
+     *
+     * @param end Point where gradient has color of position 1. Must not be
+     * equal to start.
+     *
+     * @param stops Pointer to color stops, sorted by offset. Must not be
+     * nullptr.
+     *
+     * @param stopCount A number of color stops. Must be greater than 0.
+     *
+     * @param spread Determines how area outside of gradient range is filled.
+     */
+    static Paint CreateLinearGradient(const FloatPoint &start,
+        const FloatPoint &end, const GradientStop *stops, const int stopCount,
+        const PaintSpread spread = PaintSpread::Pad);
+
+
+    /**
+     * Creates radial gradient.
+     *
+     * @param center Center of gradient where it has color of position 0.
+     *
+     * @param radius Distance from center where gradient has color of
+     * position 1. Must be greater than 0.
+     *
+     * @param stops Pointer to color stops, sorted by offset. Must not be
+     * nullptr.
+     *
+     * @param stopCount A number of color stops. Must be greater than 0.
+     *
+     * @param spread Determines how area outside of gradient range is filled.
+     */
+    static Paint CreateRadialGradient(const FloatPoint &center,
+        const double radius, const GradientStop *stops, const int stopCount,
+        const PaintSpread spread = PaintSpread::Pad);
+
+
+    /**
+     * Creates image pattern. Image is not copied and must stay alive until
+     * geometries using this paint are rasterized.
+     *
+     * @param image Image to fill geometry with. Pixels must be RGBA, 8 bits
+     * per channel, color components premultiplied by alpha. Byte stride
+     * must be a multiple of 4.
+     *
+     * @param transform Transformation matrix mapping image pixel coordinates
+     * to path coordinates.
+     *
+     * @param filter Determines how image is sampled.
+     *
+     * @param spread Determines how area outside of image is filled.
+     */
+    static Paint CreateImagePattern(const ImageData &image,
+        const Matrix &transform,
+        const ImageFilter filter = ImageFilter::Bilinear,
+        const PaintSpread spread = PaintSpread::Repeat);
+
+
+    const PaintType Type = PaintType::LinearGradient;
+    const PaintSpread Spread = PaintSpread::Pad;
+    const ImageFilter Filter = ImageFilter::Nearest;
+
+    // True if every color of gradient or every pixel of image is opaque.
+    const bool Opaque = false;
+
+    // Transformation matrix mapping paint coordinates to path coordinates.
+    // Identity for gradients.
+    const Matrix Transform;
+
+    // Start point of linear gradient or center of radial gradient.
+    const FloatPoint Start;
+
+    // End point of linear gradient. Not used for radial gradient.
+    const FloatPoint End;
+
+    // Radius of radial gradient. Not used for linear gradient.
+    const double Radius = 0;
+
+    // Pixels of image pattern. Not used for gradients.
+    const uint32 *Pixels = nullptr;
+    const int ImageWidth = 0;
+    const int ImageHeight = 0;
+
+    // A number of pixels from the start of one image row to the next one.
+    const int PixelsPerRow = 0;
+
+    // Gradient colors at evenly spaced positions from 0 to 1, premultiplied
+    // by alpha. Not used for image pattern.
+    uint32 Lut[LutSize];
+
+private:
+    Paint(const PaintType type, const PaintSpread spread,
+        const FloatPoint &start, const FloatPoint &end, const double radius,
+        const GradientStop *stops, const int stopCount);
+
+    Paint(const ImageData &image, const Matrix &transform,
+        const ImageFilter filter, const PaintSpread spread);
+};
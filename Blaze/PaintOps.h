@@ -0,0 +1,545 @@
+
+#pragma once
+
+
+#include "BlendOps.h"
+#include "CompositionOps.h"
+#include "Matrix.h"
+#include "Paint.h"
+
+
+// Span shading of gradient and image paints. Paint coordinates of each pixel
+// are affine functions of pixel position, so they are calculated for several
+// pixels at once, converted to lookup table indices or image pixel positions
+// and composited with vector instructions. Lookup tables and images are read
+// one pixel at a time, since not every SIMD backend has gather instructions.
+
+
+/**
+ * Paint prepared for rendering one geometry. Paint coordinates are mapped
+ * from destination image coordinates, so they can be evaluated without
+ * transforming every pixel.
+ */
+struct PaintShader final {
+
+    // Colors of gradient, see Paint::Lut.
+    const uint32 *Lut = nullptr;
+
+    // Image pattern, see Paint::Pixels.
+    const uint32 *Pixels = nullptr;
+    int PixelsPerRow = 0;
+    float ImageWidth = 0;
+    float ImageHeight = 0;
+
+    // Paint coordinates of the center of pixel at x, y are U = UX * x + UY *
+    // y + U0 and V = VX * x + VY * y + V0. For linear gradient, U is position
+    // within gradient and V is not used. For radial gradient, position
+    // within gradient is the length of vector U, V. For image pattern, U and
+    // V are image pixel coordinates.
+    float UX = 0;
+    float UY = 0;
+    float U0 = 0;
+    float VX = 0;
+    float VY = 0;
+    float V0 = 0;
+
+    PaintType Type = PaintType::LinearGradient;
+    PaintSpread Spread = PaintSpread::Pad;
+    ImageFilter Filter = ImageFilter::Nearest;
+
+    // Kernel compositing shaded pixels with blend mode other than source
+    // over, nullptr for source over.
+    BlendPixelSpanKernel Blend = nullptr;
+};
+
+
+/**
+ * Prepares paint for rendering geometry transformed by a given matrix and
+ * composited using a given blend mode.
+ */
+static FORCE_INLINE void InitializePaintShader(PaintShader &shader,
+    const Paint &paint, const Matrix &matrix, const BlendMode mode)
+{
+    shader.Lut = paint.Lut;
+    shader.Pixels = paint.Pixels;
+    shader.PixelsPerRow = paint.PixelsPerRow;
+    shader.ImageWidth = float(paint.ImageWidth);
+    shader.ImageHeight = float(paint.ImageHeight);
+    shader.Type = paint.Type;
+    shader.Spread = paint.Spread;
+    shader.Filter = paint.Filter;
+    shader.Blend = mode == BlendMode::SourceOver ? nullptr :
+        GetBlendModeKernels(mode).CompositePixelSpan;
+
+    Matrix m(paint.Transform);
+
+    m.PreMultiply(matrix);
+
+    Matrix inverse;
+
+    if (not m.Invert(inverse)) {
+        // Geometry is degenerate and does not cover any pixels.
+        return;
+    }
+
+    // Map destination pixel center to paint coordinates.
+    const double ax = inverse.M11();
+    const double ay = inverse.M21();
+    const double a0 = inverse.M31() + ((ax + ay) * 0.5);
+    const double bx = inverse.M12();
+    const double by = inverse.M22();
+    const double b0 = inverse.M32() + ((bx + by) * 0.5);
+
+    switch (paint.Type) {
+        case PaintType::LinearGradient: {
+            // Project onto the line from start to end point.
+            const FloatPoint d = paint.End - paint.Start;
+            const double length = (d.X * d.X) + (d.Y * d.Y);
+
+            ASSERT(length > 0);
+
+            const double dx = d.X / length;
+            const double dy = d.Y / length;
+
+            shader.UX = float((ax * dx) + (bx * dy));
+            shader.UY = float((ay * dx) + (by * dy));
+            shader.U0 = float(((a0 - paint.Start.X) * dx) +
+                ((b0 - paint.Start.Y) * dy));
+            break;
+        }
+
+        case PaintType::RadialGradient: {
+            const double scale = 1.0 / paint.Radius;
+
+            shader.UX = float(ax * scale);
+            shader.UY = float(ay * scale);
+            shader.U0 = float((a0 - paint.Start.X) * scale);
+            shader.VX = float(bx * scale);
+            shader.VY = float(by * scale);
+            shader.V0 = float((b0 - paint.Start.Y) * scale);
+            break;
+        }
+
+        case PaintType::ImagePattern: {
+            shader.UX = float(ax);
+            shader.UY = float(ay);
+            shader.U0 = float(a0);
+            shader.VX = float(bx);
+            shader.VY = float(by);
+            shader.V0 = float(b0);
+            break;
+        }
+    }
+}
+
+
+/**
+ * Paint coordinates beyond this value are clamped to it. This keeps them
+ * within range of 32 bit integers when calculating lookup table index and
+ * keeps whole numbers exact when wrapping image coordinates. Repeated paint
+ * is not accurate that far from its start anyway.
+ */
+static constexpr float PaintMaxCoordinate = 4194304.0f;
+
+
+/**
+ * Converts position within gradient to lookup table index according to
+ * spread method.
+ */
+template <PaintSpread Spread>
+static FORCE_INLINE int32 GradientLutIndex(const float t) {
+    float p = Clamp(t, -PaintMaxCoordinate, PaintMaxCoordinate);
+
+    if constexpr (Spread == PaintSpread::Pad) {
+        p = Clamp(p, 0.0f, 1.0f);
+    } else if constexpr (Spread == PaintSpread::Repeat) {
+        p = p - floorf(p);
+    } else {
+        STATIC_ASSERT(Spread == PaintSpread::Reflect);
+
+        const float h = p * 0.5f;
+        const float f = h - floorf(h);
+
+        p = 1.0f - fabsf((f * 2.0f) - 1.0f);
+    }
+
+    return int32((p * float(Paint::LutSize - 1)) + 0.5f);
+}
+
+
+/**
+ * Finds color of pixel at x on scanline where gradient coordinates of the
+ * first pixel are u and v.
+ */
+template <PaintType Type, PaintSpread Spread>
+static FORCE_INLINE uint32 ShadeGradientPixel(const PaintShader &shader,
+    const int x, const float u, const float v)
+{
+    const float fx = float(x);
+    const float pu = (shader.UX * fx) + u;
+
+    if constexpr (Type == PaintType::LinearGradient) {
+        return shader.Lut[GradientLutIndex<Spread>(pu)];
+    } else {
+        STATIC_ASSERT(Type == PaintType::RadialGradient);
+
+        const float pv = (shader.VX * fx) + v;
+
+        return shader.Lut[GradientLutIndex<Spread>(
+            sqrtf((pu * pu) + (pv * pv)))];
+    }
+}
+
+
+/**
+ * Maps whole image pixel coordinate to range from 0 to size - 1 according to
+ * spread method. Both arguments are whole numbers not exceeding
+ * PaintMaxCoordinate, so every step is exact.
+ */
+template <PaintSpread Spread>
+static FORCE_INLINE float WrapImageCoordinate(const float c, const float size) {
+    if constexpr (Spread == PaintSpread::Pad) {
+        return Clamp(c, 0.0f, size - 1.0f);
+    } else if constexpr (Spread == PaintSpread::Repeat) {
+        return c - (floorf(c / size) * size);
+    } else {
+        STATIC_ASSERT(Spread == PaintSpread::Reflect);
+
+        const float period = size + size;
+        const float r = c - (floorf(c / period) * period);
+
+        if (r >= size) {
+            return period - 1.0f - r;
+        }
+
+        return r;
+    }
+}
+
+
+/**
+ * Interpolates each channel of two pixels. Weight is in range 0-255 and
+ * result is (a × (256 - w) + b × w) >> 8 for each channel.
+ */
+static FORCE_INLINE uint32 LerpPixels(const uint32 a, const uint32 b, const uint32 w) {
+    const uint64 a0 = ((uint64(a)) | ((uint64(a)) << 24)) & 0x00ff00ff00ff00ff;
+    const uint64 b0 = ((uint64(b)) | ((uint64(b)) << 24)) & 0x00ff00ff00ff00ff;
+    const uint64 c = (((a0 * (256 - w)) + (b0 * w)) >> 8) & 0x00ff00ff00ff00ff;
+
+    return (uint32(c)) | (uint32(c >> 24));
+}
+
+
+/**
+ * Finds color of pixel at x on scanline where image coordinates of the first
+ * pixel are u and v.
+ */
+template <ImageFilter Filter, PaintSpread Spread>
+static FORCE_INLINE uint32 ShadeImagePixel(const PaintShader &shader,
+    const int x, const float u, const float v)
+{
+    const float fx = float(x);
+
+    const float pu = Clamp((shader.UX * fx) + u, -PaintMaxCoordinate,
+        PaintMaxCoordinate);
+
+    const float pv = Clamp((shader.VX * fx) + v, -PaintMaxCoordinate,
+        PaintMaxCoordinate);
+
+    const float w = shader.ImageWidth;
+    const float h = shader.ImageHeight;
+    const uint32 *pixels = shader.Pixels;
+    const int stride = shader.PixelsPerRow;
+
+    if constexpr (Filter == ImageFilter::Nearest) {
+        const int ix = int(WrapImageCoordinate<Spread>(floorf(pu), w));
+        const int iy = int(WrapImageCoordinate<Spread>(floorf(pv), h));
+
+        return pixels[(iy * stride) + ix];
+    } else {
+        STATIC_ASSERT(Filter == ImageFilter::Bilinear);
+
+        // Pixel centers are at half-integer coordinates.
+        const float su = pu - 0.5f;
+        const float sv = pv - 0.5f;
+        const float fu = floorf(su);
+        const float fv = floorf(sv);
+        const uint32 wx = uint32((su - fu) * 256.0f);
+        const uint32 wy = uint32((sv - fv) * 256.0f);
+
+        const int x0 = int(WrapImageCoordinate<Spread>(fu, w));
+        const int x1 = int(WrapImageCoordinate<Spread>(fu + 1.0f, w));
+        const uint32 *row0 = pixels + (int(WrapImageCoordinate<Spread>(fv, h)) * stride);
+        const uint32 *row1 = pixels + (int(WrapImageCoordinate<Spread>(fv + 1.0f, h)) * stride);
+
+        return LerpPixels(LerpPixels(row0[x0], row0[x1], wx),
+            LerpPixels(row1[x0], row1[x1], wx), wy);
+    }
+}
+
+
+/**
+ * Composites one shaded pixel with coverage alpha using source over
+ * operator.
+ */
+static FORCE_INLINE uint32 CompositeShadedPixel(const uint32 d, const uint32 c, const int32 alpha) {
+    if (alpha < 255) {
+        return BlendSourceOver(d, ApplyAlpha(c, alpha));
+    }
+
+    return BlendSourceOver(d, c);
+}
+
+
+/**
+ * Composites gradient span one pixel at a time. Plain C++ version.
+ *
+ * @param u Gradient coordinate U of pixel at x = 0 on this scanline.
+ *
+ * @param v Gradient coordinate V of pixel at x = 0 on this scanline.
+ */
+template <PaintType Type, PaintSpread Spread>
+static FORCE_INLINE void CompositeGradientSpan_generic(const int pos,
+    const int end, uint32 *d, const int32 alpha, const PaintShader &shader,
+    const float u, const float v)
+{
+    for (int x = pos; x < end; x++) {
+        d[x] = CompositeShadedPixel(d[x],
+            ShadeGradientPixel<Type, Spread>(shader, x, u, v), alpha);
+    }
+}
+
+
+/**
+ * Composites image span one pixel at a time. Plain C++ version.
+ *
+ * @param u Image coordinate U of pixel at x = 0 on this scanline.
+ *
+ * @param v Image coordinate V of pixel at x = 0 on this scanline.
+ */
+template <ImageFilter Filter, PaintSpread Spread>
+static FORCE_INLINE void CompositeImageSpan_generic(const int pos,
+    const int end, uint32 *d, const int32 alpha, const PaintShader &shader,
+    const float u, const float v)
+{
+    for (int x = pos; x < end; x++) {
+        d[x] = CompositeShadedPixel(d[x],
+            ShadeImagePixel<Filter, Spread>(shader, x, u, v), alpha);
+    }
+}
+
+
+// Vector versions process span tails with the plain C++ functions above.
+#ifdef SIMD_NEON
+#include "PaintOps_neon.h"
+#elif defined SIMD_WASM
+#include "PaintOps_wasm.h"
+#elif defined SIMD_SSE2
+#include "PaintOps_x86.h"
+#endif
+
+
+/**
+ * Composites span of gradient pixels using source over operator.
+ */
+template <PaintType Type, PaintSpread Spread>
+static FORCE_INLINE void CompositeGradientSpan(const int pos, const int end,
+    uint32 *d, const int32 alpha, const PaintShader &shader, const float u,
+    const float v)
+{
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+    ASSERT(alpha <= 255);
+
+#ifdef SIMD_NEON
+    CompositeGradientSpan_neon<Type, Spread>(pos, end, d, alpha, shader, u, v);
+#elif defined SIMD_WASM
+    CompositeGradientSpan_wasm<Type, Spread>(pos, end, d, alpha, shader, u, v);
+#elif defined SIMD_SSE2
+    CompositeGradientSpan_sse2<Type, Spread>(pos, end, d, alpha, shader, u, v);
+#else
+    CompositeGradientSpan_generic<Type, Spread>(pos, end, d, alpha, shader,
+        u, v);
+#endif
+}
+
+
+/**
+ * Composites span of image pixels using source over operator.
+ */
+template <ImageFilter Filter, PaintSpread Spread>
+static FORCE_INLINE void CompositeImageSpan(const int pos, const int end,
+    uint32 *d, const int32 alpha, const PaintShader &shader, const float u,
+    const float v)
+{
+    ASSERT(pos >= 0);
+    ASSERT(pos < end);
+    ASSERT(d != nullptr);
+    ASSERT(alpha <= 255);
+
+#ifdef SIMD_NEON
+    CompositeImageSpan_neon<Filter, Spread>(pos, end, d, alpha, shader, u, v);
+#elif defined SIMD_WASM
+    CompositeImageSpan_wasm<Filter, Spread>(pos, end, d, alpha, shader, u, v);
+#elif defined SIMD_SSE2
+    CompositeImageSpan_sse2<Filter, Spread>(pos, end, d, alpha, shader, u, v);
+#else
+    CompositeImageSpan_generic<Filter, Spread>(pos, end, d, alpha, shader, u,
+        v);
+#endif
+}
+
+
+/**
+ * A number of pixels shaded at once when paint is composited using blend
+ * mode other than source over.
+ */
+static constexpr int PaintBlendChunkSize = 64;
+
+
+/**
+ * Composites span of paint pixels using blend mode kernel of a shader. Paint
+ * is shaded into a small buffer first, reusing source over span functions
+ * with transparent destination, and then the buffer is composited with
+ * destination.
+ */
+template <typename B>
+static FORCE_INLINE void CompositePaintSpanWithBlendMode(const B &blender,
+    const int pos, const int end, uint32 *d, const int32 alpha)
+{
+    ASSERT(blender.Shader.Blend != nullptr);
+
+    ALIGNED(16) uint32 pixels[PaintBlendChunkSize];
+
+    for (int x = pos; x < end; x += PaintBlendChunkSize) {
+        const int e = Min(x + PaintBlendChunkSize, end);
+        const int n = e - x;
+
+        memset(pixels, 0, SIZE_OF(uint32) * n);
+
+        blender.ShadeSpan(0, n, pixels, 255,
+            blender.U + (blender.Shader.UX * float(x)),
+            blender.V + (blender.Shader.VX * float(x)));
+
+        blender.Shader.Blend(x, e, d, alpha, pixels);
+    }
+}
+
+
+/**
+ * Span blender which fills pixels with gradient. Unlike solid color
+ * blenders, gradient blender is created for each scanline.
+ */
+template <PaintType Type>
+struct SpanBlenderGradient final {
+    static constexpr bool UsesShader = true;
+
+
+    SpanBlenderGradient(const PaintShader &shader, const int y)
+    :   Shader(shader),
+        U((shader.UY * float(y)) + shader.U0),
+        V((shader.VY * float(y)) + shader.V0)
+    {
+    }
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+    void ShadeSpan(const int pos, const int end, uint32 *d, const int32 alpha, const float u, const float v) const;
+
+    const PaintShader &Shader;
+
+    // Gradient coordinates of pixel at x = 0 on this scanline.
+    const float U = 0;
+    const float V = 0;
+};
+
+
+template <PaintType Type>
+FORCE_INLINE void SpanBlenderGradient<Type>::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    if (Shader.Blend != nullptr) {
+        CompositePaintSpanWithBlendMode(*this, pos, end, d, alpha);
+    } else {
+        ShadeSpan(pos, end, d, alpha, U, V);
+    }
+}
+
+
+template <PaintType Type>
+FORCE_INLINE void SpanBlenderGradient<Type>::ShadeSpan(const int pos, const int end, uint32 *d, const int32 alpha, const float u, const float v) const {
+    switch (Shader.Spread) {
+        case PaintSpread::Pad:
+            CompositeGradientSpan<Type, PaintSpread::Pad>(pos, end, d,
+                alpha, Shader, u, v);
+            break;
+
+        case PaintSpread::Repeat:
+            CompositeGradientSpan<Type, PaintSpread::Repeat>(pos, end, d,
+                alpha, Shader, u, v);
+            break;
+
+        case PaintSpread::Reflect:
+            CompositeGradientSpan<Type, PaintSpread::Reflect>(pos, end, d,
+                alpha, Shader, u, v);
+            break;
+    }
+}
+
+
+/**
+ * Span blender which fills pixels with image pattern sampled using a given
+ * filter. Created for each scanline, the same way as gradient blender.
+ */
+template <ImageFilter Filter>
+struct SpanBlenderImage final {
+    static constexpr bool UsesShader = true;
+
+
+    SpanBlenderImage(const PaintShader &shader, const int y)
+    :   Shader(shader),
+        U((shader.UY * float(y)) + shader.U0),
+        V((shader.VY * float(y)) + shader.V0)
+    {
+    }
+
+
+    void CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const;
+    void ShadeSpan(const int pos, const int end, uint32 *d, const int32 alpha, const float u, const float v) const;
+
+    const PaintShader &Shader;
+
+    // Image coordinates of pixel at x = 0 on this scanline.
+    const float U = 0;
+    const float V = 0;
+};
+
+
+template <ImageFilter Filter>
+FORCE_INLINE void SpanBlenderImage<Filter>::CompositeSpan(const int pos, const int end, uint32 *d, const int32 alpha) const {
+    if (Shader.Blend != nullptr) {
+        CompositePaintSpanWithBlendMode(*this, pos, end, d, alpha);
+    } else {
+        ShadeSpan(pos, end, d, alpha, U, V);
+    }
+}
+
+
+template <ImageFilter Filter>
+FORCE_INLINE void SpanBlenderImage<Filter>::ShadeSpan(const int pos, const int end, uint32 *d, const int32 alpha, const float u, const float v) const {
+    switch (Shader.Spread) {
+        case PaintSpread::Pad:
+            CompositeImageSpan<Filter, PaintSpread::Pad>(pos, end, d, alpha,
+                Shader, u, v);
+            break;
+
+        case PaintSpread::Repeat:
+            CompositeImageSpan<Filter, PaintSpread::Repeat>(pos, end, d,
+                alpha, Shader, u, v);
+            break;
+
+        case PaintSpread::Reflect:
+            CompositeImageSpan<Filter, PaintSpread::Reflect>(pos, end, d,
+                alpha, Shader, u, v);
+            break;
+    }
+}
@@ -0,0 +1,281 @@
+
+// This must only be included from PaintOps.h
+
+
+#include <arm_neon.h>
+
+
+/**
+ * Converts four positions within gradient to lookup table indices, see
+ * GradientLutIndex.
+ */
+template <PaintSpread Spread>
+static FORCE_INLINE int32x4_t GradientLutIndex_neon(const float32x4_t t) {
+    const float32x4_t one = vdupq_n_f32(1);
+
+    float32x4_t p = vminq_f32(vmaxq_f32(t, vdupq_n_f32(-PaintMaxCoordinate)),
+        vdupq_n_f32(PaintMaxCoordinate));
+
+    if constexpr (Spread == PaintSpread::Pad) {
+        p = vminq_f32(vmaxq_f32(p, vdupq_n_f32(0)), one);
+    } else if constexpr (Spread == PaintSpread::Repeat) {
+        p = vsubq_f32(p, vrndmq_f32(p));
+    } else {
+        STATIC_ASSERT(Spread == PaintSpread::Reflect);
+
+        const float32x4_t h = vmulq_f32(p, vdupq_n_f32(0.5f));
+        const float32x4_t f = vsubq_f32(h, vrndmq_f32(h));
+
+        p = vsubq_f32(one, vabsq_f32(vsubq_f32(vmulq_f32(f,
+            vdupq_n_f32(2)), one)));
+    }
+
+    return vcvtq_s32_f32(vaddq_f32(vmulq_f32(p,
+        vdupq_n_f32(float(Paint::LutSize - 1))), vdupq_n_f32(0.5f)));
+}
+
+
+/**
+ * Composites four shaded pixels with coverage alpha using source over
+ * operator.
+ *
+ * @param a Coverage alpha repeated in every 8 bit lane.
+ */
+static FORCE_INLINE void CompositePixels_neon(uint32 *d, const uint32x4_t s,
+    const int32 alpha, const uint8x16_t a)
+{
+    const uint32x4_t c = alpha < 255 ?
+        vreinterpretq_u32_u8(ApplyAlpha_neon(vreinterpretq_u8_u32(s), a)) : s;
+
+    // Inverse alpha of each source pixel repeated in every channel.
+    const uint32x4_t ia = vmulq_n_u32(vsubq_u32(vdupq_n_u32(255),
+        vshrq_n_u32(c, 24)), 0x01010101);
+
+    const uint8x16_t dd = ApplyAlpha_neon(vreinterpretq_u8_u32(vld1q_u32(d)),
+        vreinterpretq_u8_u32(ia));
+
+    vst1q_u32(d, vaddq_u32(c, vreinterpretq_u32_u8(dd)));
+}
+
+
+template <PaintType Type, PaintSpread Spread>
+static FORCE_INLINE void CompositeGradientSpan_neon(const int pos,
+    const int end, uint32 *d, const int32 alpha, const PaintShader &shader,
+    const float u, const float v)
+{
+    const int32x4_t lanes = { 0, 1, 2, 3 };
+    const uint8x16_t a = vdupq_n_u8(uint8(alpha));
+    const float32x4_t ux = vdupq_n_f32(shader.UX);
+    const float32x4_t vu = vdupq_n_f32(u);
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        const float32x4_t fx = vcvtq_f32_s32(vaddq_s32(vdupq_n_s32(x),
+            lanes));
+
+        const float32x4_t pu = vaddq_f32(vmulq_f32(ux, fx), vu);
+
+        int32x4_t index;
+
+        if constexpr (Type == PaintType::LinearGradient) {
+            index = GradientLutIndex_neon<Spread>(pu);
+        } else {
+            STATIC_ASSERT(Type == PaintType::RadialGradient);
+
+            const float32x4_t pv = vaddq_f32(vmulq_f32(
+                vdupq_n_f32(shader.VX), fx), vdupq_n_f32(v));
+
+            index = GradientLutIndex_neon<Spread>(vsqrtq_f32(vaddq_f32(
+                vmulq_f32(pu, pu), vmulq_f32(pv, pv))));
+        }
+
+        const uint32 colors[4] = {
+            shader.Lut[vgetq_lane_s32(index, 0)],
+            shader.Lut[vgetq_lane_s32(index, 1)],
+            shader.Lut[vgetq_lane_s32(index, 2)],
+            shader.Lut[vgetq_lane_s32(index, 3)]
+        };
+
+        CompositePixels_neon(d + x, vld1q_u32(colors), alpha, a);
+    }
+
+    if (x < end) {
+        CompositeGradientSpan_generic<Type, Spread>(x, end, d, alpha, shader,
+            u, v);
+    }
+}
+
+
+/**
+ * Maps four whole image pixel coordinates to range from 0 to size - 1, see
+ * WrapImageCoordinate.
+ */
+template <PaintSpread Spread>
+static FORCE_INLINE float32x4_t WrapImageCoordinate_neon(const float32x4_t c, const float32x4_t size) {
+    if constexpr (Spread == PaintSpread::Pad) {
+        return vminq_f32(vmaxq_f32(c, vdupq_n_f32(0)),
+            vsubq_f32(size, vdupq_n_f32(1)));
+    } else if constexpr (Spread == PaintSpread::Repeat) {
+        return vsubq_f32(c, vmulq_f32(vrndmq_f32(vdivq_f32(c, size)), size));
+    } else {
+        STATIC_ASSERT(Spread == PaintSpread::Reflect);
+
+        const float32x4_t period = vaddq_f32(size, size);
+
+        const float32x4_t r = vsubq_f32(c, vmulq_f32(vrndmq_f32(vdivq_f32(c,
+            period)), period));
+
+        const float32x4_t m = vsubq_f32(vsubq_f32(period, vdupq_n_f32(1)), r);
+
+        return vbslq_f32(vcgeq_f32(r, size), m, r);
+    }
+}
+
+
+/**
+ * Interpolates each channel of two pixels unpacked to 16 bit lanes, see
+ * LerpPixels. Calculated as ((a << 8) + b × w - a × w) >> 8, intermediate
+ * values may wrap around, but the final sum always fits into 16 bits.
+ */
+static FORCE_INLINE uint16x8_t LerpPixels16_neon(const uint16x8_t a, const uint16x8_t b, const uint16x8_t w) {
+    return vshrq_n_u16(vaddq_u16(vshlq_n_u16(a, 8),
+        vsubq_u16(vmulq_u16(b, w), vmulq_u16(a, w))), 8);
+}
+
+
+template <ImageFilter Filter, PaintSpread Spread>
+static FORCE_INLINE void CompositeImageSpan_neon(const int pos,
+    const int end, uint32 *d, const int32 alpha, const PaintShader &shader,
+    const float u, const float v)
+{
+    const int32x4_t lanes = { 0, 1, 2, 3 };
+    const uint8x16_t a = vdupq_n_u8(uint8(alpha));
+    const float32x4_t ux = vdupq_n_f32(shader.UX);
+    const float32x4_t vx = vdupq_n_f32(shader.VX);
+    const float32x4_t vu = vdupq_n_f32(u);
+    const float32x4_t vv = vdupq_n_f32(v);
+    const float32x4_t w = vdupq_n_f32(shader.ImageWidth);
+    const float32x4_t h = vdupq_n_f32(shader.ImageHeight);
+    const float32x4_t minc = vdupq_n_f32(-PaintMaxCoordinate);
+    const float32x4_t maxc = vdupq_n_f32(PaintMaxCoordinate);
+    const uint32 *pixels = shader.Pixels;
+    const int stride = shader.PixelsPerRow;
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        const float32x4_t fx = vcvtq_f32_s32(vaddq_s32(vdupq_n_s32(x),
+            lanes));
+
+        const float32x4_t pu = vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(ux,
+            fx), vu), minc), maxc);
+
+        const float32x4_t pv = vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(vx,
+            fx), vv), minc), maxc);
+
+        uint32x4_t s;
+
+        if constexpr (Filter == ImageFilter::Nearest) {
+            const int32x4_t ix = vcvtq_s32_f32(
+                WrapImageCoordinate_neon<Spread>(vrndmq_f32(pu), w));
+
+            const int32x4_t iy = vcvtq_s32_f32(
+                WrapImageCoordinate_neon<Spread>(vrndmq_f32(pv), h));
+
+            const uint32 colors[4] = {
+                pixels[(vgetq_lane_s32(iy, 0) * stride) + vgetq_lane_s32(ix, 0)],
+                pixels[(vgetq_lane_s32(iy, 1) * stride) + vgetq_lane_s32(ix, 1)],
+                pixels[(vgetq_lane_s32(iy, 2) * stride) + vgetq_lane_s32(ix, 2)],
+                pixels[(vgetq_lane_s32(iy, 3) * stride) + vgetq_lane_s32(ix, 3)]
+            };
+
+            s = vld1q_u32(colors);
+        } else {
+            STATIC_ASSERT(Filter == ImageFilter::Bilinear);
+
+            const float32x4_t one = vdupq_n_f32(1);
+            const float32x4_t half = vdupq_n_f32(0.5f);
+            const float32x4_t scale = vdupq_n_f32(256);
+
+            // Pixel centers are at half-integer coordinates.
+            const float32x4_t su = vsubq_f32(pu, half);
+            const float32x4_t sv = vsubq_f32(pv, half);
+            const float32x4_t fu = vrndmq_f32(su);
+            const float32x4_t fv = vrndmq_f32(sv);
+
+            int32 x0[4];
+            int32 x1[4];
+            int32 y0[4];
+            int32 y1[4];
+
+            vst1q_s32(x0, vcvtq_s32_f32(WrapImageCoordinate_neon<Spread>(fu,
+                w)));
+
+            vst1q_s32(x1, vcvtq_s32_f32(WrapImageCoordinate_neon<Spread>(
+                vaddq_f32(fu, one), w)));
+
+            vst1q_s32(y0, vcvtq_s32_f32(WrapImageCoordinate_neon<Spread>(fv,
+                h)));
+
+            vst1q_s32(y1, vcvtq_s32_f32(WrapImageCoordinate_neon<Spread>(
+                vaddq_f32(fv, one), h)));
+
+            uint32 c00[4];
+            uint32 c01[4];
+            uint32 c10[4];
+            uint32 c11[4];
+
+            for (int i = 0; i < 4; i++) {
+                const uint32 *row0 = pixels + (y0[i] * stride);
+                const uint32 *row1 = pixels + (y1[i] * stride);
+
+                c00[i] = row0[x0[i]];
+                c01[i] = row0[x1[i]];
+                c10[i] = row1[x0[i]];
+                c11[i] = row1[x1[i]];
+            }
+
+            // Weights in range 0-255, repeated in 16 bit lanes of each
+            // channel.
+            const uint32x4_t wx = vmulq_n_u32(vcvtq_u32_f32(vmulq_f32(
+                vsubq_f32(su, fu), scale)), 0x00010001);
+
+            const uint32x4_t wy = vmulq_n_u32(vcvtq_u32_f32(vmulq_f32(
+                vsubq_f32(sv, fv), scale)), 0x00010001);
+
+            const uint16x8_t wxlo = vreinterpretq_u16_u32(vzip1q_u32(wx, wx));
+            const uint16x8_t wxhi = vreinterpretq_u16_u32(vzip2q_u32(wx, wx));
+            const uint16x8_t wylo = vreinterpretq_u16_u32(vzip1q_u32(wy, wy));
+            const uint16x8_t wyhi = vreinterpretq_u16_u32(vzip2q_u32(wy, wy));
+
+            const uint8x16_t p00 = vreinterpretq_u8_u32(vld1q_u32(c00));
+            const uint8x16_t p01 = vreinterpretq_u8_u32(vld1q_u32(c01));
+            const uint8x16_t p10 = vreinterpretq_u8_u32(vld1q_u32(c10));
+            const uint8x16_t p11 = vreinterpretq_u8_u32(vld1q_u32(c11));
+
+            const uint16x8_t toplo = LerpPixels16_neon(
+                vmovl_u8(vget_low_u8(p00)), vmovl_u8(vget_low_u8(p01)), wxlo);
+
+            const uint16x8_t tophi = LerpPixels16_neon(vmovl_high_u8(p00),
+                vmovl_high_u8(p01), wxhi);
+
+            const uint16x8_t bottomlo = LerpPixels16_neon(
+                vmovl_u8(vget_low_u8(p10)), vmovl_u8(vget_low_u8(p11)), wxlo);
+
+            const uint16x8_t bottomhi = LerpPixels16_neon(vmovl_high_u8(p10),
+                vmovl_high_u8(p11), wxhi);
+
+            s = vreinterpretq_u32_u8(vcombine_u8(
+                vmovn_u16(LerpPixels16_neon(toplo, bottomlo, wylo)),
+                vmovn_u16(LerpPixels16_neon(tophi, bottomhi, wyhi))));
+        }
+
+        CompositePixels_neon(d + x, s, alpha, a);
+    }
+
+    if (x < end) {
+        CompositeImageSpan_generic<Filter, Spread>(x, end, d, alpha, shader,
+            u, v);
+    }
+}
@@ -0,0 +1,289 @@
+
+// This must only be included from PaintOps.h
+
+
+#include <wasm_simd128.h>
+
+
+/**
+ * Converts four positions within gradient to lookup table indices, see
+ * GradientLutIndex.
+ */
+template <PaintSpread Spread>
+static FORCE_INLINE v128_t GradientLutIndex_wasm(const v128_t t) {
+    const v128_t one = wasm_f32x4_splat(1);
+
+    v128_t p = wasm_f32x4_min(wasm_f32x4_max(t,
+        wasm_f32x4_splat(-PaintMaxCoordinate)),
+        wasm_f32x4_splat(PaintMaxCoordinate));
+
+    if constexpr (Spread == PaintSpread::Pad) {
+        p = wasm_f32x4_min(wasm_f32x4_max(p, wasm_f32x4_splat(0)), one);
+    } else if constexpr (Spread == PaintSpread::Repeat) {
+        p = wasm_f32x4_sub(p, wasm_f32x4_floor(p));
+    } else {
+        STATIC_ASSERT(Spread == PaintSpread::Reflect);
+
+        const v128_t h = wasm_f32x4_mul(p, wasm_f32x4_splat(0.5f));
+        const v128_t f = wasm_f32x4_sub(h, wasm_f32x4_floor(h));
+
+        p = wasm_f32x4_sub(one, wasm_f32x4_abs(wasm_f32x4_sub(
+            wasm_f32x4_mul(f, wasm_f32x4_splat(2)), one)));
+    }
+
+    return wasm_i32x4_trunc_sat_f32x4(wasm_f32x4_add(wasm_f32x4_mul(p,
+        wasm_f32x4_splat(float(Paint::LutSize - 1))),
+        wasm_f32x4_splat(0.5f)));
+}
+
+
+/**
+ * Composites four shaded pixels with coverage alpha using source over
+ * operator.
+ *
+ * @param a Coverage alpha repeated in every 8 bit lane.
+ */
+static FORCE_INLINE void CompositePixels_wasm(uint32 *d, const v128_t s,
+    const int32 alpha, const v128_t a)
+{
+    const v128_t c = alpha < 255 ? ApplyAlphaLanes_wasm(s, a) : s;
+
+    // Inverse alpha of each source pixel repeated in every channel.
+    const v128_t ia = wasm_i32x4_mul(wasm_i32x4_sub(wasm_i32x4_splat(255),
+        wasm_u32x4_shr(c, 24)), wasm_i32x4_splat(0x01010101));
+
+    wasm_v128_store(d, wasm_i32x4_add(c,
+        ApplyAlphaLanes_wasm(wasm_v128_load(d), ia)));
+}
+
+
+template <PaintType Type, PaintSpread Spread>
+static FORCE_INLINE void CompositeGradientSpan_wasm(const int pos,
+    const int end, uint32 *d, const int32 alpha, const PaintShader &shader,
+    const float u, const float v)
+{
+    const v128_t lanes = wasm_i32x4_make(0, 1, 2, 3);
+    const v128_t a = wasm_i32x4_splat(int(uint32(alpha) * 0x01010101));
+    const v128_t ux = wasm_f32x4_splat(shader.UX);
+    const v128_t vu = wasm_f32x4_splat(u);
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        const v128_t fx = wasm_f32x4_convert_i32x4(wasm_i32x4_add(
+            wasm_i32x4_splat(x), lanes));
+
+        const v128_t pu = wasm_f32x4_add(wasm_f32x4_mul(ux, fx), vu);
+
+        v128_t index;
+
+        if constexpr (Type == PaintType::LinearGradient) {
+            index = GradientLutIndex_wasm<Spread>(pu);
+        } else {
+            STATIC_ASSERT(Type == PaintType::RadialGradient);
+
+            const v128_t pv = wasm_f32x4_add(wasm_f32x4_mul(
+                wasm_f32x4_splat(shader.VX), fx), wasm_f32x4_splat(v));
+
+            index = GradientLutIndex_wasm<Spread>(wasm_f32x4_sqrt(
+                wasm_f32x4_add(wasm_f32x4_mul(pu, pu),
+                    wasm_f32x4_mul(pv, pv))));
+        }
+
+        const v128_t s = wasm_i32x4_make(
+            int(shader.Lut[wasm_i32x4_extract_lane(index, 0)]),
+            int(shader.Lut[wasm_i32x4_extract_lane(index, 1)]),
+            int(shader.Lut[wasm_i32x4_extract_lane(index, 2)]),
+            int(shader.Lut[wasm_i32x4_extract_lane(index, 3)]));
+
+        CompositePixels_wasm(d + x, s, alpha, a);
+    }
+
+    if (x < end) {
+        CompositeGradientSpan_generic<Type, Spread>(x, end, d, alpha, shader,
+            u, v);
+    }
+}
+
+
+/**
+ * Maps four whole image pixel coordinates to range from 0 to size - 1, see
+ * WrapImageCoordinate.
+ */
+template <PaintSpread Spread>
+static FORCE_INLINE v128_t WrapImageCoordinate_wasm(const v128_t c, const v128_t size) {
+    if constexpr (Spread == PaintSpread::Pad) {
+        return wasm_f32x4_min(wasm_f32x4_max(c, wasm_f32x4_splat(0)),
+            wasm_f32x4_sub(size, wasm_f32x4_splat(1)));
+    } else if constexpr (Spread == PaintSpread::Repeat) {
+        return wasm_f32x4_sub(c, wasm_f32x4_mul(wasm_f32x4_floor(
+            wasm_f32x4_div(c, size)), size));
+    } else {
+        STATIC_ASSERT(Spread == PaintSpread::Reflect);
+
+        const v128_t period = wasm_f32x4_add(size, size);
+
+        const v128_t r = wasm_f32x4_sub(c, wasm_f32x4_mul(wasm_f32x4_floor(
+            wasm_f32x4_div(c, period)), period));
+
+        const v128_t m = wasm_f32x4_sub(wasm_f32x4_sub(period,
+            wasm_f32x4_splat(1)), r);
+
+        return wasm_v128_bitselect(m, r, wasm_f32x4_ge(r, size));
+    }
+}
+
+
+/**
+ * Interpolates each channel of two pixels unpacked to 16 bit lanes, see
+ * LerpPixels. Calculated as ((a << 8) + b × w - a × w) >> 8, intermediate
+ * values may wrap around, but the final sum always fits into 16 bits.
+ */
+static FORCE_INLINE v128_t LerpPixels16_wasm(const v128_t a, const v128_t b, const v128_t w) {
+    return wasm_u16x8_shr(wasm_i16x8_add(wasm_i16x8_shl(a, 8),
+        wasm_i16x8_sub(wasm_i16x8_mul(b, w), wasm_i16x8_mul(a, w))), 8);
+}
+
+
+template <ImageFilter Filter, PaintSpread Spread>
+static FORCE_INLINE void CompositeImageSpan_wasm(const int pos,
+    const int end, uint32 *d, const int32 alpha, const PaintShader &shader,
+    const float u, const float v)
+{
+    const v128_t lanes = wasm_i32x4_make(0, 1, 2, 3);
+    const v128_t a = wasm_i32x4_splat(int(uint32(alpha) * 0x01010101));
+    const v128_t ux = wasm_f32x4_splat(shader.UX);
+    const v128_t vx = wasm_f32x4_splat(shader.VX);
+    const v128_t vu = wasm_f32x4_splat(u);
+    const v128_t vv = wasm_f32x4_splat(v);
+    const v128_t w = wasm_f32x4_splat(shader.ImageWidth);
+    const v128_t h = wasm_f32x4_splat(shader.ImageHeight);
+    const v128_t minc = wasm_f32x4_splat(-PaintMaxCoordinate);
+    const v128_t maxc = wasm_f32x4_splat(PaintMaxCoordinate);
+    const uint32 *pixels = shader.Pixels;
+    const int stride = shader.PixelsPerRow;
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        const v128_t fx = wasm_f32x4_convert_i32x4(wasm_i32x4_add(
+            wasm_i32x4_splat(x), lanes));
+
+        const v128_t pu = wasm_f32x4_min(wasm_f32x4_max(wasm_f32x4_add(
+            wasm_f32x4_mul(ux, fx), vu), minc), maxc);
+
+        const v128_t pv = wasm_f32x4_min(wasm_f32x4_max(wasm_f32x4_add(
+            wasm_f32x4_mul(vx, fx), vv), minc), maxc);
+
+        v128_t s;
+
+        if constexpr (Filter == ImageFilter::Nearest) {
+            const v128_t ix = wasm_i32x4_trunc_sat_f32x4(
+                WrapImageCoordinate_wasm<Spread>(wasm_f32x4_floor(pu), w));
+
+            const v128_t iy = wasm_i32x4_trunc_sat_f32x4(
+                WrapImageCoordinate_wasm<Spread>(wasm_f32x4_floor(pv), h));
+
+            s = wasm_i32x4_make(
+                int(pixels[(wasm_i32x4_extract_lane(iy, 0) * stride) +
+                    wasm_i32x4_extract_lane(ix, 0)]),
+                int(pixels[(wasm_i32x4_extract_lane(iy, 1) * stride) +
+                    wasm_i32x4_extract_lane(ix, 1)]),
+                int(pixels[(wasm_i32x4_extract_lane(iy, 2) * stride) +
+                    wasm_i32x4_extract_lane(ix, 2)]),
+                int(pixels[(wasm_i32x4_extract_lane(iy, 3) * stride) +
+                    wasm_i32x4_extract_lane(ix, 3)]));
+        } else {
+            STATIC_ASSERT(Filter == ImageFilter::Bilinear);
+
+            const v128_t one = wasm_f32x4_splat(1);
+            const v128_t half = wasm_f32x4_splat(0.5f);
+            const v128_t scale = wasm_f32x4_splat(256);
+
+            // Pixel centers are at half-integer coordinates.
+            const v128_t su = wasm_f32x4_sub(pu, half);
+            const v128_t sv = wasm_f32x4_sub(pv, half);
+            const v128_t fu = wasm_f32x4_floor(su);
+            const v128_t fv = wasm_f32x4_floor(sv);
+
+            int32 x0[4];
+            int32 x1[4];
+            int32 y0[4];
+            int32 y1[4];
+
+            wasm_v128_store(x0, wasm_i32x4_trunc_sat_f32x4(
+                WrapImageCoordinate_wasm<Spread>(fu, w)));
+
+            wasm_v128_store(x1, wasm_i32x4_trunc_sat_f32x4(
+                WrapImageCoordinate_wasm<Spread>(wasm_f32x4_add(fu, one), w)));
+
+            wasm_v128_store(y0, wasm_i32x4_trunc_sat_f32x4(
+                WrapImageCoordinate_wasm<Spread>(fv, h)));
+
+            wasm_v128_store(y1, wasm_i32x4_trunc_sat_f32x4(
+                WrapImageCoordinate_wasm<Spread>(wasm_f32x4_add(fv, one), h)));
+
+            uint32 c00[4];
+            uint32 c01[4];
+            uint32 c10[4];
+            uint32 c11[4];
+
+            for (int i = 0; i < 4; i++) {
+                const uint32 *row0 = pixels + (y0[i] * stride);
+                const uint32 *row1 = pixels + (y1[i] * stride);
+
+                c00[i] = row0[x0[i]];
+                c01[i] = row0[x1[i]];
+                c10[i] = row1[x0[i]];
+                c11[i] = row1[x1[i]];
+            }
+
+            // Weights in range 0-255, repeated in 16 bit lanes of each
+            // channel.
+            const v128_t wx = wasm_i32x4_mul(wasm_i32x4_trunc_sat_f32x4(
+                wasm_f32x4_mul(wasm_f32x4_sub(su, fu), scale)),
+                wasm_i32x4_splat(0x00010001));
+
+            const v128_t wy = wasm_i32x4_mul(wasm_i32x4_trunc_sat_f32x4(
+                wasm_f32x4_mul(wasm_f32x4_sub(sv, fv), scale)),
+                wasm_i32x4_splat(0x00010001));
+
+            const v128_t wxlo = wasm_i32x4_shuffle(wx, wx, 0, 0, 1, 1);
+            const v128_t wxhi = wasm_i32x4_shuffle(wx, wx, 2, 2, 3, 3);
+            const v128_t wylo = wasm_i32x4_shuffle(wy, wy, 0, 0, 1, 1);
+            const v128_t wyhi = wasm_i32x4_shuffle(wy, wy, 2, 2, 3, 3);
+
+            const v128_t p00 = wasm_v128_load(c00);
+            const v128_t p01 = wasm_v128_load(c01);
+            const v128_t p10 = wasm_v128_load(c10);
+            const v128_t p11 = wasm_v128_load(c11);
+
+            const v128_t toplo = LerpPixels16_wasm(
+                wasm_u16x8_extend_low_u8x16(p00),
+                wasm_u16x8_extend_low_u8x16(p01), wxlo);
+
+            const v128_t tophi = LerpPixels16_wasm(
+                wasm_u16x8_extend_high_u8x16(p00),
+                wasm_u16x8_extend_high_u8x16(p01), wxhi);
+
+            const v128_t bottomlo = LerpPixels16_wasm(
+                wasm_u16x8_extend_low_u8x16(p10),
+                wasm_u16x8_extend_low_u8x16(p11), wxlo);
+
+            const v128_t bottomhi = LerpPixels16_wasm(
+                wasm_u16x8_extend_high_u8x16(p10),
+                wasm_u16x8_extend_high_u8x16(p11), wxhi);
+
+            s = wasm_u8x16_narrow_i16x8(
+                LerpPixels16_wasm(toplo, bottomlo, wylo),
+                LerpPixels16_wasm(tophi, bottomhi, wyhi));
+        }
+
+        CompositePixels_wasm(d + x, s, alpha, a);
+    }
+
+    if (x < end) {
+        CompositeImageSpan_generic<Filter, Spread>(x, end, d, alpha, shader,
+            u, v);
+    }
+}
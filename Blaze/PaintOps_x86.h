@@ -0,0 +1,305 @@
+
+// This must only be included from PaintOps.h
+
+
+#include <emmintrin.h>
+
+
+/**
+ * Rounds each lane towards negative infinity. Values must fit into 32 bit
+ * integers. SSE2 has no rounding instructions.
+ */
+static FORCE_INLINE __m128 Floor_sse2(const __m128 x) {
+    const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1)));
+}
+
+
+/**
+ * Converts four positions within gradient to lookup table indices, see
+ * GradientLutIndex.
+ */
+template <PaintSpread Spread>
+static FORCE_INLINE __m128i GradientLutIndex_sse2(const __m128 t) {
+    const __m128 one = _mm_set1_ps(1);
+
+    __m128 p = _mm_min_ps(_mm_max_ps(t, _mm_set1_ps(-PaintMaxCoordinate)),
+        _mm_set1_ps(PaintMaxCoordinate));
+
+    if constexpr (Spread == PaintSpread::Pad) {
+        p = _mm_min_ps(_mm_max_ps(p, _mm_setzero_ps()), one);
+    } else if constexpr (Spread == PaintSpread::Repeat) {
+        p = _mm_sub_ps(p, Floor_sse2(p));
+    } else {
+        STATIC_ASSERT(Spread == PaintSpread::Reflect);
+
+        const __m128 h = _mm_mul_ps(p, _mm_set1_ps(0.5f));
+        const __m128 f = _mm_sub_ps(h, Floor_sse2(h));
+        const __m128 m = _mm_sub_ps(_mm_mul_ps(f, _mm_set1_ps(2)), one);
+
+        // Clear sign bit to find absolute value.
+        p = _mm_sub_ps(one, _mm_andnot_ps(_mm_set1_ps(-0.0f), m));
+    }
+
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(p,
+        _mm_set1_ps(float(Paint::LutSize - 1))), _mm_set1_ps(0.5f)));
+}
+
+
+/**
+ * Composites four shaded pixels with coverage alpha using source over
+ * operator.
+ *
+ * @param a Coverage alpha repeated in every 8 bit lane.
+ */
+static FORCE_INLINE void CompositePixels_sse2(uint32 *d, const __m128i s,
+    const int32 alpha, const __m128i a)
+{
+    const __m128i c = alpha < 255 ? ApplyAlpha_sse2(s, a) : s;
+
+    // Inverse alpha of each source pixel repeated in every channel.
+    // Multiplication by 0x01010101 is done with shifts, SSE2 has no 32 bit
+    // multiplication.
+    const __m128i ia = _mm_sub_epi32(_mm_set1_epi32(255),
+        _mm_srli_epi32(c, 24));
+
+    const __m128i ia2 = _mm_or_si128(ia, _mm_slli_epi32(ia, 8));
+    const __m128i ia4 = _mm_or_si128(ia2, _mm_slli_epi32(ia2, 16));
+
+    __m128i *p = reinterpret_cast<__m128i *>(d);
+
+    _mm_storeu_si128(p, _mm_add_epi32(c,
+        ApplyAlpha_sse2(_mm_loadu_si128(p), ia4)));
+}
+
+
+template <PaintType Type, PaintSpread Spread>
+static FORCE_INLINE void CompositeGradientSpan_sse2(const int pos,
+    const int end, uint32 *d, const int32 alpha, const PaintShader &shader,
+    const float u, const float v)
+{
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i a = _mm_set1_epi8(char(alpha));
+    const __m128 ux = _mm_set1_ps(shader.UX);
+    const __m128 vu = _mm_set1_ps(u);
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        const __m128 fx = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x),
+            lanes));
+
+        const __m128 pu = _mm_add_ps(_mm_mul_ps(ux, fx), vu);
+
+        __m128i index;
+
+        if constexpr (Type == PaintType::LinearGradient) {
+            index = GradientLutIndex_sse2<Spread>(pu);
+        } else {
+            STATIC_ASSERT(Type == PaintType::RadialGradient);
+
+            const __m128 pv = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(shader.VX),
+                fx), _mm_set1_ps(v));
+
+            index = GradientLutIndex_sse2<Spread>(_mm_sqrt_ps(_mm_add_ps(
+                _mm_mul_ps(pu, pu), _mm_mul_ps(pv, pv))));
+        }
+
+        alignas(16) int32 indices[4];
+
+        _mm_store_si128(reinterpret_cast<__m128i *>(indices), index);
+
+        const __m128i s = _mm_setr_epi32(int(shader.Lut[indices[0]]),
+            int(shader.Lut[indices[1]]), int(shader.Lut[indices[2]]),
+            int(shader.Lut[indices[3]]));
+
+        CompositePixels_sse2(d + x, s, alpha, a);
+    }
+
+    if (x < end) {
+        CompositeGradientSpan_generic<Type, Spread>(x, end, d, alpha, shader,
+            u, v);
+    }
+}
+
+
+/**
+ * Maps four whole image pixel coordinates to range from 0 to size - 1, see
+ * WrapImageCoordinate.
+ */
+template <PaintSpread Spread>
+static FORCE_INLINE __m128 WrapImageCoordinate_sse2(const __m128 c, const __m128 size) {
+    if constexpr (Spread == PaintSpread::Pad) {
+        return _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()),
+            _mm_sub_ps(size, _mm_set1_ps(1)));
+    } else if constexpr (Spread == PaintSpread::Repeat) {
+        return _mm_sub_ps(c, _mm_mul_ps(Floor_sse2(_mm_div_ps(c, size)),
+            size));
+    } else {
+        STATIC_ASSERT(Spread == PaintSpread::Reflect);
+
+        const __m128 period = _mm_add_ps(size, size);
+
+        const __m128 r = _mm_sub_ps(c, _mm_mul_ps(Floor_sse2(_mm_div_ps(c,
+            period)), period));
+
+        const __m128 m = _mm_sub_ps(_mm_sub_ps(period, _mm_set1_ps(1)), r);
+        const __m128 mask = _mm_cmpge_ps(r, size);
+
+        return _mm_or_ps(_mm_and_ps(mask, m), _mm_andnot_ps(mask, r));
+    }
+}
+
+
+/**
+ * Interpolates each channel of four pixels unpacked to 16 bit lanes, see
+ * LerpPixels. Calculated as ((a << 8) + b × w - a × w) >> 8, intermediate
+ * values may wrap around, but the final sum always fits into 16 bits.
+ */
+static FORCE_INLINE __m128i LerpPixels16_sse2(const __m128i a, const __m128i b, const __m128i w) {
+    return _mm_srli_epi16(_mm_add_epi16(_mm_slli_epi16(a, 8),
+        _mm_sub_epi16(_mm_mullo_epi16(b, w), _mm_mullo_epi16(a, w))), 8);
+}
+
+
+template <ImageFilter Filter, PaintSpread Spread>
+static FORCE_INLINE void CompositeImageSpan_sse2(const int pos,
+    const int end, uint32 *d, const int32 alpha, const PaintShader &shader,
+    const float u, const float v)
+{
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i a = _mm_set1_epi8(char(alpha));
+    const __m128 ux = _mm_set1_ps(shader.UX);
+    const __m128 vx = _mm_set1_ps(shader.VX);
+    const __m128 vu = _mm_set1_ps(u);
+    const __m128 vv = _mm_set1_ps(v);
+    const __m128 w = _mm_set1_ps(shader.ImageWidth);
+    const __m128 h = _mm_set1_ps(shader.ImageHeight);
+    const __m128 minc = _mm_set1_ps(-PaintMaxCoordinate);
+    const __m128 maxc = _mm_set1_ps(PaintMaxCoordinate);
+    const uint32 *pixels = shader.Pixels;
+    const int stride = shader.PixelsPerRow;
+
+    int x = pos;
+
+    for (; x <= end - 4; x += 4) {
+        const __m128 fx = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x),
+            lanes));
+
+        const __m128 pu = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(ux,
+            fx), vu), minc), maxc);
+
+        const __m128 pv = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(vx,
+            fx), vv), minc), maxc);
+
+        __m128i s;
+
+        if constexpr (Filter == ImageFilter::Nearest) {
+            alignas(16) int32 ix[4];
+            alignas(16) int32 iy[4];
+
+            _mm_store_si128(reinterpret_cast<__m128i *>(ix), _mm_cvttps_epi32(
+                WrapImageCoordinate_sse2<Spread>(Floor_sse2(pu), w)));
+
+            _mm_store_si128(reinterpret_cast<__m128i *>(iy), _mm_cvttps_epi32(
+                WrapImageCoordinate_sse2<Spread>(Floor_sse2(pv), h)));
+
+            s = _mm_setr_epi32(int(pixels[(iy[0] * stride) + ix[0]]),
+                int(pixels[(iy[1] * stride) + ix[1]]),
+                int(pixels[(iy[2] * stride) + ix[2]]),
+                int(pixels[(iy[3] * stride) + ix[3]]));
+        } else {
+            STATIC_ASSERT(Filter == ImageFilter::Bilinear);
+
+            const __m128 one = _mm_set1_ps(1);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 scale = _mm_set1_ps(256);
+            const __m128i zero = _mm_setzero_si128();
+
+            // Pixel centers are at half-integer coordinates.
+            const __m128 su = _mm_sub_ps(pu, half);
+            const __m128 sv = _mm_sub_ps(pv, half);
+            const __m128 fu = Floor_sse2(su);
+            const __m128 fv = Floor_sse2(sv);
+
+            alignas(16) int32 x0[4];
+            alignas(16) int32 x1[4];
+            alignas(16) int32 y0[4];
+            alignas(16) int32 y1[4];
+
+            _mm_store_si128(reinterpret_cast<__m128i *>(x0), _mm_cvttps_epi32(
+                WrapImageCoordinate_sse2<Spread>(fu, w)));
+
+            _mm_store_si128(reinterpret_cast<__m128i *>(x1), _mm_cvttps_epi32(
+                WrapImageCoordinate_sse2<Spread>(_mm_add_ps(fu, one), w)));
+
+            _mm_store_si128(reinterpret_cast<__m128i *>(y0), _mm_cvttps_epi32(
+                WrapImageCoordinate_sse2<Spread>(fv, h)));
+
+            _mm_store_si128(reinterpret_cast<__m128i *>(y1), _mm_cvttps_epi32(
+                WrapImageCoordinate_sse2<Spread>(_mm_add_ps(fv, one), h)));
+
+            alignas(16) uint32 c00[4];
+            alignas(16) uint32 c01[4];
+            alignas(16) uint32 c10[4];
+            alignas(16) uint32 c11[4];
+
+            for (int i = 0; i < 4; i++) {
+                const uint32 *row0 = pixels + (y0[i] * stride);
+                const uint32 *row1 = pixels + (y1[i] * stride);
+
+                c00[i] = row0[x0[i]];
+                c01[i] = row0[x1[i]];
+                c10[i] = row1[x0[i]];
+                c11[i] = row1[x1[i]];
+            }
+
+            // Weights in range 0-255, repeated in 16 bit lanes of each
+            // channel.
+            const __m128i wx = _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(su, fu),
+                scale));
+
+            const __m128i wy = _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(sv, fv),
+                scale));
+
+            const __m128i wx2 = _mm_or_si128(wx, _mm_slli_epi32(wx, 16));
+            const __m128i wy2 = _mm_or_si128(wy, _mm_slli_epi32(wy, 16));
+            const __m128i wxlo = _mm_unpacklo_epi32(wx2, wx2);
+            const __m128i wxhi = _mm_unpackhi_epi32(wx2, wx2);
+            const __m128i wylo = _mm_unpacklo_epi32(wy2, wy2);
+            const __m128i wyhi = _mm_unpackhi_epi32(wy2, wy2);
+
+            const __m128i p00 = _mm_load_si128(reinterpret_cast<const __m128i *>(c00));
+            const __m128i p01 = _mm_load_si128(reinterpret_cast<const __m128i *>(c01));
+            const __m128i p10 = _mm_load_si128(reinterpret_cast<const __m128i *>(c10));
+            const __m128i p11 = _mm_load_si128(reinterpret_cast<const __m128i *>(c11));
+
+            const __m128i toplo = LerpPixels16_sse2(
+                _mm_unpacklo_epi8(p00, zero), _mm_unpacklo_epi8(p01, zero),
+                wxlo);
+
+            const __m128i tophi = LerpPixels16_sse2(
+                _mm_unpackhi_epi8(p00, zero), _mm_unpackhi_epi8(p01, zero),
+                wxhi);
+
+            const __m128i bottomlo = LerpPixels16_sse2(
+                _mm_unpacklo_epi8(p10, zero), _mm_unpacklo_epi8(p11, zero),
+                wxlo);
+
+            const __m128i bottomhi = LerpPixels16_sse2(
+                _mm_unpackhi_epi8(p10, zero), _mm_unpackhi_epi8(p11, zero),
+                wxhi);
+
+            s = _mm_packus_epi16(LerpPixels16_sse2(toplo, bottomlo, wylo),
+                LerpPixels16_sse2(tophi, bottomhi, wyhi));
+        }
+
+        CompositePixels_sse2(d + x, s, alpha, a);
+    }
+
+    if (x < end) {
+        CompositeImageSpan_generic<Filter, Spread>(x, end, d, alpha, shader,
+            u, v);
+    }
+}
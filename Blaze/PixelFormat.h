@@ -0,0 +1,85 @@
+#pragma once
+
+
+#include "Utils.h"
+
+
+/**
+ * Pixel formats of destination images. Rasterizer composites in premultiplied
+ * RGBA8. BGRA8 is composited the same way with red and blue swapped, see
+ * Rasterizer::RasterizeFrame. Other formats are read and written directly by
+ * SpanBlenderFormat, which converts each destination pixel to premultiplied
+ * RGBA8 and back while compositing, so no separate conversion pass is
+ * needed. RGBA16 is composited with 16 bits per component instead. These
+ * only composite geometry colors with source over operator.
+ */
+enum class PixelFormat : uint8 {
+
+    /**
+     * 32 bits per pixel, bytes in red, green, blue, alpha order, color
+     * components premultiplied by alpha. Native format of rasterizer.
+     */
+    RGBA8 = 0,
+
+    /**
+     * 32 bits per pixel, bytes in blue, green, red, alpha order, color
+     * components premultiplied by alpha.
+     */
+    BGRA8,
+
+    /**
+     * 16 bits per pixel, 5 bits of red in the most significant bits, 6 bits
+     * of green and 5 bits of blue. There is no alpha, destination is opaque.
+     */
+    RGB565,
+
+    /**
+     * 32 bits per pixel, bytes in red, green, blue, alpha order, color
+     * components not premultiplied by alpha.
+     */
+    RGBA8Straight,
+
+    /**
+     * 64 bits per pixel, 16 bit red, green, blue and alpha components in this
+     * order, each in native byte order, color components premultiplied by
+     * alpha. Coverage of pixels is computed with 16 bits of precision as
+     * well, see AreaToAlphaNonZero16.
+     */
+    RGBA16
+};
+
+
+/**
+ * Returns a number of bytes one pixel of a given format takes.
+ */
+static constexpr int BytesPerPixelForFormat(const PixelFormat format) {
+    switch (format) {
+        case PixelFormat::RGB565:
+            return 2;
+        case PixelFormat::RGBA16:
+            return 8;
+        default:
+            return 4;
+    }
+}
+
+
+/**
+ * Returns human readable name of a given pixel format, for example "rgb565".
+ */
+static constexpr const char *GetPixelFormatName(const PixelFormat format) {
+    switch (format) {
+        case PixelFormat::RGBA8:
+            return "rgba8";
+        case PixelFormat::BGRA8:
+            return "bgra8";
+        case PixelFormat::RGB565:
+            return "rgb565";
+        case PixelFormat::RGBA8Straight:
+            return "rgba8-straight";
+        case PixelFormat::RGBA16:
+            return "rgba16";
+    }
+
+    return "unknown";
+}
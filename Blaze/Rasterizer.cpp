@@ -0,0 +1,209 @@
+
+#include "Rasterizer.h"
+
+
+/**
+ * Scenes having at least this many pixels of clipped geometry bounds per
+ * point are considered to consist of large fills and are rasterized with
+ * large tiles. Text and detailed illustrations have from a few to a few
+ * hundred pixels per point.
+ */
+static constexpr double LargeFillMinPixelsPerPoint = 1024;
+
+
+/**
+ * Carries tile descriptor type to generic function called by
+ * RasterizeWithTileShape.
+ */
+template <typename T>
+struct TileDescriptorTag final {
+    using Descriptor = T;
+};
+
+
+/**
+ * Resolves tile shape requested by options, see Rasterize, and calls a given
+ * function with TileDescriptorTag of that shape. This is the only place
+ * which maps tile shapes to tile descriptors.
+ *
+ * @return Tile shape function was called with. Never TileShape::Automatic.
+ */
+template <typename F>
+static TileShape RasterizeWithTileShape(const Geometry *geometries,
+    const int geometryCount, const Matrix &matrix, const ImageData &image,
+    const RasterizerOptions &options, const F &rasterize)
+{
+    TileShape shape = options.Shape;
+
+    if (shape == TileShape::Automatic) {
+        shape = SelectTileShape(geometries, geometryCount, matrix,
+            IntSize { image.Width, image.Height });
+    }
+
+    switch (shape) {
+        case TileShape::Tiles8x8:
+            rasterize(TileDescriptorTag<TileDescriptor_8x8>());
+            break;
+
+        case TileShape::Tiles8x32:
+            rasterize(TileDescriptorTag<TileDescriptor_8x32>());
+            break;
+
+        case TileShape::Tiles16x8:
+            rasterize(TileDescriptorTag<TileDescriptor_16x8>());
+            break;
+
+        case TileShape::Tiles64x16:
+            rasterize(TileDescriptorTag<TileDescriptor_64x16>());
+            break;
+
+        default:
+            shape = TileShape::Tiles8x16;
+
+            rasterize(TileDescriptorTag<TileDescriptor_8x16>());
+            break;
+    }
+
+    return shape;
+}
+
+
+TileShape Rasterize(const Geometry *geometries, const int geometryCount,
+    const Matrix &matrix, Threads &threads, const ImageData &image,
+    const RasterizerOptions &options)
+{
+    return RasterizeWithTileShape(geometries, geometryCount, matrix, image,
+        options, [&](const auto tag) {
+            using T = typename decltype(tag)::Descriptor;
+
+            Rasterizer<T>::Rasterize(geometries, geometryCount, matrix,
+                threads, image, options);
+        });
+}
+
+
+template <typename W>
+TileShape RasterizeMask(const Geometry *geometries, const int geometryCount,
+    const Matrix &matrix, Threads &threads, const ImageData &mask,
+    const RasterizerOptions &options)
+{
+    return RasterizeWithTileShape(geometries, geometryCount, matrix, mask,
+        options, [&](const auto tag) {
+            using T = typename decltype(tag)::Descriptor;
+
+            Rasterizer<T>::template RasterizeMask<W>(geometries,
+                geometryCount, matrix, threads, mask, options);
+        });
+}
+
+
+template TileShape RasterizeMask<SpanWriterMaskMax>(const Geometry *,
+    const int, const Matrix &, Threads &, const ImageData &,
+    const RasterizerOptions &);
+template TileShape RasterizeMask<SpanWriterMaskAdd>(const Geometry *,
+    const int, const Matrix &, Threads &, const ImageData &,
+    const RasterizerOptions &);
+template TileShape RasterizeMask<SpanWriterMaskSourceOver>(const Geometry *,
+    const int, const Matrix &, Threads &, const ImageData &,
+    const RasterizerOptions &);
+
+
+template <PixelFormat F>
+TileShape RasterizeInFormat(const Geometry *geometries,
+    const int geometryCount, const Matrix &matrix, Threads &threads,
+    const ImageData &image, const RasterizerOptions &options)
+{
+    return RasterizeWithTileShape(geometries, geometryCount, matrix, image,
+        options, [&](const auto tag) {
+            using T = typename decltype(tag)::Descriptor;
+
+            Rasterizer<T>::template RasterizeInFormat<F>(geometries,
+                geometryCount, matrix, threads, image, options);
+        });
+}
+
+
+template TileShape RasterizeInFormat<PixelFormat::RGBA8>(const Geometry *,
+    const int, const Matrix &, Threads &, const ImageData &,
+    const RasterizerOptions &);
+template TileShape RasterizeInFormat<PixelFormat::BGRA8>(const Geometry *,
+    const int, const Matrix &, Threads &, const ImageData &,
+    const RasterizerOptions &);
+template TileShape RasterizeInFormat<PixelFormat::RGB565>(const Geometry *,
+    const int, const Matrix &, Threads &, const ImageData &,
+    const RasterizerOptions &);
+template TileShape RasterizeInFormat<PixelFormat::RGBA8Straight>(
+    const Geometry *, const int, const Matrix &, Threads &,
+    const ImageData &, const RasterizerOptions &);
+template TileShape RasterizeInFormat<PixelFormat::RGBA16>(const Geometry *,
+    const int, const Matrix &, Threads &, const ImageData &,
+    const RasterizerOptions &);
+
+
+TileShape SelectTileShape(const Geometry *geometries,
+    const int geometryCount, const Matrix &matrix, const IntSize imageSize)
+{
+    ASSERT(geometries != nullptr);
+
+    double width = 0;
+    double height = 0;
+    double area = 0;
+    double pointCount = 0;
+
+    for (int i = 0; i < geometryCount; i++) {
+        const Geometry &g = geometries[i];
+
+        Matrix tm(g.TM);
+
+        tm.PreMultiply(matrix);
+
+        const IntRect b = tm.MapBoundingRect(g.PathBounds);
+
+        const int w = Min(b.MaxX, imageSize.Width) - Max(b.MinX, 0);
+        const int h = Min(b.MaxY, imageSize.Height) - Max(b.MinY, 0);
+
+        if (w <= 0 or h <= 0) {
+            continue;
+        }
+
+        width += w;
+        height += h;
+        area += double(w) * double(h);
+        pointCount += g.PointCount;
+    }
+
+    if (area < (pointCount * LargeFillMinPixelsPerPoint)) {
+        return TileShape::Tiles8x16;
+    }
+
+    // Rasterizer may write up to the right edge of the last tile column, 64
+    // pixel wide tiles are only used if image width is a multiple of that.
+    if (height > width or
+        (imageSize.Width % TileDescriptor_64x16::TileW) != 0)
+    {
+        return TileShape::Tiles8x32;
+    }
+
+    return TileShape::Tiles64x16;
+}
+
+
+const char *GetTileShapeName(const TileShape shape)
+{
+    switch (shape) {
+        case TileShape::Automatic:
+            return "automatic";
+        case TileShape::Tiles8x8:
+            return "8x8";
+        case TileShape::Tiles8x16:
+            return "8x16";
+        case TileShape::Tiles8x32:
+            return "8x32";
+        case TileShape::Tiles16x8:
+            return "16x8";
+        case TileShape::Tiles64x16:
+            return "64x16";
+    }
+
+    return "unknown";
+}
@@ -4,6 +4,7 @@
 
 #include "ImageData.h"
 #include "Linearizer.h"
+#include "RasterizerOptions.h"
 #include "Threads.h"
 
 
@@ -24,12 +25,165 @@
  * @param threads Threads to use.
  *
  * @param image Destination image. 
+ *
+ * @param options Optional rasterizer features. See RasterizerOptions.
  */
 template <typename T>
 static FORCE_INLINE void Rasterize(const Geometry *geometries,
     const int geometryCount, const Matrix &matrix, Threads &threads,
-    const ImageData &image)
+    const ImageData &image, const RasterizerOptions &options = RasterizerOptions())
 {
     Rasterizer<T>::Rasterize(geometries, geometryCount, matrix, threads,
-    image);
+    image, options);
 }
+
+
+/**
+ * Rasterize 8 bit coverage mask, for example glyph atlas or shadow mask.
+ * Each pixel of destination image is one byte. Span writer W determines how
+ * coverage of each geometry is combined with destination, it must be one of
+ * SpanWriterMaskMax, SpanWriterMaskAdd or SpanWriterMaskSourceOver. Paints,
+ * blend modes and layers of geometries are ignored, coverage is multiplied
+ * by alpha of geometry color.
+ *
+ * @param geometries Pointer to geometries to rasterize. Must not be nullptr.
+ *
+ * @param geometryCount A number of geometries in geometry array. Must be at
+ * least 1.
+ *
+ * @param matrix Transformation matrix. All geometries will be pre-transformed
+ * by this matrix when rasterizing.
+ *
+ * @param threads Threads to use.
+ *
+ * @param mask Destination mask, one byte per pixel.
+ *
+ * @param options Optional rasterizer features. See RasterizerOptions.
+ */
+template <typename T, typename W>
+static FORCE_INLINE void RasterizeMask(const Geometry *geometries,
+    const int geometryCount, const Matrix &matrix, Threads &threads,
+    const ImageData &mask, const RasterizerOptions &options = RasterizerOptions())
+{
+    Rasterizer<T>::template RasterizeMask<W>(geometries, geometryCount,
+        matrix, threads, mask, options);
+}
+
+
+/**
+ * Rasterize image of a given pixel format. Destination pixels are read and
+ * written in format F directly while compositing, there is no conversion
+ * pass. PixelFormat::RGBA8 and PixelFormat::BGRA8 support everything
+ * Rasterize does. Other formats only composite geometry colors with source
+ * over operator, see SpanBlenderFormat. Geometries rasterized into them must
+ * not have paints, blend modes other than source over or layers, and linear
+ * blending must be disabled.
+ *
+ * @param geometries Pointer to geometries to rasterize. Must not be nullptr.
+ *
+ * @param geometryCount A number of geometries in geometry array. Must be at
+ * least 1.
+ *
+ * @param matrix Transformation matrix. All geometries will be pre-transformed
+ * by this matrix when rasterizing.
+ *
+ * @param threads Threads to use.
+ *
+ * @param image Destination image in pixel format F.
+ *
+ * @param options Optional rasterizer features. See RasterizerOptions.
+ */
+template <typename T, PixelFormat F>
+static FORCE_INLINE void RasterizeInFormat(const Geometry *geometries,
+    const int geometryCount, const Matrix &matrix, Threads &threads,
+    const ImageData &image, const RasterizerOptions &options = RasterizerOptions())
+{
+    Rasterizer<T>::template RasterizeInFormat<F>(geometries, geometryCount,
+        matrix, threads, image, options);
+}
+
+
+/**
+ * Rasterize image with tile descriptor selected at runtime. Tile descriptor
+ * is selected by RasterizerOptions::Shape. If it is TileShape::Automatic,
+ * SelectTileShape selects one for this frame.
+ *
+ * @param geometries Pointer to geometries to rasterize. Must not be nullptr.
+ *
+ * @param geometryCount A number of geometries in geometry array. Must be at
+ * least 1.
+ *
+ * @param matrix Transformation matrix. All geometries will be pre-transformed
+ * by this matrix when rasterizing.
+ *
+ * @param threads Threads to use.
+ *
+ * @param image Destination image. Image width must be a multiple of tile
+ * width of selected tile shape, DestinationImage rounds its width to 64
+ * pixels, which works with all of them.
+ *
+ * @param options Optional rasterizer features. See RasterizerOptions.
+ *
+ * @return Tile shape image was rasterized with. Never TileShape::Automatic.
+ */
+TileShape Rasterize(const Geometry *geometries, const int geometryCount,
+    const Matrix &matrix, Threads &threads, const ImageData &image,
+    const RasterizerOptions &options = RasterizerOptions());
+
+
+/**
+ * Rasterize 8 bit coverage mask with tile descriptor selected at runtime, the
+ * same way as Rasterize does. See RasterizeMask with tile descriptor
+ * parameter for description of span writer W. Instantiated for
+ * SpanWriterMaskMax, SpanWriterMaskAdd and SpanWriterMaskSourceOver.
+ *
+ * @return Tile shape mask was rasterized with. Never TileShape::Automatic.
+ */
+template <typename W>
+TileShape RasterizeMask(const Geometry *geometries, const int geometryCount,
+    const Matrix &matrix, Threads &threads, const ImageData &mask,
+    const RasterizerOptions &options = RasterizerOptions());
+
+
+/**
+ * Rasterize image of a given pixel format with tile descriptor selected at
+ * runtime, the same way as Rasterize does. See RasterizeInFormat with tile
+ * descriptor parameter for details. Instantiated for all pixel formats.
+ *
+ * @return Tile shape image was rasterized with. Never TileShape::Automatic.
+ */
+template <PixelFormat F>
+TileShape RasterizeInFormat(const Geometry *geometries,
+    const int geometryCount, const Matrix &matrix, Threads &threads,
+    const ImageData &image,
+    const RasterizerOptions &options = RasterizerOptions());
+
+
+/**
+ * Selects tile shape for rasterizing a given frame. Only looks at bounds of
+ * transformed geometries clipped to destination image and their point
+ * counts, so selection takes a fraction of time rasterizing takes.
+ *
+ * Most geometries of typical scenes, like text and icons, are small and have
+ * many points for their size. Such scenes use 8×16 tiles. Scenes where
+ * geometries are large for a number of points they have spend most of the
+ * time filling large areas. Such scenes use 64×16 tiles, or 8×32 tiles if
+ * geometries are taller than they are wide on average or image width is
+ * not a multiple of 64.
+ *
+ * @param geometries Pointer to geometries to rasterize. Must not be nullptr.
+ *
+ * @param geometryCount A number of geometries in geometry array.
+ *
+ * @param matrix Transformation matrix geometries will be rasterized with.
+ *
+ * @param imageSize Size of destination image.
+ */
+TileShape SelectTileShape(const Geometry *geometries,
+    const int geometryCount, const Matrix &matrix, const IntSize imageSize);
+
+
+/**
+ * Returns human readable name of a given tile shape, for example "8x16".
+ */
+const char *GetTileShapeName(const TileShape shape);
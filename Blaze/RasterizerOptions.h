@@ -0,0 +1,141 @@
+
+#pragma once
+
+
+#include <stdatomic.h>
+#include "Utils.h"
+
+
+/**
+ * Counters collected while rasterizing. All counters are updated atomically,
+ * so one instance can be shared by all threads rendering the same frame.
+ * Counters are never reset by rasterizer, call Reset before rendering a frame
+ * to get numbers for that frame only.
+ */
+struct RasterizerStatistics final {
+    RasterizerStatistics() {
+    }
+
+    void Reset();
+
+    // A number of tiles composited into destination image. One geometry
+    // covering a tile counts as one tile, so this value divided by the number
+    // of tiles in destination image gives average overdraw.
+    atomic_int CompositedTileCount = 0;
+
+    // A number of tiles that were not composited because opaque geometries
+    // drawn later completely hide them.
+    atomic_int CulledTileCount = 0;
+
+    // A number of bytes taken by line blocks of all rasterized geometries.
+    atomic_llong LineBlockBytes = 0;
+private:
+    DISABLE_COPY_AND_ASSIGN(RasterizerStatistics);
+};
+
+
+/**
+ * Determines how linearizer stores lines of each geometry.
+ */
+enum class LineEncoding : uint8 {
+
+    /**
+     * Delta encoding is selected for geometries with enough lines per tile
+     * row for it to take less memory, fixed size lines otherwise. Both give
+     * exactly the same result. Tiled lines are never selected.
+     */
+    Automatic = 0,
+
+    /**
+     * Lines are always stored with fixed size coordinates, 8 bytes per line
+     * for narrow geometries and 12 bytes per line for wide ones.
+     */
+    Fixed,
+
+    /**
+     * Lines are always delta encoded, see LineArrayDeltaBlock. Mostly useful
+     * for testing and benchmarking.
+     */
+    Delta,
+
+    /**
+     * Lines are split at tile column boundaries and stored separately for
+     * each tile, see LineArrayTiled. Rows of such geometries can be searched
+     * for fully covered tiles regardless of how many lines they have.
+     * Splitting rounds the points where lines cross column boundaries, so
+     * alpha of some edge pixels can differ by a few steps from other
+     * encodings. Wide geometries with just a few edges in each row take
+     * much less memory in this encoding.
+     */
+    Tiled
+};
+
+
+/**
+ * Tile sizes rasterizer can linearize geometries into. Each value except
+ * Automatic corresponds to one tile descriptor, for example Tiles8x16
+ * corresponds to TileDescriptor_8x16. Only used by Rasterize function which
+ * selects tile descriptor at runtime.
+ */
+enum class TileShape : uint8 {
+
+    /**
+     * Tile shape is selected for each frame, see SelectTileShape.
+     */
+    Automatic = 0,
+
+    Tiles8x8,
+    Tiles8x16,
+    Tiles8x32,
+    Tiles16x8,
+    Tiles64x16
+};
+
+
+/**
+ * Optional rasterizer features. Default values select the regular
+ * rasterization path.
+ */
+struct RasterizerOptions final {
+
+    /**
+     * When enabled, each tile row is scanned from top to bottom before
+     * rendering and geometries hidden beneath fully covered tiles of opaque
+     * geometries are skipped. Only geometries with color alpha equal to 255
+     * can hide anything.
+     */
+    bool OcclusionCulling = false;
+
+    /**
+     * When enabled, geometries filled with plain color using source over
+     * operator are composited in linear light instead of blending sRGB
+     * encoded values, see LinearBlendOps.h. Anti-aliased edges and
+     * translucent colors then have correct weight without supersampling.
+     * Paints, other blend modes and compositing of layers onto destination
+     * are not affected. Only used when rendering into RGBA8 images.
+     */
+    bool LinearBlending = false;
+
+    /**
+     * Selects how lines are stored between linearization and rasterization.
+     */
+    LineEncoding Encoding = LineEncoding::Automatic;
+
+    /**
+     * Selects tile descriptor used by Rasterize function which is not given
+     * one at compile time. Ignored by Rasterize<T>.
+     */
+    TileShape Shape = TileShape::Automatic;
+
+    /**
+     * If not nullptr, rasterizer will add its counters to this object.
+     */
+    RasterizerStatistics *Statistics = nullptr;
+};
+
+
+FORCE_INLINE void RasterizerStatistics::Reset() {
+    CompositedTileCount = 0;
+    CulledTileCount = 0;
+    LineBlockBytes = 0;
+}
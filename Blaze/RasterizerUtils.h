@@ -2,6 +2,7 @@
 #pragma once
 
 
+#include "F24Dot8.h"
 #include "Utils.h"
 
 
@@ -51,6 +52,48 @@ static constexpr int32 AreaToAlphaEvenOdd(const int32 area) {
 }
 
 
+/**
+ * Given area, calculate alpha in range 0-65535 using non-zero fill rule. The
+ * same as AreaToAlphaNonZero, but keeps 16 bits of area precision for
+ * destinations with 16 bits per component.
+ */
+static constexpr int32 AreaToAlphaNonZero16(const int32 area) {
+    STATIC_ASSERT(SIZE_OF(int32) == 4);
+
+    const int32 aa = area >> 1;
+
+    // Find absolute area value.
+    const int32 mask = aa >> 31;
+    const int32 aaabs = (aa + mask) ^ mask;
+
+    // Clamp absolute area value to be 65535 or less.
+    return Min(aaabs, 65535);
+}
+
+
+/**
+ * Given area, calculate alpha in range 0-65535 using even-odd fill rule. The
+ * same as AreaToAlphaEvenOdd, but keeps 16 bits of area precision.
+ */
+static constexpr int32 AreaToAlphaEvenOdd16(const int32 area) {
+    STATIC_ASSERT(SIZE_OF(int32) == 4);
+
+    const int32 aa = area >> 1;
+
+    // Find absolute area value.
+    const int32 mask = aa >> 31;
+    const int32 aaabs = (aa + mask) ^ mask;
+
+    const int32 aac = aaabs & 131071;
+
+    if (aac > 65536) {
+        return 131072 - aac;
+    }
+
+    return Min(aac, 65535);
+}
+
+
 /**
  * This function returns 1 if value is greater than zero and it is divisible
  * by 256 (equal to one in 24.8 format) without a reminder.
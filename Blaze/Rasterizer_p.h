@@ -1,10 +1,16 @@
 
+#include "AccumulationOps.h"
 #include "BitOps.h"
+#include "CellOps.h"
 #include "CompositionOps.h"
 #include "IntSize.h"
+#include "LinearBlendOps.h"
 #include "Linearizer.h"
 #include "LineArray.h"
+#include "MaskOps.h"
+#include "PaintOps.h"
 #include "Rasterizer.h"
+#include "RasterizerOptions.h"
 #include "RasterizerUtils.h"
 #include "RowItemList.h"
 #include "SIMD.h"
@@ -18,7 +24,32 @@ struct Rasterizer final {
 
     static void Rasterize(const Geometry *inputGeometries,
         const int inputGeometryCount, const Matrix &matrix, Threads &threads,
-        const ImageData &image);
+        const ImageData &image, const RasterizerOptions &options);
+
+
+    /**
+     * Rasterizes geometries into 8 bit coverage mask with span writer W, see
+     * MaskOps.h. Geometries go through the same tile pipeline as with
+     * Rasterize, but paints, blend modes and layers are ignored and only
+     * alpha of geometry color is used.
+     */
+    template <typename W>
+    static void RasterizeMask(const Geometry *inputGeometries,
+        const int inputGeometryCount, const Matrix &matrix, Threads &threads,
+        const ImageData &mask, const RasterizerOptions &options);
+
+
+    /**
+     * Rasterizes geometries into destination image of pixel format F. RGBA8
+     * and BGRA8 are rasterized the same way as Rasterize does, see
+     * RasterizeFrame. Other formats are composited by SpanBlenderFormat with
+     * geometry color using source over operator, geometries must not have
+     * paints, blend modes or layers and linear blending must be disabled.
+     */
+    template <PixelFormat F>
+    static void RasterizeInFormat(const Geometry *inputGeometries,
+        const int inputGeometryCount, const Matrix &matrix, Threads &threads,
+        const ImageData &image, const RasterizerOptions &options);
 
 private:
 
@@ -38,6 +69,135 @@ private:
     using LineIterationFunction = void (*)(const RasterizableItem *,
         BitVector **, int32 **);
 
+
+    /**
+     * A run of horizontally adjacent tiles within one row which contain no
+     * edges and are completely covered by geometry. Column indices are
+     * relative to geometry bounds. End is exclusive.
+     */
+    struct SolidTileRun final {
+        TileIndex Begin;
+        TileIndex End;
+    };
+
+
+    /**
+     * Solid tile runs are only searched for in rows with at most this many
+     * lines. Rows of large shapes have just a few lines each, while rows with
+     * more lines rarely have tiles without edges and searching them costs
+     * more than solid runs save.
+     */
+    static constexpr int MaximumLineCountForSolidTileRuns = 8;
+
+
+    /**
+     * Each line can split one run into two.
+     */
+    static constexpr int MaximumSolidTileRunsPerRow =
+        MaximumLineCountForSolidTileRuns + 1;
+
+
+    /**
+     * Bit vector is rendered by RenderDenseBits if there are at least
+     * DenseBitsMinRange pixels between the first and the last bit, including
+     * both, and at least one of every DenseBitsDivisor of these pixels has a
+     * bit set. Otherwise bits are scanned one by one.
+     */
+    static constexpr int DenseBitsMinRange = 8;
+    static constexpr int DenseBitsDivisor = 2;
+
+
+    /**
+     * Item is rasterized into dense cover/area rows instead of bit vector
+     * tracked ones if it has at least one line for every
+     * DenseAccumulationPixelsPerLine pixels of its width. Such rows are
+     * cleared before rasterizing lines, which only pays off when most pixels
+     * have edges.
+     */
+    static constexpr int DenseAccumulationPixelsPerLine = 4;
+
+
+    /**
+     * With automatic line encoding, geometries with many contours keep fixed
+     * size lines unless they have at least this many points per contour per
+     * tile row. Delta encoded line takes 4 bytes when it continues the
+     * previous line in the same row and 14 bytes otherwise. Each contour
+     * enters each row it crosses at least twice, so contours with just a few
+     * lines in each row, like long vertical bars, mostly produce 14 byte
+     * lines. Geometries with a few contours are always delta encoded, their
+     * rows fit into one block in either encoding and delta encoded block is
+     * the smallest one.
+     */
+    static constexpr int DeltaEncodingMinPointsPerContourRow = 4;
+
+
+    /**
+     * All solid tile runs found within one row of geometry, sorted from left
+     * to right.
+     */
+    struct SolidTileRunList final {
+        const SolidTileRun *Runs = nullptr;
+        int Count = 0;
+    };
+
+
+    /**
+     * A range of pixels within one scanline. End is exclusive.
+     */
+    struct PixelSpan final {
+        int Begin;
+        int End;
+    };
+
+
+    /**
+     * Span blender which leaves pixels within given spans untouched and
+     * passes everything else to blender B. Spans must be sorted from left to
+     * right and must not overlap. Composited spans must also arrive in left
+     * to right order, which is how RenderOneLine produces them.
+     */
+    template <typename B>
+    struct SpanBlenderSkippingSpans final {
+        SpanBlenderSkippingSpans(const B &blender, const PixelSpan *spans,
+            const int spanCount);
+
+        void CompositeSpan(int pos, const int end, uint32 *d,
+            const int32 alpha);
+
+        const B Blender;
+        const PixelSpan *Current;
+        const PixelSpan *End;
+    };
+
+
+    /**
+     * Lines of one tile column within one row of geometry linearized into
+     * LineArrayTiled. X coordinates of lines are relative to the left edge of
+     * tile column.
+     */
+    struct TiledLineColumn final {
+        // The newest block of column, linked to older ones. Only this block
+        // can be partially filled.
+        const LineArrayTiledBlock *Block;
+
+        // Tile column index, relative to geometry bounds.
+        TileIndex Index;
+
+        // A number of lines in all blocks of this column.
+        int LineCount;
+    };
+
+
+    /**
+     * Lines of one row of geometry linearized into LineArrayTiled. Only tile
+     * columns containing lines are listed, sorted from left to right.
+     */
+    struct TiledLineRow final {
+        const TiledLineColumn *Columns;
+        int ColumnCount;
+    };
+
+
     struct RasterizableGeometry final {
         constexpr RasterizableGeometry(const Geometry *geometry,
             const LineIterationFunction iterationFunction,
@@ -50,15 +210,34 @@ private:
 
         void *GetLinesForRow(const int rowIndex) const;
         int GetFirstBlockLineCountForRow(const int rowIndex) const;
+        int GetLineCountForRow(const int rowIndex) const;
         const int32 *GetCoversForRow(const int rowIndex) const;
         const int32 *GetActualCoversForRow(const int rowIndex) const;
+        const SolidTileRunList *GetSolidTileRunsForRow(const int rowIndex) const;
 
         const Geometry *Geometry = nullptr;
         const LineIterationFunction IterationFunction = nullptr;
         const TileBounds Bounds;
         void **Lines = nullptr;
         int *FirstBlockLineCounts = nullptr;
+        int *LineCounts = nullptr;
         int32 **StartCoverTable = nullptr;
+
+        // Fully covered tiles. Rasterizer fills these without scanning bit
+        // vectors and uses them to find hidden items when occlusion culling
+        // is enabled.
+        SolidTileRunList *SolidTileRuns = nullptr;
+
+        // Paint prepared for rendering, nullptr if geometry is filled with
+        // solid color.
+        const PaintShader *Shader = nullptr;
+
+        // Clip path, nullptr if geometry is not clipped.
+        const RasterizableGeometry *Clip = nullptr;
+
+        // Index of the first geometry of layer group this geometry belongs
+        // to. Not used if geometry has no layer.
+        int LayerGroup = 0;
     };
 
 
@@ -68,8 +247,10 @@ private:
             const int localRowIndex);
 
         int GetFirstBlockLineCount() const;
+        int GetLineCount() const;
         const void *GetLineArray() const;
         const int32 *GetActualCovers() const;
+        const SolidTileRunList *GetSolidTileRuns() const;
 
         // Do not initialize these since they are allocated in bunches.
         const RasterizableGeometry *Rasterizable;
@@ -85,14 +266,143 @@ private:
         BitVector **bitVectorTable, int32 **coverAreaTable);
 
 
+    static void IterateLinesDelta(const RasterizableItem *item,
+        BitVector **bitVectorTable, int32 **coverAreaTable);
+
+
+    static void IterateLinesTiled(const RasterizableItem *item,
+        BitVector **bitVectorTable, int32 **coverAreaTable);
+
+
     static RasterizableGeometry *CreateRasterizable(void *placement,
-        const Geometry *geometry, const IntSize imageSize, ThreadMemory &memory);
+        const Geometry *geometry, const IntSize imageSize,
+        const RasterizerOptions &options, ThreadMemory &memory);
+
+
+    /**
+     * Returns true if delta encoded lines of a given geometry are expected
+     * to take less memory than fixed size ones. See
+     * DeltaEncodingMinPointsPerContourRow.
+     */
+    static bool PrefersDeltaEncoding(const Geometry *geometry,
+        const TileBounds &bounds);
+
+
+    /**
+     * Returns a number of contours linearizer produces for a given geometry.
+     * Stroke outline consists of separate polygons for each segment and
+     * join, so stroked geometry is counted as two contours per tag.
+     */
+    static int CountContours(const Geometry *geometry);
 
 
     template <typename L>
     static RasterizableGeometry *Linearize(void *placement, const Geometry *geometry,
         const TileBounds &bounds, const IntSize imageSize,
-        const LineIterationFunction iterationFunction, ThreadMemory &memory);
+        const LineIterationFunction iterationFunction,
+        const RasterizerOptions &options, ThreadMemory &memory);
+
+
+    /**
+     * Linearizes geometry into LineArrayTiled and finds solid tile runs of
+     * each row from per column covers.
+     */
+    template <typename L>
+    static RasterizableGeometry *LinearizeTiled(void *placement,
+        const Geometry *geometry, const TileBounds &bounds,
+        const IntSize imageSize, const RasterizerOptions &options,
+        ThreadMemory &memory);
+
+
+    /**
+     * Removes cover arrays containing only zeroes from start cover table
+     * returned by linearizer. Returns the same table, which can be nullptr.
+     */
+    static int32 **FinalizeStartCoverTable(int32 **startCoverTable,
+        const TileIndex rowCount);
+
+
+    /**
+     * Returns a number of lines in line block which is not the front block
+     * of its row.
+     */
+    static int GetFullBlockLineCount(const LineArrayX16Y16Block *block);
+    static int GetFullBlockLineCount(const LineArrayX32Y16Block *block);
+    static int GetFullBlockLineCount(const LineArrayDeltaBlock *block);
+
+
+    static void UnpackLines(F24Dot8 *x0, F24Dot8 *y0, F24Dot8 *x1,
+        F24Dot8 *y1, const LineArrayX16Y16Block *block, const int count);
+
+
+    static void UnpackLines(F24Dot8 *x0, F24Dot8 *y0, F24Dot8 *x1,
+        F24Dot8 *y1, const LineArrayX32Y16Block *block, const int count);
+
+
+    static void UnpackLines(F24Dot8 *x0, F24Dot8 *y0, F24Dot8 *x1,
+        F24Dot8 *y1, const LineArrayDeltaBlock *block, const int count);
+
+
+    /**
+     * Unpacks lines of tiled line array block. Lines in tiled blocks are
+     * relative to their tile column, x is added to X coordinates.
+     */
+    static void UnpackLines(F24Dot8 *x0, F24Dot8 *y0, F24Dot8 *x1,
+        F24Dot8 *y1, const LineArrayTiledBlock *block, const int count,
+        const F24Dot8 x);
+
+
+    /**
+     * Decodes a given number of lines from delta encoded line block.
+     *
+     * @param position Index of the first word to decode. Updated to point
+     * past the last decoded line.
+     *
+     * @param x X coordinate where the previous line ended. Updated to the end
+     * of the last decoded line.
+     *
+     * @param y Y coordinate where the previous line ended. Updated to the end
+     * of the last decoded line.
+     */
+    static void DecodeLines(F24Dot8 *x0, F24Dot8 *y0, F24Dot8 *x1,
+        F24Dot8 *y1, const LineArrayDeltaBlock *block, const int count,
+        int &position, F24Dot8 &x, F24Dot8 &y);
+
+
+    /**
+     * Finds solid tile runs within one row of geometry.
+     *
+     * @param runs Destination array for runs. Must have space for at least
+     * MaximumSolidTileRunsPerRow runs.
+     *
+     * @param block The first line block of row. Can be nullptr if row has no
+     * lines.
+     *
+     * @param lineCount A number of lines in block. Must not exceed
+     * MaximumLineCountForSolidTileRuns.
+     *
+     * @param covers Start covers for row. Must not be nullptr.
+     *
+     * @param columnCount A number of tile columns in geometry bounds.
+     *
+     * @param height A number of pixel rows within tile row that are inside
+     * destination image.
+     *
+     * @param rule Fill rule of geometry.
+     */
+    template <typename B>
+    static int FindSolidTileRunsForRow(SolidTileRun *runs, const B *block,
+        const int lineCount, const int32 *covers, const TileIndex columnCount,
+        const int height, const FillRule rule);
+
+
+    /**
+     * Returns true if all given covers produce full alpha according to fill
+     * rule. Covers are checked with 16 bits of precision, so tiles found
+     * solid are solid for both 8 and 16 bit coverage.
+     */
+    static bool CoversAreSolid(const int32 *covers, const int height,
+        const FillRule rule);
 
 
     static void Vertical_Down(BitVector **bitVectorTable, int32 **coverAreaTable,
@@ -113,6 +423,38 @@ private:
         const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1);
 
 
+    /**
+     * Adds cover and area to pixel, setting its bit if this is the first
+     * contribution to that pixel.
+     */
+    static void UpdateCell(BitVector **bitVectorTable, int32 **coverAreaTable,
+        const PixelIndex px, const PixelIndex py, const int32 cover,
+        const int32 area);
+
+
+    /**
+     * Finds if bit at a given index is set to 1. If it is, this function
+     * returns false. Otherwise, it sets bit at this index and returns true.
+     * Same as ConditionalSetBit, except that it also marks bit vector as not
+     * empty in summary when the first bit is set in it.
+     *
+     * Each row of bit vectors is preceded by a summary with one bit for
+     * every bit vector in a row. Summary is stored in reverse order, first
+     * summary value is at index -1, second at -2 and so on. This way finding
+     * and clearing bit vectors with bits set does not need to touch the
+     * rest of the row, which is most of the row for wide geometries.
+     */
+    static bool ConditionalSetMarkedBit(BitVector *bitVectors,
+        const PixelIndex index);
+
+
+    /**
+     * Sets all bit vectors marked in summary to zero and clears summary.
+     */
+    static void ClearMarkedBitVectors(BitVector *bitVectors,
+        const int bitVectorCount);
+
+
     /**
      * ⬊
      *
@@ -242,121 +584,665 @@ private:
         int32 **coverAreaTable);
 
 
+    /**
+     * Rasterizes all lines in one line block. Lines are decoded in one go
+     * and lines which do not leave a single pixel are found and accumulated
+     * in batches, see FindSingleCellLines. Remaining lines are passed to
+     * RasterizeLine one by one.
+     */
+    template <typename B>
+    static void RasterizeLineBlock(const B *block, const int count,
+        BitVector **bitVectorTable, int32 **coverAreaTable);
+
+
+    /**
+     * Rasterizes a batch of decoded lines. Arrays must have space for at
+     * least CellBatchSize lines, count must not exceed CellBatchSize. Space
+     * after the last line is overwritten.
+     */
+    static void RasterizeLines(F24Dot8 *x0, F24Dot8 *y0, F24Dot8 *x1,
+        F24Dot8 *y1, const int count, BitVector **bitVectorTable,
+        int32 **coverAreaTable);
+
+
     template <typename B, FillRuleFn ApplyFillRule>
     static void RenderOneLine(uint8 *image, const BitVector *bitVectorTable,
-        const int bitVectorCount, const int32 *coverAreaTable, const int x,
-        const int rowLength, const int32 startCover, const uint32 color);
+        const int bitVectorCount, int32 *coverAreaTable, const int x,
+        const int rowLength, const int32 startCover, B blender);
 
 
     /**
-     * Rasterize one item within a single row.
+     * Renders one scanline of item rasterized with dense accumulation. Cover
+     * and area of every pixel up to the last bit set are valid, pixels
+     * without edges have them set to zero. Produces exactly the same pixels
+     * as RenderOneLine.
      */
-    static void RasterizeOneItem(const RasterizableItem *item,
-        BitVector **bitVectorTable, int32 **coverAreaTable,
-        const int columnCount, const ImageData &image);
+    template <typename B, FillRuleFn ApplyFillRule>
+    static void RenderOneLineAccumulated(uint8 *image,
+        const BitVector *bitVectorTable, const int bitVectorCount,
+        const int32 *coverAreaTable, const int x, const int rowLength,
+        const int32 startCover, B blender);
 
 
     /**
-     * Rasterize all items in one row.
+     * Renders pixels from the first to the last bit set in one bit vector
+     * of a row where most of these pixels have edges. Span state is the same
+     * as in RenderOneLine and is updated so that RenderOneLine can continue
+     * after this function returns. Cover and area of pixels in range without
+     * bits set are zeroed.
      */
-    static void RasterizeRow(const RowItemList<RasterizableItem> *rowList,
-        ThreadMemory &memory, const ImageData &image);
+    template <typename B, FillRuleFn ApplyFillRule>
+    static void RenderDenseBits(uint32 *d, const BitVector bitset,
+        const uint32 bitsetIndex, int32 *coverAreaTable, const int x,
+        int32 &cover, uint32 &spanX, uint32 &spanEnd, uint32 &spanAlpha,
+        B &blender);
 
-private:
-    Rasterizer() = delete;
-};
 
+    /**
+     * Coverage of a clip path within one tile row. Items clipped by the same
+     * path share it, clip path is rendered again only when an item clipped
+     * by a different path is reached.
+     */
+    struct ClipMask final {
+        // Clip path rendered into mask, nullptr if none yet.
+        const RasterizableGeometry *Clip = nullptr;
+
+        // T::TileH rows of clip path coverage and the same number of rows
+        // for coverage of clipped item, PixelsPerRow values in range 0-255
+        // each. Allocated when the first clipped item is reached.
+        uint32 *Mask = nullptr;
+        uint32 *Coverage = nullptr;
+        int PixelsPerRow = 0;
+
+        // Pixels of mask which can have non-zero coverage.
+        int MinX = 0;
+        int MaxX = 0;
+    };
 
-template <typename T>
-FORCE_INLINE void Rasterizer<T>::Rasterize(const Geometry *inputGeometries,
-    const int inputGeometryCount, const Matrix &matrix, Threads &threads,
-    const ImageData &image)
-{
-    ASSERT(inputGeometries != nullptr);
-    ASSERT(inputGeometryCount > 0);
-    ASSERT(image.Data != nullptr);
-    ASSERT(image.Width > 0);
-    ASSERT(image.Height > 0);
-    ASSERT(image.BytesPerRow >= (image.Width * 4));
 
-    // TODO
-    // Skip transform if matrix is identity.
-    Geometry *geometries = static_cast<Geometry *>(
-        threads.MallocMain(SIZE_OF(Geometry) * inputGeometryCount));
+    /**
+     * Pixels of one layer group within one tile row. Items of the group are
+     * composited into layer buffer and buffer is composited into destination
+     * image when the first item outside of the group is reached.
+     */
+    struct LayerBuffer final {
+        // Layer of group composited into buffer, nullptr if none.
+        const ::Layer *Layer = nullptr;
+
+        // Layer group, see RasterizableGeometry::LayerGroup.
+        int Group = 0;
+
+        // T::TileH rows of premultiplied pixels, PixelsPerRow each. Allocated
+        // when the first item of a layer is reached.
+        uint32 *Pixels = nullptr;
+        int PixelsPerRow = 0;
+
+        // Pixels of buffer which are cleared, end is exclusive. Only these
+        // can be changed by items of group.
+        int MinX = 0;
+        int MaxX = 0;
+
+        // The first scanline of tile row and a number of scanlines within
+        // destination image.
+        int Y = 0;
+        int Height = 0;
+    };
 
-    for (int i = 0; i < inputGeometryCount; i++) {
-        const Geometry *s = inputGeometries + i;
 
-        Matrix tm(s->TM);
+    /**
+     * Span blender parameter of RasterizeFrame for RGBA8 images. Items are
+     * composited with span blender selected by paint, blend mode and color
+     * of each geometry, see RasterizeOneItem. Other span blenders passed to
+     * RasterizeFrame set SingleBlender and are used for all items.
+     * MaximumAlpha is alpha of fully covered pixel span blender receives.
+     */
+    struct SpanBlenderPerGeometry final {
+        static constexpr bool SingleBlender = false;
+        static constexpr bool LinearBlending = false;
+        static constexpr int BytesPerPixel = 4;
+        static constexpr int32 MaximumAlpha = 255;
+    };
 
-        tm.PreMultiply(matrix);
 
-        new (geometries + i) Geometry(
-            tm.MapBoundingRect(s->PathBounds),
-            s->Tags,
-            s->Points,
-            tm,
-            s->TagCount,
-            s->PointCount,
-            s->Color,
-            s->Rule);
-    }
+    /**
+     * The same as SpanBlenderPerGeometry, but items with plain color and
+     * source over blend mode are composited in linear light, see
+     * RasterizerOptions::LinearBlending.
+     */
+    struct SpanBlenderPerGeometryLinear final {
+        static constexpr bool SingleBlender = false;
+        static constexpr bool LinearBlending = true;
+        static constexpr int BytesPerPixel = 4;
+        static constexpr int32 MaximumAlpha = 255;
+    };
 
-    // Step 1.
-    //
-    // Create and array of RasterizableGeometry instances. Instances are
-    // created and prepared for further processing in parallel.
 
-    // Allocate memory for RasterizableGeometry instance pointers.
-    const RasterizableGeometry **rasterizables = static_cast<const RasterizableGeometry **>(
-        threads.MallocMain(SIZE_OF(RasterizableGeometry *) * inputGeometryCount));
+    /**
+     * Rasterizes a frame into RGBA8 or BGRA8 image with span blender
+     * selected for each geometry.
+     */
+    static void RasterizePerGeometry(const Geometry *inputGeometries,
+        const int inputGeometryCount, const Matrix &matrix, Threads &threads,
+        const ImageData &image, const RasterizerOptions &options,
+        const bool redBlueSwapped);
 
-    // Allocate memory for RasterizableGeometry instances.
-    RasterizableGeometry *rasterizableGeometryMemory = static_cast<RasterizableGeometry *>(
-        threads.MallocMain(SIZE_OF(RasterizableGeometry) * inputGeometryCount));
 
-    const IntSize imageSize = {
-        image.Width,
-        image.Height
-    };
+    /**
+     * Rasterizes a frame. W is either SpanBlenderPerGeometry for RGBA8 and
+     * BGRA8 images, SpanBlenderFormat for other pixel formats or one of mask
+     * span writers.
+     *
+     * If redBlueSwapped is true, destination image is BGRA8 and it is
+     * composited as RGBA8. Every span blender except paints treats red and
+     * blue components the same way, so if no geometry has paint, red and
+     * blue of geometry colors are swapped instead. Otherwise each tile row
+     * of destination is swapped before its first item and swapped back after
+     * the last one, while the row is still in cache.
+     */
+    template <typename W>
+    static void RasterizeFrame(const Geometry *inputGeometries,
+        const int inputGeometryCount, const Matrix &matrix, Threads &threads,
+        const ImageData &image, const RasterizerOptions &options,
+        const bool redBlueSwapped);
 
-    threads.ParallelFor(inputGeometryCount, [=](const int index, ThreadMemory &memory) {
-        rasterizables[index] = CreateRasterizable(
-            rasterizableGeometryMemory + index, geometries + index, imageSize,
-            memory);
-    });
 
-    // Linearizer may decide that some paths do not contribute to the final
-    // image. In these situations CreateRasterizable will return nullptr. In
-    // the following step, a new array is created and only non-nullptr items
-    // are copied to it.
+    /**
+     * Swaps red and blue components of all pixels of one tile row of 32 bit
+     * destination image.
+     */
+    static void SwapRedBlueInRow(const ImageData &image,
+        const int rowIndex);
 
-    const RasterizableGeometry **visibleRasterizables = static_cast<const RasterizableGeometry **>(
-        threads.MallocMain(SIZE_OF(RasterizableGeometry *) * inputGeometryCount));
 
-    int visibleRasterizableCount = 0;
+    /**
+     * Rasterize one item within a single row.
+     */
+    template <typename W>
+    static void RasterizeOneItem(const RasterizableItem *item,
+        BitVector **bitVectorTable, int32 **coverAreaTable,
+        const int columnCount, const ImageData &image, ClipMask &clipMask,
+        LayerBuffer &layer, ThreadMemory &memory);
 
-    for (int i = 0; i < inputGeometryCount; i++) {
-        const RasterizableGeometry *rasterizable = rasterizables[i];
 
-        if (rasterizable != nullptr) {
-            visibleRasterizables[visibleRasterizableCount++] = rasterizable;
-        }
-    }
+    /**
+     * Prepares layer buffer for a given item. Composites layer buffer into
+     * destination image if item does not belong to its group. If item has
+     * layer, starts a new group if needed and clears pixels item can change.
+     */
+    static void UpdateLayer(const RasterizableItem *item,
+        const int columnCount, const ImageData &image, LayerBuffer &layer,
+        ThreadMemory &memory);
 
 
-    // Step 2.
-    //
-    // Create lists of rasterizable items for each interval.
+    /**
+     * Composites layer buffer into destination image using opacity and
+     * blend mode of its layer and leaves buffer without layer. Does nothing
+     * if buffer has no layer.
+     */
+    static void CompositeLayer(LayerBuffer &layer, const ImageData &image);
 
-    const TileIndex rowCount = CalculateRowCount<T>(imageSize.Height);
 
-    RowItemList<RasterizableItem> *rowLists =
-        static_cast<RowItemList<RasterizableItem> *>(threads.MallocMain(SIZE_OF(RowItemList<RasterizableItem>) * rowCount));
+    /**
+     * Rasterizes lines of one item into bit vectors and cover/area table.
+     * Returns true if item uses dense accumulation, see
+     * DenseAccumulationPixelsPerLine.
+     */
+    static bool PrepareOneItem(const RasterizableItem *item,
+        BitVector **bitVectorTable, int32 **coverAreaTable);
 
-    const int threadCount = Threads::GetHardwareThreadCount();
 
-    ASSERT(threadCount > 0);
+    /**
+     * Leaves bit vector table empty for the next item.
+     */
+    static void FinishOneItem(const RasterizableItem *item,
+        BitVector **bitVectorTable);
+
+
+    /**
+     * Renders coverage of clip path of a given item into clip mask, unless
+     * it is already there.
+     */
+    static void RenderClipMask(const RasterizableItem *item,
+        BitVector **bitVectorTable, int32 **coverAreaTable,
+        const int columnCount, const ImageData &image, ClipMask &clipMask,
+        ThreadMemory &memory);
+
+
+    /**
+     * Creates span blender for one scanline of rasterizable geometry.
+     *
+     * @param y Scanline index, in pixels.
+     */
+    template <typename B>
+    static B CreateBlender(const RasterizableGeometry *rasterizable,
+        const int y);
+
+
+    /**
+     * Composites one item using span blender B, selecting rendering function
+     * by fill rule and presence of lines. MaximumAlpha is alpha of fully
+     * covered pixel passed to span blender, either 255 or 65535 for span
+     * blenders writing 16 bits per component.
+     *
+     * @param clip Clip mask with coverage of clip path of item, nullptr if
+     * item is not clipped.
+     */
+    template <typename B, int32 MaximumAlpha = 255>
+    static void RenderOneItemWithBlender(const RasterizableItem *item,
+        BitVector **bitVectorTable, int32 **coverAreaTable,
+        const int bitVectorsPerRow, uint8 *ptr, const int x, const int y,
+        const int height, const bool hasLines, const bool accumulated,
+        const ImageData &image, const ClipMask *clip);
+
+
+    /**
+     * Composites one clipped item using span blender B. Coverage of item is
+     * rendered into clip mask first and then item is composited with
+     * alpha of each pixel multiplied by clip path coverage. Clip mask holds
+     * 8 bit coverage, it is scaled up when MaximumAlpha is 65535.
+     */
+    template <typename B, int32 MaximumAlpha = 255>
+    static void RenderOneClippedItem(const RasterizableItem *item,
+        BitVector **bitVectorTable, int32 **coverAreaTable,
+        const int bitVectorsPerRow, uint8 *ptr, const int x, const int y,
+        const int height, const bool hasLines, const bool accumulated,
+        const ImageData &image, const ClipMask &clip);
+
+
+    /**
+     * Composites one item with already rasterized lines into destination
+     * image. Solid tile runs of item are filled directly, one scanline after
+     * another, and then skipped when rendering the remaining pixels.
+     *
+     * @param ptr Pointer to the first scanline of tile row in destination
+     * image.
+     *
+     * @param x Left edge of item, in pixels.
+     *
+     * @param y Index of the first scanline, in pixels.
+     *
+     * @param height A number of scanlines to render.
+     *
+     * @param accumulated True if item was rasterized into dense cover/area
+     * rows, see DenseAccumulationPixelsPerLine.
+     */
+    template <typename B, FillRuleFn ApplyFillRule>
+    static void RenderOneItem(const RasterizableItem *item,
+        BitVector **bitVectorTable, int32 **coverAreaTable,
+        const int bitVectorsPerRow, uint8 *ptr, const int x, const int y,
+        const int height, const bool accumulated, const ImageData &image);
+
+
+    /**
+     * Renders one scanline of item with RenderOneLineAccumulated if item was
+     * rasterized with dense accumulation or RenderOneLine otherwise.
+     * Accumulated alphas are 8 bit, so 16 bit coverage always uses
+     * RenderOneLine, which works with accumulated cover/area rows as well.
+     */
+    template <typename B, FillRuleFn ApplyFillRule>
+    static void RenderOneItemLine(uint8 *image,
+        const BitVector *bitVectorTable, const int bitVectorCount,
+        int32 *coverAreaTable, const int x, const int rowLength,
+        const int32 startCover, const bool accumulated, B blender);
+
+
+    /**
+     * Composites one item which has no lines within this row. Each scanline
+     * then consists of a single span with alpha determined by start cover
+     * and reaching the right edge of destination image.
+     */
+    template <typename B, FillRuleFn ApplyFillRule>
+    static void RenderOneItemWithoutLines(const RasterizableItem *item,
+        uint8 *ptr, const int x, const int y, const int height,
+        const ImageData &image);
+
+
+    /**
+     * Walks items in one row from top to bottom and finds which items are
+     * completely hidden by solid tiles of opaque items above them. Returns
+     * an array of flags, one for each item in the same order as items in
+     * row list. Returns nullptr if nothing can be hidden.
+     */
+    static const bool *FindOccludedItems(
+        const RowItemList<RasterizableItem> *rowList,
+        const TileIndex columnCount, ThreadMemory &memory);
+
+
+    /**
+     * Rasterize items in one row, skipping items marked as occluded.
+     */
+    template <typename W>
+    static void RasterizeVisibleItems(
+        const RowItemList<RasterizableItem> *rowList, const bool *occluded,
+        BitVector **bitVectorTable, int32 **coverAreaTable,
+        const int columnCount, const ImageData &image, ClipMask &clipMask,
+        LayerBuffer &layer, ThreadMemory &memory,
+        RasterizerStatistics *statistics);
+
+
+    /**
+     * Rasterize all items in one row.
+     */
+    template <typename W>
+    static void RasterizeRow(const RowItemList<RasterizableItem> *rowList,
+        ThreadMemory &memory, const ImageData &image,
+        const RasterizerOptions &options);
+
+private:
+    Rasterizer() = delete;
+};
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::Rasterize(const Geometry *inputGeometries,
+    const int inputGeometryCount, const Matrix &matrix, Threads &threads,
+    const ImageData &image, const RasterizerOptions &options)
+{
+    RasterizePerGeometry(inputGeometries, inputGeometryCount, matrix,
+        threads, image, options, false);
+}
+
+
+template <typename T>
+template <typename W>
+FORCE_INLINE void Rasterizer<T>::RasterizeMask(
+    const Geometry *inputGeometries, const int inputGeometryCount,
+    const Matrix &matrix, Threads &threads, const ImageData &mask,
+    const RasterizerOptions &options)
+{
+    STATIC_ASSERT(W::SingleBlender);
+    STATIC_ASSERT(W::BytesPerPixel == 1);
+
+    RasterizeFrame<W>(inputGeometries, inputGeometryCount, matrix, threads,
+        mask, options, false);
+}
+
+
+template <typename T>
+template <PixelFormat F>
+FORCE_INLINE void Rasterizer<T>::RasterizeInFormat(
+    const Geometry *inputGeometries, const int inputGeometryCount,
+    const Matrix &matrix, Threads &threads, const ImageData &image,
+    const RasterizerOptions &options)
+{
+    if constexpr (F == PixelFormat::RGBA8 or F == PixelFormat::BGRA8) {
+        RasterizePerGeometry(inputGeometries, inputGeometryCount, matrix,
+            threads, image, options, F == PixelFormat::BGRA8);
+    } else {
+        // These formats are composited by single span blender, which has
+        // nothing to apply paints, blend modes, layers or linear blending
+        // with.
+        ASSERT(not options.LinearBlending);
+
+        for (int i = 0; i < inputGeometryCount; i++) {
+            ASSERT(inputGeometries[i].Paint == nullptr);
+            ASSERT(inputGeometries[i].Mode == BlendMode::SourceOver);
+            ASSERT(inputGeometries[i].Layer == nullptr);
+        }
+
+        RasterizeFrame<SpanBlenderFormat<F>>(inputGeometries,
+            inputGeometryCount, matrix, threads, image, options, false);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RasterizePerGeometry(
+    const Geometry *inputGeometries, const int inputGeometryCount,
+    const Matrix &matrix, Threads &threads, const ImageData &image,
+    const RasterizerOptions &options, const bool redBlueSwapped)
+{
+    if (options.LinearBlending) {
+        RasterizeFrame<SpanBlenderPerGeometryLinear>(inputGeometries,
+            inputGeometryCount, matrix, threads, image, options,
+            redBlueSwapped);
+    } else {
+        RasterizeFrame<SpanBlenderPerGeometry>(inputGeometries,
+            inputGeometryCount, matrix, threads, image, options,
+            redBlueSwapped);
+    }
+}
+
+
+template <typename T>
+template <typename W>
+FORCE_INLINE void Rasterizer<T>::RasterizeFrame(
+    const Geometry *inputGeometries, const int inputGeometryCount,
+    const Matrix &matrix, Threads &threads, const ImageData &image,
+    const RasterizerOptions &options, const bool redBlueSwapped)
+{
+    ASSERT(inputGeometries != nullptr);
+    ASSERT(inputGeometryCount > 0);
+    ASSERT(image.Data != nullptr);
+    ASSERT(image.Width > 0);
+    ASSERT(image.Height > 0);
+    ASSERT(image.BytesPerRow >= (image.Width * W::BytesPerPixel));
+    ASSERT(not redBlueSwapped or W::BytesPerPixel == 4);
+
+    // Only paints read colors of their own, see SwapRedBlueInRow.
+    bool swapRows = false;
+
+    if (redBlueSwapped) {
+        for (int i = 0; i < inputGeometryCount; i++) {
+            if (inputGeometries[i].Paint != nullptr) {
+                swapRows = true;
+                break;
+            }
+        }
+    }
+
+    const bool swapColors = redBlueSwapped and not swapRows;
+
+    // TODO
+    // Skip transform if matrix is identity.
+    Geometry *geometries = static_cast<Geometry *>(
+        threads.MallocMain(SIZE_OF(Geometry) * inputGeometryCount));
+
+    // Index of clip path of each geometry, -1 if geometry is not clipped.
+    int *clipIndices = static_cast<int *>(
+        threads.MallocMain(SIZE_OF(int) * inputGeometryCount));
+
+    const Geometry **clipPaths = static_cast<const Geometry **>(
+        threads.MallocMain(SIZE_OF(Geometry *) * inputGeometryCount));
+
+    int clipCount = 0;
+
+    // Layer group of each geometry, see RasterizableGeometry::LayerGroup.
+    int *layerGroups = static_cast<int *>(
+        threads.MallocMain(SIZE_OF(int) * inputGeometryCount));
+
+    for (int i = 0; i < inputGeometryCount; i++) {
+        const Geometry *s = inputGeometries + i;
+
+        Matrix tm(s->TM);
+
+        tm.PreMultiply(matrix);
+
+        // Stroke outline is filled with non-zero fill rule and reaches
+        // outside of path bounds.
+        const IntRect pathBounds = s->Stroke == nullptr ? s->PathBounds :
+            s->Stroke->ExpandBounds(s->PathBounds);
+
+        // Paint, blend mode and layer do not apply when the same span
+        // blender is used for all geometries, for example for masks.
+        new (geometries + i) Geometry(
+            tm.MapBoundingRect(pathBounds),
+            s->Tags,
+            s->Points,
+            tm,
+            s->TagCount,
+            s->PointCount,
+            swapColors ? SwapRedBlue(s->Color) : s->Color,
+            s->Stroke == nullptr ? s->Rule : FillRule::NonZero,
+            W::SingleBlender ? nullptr : s->Paint,
+            W::SingleBlender ? BlendMode::SourceOver : s->Mode,
+            s->Clip,
+            W::SingleBlender ? nullptr : s->Layer,
+            s->Stroke);
+
+        // Consecutive geometries of the same layer form one group.
+        const bool continuesGroup = i > 0 and s->Layer != nullptr and
+            s->Layer == inputGeometries[i - 1].Layer;
+
+        layerGroups[i] = continuesGroup ? layerGroups[i - 1] : i;
+
+        // Geometries sharing clip path are usually next to each other, so
+        // search starts from the most recently added clip path.
+        int clipIndex = -1;
+
+        if (s->Clip != nullptr) {
+            clipIndex = clipCount - 1;
+
+            while (clipIndex >= 0 and clipPaths[clipIndex] != s->Clip) {
+                clipIndex--;
+            }
+
+            if (clipIndex < 0) {
+                clipIndex = clipCount;
+                clipPaths[clipCount++] = s->Clip;
+            }
+        }
+
+        clipIndices[i] = clipIndex;
+    }
+
+    const IntSize imageSize = {
+        image.Width,
+        image.Height
+    };
+
+    // Linearize each clip path once. Clip paths are not rendered, only
+    // their coverage is used when rasterizing rows.
+    const RasterizableGeometry **clipRasterizables = nullptr;
+
+    if (clipCount > 0) {
+        Geometry *clipGeometries = static_cast<Geometry *>(
+            threads.MallocMain(SIZE_OF(Geometry) * clipCount));
+
+        for (int i = 0; i < clipCount; i++) {
+            const Geometry *s = clipPaths[i];
+
+            Matrix tm(s->TM);
+
+            tm.PreMultiply(matrix);
+
+            new (clipGeometries + i) Geometry(
+                tm.MapBoundingRect(s->PathBounds),
+                s->Tags,
+                s->Points,
+                tm,
+                s->TagCount,
+                s->PointCount,
+                0,
+                s->Rule);
+        }
+
+        clipRasterizables = static_cast<const RasterizableGeometry **>(
+            threads.MallocMain(SIZE_OF(RasterizableGeometry *) * clipCount));
+
+        RasterizableGeometry *clipMemory = static_cast<RasterizableGeometry *>(
+            threads.MallocMain(SIZE_OF(RasterizableGeometry) * clipCount));
+
+        threads.ParallelFor(clipCount, [&](const int index, ThreadMemory &memory) {
+            clipRasterizables[index] = CreateRasterizable(clipMemory + index,
+                clipGeometries + index, imageSize, options, memory);
+        });
+    }
+
+    // Step 1.
+    //
+    // Create and array of RasterizableGeometry instances. Instances are
+    // created and prepared for further processing in parallel.
+
+    // Allocate memory for RasterizableGeometry instance pointers.
+    const RasterizableGeometry **rasterizables = static_cast<const RasterizableGeometry **>(
+        threads.MallocMain(SIZE_OF(RasterizableGeometry *) * inputGeometryCount));
+
+    // Allocate memory for RasterizableGeometry instances.
+    RasterizableGeometry *rasterizableGeometryMemory = static_cast<RasterizableGeometry *>(
+        threads.MallocMain(SIZE_OF(RasterizableGeometry) * inputGeometryCount));
+
+    threads.ParallelFor(inputGeometryCount, [&](const int index, ThreadMemory &memory) {
+        const Geometry *geometry = geometries + index;
+
+        const RasterizableGeometry *clip = clipIndices[index] < 0 ? nullptr :
+            clipRasterizables[clipIndices[index]];
+
+        // Destination blend mode leaves all pixels unchanged. Geometries
+        // with clip path which is empty or does not intersect geometry
+        // bounds are not visible either, as well as geometries of layers
+        // which leave destination unchanged.
+        bool visible = geometry->Mode != BlendMode::Destination;
+
+        if (geometry->Layer != nullptr) {
+            visible = visible and geometry->Layer->Opacity != 0 and
+                geometry->Layer->Mode != BlendMode::Destination;
+        }
+
+        if (clipIndices[index] >= 0) {
+            const IntRect &a = geometry->PathBounds;
+
+            // Maximum coordinates of bounds are exclusive, bounds which only
+            // touch do not share any pixels.
+            visible = visible and clip != nullptr and
+                a.MaxX > clip->Geometry->PathBounds.MinX and
+                a.MinX < clip->Geometry->PathBounds.MaxX and
+                a.MaxY > clip->Geometry->PathBounds.MinY and
+                a.MinY < clip->Geometry->PathBounds.MaxY;
+        }
+
+        RasterizableGeometry *rasterizable = not visible ? nullptr :
+            CreateRasterizable(rasterizableGeometryMemory + index, geometry,
+                imageSize, options, memory);
+
+        if (rasterizable != nullptr) {
+            rasterizable->Clip = clip;
+            rasterizable->LayerGroup = layerGroups[index];
+        }
+
+        if (rasterizable != nullptr and geometry->Paint != nullptr) {
+            PaintShader *shader = memory.FrameMalloc<PaintShader>();
+
+            InitializePaintShader(*shader, *geometry->Paint,
+                geometry->TM, geometry->Mode);
+
+            rasterizable->Shader = shader;
+        }
+
+        rasterizables[index] = rasterizable;
+    });
+
+    // Linearizer may decide that some paths do not contribute to the final
+    // image. In these situations CreateRasterizable will return nullptr. In
+    // the following step, a new array is created and only non-nullptr items
+    // are copied to it.
+
+    const RasterizableGeometry **visibleRasterizables = static_cast<const RasterizableGeometry **>(
+        threads.MallocMain(SIZE_OF(RasterizableGeometry *) * inputGeometryCount));
+
+    int visibleRasterizableCount = 0;
+
+    for (int i = 0; i < inputGeometryCount; i++) {
+        const RasterizableGeometry *rasterizable = rasterizables[i];
+
+        if (rasterizable != nullptr) {
+            visibleRasterizables[visibleRasterizableCount++] = rasterizable;
+        }
+    }
+
+
+    // Step 2.
+    //
+    // Create lists of rasterizable items for each interval.
+
+    const TileIndex rowCount = CalculateRowCount<T>(imageSize.Height);
+
+    RowItemList<RasterizableItem> *rowLists =
+        static_cast<RowItemList<RasterizableItem> *>(threads.MallocMain(SIZE_OF(RowItemList<RasterizableItem>) * rowCount));
+
+    const int threadCount = Threads::GetHardwareThreadCount();
+
+    ASSERT(threadCount > 0);
 
     const int iterationHeight = Max<uint32>(rowCount / threadCount, 1);
     const int iterationCount = (rowCount / iterationHeight) +
@@ -373,10 +1259,20 @@ FORCE_INLINE void Rasterizer<T>::Rasterize(const Geometry *inputGeometries,
 
         for (int i = 0; i < visibleRasterizableCount; i++) {
             const RasterizableGeometry *rasterizable = visibleRasterizables[i];
+            const RasterizableGeometry *clip = rasterizable->Clip;
             const TileBounds b = rasterizable->Bounds;
 
-            const TileIndex min = Clamp(b.Y, threadY, threadMaxY);
-            const TileIndex max = Clamp(b.Y + b.RowCount, threadY,
+            TileIndex first = b.Y;
+            TileIndex last = b.Y + b.RowCount;
+
+            if (clip != nullptr) {
+                // Rows outside of clip path are not visible.
+                first = Max(first, clip->Bounds.Y);
+                last = Min(last, clip->Bounds.Y + clip->Bounds.RowCount);
+            }
+
+            const TileIndex min = Clamp(first, threadY, threadMaxY);
+            const TileIndex max = Clamp(Max(first, last), threadY,
                 threadMaxY);
 
             if (min == max) {
@@ -401,6 +1297,18 @@ FORCE_INLINE void Rasterizer<T>::Rasterize(const Geometry *inputGeometries,
                     continue;
                 }
 
+                if (clip != nullptr) {
+                    const TileIndex clipIndex = y - clip->Bounds.Y;
+
+                    const bool emptyClipRow =
+                        clip->GetLinesForRow(clipIndex) == nullptr and
+                        clip->GetCoversForRow(clipIndex) == nullptr;
+
+                    if (emptyClipRow) {
+                        continue;
+                    }
+                }
+
                 RowItemList<RasterizableItem> *list = rowLists + y;
 
                 list->Append(memory, rasterizable, localIndex);
@@ -415,11 +1323,35 @@ FORCE_INLINE void Rasterizer<T>::Rasterize(const Geometry *inputGeometries,
     threads.ParallelFor(rowCount, [&](const int rowIndex, ThreadMemory &memory) {
         const RowItemList<RasterizableItem> *item = rowLists + rowIndex;
 
-        RasterizeRow(item, memory, image);
+        if (swapRows and item->First != nullptr) {
+            SwapRedBlueInRow(image, rowIndex);
+            RasterizeRow<W>(item, memory, image, options);
+            SwapRedBlueInRow(image, rowIndex);
+        } else {
+            RasterizeRow<W>(item, memory, image, options);
+        }
     });
 }
 
 
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::SwapRedBlueInRow(const ImageData &image,
+    const int rowIndex)
+{
+    const int y = rowIndex * T::TileH;
+    const int maxy = Min(y + T::TileH, image.Height);
+
+    for (int i = y; i < maxy; i++) {
+        uint32 *d = reinterpret_cast<uint32 *>(
+            image.Data + (i * image.BytesPerRow));
+
+        for (int x = 0; x < image.Width; x++) {
+            d[x] = SwapRedBlue(d[x]);
+        }
+    }
+}
+
+
 template <typename T>
 FORCE_INLINE void *Rasterizer<T>::RasterizableGeometry::GetLinesForRow(const int rowIndex) const {
     ASSERT(rowIndex >= 0);
@@ -438,6 +1370,15 @@ FORCE_INLINE int Rasterizer<T>::RasterizableGeometry::GetFirstBlockLineCountForR
 }
 
 
+template <typename T>
+FORCE_INLINE int Rasterizer<T>::RasterizableGeometry::GetLineCountForRow(const int rowIndex) const {
+    ASSERT(rowIndex >= 0);
+    ASSERT(rowIndex < Bounds.RowCount);
+
+    return LineCounts[rowIndex];
+}
+
+
 template <typename T>
 FORCE_INLINE const int32 *Rasterizer<T>::RasterizableGeometry::GetCoversForRow(const int rowIndex) const {
     ASSERT(rowIndex >= 0);
@@ -473,12 +1414,25 @@ FORCE_INLINE const int32 *Rasterizer<T>::RasterizableGeometry::GetActualCoversFo
 
 
 template <typename T>
-FORCE_INLINE Rasterizer<T>::RasterizableItem::RasterizableItem() {
+FORCE_INLINE const typename Rasterizer<T>::SolidTileRunList *Rasterizer<T>::RasterizableGeometry::GetSolidTileRunsForRow(const int rowIndex) const {
+    ASSERT(rowIndex >= 0);
+    ASSERT(rowIndex < Bounds.RowCount);
+
+    if (SolidTileRuns == nullptr) {
+        return nullptr;
+    }
+
+    return SolidTileRuns + rowIndex;
 }
 
 
 template <typename T>
-FORCE_INLINE Rasterizer<T>::RasterizableItem::RasterizableItem(const RasterizableGeometry *rasterizable,
+FORCE_INLINE Rasterizer<T>::RasterizableItem::RasterizableItem() {
+}
+
+
+template <typename T>
+FORCE_INLINE Rasterizer<T>::RasterizableItem::RasterizableItem(const RasterizableGeometry *rasterizable,
     const int localRowIndex)
 :   Rasterizable(rasterizable),
     LocalRowIndex(localRowIndex)
@@ -492,6 +1446,12 @@ FORCE_INLINE int Rasterizer<T>::RasterizableItem::GetFirstBlockLineCount() const
 }
 
 
+template <typename T>
+FORCE_INLINE int Rasterizer<T>::RasterizableItem::GetLineCount() const  {
+    return Rasterizable->GetLineCountForRow(LocalRowIndex);
+}
+
+
 template <typename T>
 FORCE_INLINE const void *Rasterizer<T>::RasterizableItem::GetLineArray() const {
     return Rasterizable->GetLinesForRow(LocalRowIndex);
@@ -504,6 +1464,12 @@ FORCE_INLINE const int32 *Rasterizer<T>::RasterizableItem::GetActualCovers() con
 }
 
 
+template <typename T>
+FORCE_INLINE const typename Rasterizer<T>::SolidTileRunList *Rasterizer<T>::RasterizableItem::GetSolidTileRuns() const {
+    return Rasterizable->GetSolidTileRunsForRow(LocalRowIndex);
+}
+
+
 template <typename T>
 FORCE_INLINE void Rasterizer<T>::IterateLinesX32Y16(const RasterizableItem *item, BitVector **bitVectorTable, int32 **coverAreaTable) {
     int count = item->GetFirstBlockLineCount();
@@ -512,19 +1478,7 @@ FORCE_INLINE void Rasterizer<T>::IterateLinesX32Y16(const RasterizableItem *item
         static_cast<const LineArrayX32Y16Block *>(item->GetLineArray());
 
     while (v != nullptr) {
-        const F8Dot8x2 *yy = v->Y0Y1;
-        const F24Dot8 *xx0 = v->X0;
-        const F24Dot8 *xx1 = v->X1;
-
-        for (int i = 0; i < count; i++) {
-            const F8Dot8x2 y0y1 = yy[i];
-            const F24Dot8 x0 = xx0[i];
-            const F24Dot8 x1 = xx1[i];
-
-            RasterizeLine(x0, UnpackLoFromF8Dot8x2(y0y1), x1,
-                UnpackHiFromF8Dot8x2(y0y1), bitVectorTable,
-                coverAreaTable);
-        }
+        RasterizeLineBlock(v, count, bitVectorTable, coverAreaTable);
 
         v = v->Next;
         count = LineArrayX32Y16Block::LinesPerBlock;
@@ -540,30 +1494,176 @@ FORCE_INLINE void Rasterizer<T>::IterateLinesX16Y16(const RasterizableItem *item
         static_cast<const LineArrayX16Y16Block *>(item->GetLineArray());
 
     while (v != nullptr) {
-        const F8Dot8x2 *yy = v->Y0Y1;
-        const F8Dot8x2 *xx = v->X0X1;
-
-        for (int i = 0; i < count; i++) {
-            const F8Dot8x2 y0y1 = yy[i];
-            const F8Dot8x2 x0x1 = xx[i];
-
-            RasterizeLine(
-                UnpackLoFromF8Dot8x2(x0x1),
-                UnpackLoFromF8Dot8x2(y0y1),
-                UnpackHiFromF8Dot8x2(x0x1),
-                UnpackHiFromF8Dot8x2(y0y1), bitVectorTable,
+        RasterizeLineBlock(v, count, bitVectorTable, coverAreaTable);
+
+        v = v->Next;
+        count = LineArrayX32Y16Block::LinesPerBlock;
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::IterateLinesDelta(const RasterizableItem *item, BitVector **bitVectorTable, int32 **coverAreaTable) {
+    int count = item->GetFirstBlockLineCount();
+
+    const LineArrayDeltaBlock *v =
+        static_cast<const LineArrayDeltaBlock *>(item->GetLineArray());
+
+    F24Dot8 x0[CellBatchSize] ALIGNED(16);
+    F24Dot8 y0[CellBatchSize] ALIGNED(16);
+    F24Dot8 x1[CellBatchSize] ALIGNED(16);
+    F24Dot8 y1[CellBatchSize] ALIGNED(16);
+
+    while (v != nullptr) {
+        // Block can hold more lines than one batch, decoding continues from
+        // where the previous batch ended.
+        int position = 0;
+        F24Dot8 x = 0;
+        F24Dot8 y = 0;
+
+        for (int i = 0; i < count; i += CellBatchSize) {
+            const int n = Min(count - i, CellBatchSize);
+
+            DecodeLines(x0, y0, x1, y1, v, n, position, x, y);
+
+            RasterizeLines(x0, y0, x1, y1, n, bitVectorTable,
                 coverAreaTable);
         }
 
         v = v->Next;
-        count = LineArrayX32Y16Block::LinesPerBlock;
+
+        if (v != nullptr) {
+            count = v->LineCount;
+        }
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::IterateLinesTiled(const RasterizableItem *item, BitVector **bitVectorTable, int32 **coverAreaTable) {
+    STATIC_ASSERT(LineArrayTiledBlock::LinesPerBlock <= CellBatchSize);
+
+    const TiledLineRow *row =
+        static_cast<const TiledLineRow *>(item->GetLineArray());
+
+    F24Dot8 x0[CellBatchSize] ALIGNED(16);
+    F24Dot8 y0[CellBatchSize] ALIGNED(16);
+    F24Dot8 x1[CellBatchSize] ALIGNED(16);
+    F24Dot8 y1[CellBatchSize] ALIGNED(16);
+
+    // Tiled blocks are small, lines of several blocks and columns are
+    // gathered into one batch.
+    int n = 0;
+
+    for (int i = 0; i < row->ColumnCount; i++) {
+        const TiledLineColumn &column = row->Columns[i];
+        const F24Dot8 cx = T::TileColumnIndexToF24Dot8(column.Index);
+
+        int count = ((column.LineCount - 1) &
+            (LineArrayTiledBlock::LinesPerBlock - 1)) + 1;
+
+        for (const LineArrayTiledBlock *b = column.Block; b != nullptr;
+            b = b->Next)
+        {
+            if ((n + count) > CellBatchSize) {
+                RasterizeLines(x0, y0, x1, y1, n, bitVectorTable,
+                    coverAreaTable);
+
+                n = 0;
+            }
+
+            UnpackLines(x0 + n, y0 + n, x1 + n, y1 + n, b, count, cx);
+
+            n += count;
+            count = LineArrayTiledBlock::LinesPerBlock;
+        }
+    }
+
+    if (n > 0) {
+        RasterizeLines(x0, y0, x1, y1, n, bitVectorTable, coverAreaTable);
+    }
+}
+
+
+template <typename T>
+template <typename B>
+FORCE_INLINE void Rasterizer<T>::RasterizeLineBlock(const B *block,
+    const int count, BitVector **bitVectorTable, int32 **coverAreaTable)
+{
+    STATIC_ASSERT(B::LinesPerBlock <= CellBatchSize);
+
+    ASSERT(block != nullptr);
+    ASSERT(count > 0);
+    ASSERT(count <= B::LinesPerBlock);
+
+    F24Dot8 x0[CellBatchSize] ALIGNED(16);
+    F24Dot8 y0[CellBatchSize] ALIGNED(16);
+    F24Dot8 x1[CellBatchSize] ALIGNED(16);
+    F24Dot8 y1[CellBatchSize] ALIGNED(16);
+
+    UnpackLines(x0, y0, x1, y1, block, count);
+
+    RasterizeLines(x0, y0, x1, y1, count, bitVectorTable, coverAreaTable);
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RasterizeLines(F24Dot8 *x0, F24Dot8 *y0,
+    F24Dot8 *x1, F24Dot8 *y1, const int count, BitVector **bitVectorTable,
+    int32 **coverAreaTable)
+{
+    ASSERT(count > 0);
+    ASSERT(count <= CellBatchSize);
+
+    // Lines are processed four at a time. Lines after the last one are
+    // ignored, but must still be initialized.
+    const int batchCount = (count + 3) & ~3;
+
+    for (int i = count; i < batchCount; i++) {
+        x0[i] = 0;
+        y0[i] = 0;
+        x1[i] = 0;
+        y1[i] = 0;
+    }
+
+    int32 px[CellBatchSize] ALIGNED(16);
+    int32 py[CellBatchSize] ALIGNED(16);
+    int32 cover[CellBatchSize] ALIGNED(16);
+    int32 area[CellBatchSize] ALIGNED(16);
+
+    const uint32 all = count < CellBatchSize ?
+        (uint32(1) << count) - 1 : ~uint32(0);
+
+    uint32 single = FindSingleCellLines(px, py, cover, area, x0, y0, x1, y1,
+        batchCount) & all;
+
+    uint32 other = all & ~single;
+
+    // Several lines can end up in the same pixel. Pixels are updated one
+    // line at a time, so contributions of such lines simply add up.
+    while (single != 0) {
+        const int i = CountTrailingZeroes(single);
+
+        single &= single - 1;
+
+        UpdateCell(bitVectorTable, coverAreaTable, px[i], py[i], cover[i],
+            area[i]);
+    }
+
+    while (other != 0) {
+        const int i = CountTrailingZeroes(other);
+
+        other &= other - 1;
+
+        RasterizeLine(x0[i], y0[i], x1[i], y1[i], bitVectorTable,
+            coverAreaTable);
     }
 }
 
 
 template <typename T>
 FORCE_INLINE typename Rasterizer<T>::RasterizableGeometry *
-Rasterizer<T>::CreateRasterizable(void *placement, const Geometry *geometry, const IntSize imageSize, ThreadMemory &memory) {
+Rasterizer<T>::CreateRasterizable(void *placement, const Geometry *geometry, const IntSize imageSize, const RasterizerOptions &options, ThreadMemory &memory) {
     ASSERT(placement != nullptr);
     ASSERT(geometry != nullptr);
     ASSERT(imageSize.Width > 0);
@@ -617,20 +1717,72 @@ Rasterizer<T>::CreateRasterizable(void *placement, const Geometry *geometry, con
     const bool narrow =
         128 > (bounds.ColumnCount * T::TileW);
 
-    if (narrow) {
+    // Tiled lines are never selected automatically, splitting lines at tile
+    // column boundaries changes alpha of some edge pixels.
+    if (options.Encoding == LineEncoding::Tiled) {
+        return LinearizeTiled<LineArrayTiled<T>>(placement, geometry, bounds,
+            imageSize, options, memory);
+    }
+
+    const bool delta = options.Encoding == LineEncoding::Delta or
+        (options.Encoding == LineEncoding::Automatic and
+            PrefersDeltaEncoding(geometry, bounds));
+
+    if (delta) {
+        return Linearize<LineArrayDelta>(placement, geometry, bounds,
+            imageSize, IterateLinesDelta, options, memory);
+    } else if (narrow) {
         return Linearize<LineArrayX16Y16>(placement, geometry, bounds,
-            imageSize, IterateLinesX16Y16, memory);
+            imageSize, IterateLinesX16Y16, options, memory);
     } else {
         return Linearize<LineArrayX32Y16>(placement, geometry, bounds,
-            imageSize, IterateLinesX32Y16, memory);
+            imageSize, IterateLinesX32Y16, options, memory);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE bool Rasterizer<T>::PrefersDeltaEncoding(const Geometry *geometry, const TileBounds &bounds) {
+    ASSERT(geometry != nullptr);
+
+    const int contourCount = CountContours(geometry);
+
+    // Two escape records of each contour crossing all rows fit into one
+    // block.
+    if ((contourCount * 2 * LineArrayDeltaBlock::WordsPerEscape) <=
+        LineArrayDeltaBlock::WordsPerBlock)
+    {
+        return true;
+    }
+
+    return int64(geometry->PointCount) >=
+        int64(DeltaEncodingMinPointsPerContourRow) * contourCount *
+            bounds.RowCount;
+}
+
+
+template <typename T>
+FORCE_INLINE int Rasterizer<T>::CountContours(const Geometry *geometry) {
+    ASSERT(geometry != nullptr);
+
+    if (geometry->Stroke != nullptr) {
+        return geometry->TagCount * 2;
+    }
+
+    int contourCount = 0;
+
+    for (int i = 0; i < geometry->TagCount; i++) {
+        contourCount += geometry->Tags[i] == PathTag::Move;
     }
+
+    return contourCount;
 }
 
 
 template <typename T>
 template <typename L>
 FORCE_INLINE typename Rasterizer<T>::RasterizableGeometry *
-Rasterizer<T>::Linearize(void *placement, const Geometry *geometry, const TileBounds &bounds, const IntSize imageSize, const LineIterationFunction iterationFunction, ThreadMemory &memory) {
+Rasterizer<T>::Linearize(void *placement, const Geometry *geometry, const TileBounds &bounds, const IntSize imageSize, const LineIterationFunction iterationFunction, const RasterizerOptions &options, ThreadMemory &memory) {
     RasterizableGeometry *linearized = new (placement) RasterizableGeometry(
         geometry, iterationFunction, bounds);
 
@@ -654,6 +1806,10 @@ Rasterizer<T>::Linearize(void *placement, const Geometry *geometry, const TileBo
     int32 *firstLineBlockCounts = memory.FrameMallocArray<int32>(
         bounds.RowCount);
 
+    int32 *lineCounts = memory.FrameMallocArray<int32>(bounds.RowCount);
+
+    int64 lineBlockBytes = 0;
+
     for (TileIndex i = 0; i < bounds.RowCount; i++) {
         const L *la = linearizer->GetLineArrayAtIndex(i);
 
@@ -662,451 +1818,720 @@ Rasterizer<T>::Linearize(void *placement, const Geometry *geometry, const TileBo
         if (la->GetFrontBlock() == nullptr) {
             lineBlocks[i] = nullptr;
             firstLineBlockCounts[i] = 0;
+            lineCounts[i] = 0;
             continue;
         }
 
+        // All blocks except the first one are full.
+        int lineCount = la->GetFrontBlockLineCount();
+        int blockCount = 1;
+
+        for (const auto *b = la->GetFrontBlock()->Next; b != nullptr;
+            b = b->Next)
+        {
+            lineCount += GetFullBlockLineCount(b);
+            blockCount++;
+        }
+
+        lineBlockBytes += blockCount * SIZE_OF(*la->GetFrontBlock());
+
         lineBlocks[i] = la->GetFrontBlock();
         firstLineBlockCounts[i] = la->GetFrontBlockLineCount();
+        lineCounts[i] = lineCount;
     }
 
     linearized->Lines = lineBlocks;
     linearized->FirstBlockLineCounts = firstLineBlockCounts;
+    linearized->LineCounts = lineCounts;
 
-    int32 **startCoverTable = linearizer->GetStartCoverTable();
+    if (options.Statistics != nullptr) {
+        options.Statistics->LineBlockBytes += lineBlockBytes;
+    }
 
-    if (startCoverTable != nullptr) {
-        for (int i = 0; i < bounds.RowCount; i++) {
-            const int32 *t = startCoverTable[i];
+    linearized->StartCoverTable = FinalizeStartCoverTable(
+        linearizer->GetStartCoverTable(), bounds.RowCount);
 
-            if (t != nullptr and T::CoverArrayContainsOnlyZeroes(t)) {
-                // Don't need cover array after all, all segments cancelled
-                // each other.
-                startCoverTable[i] = nullptr;
-            }
-        }
+    SolidTileRunList *solidTileRuns =
+        memory.FrameMallocArray<SolidTileRunList>(bounds.RowCount);
 
-        linearized->StartCoverTable = startCoverTable;
-    }
+    for (TileIndex i = 0; i < bounds.RowCount; i++) {
+        new (solidTileRuns + i) SolidTileRunList();
 
-    return linearized;
-}
+        const int lineCount = firstLineBlockCounts[i];
+        const auto *block = linearizer->GetLineArrayAtIndex(i)->GetFrontBlock();
 
+        if (block != nullptr and (block->Next != nullptr or
+            lineCount > MaximumLineCountForSolidTileRuns))
+        {
+            // Too many edges in this row for it to have large solid
+            // areas worth finding.
+            continue;
+        }
 
-template <typename T>
-FORCE_INLINE void Rasterizer<T>::Vertical_Down(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex columnIndex, const F24Dot8 y0,
-    const F24Dot8 y1, const F24Dot8 x)
-{
-    ASSERT(y0 < y1);
+        const int py = T::TileRowIndexToPoints(bounds.Y + i);
+        const int height = Min(T::TileH, imageSize.Height - py);
 
-    const PixelIndex rowIndex0 = F24Dot8ToPixelIndex(y0);
-    const PixelIndex rowIndex1 = F24Dot8ToPixelIndex(y1 - 1);
-    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
-    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
-    const F24Dot8 fx = x - PixelIndexToF24Dot8(columnIndex);
+        SolidTileRun runs[MaximumSolidTileRunsPerRow];
 
-    if (rowIndex0 == rowIndex1) {
-        return CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex0, fx, fy0, fy1);
-    } else {
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex0, fx, fy0, F24Dot8_1);
+        const int count = FindSolidTileRunsForRow(runs, block, lineCount,
+            linearized->GetActualCoversForRow(i), bounds.ColumnCount,
+            height, geometry->Rule);
 
-        for (PixelIndex i = rowIndex0 + 1; i < rowIndex1; i++) {
-            CellVertical(bitVectorTable, coverAreaTable, columnIndex, i, fx, 0, F24Dot8_1);
+        if (count == 0) {
+            continue;
         }
 
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex1, fx, 0, fy1);
+        SolidTileRun *r = memory.FrameMallocArray<SolidTileRun>(count);
+
+        memcpy(r, runs, SIZE_OF(SolidTileRun) * count);
+
+        solidTileRuns[i].Runs = r;
+        solidTileRuns[i].Count = count;
     }
+
+    linearized->SolidTileRuns = solidTileRuns;
+
+    return linearized;
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::Vertical_Up(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex columnIndex, const F24Dot8 y0,
-    const F24Dot8 y1, const F24Dot8 x)
-{
-    ASSERT(y0 > y1);
+template <typename L>
+FORCE_INLINE typename Rasterizer<T>::RasterizableGeometry *
+Rasterizer<T>::LinearizeTiled(void *placement, const Geometry *geometry, const TileBounds &bounds, const IntSize imageSize, const RasterizerOptions &options, ThreadMemory &memory) {
+    RasterizableGeometry *linearized = new (placement) RasterizableGeometry(
+        geometry, IterateLinesTiled, bounds);
 
-    const PixelIndex rowIndex0 = F24Dot8ToPixelIndex(y0 - 1);
-    const PixelIndex rowIndex1 = F24Dot8ToPixelIndex(y1);
-    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
-    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
-    const F24Dot8 fx = x - PixelIndexToF24Dot8(columnIndex);
+    const bool contains =
+        geometry->PathBounds.MinX >= 0 and
+        geometry->PathBounds.MinY >= 0 and
+        geometry->PathBounds.MaxX <= imageSize.Width and
+        geometry->PathBounds.MaxY <= imageSize.Height;
 
-    if (rowIndex0 == rowIndex1) {
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex0, fx, fy0, fy1);
-    } else {
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex0, fx, fy0, 0);
+    Linearizer<T, L> *linearizer =
+        Linearizer<T, L>::Create(memory, bounds, contains, geometry);
 
-        for (PixelIndex i = rowIndex0 - 1; i > rowIndex1; i--) {
-            CellVertical(bitVectorTable, coverAreaTable, columnIndex, i, fx, F24Dot8_1, 0);
-        }
+    ASSERT(linearizer != nullptr);
 
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex1, fx, F24Dot8_1, fy1);
-    }
-}
+    linearized->StartCoverTable = FinalizeStartCoverTable(
+        linearizer->GetStartCoverTable(), bounds.RowCount);
 
+    // Line arrays only live as long as linearizer does, occupied columns of
+    // each row are copied to frame memory.
+    void **rows = memory.FrameMallocArray<void *>(bounds.RowCount);
 
-template <typename T>
-void Rasterizer<T>::CellVertical(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex px, const PixelIndex py,
-    const F24Dot8 x, const F24Dot8 y0, const F24Dot8 y1)
-{
-    ASSERT(px >= 0);
-    ASSERT(py >= 0);
-    ASSERT(py < T::TileH);
+    int32 *firstLineBlockCounts = memory.FrameMallocArrayZeroFill<int32>(
+        bounds.RowCount);
 
-    const F24Dot8 delta = y0 - y1;
-    const F24Dot8 a = delta * (F24Dot8_2 - x - x);
-    const int index = px << 1;
-    int32 *ca = coverAreaTable[py];
+    int32 *lineCounts = memory.FrameMallocArray<int32>(bounds.RowCount);
 
-    if (ConditionalSetBit(bitVectorTable[py], px)) {
-        // New.
-        ca[index] = delta;
-        ca[index + 1] = a;
-    } else {
-        // Update old.
-        const int32 cover = ca[index];
-        const int32 area = ca[index + 1];
+    SolidTileRunList *solidTileRuns =
+        memory.FrameMallocArray<SolidTileRunList>(bounds.RowCount);
 
-        ca[index] = cover + delta;
-        ca[index + 1] = area + a;
-    }
-}
+    const int bitVectorCount = BitVectorsForMaxBitCount(bounds.ColumnCount);
 
+    int64 lineBlockBytes = 0;
 
-template <typename T>
-void Rasterizer<T>::Cell(BitVector **bitVectorTable, int32 **coverAreaTable,
-    const PixelIndex px, const PixelIndex py, const F24Dot8 x0,
-    const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1)
-{
-    ASSERT(px >= 0);
-    ASSERT(py >= 0);
-    ASSERT(py < T::TileH);
+    for (TileIndex i = 0; i < bounds.RowCount; i++) {
+        new (solidTileRuns + i) SolidTileRunList();
 
-    const F24Dot8 delta = y0 - y1;
-    const F24Dot8 a = delta * (F24Dot8_2 - x0 - x1);
-    const int index = px << 1;
-    int32 *ca = coverAreaTable[py];
+        const L *la = linearizer->GetLineArrayAtIndex(i);
 
-    if (ConditionalSetBit(bitVectorTable[py], px)) {
-        // New.
-        ca[index] = delta;
-        ca[index + 1] = a;
-    } else {
-        // Update old.
-        const int32 cover = ca[index];
-        const int32 area = ca[index + 1];
+        ASSERT(la != nullptr);
 
-        ca[index] = cover + delta;
-        ca[index + 1] = area + a;
-    }
-}
+        const BitVector *bits = la->GetTileAllocationBitVectors();
+        const int columnCount = CountBitsInVector(bits, bitVectorCount);
 
+        const int py = T::TileRowIndexToPoints(bounds.Y + i);
+        const int height = Min(T::TileH, imageSize.Height - py);
 
-template <typename T>
-FORCE_INLINE void Rasterizer<T>::RowDownR(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
-    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
-{
-    ASSERT(p0x < p1x);
-    ASSERT(p0y >= 0);
-    ASSERT(p0y <= T::TileHF24Dot8);
-    ASSERT(p1y >= 0);
-    ASSERT(p1y <= T::TileHF24Dot8);
-    ASSERT(p0y <= p1y);
+        SolidTileRun runs[MaximumSolidTileRunsPerRow];
 
-    const PixelIndex columnIndex0 = F24Dot8ToPixelIndex(p0x);
-    const PixelIndex columnIndex1 = F24Dot8ToPixelIndex(p1x - 1);
+        int runCount = 0;
 
-    ASSERT(columnIndex0 <= columnIndex1);
+        if (columnCount == 0) {
+            rows[i] = nullptr;
+            lineCounts[i] = 0;
 
-    // Extract remainders.
-    const F24Dot8 fx0 = p0x - PixelIndexToF24Dot8(columnIndex0);
-    const F24Dot8 fx1 = p1x - PixelIndexToF24Dot8(columnIndex1);
+            // Row is either empty or completely solid.
+            if (CoversAreSolid(linearized->GetActualCoversForRow(i), height,
+                geometry->Rule))
+            {
+                runs[0].Begin = 0;
+                runs[0].End = bounds.ColumnCount;
+                runCount = 1;
+            }
+        } else {
+            TiledLineColumn *columns =
+                memory.FrameMallocArray<TiledLineColumn>(columnCount);
 
-    ASSERT(fx0 >= 0);
-    ASSERT(fx0 <= F24Dot8_1);
-    ASSERT(fx1 >= 0);
-    ASSERT(fx1 <= F24Dot8_1);
+            TiledLineRow *row = memory.FrameNew<TiledLineRow>();
 
-    if (columnIndex0 == columnIndex1) {
-        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, fx1, p1y);
-    } else {
-        // Horizontal and vertical deltas.
-        const F24Dot8 dx = p1x - p0x;
-        const F24Dot8 dy = p1y - p0y;
+            row->Columns = columns;
+            row->ColumnCount = columnCount;
 
-        const F24Dot8 pp = (F24Dot8_1 - fx0) * dy;
+            // Covers at the left edge of the next tile.
+            int32 covers[T::TileH];
 
-        F24Dot8 cy = p0y + (pp / dx);
+            memcpy(covers, linearized->GetActualCoversForRow(i),
+                SIZE_OF(int32) * T::TileH);
 
-        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y,
-            F24Dot8_1, cy);
+            TileIndex next = 0;
+            int lineCount = 0;
+            int n = 0;
 
-        PixelIndex idx = columnIndex0 + 1;
+            for (int j = 0; j < bitVectorCount; j++) {
+                BitVector v = bits[j];
 
-        if (idx != columnIndex1) {
-            F24Dot8 mod = (pp % dx) - dx;
+                while (v != 0) {
+                    const TileIndex c = TileIndex(
+                        (j * BIT_SIZE_OF(BitVector)) + CountTrailingZeroes(v));
 
-            const F24Dot8 p = F24Dot8_1 * dy;
-            const F24Dot8 lift = p / dx;
-            const F24Dot8 rem = p % dx;
+                    v &= v - 1;
 
-            for ( ; idx != columnIndex1; idx++) {
-                F24Dot8 delta = lift;
+                    const int count = la->GetTotalLineCountForColumn(c);
 
-                mod += rem;
+                    columns[n].Block = la->GetFrontBlockForColumn(c);
+                    columns[n].Index = c;
+                    columns[n].LineCount = count;
 
-                if (mod >= 0) {
-                    mod -= dx;
-                    delta++;
-                }
+                    n++;
 
-                const F24Dot8 ny = cy + delta;
+                    lineCount += count;
 
-                Cell(bitVectorTable, coverAreaTable, idx, rowIndex, 0, cy,
-                    F24Dot8_1, ny);
+                    lineBlockBytes += SIZE_OF(LineArrayTiledBlock) *
+                        ((count + LineArrayTiledBlock::LinesPerBlock - 1) /
+                            LineArrayTiledBlock::LinesPerBlock);
 
-                cy = ny;
+                    // Tiles between the previous column with lines and this
+                    // one all have the same covers.
+                    if (next < c and runCount < MaximumSolidTileRunsPerRow and
+                        CoversAreSolid(covers, height, geometry->Rule))
+                    {
+                        runs[runCount].Begin = next;
+                        runs[runCount].End = c;
+                        runCount++;
+                    }
+
+                    const int32 *columnCovers = la->GetCoversForColumn(c);
+
+                    for (int k = 0; k < T::TileH; k++) {
+                        covers[k] += columnCovers[k];
+                    }
+
+                    next = c + 1;
+                }
+            }
+
+            ASSERT(n == columnCount);
+
+            if (next < bounds.ColumnCount and
+                runCount < MaximumSolidTileRunsPerRow and
+                CoversAreSolid(covers, height, geometry->Rule))
+            {
+                runs[runCount].Begin = next;
+                runs[runCount].End = bounds.ColumnCount;
+                runCount++;
             }
+
+            rows[i] = row;
+            lineCounts[i] = lineCount;
         }
 
-        Cell(bitVectorTable, coverAreaTable, columnIndex1, rowIndex, 0, cy, fx1, p1y);
+        if (runCount > 0) {
+            SolidTileRun *r = memory.FrameMallocArray<SolidTileRun>(runCount);
+
+            memcpy(r, runs, SIZE_OF(SolidTileRun) * runCount);
+
+            solidTileRuns[i].Runs = r;
+            solidTileRuns[i].Count = runCount;
+        }
+    }
+
+    linearized->Lines = rows;
+    linearized->FirstBlockLineCounts = firstLineBlockCounts;
+    linearized->LineCounts = lineCounts;
+    linearized->SolidTileRuns = solidTileRuns;
+
+    if (options.Statistics != nullptr) {
+        options.Statistics->LineBlockBytes += lineBlockBytes;
     }
+
+    return linearized;
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RowDownR_V(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
-    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+FORCE_INLINE int32 **Rasterizer<T>::FinalizeStartCoverTable(int32 **startCoverTable, const TileIndex rowCount) {
+    if (startCoverTable != nullptr) {
+        for (TileIndex i = 0; i < rowCount; i++) {
+            const int32 *t = startCoverTable[i];
+
+            if (t != nullptr and T::CoverArrayContainsOnlyZeroes(t)) {
+                // Don't need cover array after all, all segments cancelled
+                // each other.
+                startCoverTable[i] = nullptr;
+            }
+        }
+    }
+
+    return startCoverTable;
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::UnpackLines(F24Dot8 *x0, F24Dot8 *y0,
+    F24Dot8 *x1, F24Dot8 *y1, const LineArrayX16Y16Block *block,
+    const int count)
 {
-    ASSERT(p0x <= p1x);
-    ASSERT(p0y >= 0);
-    ASSERT(p0y <= T::TileHF24Dot8);
-    ASSERT(p1y >= 0);
-    ASSERT(p1y <= T::TileHF24Dot8);
-    ASSERT(p0y <= p1y);
+    ASSERT(block != nullptr);
+    ASSERT(count <= LineArrayX16Y16Block::LinesPerBlock);
 
-    if (LIKELY(p0x < p1x)) {
-        RowDownR(bitVectorTable, coverAreaTable, rowIndex, p0x, p0y, p1x, p1y);
-    } else {
-        const PixelIndex columnIndex = F24Dot8ToPixelIndex(p0x - FindAdjustment(p0x));
-        const F24Dot8 x = p0x - PixelIndexToF24Dot8(columnIndex);
+    for (int i = 0; i < count; i++) {
+        const F8Dot8x2 y0y1 = block->Y0Y1[i];
+        const F8Dot8x2 x0x1 = block->X0X1[i];
 
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex, x, p0y, p1y);
+        x0[i] = UnpackLoFromF8Dot8x2(x0x1);
+        y0[i] = UnpackLoFromF8Dot8x2(y0y1);
+        x1[i] = UnpackHiFromF8Dot8x2(x0x1);
+        y1[i] = UnpackHiFromF8Dot8x2(y0y1);
     }
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RowUpR(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
-    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+FORCE_INLINE void Rasterizer<T>::UnpackLines(F24Dot8 *x0, F24Dot8 *y0,
+    F24Dot8 *x1, F24Dot8 *y1, const LineArrayX32Y16Block *block,
+    const int count)
 {
-    ASSERT(p0x < p1x);
-    ASSERT(p0y >= 0);
-    ASSERT(p0y <= T::TileHF24Dot8);
-    ASSERT(p1y >= 0);
-    ASSERT(p1y <= T::TileHF24Dot8);
-    ASSERT(p0y >= p1y);
+    ASSERT(block != nullptr);
+    ASSERT(count <= LineArrayX32Y16Block::LinesPerBlock);
 
-    const PixelIndex columnIndex0 = F24Dot8ToPixelIndex(p0x);
-    const PixelIndex columnIndex1 = F24Dot8ToPixelIndex(p1x - 1);
+    for (int i = 0; i < count; i++) {
+        const F8Dot8x2 y0y1 = block->Y0Y1[i];
 
-    ASSERT(columnIndex0 <= columnIndex1);
+        x0[i] = block->X0[i];
+        y0[i] = UnpackLoFromF8Dot8x2(y0y1);
+        x1[i] = block->X1[i];
+        y1[i] = UnpackHiFromF8Dot8x2(y0y1);
+    }
+}
 
-    // Extract remainders.
-    const F24Dot8 fx0 = p0x - PixelIndexToF24Dot8(columnIndex0);
-    const F24Dot8 fx1 = p1x - PixelIndexToF24Dot8(columnIndex1);
 
-    ASSERT(fx0 >= 0);
-    ASSERT(fx0 <= F24Dot8_1);
-    ASSERT(fx1 >= 0);
-    ASSERT(fx1 <= F24Dot8_1);
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::UnpackLines(F24Dot8 *x0, F24Dot8 *y0,
+    F24Dot8 *x1, F24Dot8 *y1, const LineArrayDeltaBlock *block,
+    const int count)
+{
+    int position = 0;
+    F24Dot8 x = 0;
+    F24Dot8 y = 0;
 
-    if (columnIndex0 == columnIndex1) {
-        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, fx1, p1y);
-    } else {
-        // Horizontal and vertical deltas.
-        const F24Dot8 dx = p1x - p0x;
-        const F24Dot8 dy = p0y - p1y;
+    DecodeLines(x0, y0, x1, y1, block, count, position, x, y);
+}
 
-        const F24Dot8 pp = (F24Dot8_1 - fx0) * dy;
 
-        F24Dot8 cy = p0y - (pp / dx);
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::UnpackLines(F24Dot8 *x0, F24Dot8 *y0,
+    F24Dot8 *x1, F24Dot8 *y1, const LineArrayTiledBlock *block,
+    const int count, const F24Dot8 x)
+{
+    ASSERT(block != nullptr);
+    ASSERT(count <= LineArrayTiledBlock::LinesPerBlock);
 
-        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y,
-            F24Dot8_1, cy);
+    for (int i = 0; i < count; i++) {
+        const F8Dot8x4 p = block->P0P1[i];
 
-        PixelIndex idx = columnIndex0 + 1;
+        x0[i] = x + F24Dot8(p & 0xffff);
+        y0[i] = F24Dot8((p >> 16) & 0xffff);
+        x1[i] = x + F24Dot8((p >> 32) & 0xffff);
+        y1[i] = F24Dot8(p >> 48);
+    }
+}
 
-        if (idx != columnIndex1) {
-            F24Dot8 mod = (pp % dx) - dx;
 
-            const F24Dot8 p = F24Dot8_1 * dy;
-            const F24Dot8 lift = p / dx;
-            const F24Dot8 rem = p % dx;
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::DecodeLines(F24Dot8 *x0, F24Dot8 *y0,
+    F24Dot8 *x1, F24Dot8 *y1, const LineArrayDeltaBlock *block,
+    const int count, int &position, F24Dot8 &x, F24Dot8 &y)
+{
+    ASSERT(block != nullptr);
+    ASSERT(count <= LineArrayDeltaBlock::MaximumLinesPerBlock);
 
-            for ( ; idx != columnIndex1; idx++) {
-                F24Dot8 delta = lift;
+    const int16 *words = block->Words;
 
-                mod += rem;
+    int p = position;
+    F24Dot8 cx = x;
+    F24Dot8 cy = y;
 
-                if (mod >= 0) {
-                    mod -= dx;
-                    delta++;
-                }
+    for (int i = 0; i < count; i++) {
+        ASSERT(p < LineArrayDeltaBlock::WordsPerBlock);
 
-                const F24Dot8 ny = cy - delta;
+        const int16 dy = words[p];
 
-                Cell(bitVectorTable, coverAreaTable, idx, rowIndex, 0, cy,
-                    F24Dot8_1, ny);
+        if (LIKELY(dy != 0)) {
+            x0[i] = cx;
+            y0[i] = cy;
 
-                cy = ny;
-            }
+            cx += words[p + 1];
+            cy += dy;
+
+            p += LineArrayDeltaBlock::WordsPerContinuation;
+        } else {
+            x0[i] = F24Dot8(uint32(uint16(words[p + 3])) |
+                (uint32(uint16(words[p + 4])) << 16));
+            y0[i] = words[p + 1];
+
+            cx = F24Dot8(uint32(uint16(words[p + 5])) |
+                (uint32(uint16(words[p + 6])) << 16));
+            cy = words[p + 2];
+
+            p += LineArrayDeltaBlock::WordsPerEscape;
         }
 
-        Cell(bitVectorTable, coverAreaTable, columnIndex1, rowIndex, 0, cy, fx1, p1y);
+        x1[i] = cx;
+        y1[i] = cy;
     }
+
+    position = p;
+    x = cx;
+    y = cy;
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RowUpR_V(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
-    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
-{
-    ASSERT(p0x <= p1x);
-    ASSERT(p0y >= 0);
-    ASSERT(p0y <= T::TileHF24Dot8);
-    ASSERT(p1y >= 0);
-    ASSERT(p1y <= T::TileHF24Dot8);
-    ASSERT(p0y >= p1y);
+FORCE_INLINE int Rasterizer<T>::GetFullBlockLineCount(const LineArrayX16Y16Block *) {
+    return LineArrayX16Y16Block::LinesPerBlock;
+}
 
-    if (LIKELY(p0x < p1x)) {
-        RowUpR(bitVectorTable, coverAreaTable, rowIndex, p0x, p0y, p1x, p1y);
-    } else {
-        const PixelIndex columnIndex = F24Dot8ToPixelIndex(p0x - FindAdjustment(p0x));
-        const F24Dot8 x = p0x - PixelIndexToF24Dot8(columnIndex);
 
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex, x, p0y, p1y);
-    }
+template <typename T>
+FORCE_INLINE int Rasterizer<T>::GetFullBlockLineCount(const LineArrayX32Y16Block *) {
+    return LineArrayX32Y16Block::LinesPerBlock;
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RowDownL(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
-    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+FORCE_INLINE int Rasterizer<T>::GetFullBlockLineCount(const LineArrayDeltaBlock *block) {
+    ASSERT(block != nullptr);
+
+    return block->LineCount;
+}
+
+
+template <typename T>
+template <typename B>
+FORCE_INLINE int Rasterizer<T>::FindSolidTileRunsForRow(SolidTileRun *runs,
+    const B *block, const int lineCount, const int32 *covers,
+    const TileIndex columnCount, const int height, const FillRule rule)
 {
-    ASSERT(p0x > p1x);
-    ASSERT(p0y >= 0);
-    ASSERT(p0y <= T::TileHF24Dot8);
-    ASSERT(p1y >= 0);
-    ASSERT(p1y <= T::TileHF24Dot8);
-    ASSERT(p0y <= p1y);
+    ASSERT(runs != nullptr);
+    ASSERT(covers != nullptr);
+    ASSERT(columnCount > 0);
+    ASSERT(height > 0);
+    ASSERT(height <= T::TileH);
 
-    const PixelIndex columnIndex0 = F24Dot8ToPixelIndex(p0x - 1);
-    const PixelIndex columnIndex1 = F24Dot8ToPixelIndex(p1x);
+    const int n = block == nullptr ? 0 : lineCount;
 
-    ASSERT(columnIndex1 <= columnIndex0);
+    ASSERT(n <= MaximumLineCountForSolidTileRuns);
 
-    // Extract remainders.
-    const F24Dot8 fx0 = p0x - PixelIndexToF24Dot8(columnIndex0);
-    const F24Dot8 fx1 = p1x - PixelIndexToF24Dot8(columnIndex1);
+    F24Dot8 x0[MaximumLineCountForSolidTileRuns];
+    F24Dot8 y0[MaximumLineCountForSolidTileRuns];
+    F24Dot8 x1[MaximumLineCountForSolidTileRuns];
+    F24Dot8 y1[MaximumLineCountForSolidTileRuns];
 
-    ASSERT(fx0 >= 0);
-    ASSERT(fx0 <= F24Dot8_1);
-    ASSERT(fx1 >= 0);
-    ASSERT(fx1 <= F24Dot8_1);
+    // Range of tile columns each line can leave edges in. Range is empty
+    // (last is less than first) for vertical lines lying exactly on tile
+    // boundary, these only change cover of tiles to the right.
+    int first[MaximumLineCountForSolidTileRuns];
+    int last[MaximumLineCountForSolidTileRuns];
 
-    if (columnIndex0 == columnIndex1) {
-        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, fx1, p1y);
-    } else {
-        // Horizontal and vertical deltas.
-        const F24Dot8 dx = p0x - p1x;
-        const F24Dot8 dy = p1y - p0y;
+    // Line indices, sorted by first tile column.
+    int order[MaximumLineCountForSolidTileRuns];
 
-        const F24Dot8 pp = fx0 * dy;
+    if (n > 0) {
+        UnpackLines(x0, y0, x1, y1, block, n);
+    }
 
-        F24Dot8 cy = p0y + (pp / dx);
+    for (int i = 0; i < n; i++) {
+        const F24Dot8 minx = Min(x0[i], x1[i]);
+        const F24Dot8 maxx = Max(x0[i], x1[i]);
 
-        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, 0, cy);
+        if (minx == maxx and (minx & (T::TileWF24Dot8 - 1)) == 0) {
+            const int c = T::F24Dot8ToTileColumnIndex(minx);
 
-        PixelIndex idx = columnIndex0 - 1;
+            first[i] = c;
+            last[i] = c - 1;
+        } else {
+            // Line pieces touching pixel boundary at their left end can be
+            // assigned to the pixel on the left side of that boundary.
+            first[i] = T::PointsToTileColumnIndex(Max(minx - 1, 0) >> 8);
+            last[i] = T::PointsToTileColumnIndex(Max(maxx - 1, 0) >> 8);
+        }
 
-        if (idx != columnIndex1) {
-            F24Dot8 mod = (pp % dx) - dx;
+        // Insertion sort, there are only a few lines.
+        int j = i;
 
-            const F24Dot8 p = F24Dot8_1 * dy;
-            const F24Dot8 lift = p / dx;
-            const F24Dot8 rem = p % dx;
+        while (j > 0 and first[order[j - 1]] > first[i]) {
+            order[j] = order[j - 1];
+            j--;
+        }
 
-            for ( ; idx != columnIndex1; idx--) {
-                F24Dot8 delta = lift;
+        order[j] = i;
+    }
 
-                mod += rem;
+    // Cover accumulated from the left edge of geometry up to current column.
+    int32 c[T::TileH];
 
-                if (mod >= 0) {
-                    mod -= dx;
-                    delta++;
-                }
+    memcpy(c, covers, SIZE_OF(int32) * T::TileH);
 
-                const F24Dot8 ny = cy + delta;
+    const int maxColumn = int(columnCount);
 
-                Cell(bitVectorTable, coverAreaTable, idx, rowIndex, F24Dot8_1,
-                    cy, 0, ny);
+    int count = 0;
+    int i = 0;
+    int column = 0;
 
-                cy = ny;
-            }
+    while (column < maxColumn) {
+        // Columns between current position and the next line are free of
+        // edges and have the same cover.
+        const int gapEnd = i < n ?
+            Min(first[order[i]], maxColumn) : maxColumn;
+
+        if (gapEnd > column and CoversAreSolid(c, height, rule)) {
+            runs[count].Begin = column;
+            runs[count].End = gapEnd;
+            count++;
         }
 
-        Cell(bitVectorTable, coverAreaTable, columnIndex1, rowIndex, F24Dot8_1, cy, fx1, p1y);
+        if (i == n) {
+            break;
+        }
+
+        // Skip all lines with overlapping column ranges, accumulating their
+        // cover on the way.
+        int intervalEnd = last[order[i]];
+
+        do {
+            const int k = order[i];
+
+            intervalEnd = Max(intervalEnd, last[k]);
+
+            UpdateCoverTable(c, y0[k], y1[k]);
+
+            i++;
+        } while (i < n and first[order[i]] <= intervalEnd);
+
+        column = Max(column, intervalEnd + 1);
     }
+
+    return count;
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RowDownL_V(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
-    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+FORCE_INLINE bool Rasterizer<T>::CoversAreSolid(const int32 *covers,
+    const int height, const FillRule rule)
 {
-    ASSERT(p0x >= p1x);
-    ASSERT(p0y >= 0);
-    ASSERT(p0y <= T::TileHF24Dot8);
-    ASSERT(p1y >= 0);
-    ASSERT(p1y <= T::TileHF24Dot8);
-    ASSERT(p0y <= p1y);
+    ASSERT(covers != nullptr);
 
-    if (LIKELY(p0x > p1x)) {
-        RowDownL(bitVectorTable, coverAreaTable, rowIndex, p0x, p0y, p1x, p1y);
+    if (rule == FillRule::NonZero) {
+        for (int i = 0; i < height; i++) {
+            if (AreaToAlphaNonZero16(covers[i] << 9) != 65535) {
+                return false;
+            }
+        }
     } else {
-        const PixelIndex columnIndex = F24Dot8ToPixelIndex(p0x - FindAdjustment(p0x));
-        const F24Dot8 x = p0x - PixelIndexToF24Dot8(columnIndex);
-
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex, x, p0y, p1y);
+        for (int i = 0; i < height; i++) {
+            if (AreaToAlphaEvenOdd16(covers[i] << 9) != 65535) {
+                return false;
+            }
+        }
     }
+
+    return true;
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RowUpL(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
-    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+FORCE_INLINE void Rasterizer<T>::Vertical_Down(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex columnIndex, const F24Dot8 y0,
+    const F24Dot8 y1, const F24Dot8 x)
 {
-    ASSERT(p0x > p1x);
-    ASSERT(p0y >= 0);
-    ASSERT(p0y <= T::TileHF24Dot8);
-    ASSERT(p1y >= 0);
-    ASSERT(p1y <= T::TileHF24Dot8);
-    ASSERT(p0y >= p1y);
+    ASSERT(y0 < y1);
 
-    const PixelIndex columnIndex0 = F24Dot8ToPixelIndex(p0x - 1);
-    const PixelIndex columnIndex1 = F24Dot8ToPixelIndex(p1x);
+    const PixelIndex rowIndex0 = F24Dot8ToPixelIndex(y0);
+    const PixelIndex rowIndex1 = F24Dot8ToPixelIndex(y1 - 1);
+    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
+    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+    const F24Dot8 fx = x - PixelIndexToF24Dot8(columnIndex);
 
-    ASSERT(columnIndex1 <= columnIndex0);
+    if (rowIndex0 == rowIndex1) {
+        return CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex0, fx, fy0, fy1);
+    } else {
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex0, fx, fy0, F24Dot8_1);
+
+        for (PixelIndex i = rowIndex0 + 1; i < rowIndex1; i++) {
+            CellVertical(bitVectorTable, coverAreaTable, columnIndex, i, fx, 0, F24Dot8_1);
+        }
+
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex1, fx, 0, fy1);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::Vertical_Up(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex columnIndex, const F24Dot8 y0,
+    const F24Dot8 y1, const F24Dot8 x)
+{
+    ASSERT(y0 > y1);
+
+    const PixelIndex rowIndex0 = F24Dot8ToPixelIndex(y0 - 1);
+    const PixelIndex rowIndex1 = F24Dot8ToPixelIndex(y1);
+    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
+    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+    const F24Dot8 fx = x - PixelIndexToF24Dot8(columnIndex);
+
+    if (rowIndex0 == rowIndex1) {
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex0, fx, fy0, fy1);
+    } else {
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex0, fx, fy0, 0);
+
+        for (PixelIndex i = rowIndex0 - 1; i > rowIndex1; i--) {
+            CellVertical(bitVectorTable, coverAreaTable, columnIndex, i, fx, F24Dot8_1, 0);
+        }
+
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex1, fx, F24Dot8_1, fy1);
+    }
+}
+
+
+template <typename T>
+void Rasterizer<T>::CellVertical(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex px, const PixelIndex py,
+    const F24Dot8 x, const F24Dot8 y0, const F24Dot8 y1)
+{
+    ASSERT(px >= 0);
+    ASSERT(py >= 0);
+    ASSERT(py < T::TileH);
+
+    const F24Dot8 delta = y0 - y1;
+    const F24Dot8 a = delta * (F24Dot8_2 - x - x);
+
+    UpdateCell(bitVectorTable, coverAreaTable, px, py, delta, a);
+}
+
+
+template <typename T>
+void Rasterizer<T>::Cell(BitVector **bitVectorTable, int32 **coverAreaTable,
+    const PixelIndex px, const PixelIndex py, const F24Dot8 x0,
+    const F24Dot8 y0, const F24Dot8 x1, const F24Dot8 y1)
+{
+    ASSERT(px >= 0);
+    ASSERT(py >= 0);
+    ASSERT(py < T::TileH);
+
+    const F24Dot8 delta = y0 - y1;
+    const F24Dot8 a = delta * (F24Dot8_2 - x0 - x1);
+
+    UpdateCell(bitVectorTable, coverAreaTable, px, py, delta, a);
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::UpdateCell(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex px, const PixelIndex py,
+    const int32 cover, const int32 area)
+{
+    ASSERT(py < T::TileH);
+
+    const int index = px << 1;
+    int32 *ca = coverAreaTable[py];
+
+    if (ConditionalSetMarkedBit(bitVectorTable[py], px)) {
+        // New.
+        ca[index] = cover;
+        ca[index + 1] = area;
+    } else {
+        // Update old.
+        ca[index] += cover;
+        ca[index + 1] += area;
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE bool Rasterizer<T>::ConditionalSetMarkedBit(
+    BitVector *bitVectors, const PixelIndex index)
+{
+    ASSERT(bitVectors != nullptr);
+
+    constexpr PixelIndex N = BIT_SIZE_OF(BitVector);
+
+    const PixelIndex vectorIndex = index / N;
+
+    BitVector *v = bitVectors + vectorIndex;
+
+    const BitVector current = *v;
+    const BitVector bit = BitVector(1) << (index % N);
+
+    if ((current & bit) != 0) {
+        return false;
+    }
+
+    if (current == 0) {
+        bitVectors[-1 - int(vectorIndex / N)] |=
+            BitVector(1) << (vectorIndex % N);
+    }
+
+    v[0] = current | bit;
+
+    return true;
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::ClearMarkedBitVectors(BitVector *bitVectors,
+    const int bitVectorCount)
+{
+    ASSERT(bitVectors != nullptr);
+    ASSERT(bitVectorCount > 0);
+
+    const int summaryCount = BitVectorsForMaxBitCount(bitVectorCount);
+
+    for (int s = 0; s < summaryCount; s++) {
+        BitVector summary = bitVectors[-1 - s];
+
+        while (summary != 0) {
+            const int i = (s * BIT_SIZE_OF(BitVector)) +
+                CountTrailingZeroes(summary);
+
+            summary &= summary - 1;
+
+            bitVectors[i] = 0;
+        }
+
+        bitVectors[-1 - s] = 0;
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RowDownR(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
+    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+{
+    ASSERT(p0x < p1x);
+    ASSERT(p0y >= 0);
+    ASSERT(p0y <= T::TileHF24Dot8);
+    ASSERT(p1y >= 0);
+    ASSERT(p1y <= T::TileHF24Dot8);
+    ASSERT(p0y <= p1y);
+
+    const PixelIndex columnIndex0 = F24Dot8ToPixelIndex(p0x);
+    const PixelIndex columnIndex1 = F24Dot8ToPixelIndex(p1x - 1);
+
+    ASSERT(columnIndex0 <= columnIndex1);
 
     // Extract remainders.
     const F24Dot8 fx0 = p0x - PixelIndexToF24Dot8(columnIndex0);
@@ -1121,606 +2546,1759 @@ FORCE_INLINE void Rasterizer<T>::RowUpL(BitVector **bitVectorTable,
         Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, fx1, p1y);
     } else {
         // Horizontal and vertical deltas.
-        const F24Dot8 dx = p0x - p1x;
+        const F24Dot8 dx = p1x - p0x;
+        const F24Dot8 dy = p1y - p0y;
+
+        const F24Dot8 pp = (F24Dot8_1 - fx0) * dy;
+
+        F24Dot8 cy = p0y + (pp / dx);
+
+        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y,
+            F24Dot8_1, cy);
+
+        PixelIndex idx = columnIndex0 + 1;
+
+        if (idx != columnIndex1) {
+            F24Dot8 mod = (pp % dx) - dx;
+
+            const F24Dot8 p = F24Dot8_1 * dy;
+            const F24Dot8 lift = p / dx;
+            const F24Dot8 rem = p % dx;
+
+            for ( ; idx != columnIndex1; idx++) {
+                F24Dot8 delta = lift;
+
+                mod += rem;
+
+                if (mod >= 0) {
+                    mod -= dx;
+                    delta++;
+                }
+
+                const F24Dot8 ny = cy + delta;
+
+                Cell(bitVectorTable, coverAreaTable, idx, rowIndex, 0, cy,
+                    F24Dot8_1, ny);
+
+                cy = ny;
+            }
+        }
+
+        Cell(bitVectorTable, coverAreaTable, columnIndex1, rowIndex, 0, cy, fx1, p1y);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RowDownR_V(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
+    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+{
+    ASSERT(p0x <= p1x);
+    ASSERT(p0y >= 0);
+    ASSERT(p0y <= T::TileHF24Dot8);
+    ASSERT(p1y >= 0);
+    ASSERT(p1y <= T::TileHF24Dot8);
+    ASSERT(p0y <= p1y);
+
+    if (LIKELY(p0x < p1x)) {
+        RowDownR(bitVectorTable, coverAreaTable, rowIndex, p0x, p0y, p1x, p1y);
+    } else {
+        const PixelIndex columnIndex = F24Dot8ToPixelIndex(p0x - FindAdjustment(p0x));
+        const F24Dot8 x = p0x - PixelIndexToF24Dot8(columnIndex);
+
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex, x, p0y, p1y);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RowUpR(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
+    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+{
+    ASSERT(p0x < p1x);
+    ASSERT(p0y >= 0);
+    ASSERT(p0y <= T::TileHF24Dot8);
+    ASSERT(p1y >= 0);
+    ASSERT(p1y <= T::TileHF24Dot8);
+    ASSERT(p0y >= p1y);
+
+    const PixelIndex columnIndex0 = F24Dot8ToPixelIndex(p0x);
+    const PixelIndex columnIndex1 = F24Dot8ToPixelIndex(p1x - 1);
+
+    ASSERT(columnIndex0 <= columnIndex1);
+
+    // Extract remainders.
+    const F24Dot8 fx0 = p0x - PixelIndexToF24Dot8(columnIndex0);
+    const F24Dot8 fx1 = p1x - PixelIndexToF24Dot8(columnIndex1);
+
+    ASSERT(fx0 >= 0);
+    ASSERT(fx0 <= F24Dot8_1);
+    ASSERT(fx1 >= 0);
+    ASSERT(fx1 <= F24Dot8_1);
+
+    if (columnIndex0 == columnIndex1) {
+        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, fx1, p1y);
+    } else {
+        // Horizontal and vertical deltas.
+        const F24Dot8 dx = p1x - p0x;
         const F24Dot8 dy = p0y - p1y;
 
-        const F24Dot8 pp = fx0 * dy;
+        const F24Dot8 pp = (F24Dot8_1 - fx0) * dy;
+
+        F24Dot8 cy = p0y - (pp / dx);
+
+        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y,
+            F24Dot8_1, cy);
+
+        PixelIndex idx = columnIndex0 + 1;
+
+        if (idx != columnIndex1) {
+            F24Dot8 mod = (pp % dx) - dx;
+
+            const F24Dot8 p = F24Dot8_1 * dy;
+            const F24Dot8 lift = p / dx;
+            const F24Dot8 rem = p % dx;
+
+            for ( ; idx != columnIndex1; idx++) {
+                F24Dot8 delta = lift;
+
+                mod += rem;
+
+                if (mod >= 0) {
+                    mod -= dx;
+                    delta++;
+                }
+
+                const F24Dot8 ny = cy - delta;
+
+                Cell(bitVectorTable, coverAreaTable, idx, rowIndex, 0, cy,
+                    F24Dot8_1, ny);
+
+                cy = ny;
+            }
+        }
+
+        Cell(bitVectorTable, coverAreaTable, columnIndex1, rowIndex, 0, cy, fx1, p1y);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RowUpR_V(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
+    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+{
+    ASSERT(p0x <= p1x);
+    ASSERT(p0y >= 0);
+    ASSERT(p0y <= T::TileHF24Dot8);
+    ASSERT(p1y >= 0);
+    ASSERT(p1y <= T::TileHF24Dot8);
+    ASSERT(p0y >= p1y);
+
+    if (LIKELY(p0x < p1x)) {
+        RowUpR(bitVectorTable, coverAreaTable, rowIndex, p0x, p0y, p1x, p1y);
+    } else {
+        const PixelIndex columnIndex = F24Dot8ToPixelIndex(p0x - FindAdjustment(p0x));
+        const F24Dot8 x = p0x - PixelIndexToF24Dot8(columnIndex);
+
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex, x, p0y, p1y);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RowDownL(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
+    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+{
+    ASSERT(p0x > p1x);
+    ASSERT(p0y >= 0);
+    ASSERT(p0y <= T::TileHF24Dot8);
+    ASSERT(p1y >= 0);
+    ASSERT(p1y <= T::TileHF24Dot8);
+    ASSERT(p0y <= p1y);
+
+    const PixelIndex columnIndex0 = F24Dot8ToPixelIndex(p0x - 1);
+    const PixelIndex columnIndex1 = F24Dot8ToPixelIndex(p1x);
+
+    ASSERT(columnIndex1 <= columnIndex0);
+
+    // Extract remainders.
+    const F24Dot8 fx0 = p0x - PixelIndexToF24Dot8(columnIndex0);
+    const F24Dot8 fx1 = p1x - PixelIndexToF24Dot8(columnIndex1);
+
+    ASSERT(fx0 >= 0);
+    ASSERT(fx0 <= F24Dot8_1);
+    ASSERT(fx1 >= 0);
+    ASSERT(fx1 <= F24Dot8_1);
+
+    if (columnIndex0 == columnIndex1) {
+        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, fx1, p1y);
+    } else {
+        // Horizontal and vertical deltas.
+        const F24Dot8 dx = p0x - p1x;
+        const F24Dot8 dy = p1y - p0y;
+
+        const F24Dot8 pp = fx0 * dy;
+
+        F24Dot8 cy = p0y + (pp / dx);
+
+        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, 0, cy);
+
+        PixelIndex idx = columnIndex0 - 1;
+
+        if (idx != columnIndex1) {
+            F24Dot8 mod = (pp % dx) - dx;
+
+            const F24Dot8 p = F24Dot8_1 * dy;
+            const F24Dot8 lift = p / dx;
+            const F24Dot8 rem = p % dx;
+
+            for ( ; idx != columnIndex1; idx--) {
+                F24Dot8 delta = lift;
+
+                mod += rem;
+
+                if (mod >= 0) {
+                    mod -= dx;
+                    delta++;
+                }
+
+                const F24Dot8 ny = cy + delta;
+
+                Cell(bitVectorTable, coverAreaTable, idx, rowIndex, F24Dot8_1,
+                    cy, 0, ny);
+
+                cy = ny;
+            }
+        }
+
+        Cell(bitVectorTable, coverAreaTable, columnIndex1, rowIndex, F24Dot8_1, cy, fx1, p1y);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RowDownL_V(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
+    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+{
+    ASSERT(p0x >= p1x);
+    ASSERT(p0y >= 0);
+    ASSERT(p0y <= T::TileHF24Dot8);
+    ASSERT(p1y >= 0);
+    ASSERT(p1y <= T::TileHF24Dot8);
+    ASSERT(p0y <= p1y);
+
+    if (LIKELY(p0x > p1x)) {
+        RowDownL(bitVectorTable, coverAreaTable, rowIndex, p0x, p0y, p1x, p1y);
+    } else {
+        const PixelIndex columnIndex = F24Dot8ToPixelIndex(p0x - FindAdjustment(p0x));
+        const F24Dot8 x = p0x - PixelIndexToF24Dot8(columnIndex);
+
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex, x, p0y, p1y);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RowUpL(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
+    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+{
+    ASSERT(p0x > p1x);
+    ASSERT(p0y >= 0);
+    ASSERT(p0y <= T::TileHF24Dot8);
+    ASSERT(p1y >= 0);
+    ASSERT(p1y <= T::TileHF24Dot8);
+    ASSERT(p0y >= p1y);
+
+    const PixelIndex columnIndex0 = F24Dot8ToPixelIndex(p0x - 1);
+    const PixelIndex columnIndex1 = F24Dot8ToPixelIndex(p1x);
+
+    ASSERT(columnIndex1 <= columnIndex0);
+
+    // Extract remainders.
+    const F24Dot8 fx0 = p0x - PixelIndexToF24Dot8(columnIndex0);
+    const F24Dot8 fx1 = p1x - PixelIndexToF24Dot8(columnIndex1);
+
+    ASSERT(fx0 >= 0);
+    ASSERT(fx0 <= F24Dot8_1);
+    ASSERT(fx1 >= 0);
+    ASSERT(fx1 <= F24Dot8_1);
+
+    if (columnIndex0 == columnIndex1) {
+        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, fx1, p1y);
+    } else {
+        // Horizontal and vertical deltas.
+        const F24Dot8 dx = p0x - p1x;
+        const F24Dot8 dy = p0y - p1y;
+
+        const F24Dot8 pp = fx0 * dy;
+
+        F24Dot8 cy = p0y - (pp / dx);
+
+        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, 0, cy);
+
+        PixelIndex idx = columnIndex0 - 1;
+
+        if (idx != columnIndex1) {
+            F24Dot8 mod = (pp % dx) - dx;
+
+            const F24Dot8 p = F24Dot8_1 * dy;
+            const F24Dot8 lift = p / dx;
+            const F24Dot8 rem = p % dx;
+
+            for ( ; idx != columnIndex1; idx--) {
+                F24Dot8 delta = lift;
+
+                mod += rem;
+
+                if (mod >= 0) {
+                    mod -= dx;
+                    delta++;
+                }
+
+                const F24Dot8 ny = cy - delta;
+
+                Cell(bitVectorTable, coverAreaTable, idx, rowIndex, F24Dot8_1,
+                    cy, 0, ny);
+
+                cy = ny;
+            }
+        }
+
+        Cell(bitVectorTable, coverAreaTable, columnIndex1, rowIndex, F24Dot8_1, cy, fx1, p1y);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RowUpL_V(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
+    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+{
+    ASSERT(p0x >= p1x);
+    ASSERT(p0y >= 0);
+    ASSERT(p0y <= T::TileHF24Dot8);
+    ASSERT(p1y >= 0);
+    ASSERT(p1y <= T::TileHF24Dot8);
+    ASSERT(p0y >= p1y);
+
+    if (LIKELY(p0x > p1x)) {
+        RowUpL(bitVectorTable, coverAreaTable, rowIndex, p0x, p0y, p1x, p1y);
+    } else {
+        const PixelIndex columnIndex = F24Dot8ToPixelIndex(p0x - FindAdjustment(p0x));
+        const F24Dot8 x = p0x - PixelIndexToF24Dot8(columnIndex);
+
+        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex, x, p0y, p1y);
+    }
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::LineDownR(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex0,
+    const PixelIndex rowIndex1, const F24Dot8 x0, const F24Dot8 y0,
+    const F24Dot8 x1, const F24Dot8 y1)
+{
+    ASSERT(y0 < y1);
+    ASSERT(x0 < x1);
+    ASSERT(rowIndex0 < rowIndex1);
+
+    const F24Dot8 dx = x1 - x0;
+    const F24Dot8 dy = y1 - y0;
+
+    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
+    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+
+    F24Dot8 p = (F24Dot8_1 - fy0) * dx;
+    F24Dot8 delta = p / dy;
+
+    F24Dot8 cx = x0 + delta;
+
+    RowDownR_V(bitVectorTable, coverAreaTable, rowIndex0, x0, fy0, cx,
+        F24Dot8_1);
+
+    PixelIndex idy = rowIndex0 + 1;
+
+    if (idy != rowIndex1) {
+        F24Dot8 mod = (p % dy) - dy;
+
+        p = F24Dot8_1 * dx;
+
+        F24Dot8 lift = p / dy;
+        F24Dot8 rem = p % dy;
+
+        for ( ; idy != rowIndex1; idy++) {
+            delta = lift;
+            mod += rem;
+
+            if (mod >= 0) {
+                mod -= dy;
+                delta++;
+            }
+
+            const F24Dot8 nx = cx + delta;
+
+            RowDownR_V(bitVectorTable, coverAreaTable, idy, cx, 0, nx,
+                F24Dot8_1);
+
+            cx = nx;
+        }
+    }
+
+    RowDownR_V(bitVectorTable, coverAreaTable, rowIndex1, cx, 0, x1, fy1);
+}
+
+
+/**
+ * ⬈
+ */
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::LineUpR(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex0,
+    const PixelIndex rowIndex1, const F24Dot8 x0, const F24Dot8 y0,
+    const F24Dot8 x1, const F24Dot8 y1)
+{
+    ASSERT(y0 > y1);
+    ASSERT(x0 < x1);
+    ASSERT(rowIndex0 > rowIndex1);
+
+    const F24Dot8 dx = x1 - x0;
+    const F24Dot8 dy = y0 - y1;
+
+    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
+    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+
+    F24Dot8 p = fy0 * dx;
+    F24Dot8 delta = p / dy;
+
+    F24Dot8 cx = x0 + delta;
+
+    RowUpR_V(bitVectorTable, coverAreaTable, rowIndex0, x0, fy0, cx, 0);
+
+    PixelIndex idy = rowIndex0 - 1;
+
+    if (idy != rowIndex1) {
+        F24Dot8 mod = (p % dy) - dy;
+
+        p = F24Dot8_1 * dx;
+
+        F24Dot8 lift = p / dy;
+        F24Dot8 rem = p % dy;
+
+        for ( ; idy != rowIndex1; idy--) {
+            delta = lift;
+            mod += rem;
+
+            if (mod >= 0) {
+                mod -= dy;
+                delta++;
+            }
+
+            const F24Dot8 nx = cx + delta;
+
+            RowUpR_V(bitVectorTable, coverAreaTable, idy, cx, F24Dot8_1, nx, 0);
+
+            cx = nx;
+        }
+    }
+
+    RowUpR_V(bitVectorTable, coverAreaTable, rowIndex1, cx, F24Dot8_1, x1, fy1);
+}
+
+
+/**
+ * ⬋
+ */
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::LineDownL(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex0,
+    const PixelIndex rowIndex1, const F24Dot8 x0, const F24Dot8 y0,
+    const F24Dot8 x1, const F24Dot8 y1)
+{
+    ASSERT(y0 < y1);
+    ASSERT(x0 > x1);
+    ASSERT(rowIndex0 < rowIndex1);
+
+    const F24Dot8 dx = x0 - x1;
+    const F24Dot8 dy = y1 - y0;
+
+    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
+    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+
+    F24Dot8 p = (F24Dot8_1 - fy0) * dx;
+    F24Dot8 delta = p / dy;
+
+    F24Dot8 cx = x0 - delta;
+
+    RowDownL_V(bitVectorTable, coverAreaTable, rowIndex0, x0, fy0, cx,
+        F24Dot8_1);
+
+    PixelIndex idy = rowIndex0 + 1;
+
+    if (idy != rowIndex1) {
+        F24Dot8 mod = (p % dy) - dy;
+
+        p = F24Dot8_1 * dx;
+
+        F24Dot8 lift = p / dy;
+        F24Dot8 rem = p % dy;
+
+        for ( ; idy != rowIndex1; idy++) {
+            delta = lift;
+            mod += rem;
+
+            if (mod >= 0) {
+                mod -= dy;
+                delta++;
+            }
+
+            const F24Dot8 nx = cx - delta;
+
+            RowDownL_V(bitVectorTable, coverAreaTable, idy, cx, 0, nx,
+                F24Dot8_1);
+
+            cx = nx;
+        }
+    }
+
+    RowDownL_V(bitVectorTable, coverAreaTable, rowIndex1, cx, 0, x1, fy1);
+}
+
+
+/**
+ * ⬉
+ */
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::LineUpL(BitVector **bitVectorTable,
+    int32 **coverAreaTable, const PixelIndex rowIndex0,
+    const PixelIndex rowIndex1, const F24Dot8 x0, const F24Dot8 y0,
+    const F24Dot8 x1, const F24Dot8 y1)
+{
+    ASSERT(y0 > y1);
+    ASSERT(x0 > x1);
+    ASSERT(rowIndex0 > rowIndex1);
+
+    const F24Dot8 dx = x0 - x1;
+    const F24Dot8 dy = y0 - y1;
+
+    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
+    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+
+    F24Dot8 p = fy0 * dx;
+    F24Dot8 delta = p / dy;
+
+    F24Dot8 cx = x0 - delta;
+
+    RowUpL_V(bitVectorTable, coverAreaTable, rowIndex0, x0, fy0, cx, 0);
+
+    PixelIndex idy = rowIndex0 - 1;
+
+    if (idy != rowIndex1) {
+        F24Dot8 mod = (p % dy) - dy;
+
+        p = F24Dot8_1 * dx;
+
+        F24Dot8 lift = p / dy;
+        F24Dot8 rem = p % dy;
+
+        for ( ; idy != rowIndex1; idy--) {
+            delta = lift;
+            mod += rem;
+
+            if (mod >= 0) {
+                mod -= dy;
+                delta++;
+            }
+
+            const F24Dot8 nx = cx - delta;
+
+            RowUpL_V(bitVectorTable, coverAreaTable, idy, cx, F24Dot8_1, nx, 0);
+
+            cx = nx;
+        }
+    }
+
+    RowUpL_V(bitVectorTable, coverAreaTable, rowIndex1, cx, F24Dot8_1, x1, fy1);
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RasterizeLine(const F24Dot8 X0,
+    const F24Dot8 Y0, const F24Dot8 X1, const F24Dot8 Y1,
+    BitVector **bitVectorTable, int32 **coverAreaTable)
+{
+    ASSERT(Y0 != Y1);
+    ASSERT(bitVectorTable != nullptr);
+    ASSERT(coverAreaTable != nullptr);
+
+    if (X0 == X1) {
+        const PixelIndex columnIndex = F24Dot8ToPixelIndex(X0 - FindAdjustment(X0));
+
+        // Special case, vertical line, simplifies this thing a lot.
+        if (Y0 < Y1) {
+            // Line is going down ↓
+            return Vertical_Down(bitVectorTable, coverAreaTable, columnIndex, Y0, Y1, X0);
+        } else {
+            // Line is going up ↑
+            return Vertical_Up(bitVectorTable, coverAreaTable, columnIndex, Y0, Y1, X0);
+        }
+    }
+
+    if (Y0 < Y1) {
+        // Line is going down ↓
+        const PixelIndex rowIndex0 = F24Dot8ToPixelIndex(Y0);
+        const PixelIndex rowIndex1 = F24Dot8ToPixelIndex(Y1 - 1);
+
+        ASSERT(rowIndex0 <= rowIndex1);
+
+        if (rowIndex0 == rowIndex1) {
+            // Entire line is completely within horizontal band. For curves
+            // this is common case.
+            const F24Dot8 ty = PixelIndexToF24Dot8(rowIndex0);
+            const F24Dot8 y0 = Y0 - ty;
+            const F24Dot8 y1 = Y1 - ty;
+
+            if (X0 < X1) {
+                return RowDownR(bitVectorTable, coverAreaTable, rowIndex0,
+                    X0, y0, X1, y1);
+            } else {
+                return RowDownL(bitVectorTable, coverAreaTable, rowIndex0,
+                    X0, y0, X1, y1);
+            }
+        } else if (X0 < X1) {
+            // Line is going from left to right →
+            return LineDownR(bitVectorTable, coverAreaTable, rowIndex0,
+                rowIndex1, X0, Y0, X1, Y1);
+        } else {
+            // Line is going right to left ←
+            return LineDownL(bitVectorTable, coverAreaTable, rowIndex0,
+                rowIndex1, X0, Y0, X1, Y1);
+        }
+    } else {
+        // Line is going up ↑
+        const PixelIndex rowIndex0 = F24Dot8ToPixelIndex(Y0 - 1);
+        const PixelIndex rowIndex1 = F24Dot8ToPixelIndex(Y1);
+
+        ASSERT(rowIndex1 <= rowIndex0);
+
+        if (rowIndex0 == rowIndex1) {
+            // Entire line is completely within horizontal band. For curves
+            // this is common case.
+            const F24Dot8 ty = PixelIndexToF24Dot8(rowIndex0);
+            const F24Dot8 y0 = Y0 - ty;
+            const F24Dot8 y1 = Y1 - ty;
+
+            if (X0 < X1) {
+                return RowUpR(bitVectorTable, coverAreaTable, rowIndex0,
+                    X0, y0, X1, y1);
+            } else {
+                return RowUpL(bitVectorTable, coverAreaTable, rowIndex0,
+                    X0, y0, X1, y1);
+            }
+        } else if (X0 < X1) {
+            // Line is going from left to right →
+            return LineUpR(bitVectorTable, coverAreaTable, rowIndex0,
+                rowIndex1, X0, Y0, X1, Y1);
+        } else {
+            // Line is going right to left ←
+            return LineUpL(bitVectorTable, coverAreaTable, rowIndex0,
+                rowIndex1, X0, Y0, X1, Y1);
+        }
+    }
+}
+
+
+template <typename T>
+template <typename B, FillRuleFn ApplyFillRule>
+FORCE_INLINE void Rasterizer<T>::RenderOneLine(uint8 *image,
+    const BitVector *bitVectorTable, const int bitVectorCount,
+    int32 *coverAreaTable, const int x, const int rowLength,
+    const int32 startCover, B blender)
+{
+    ASSERT(image != nullptr);
+    ASSERT(bitVectorTable != nullptr);
+    ASSERT(bitVectorCount > 0);
+    ASSERT(coverAreaTable != nullptr);
+    ASSERT(rowLength > 0);
+
+    // X must be aligned on tile boundary.
+    ASSERT((x & (T::TileW - 1)) == 0);
+
+    uint32 *d = reinterpret_cast<uint32 *>(image);
+
+    // Cover accumulation.
+    int32 cover = startCover;
+
+    // Span state.
+    uint32 spanX = x;
+    uint32 spanEnd = x;
+    uint32 spanAlpha = 0;
+
+    // Only bit vectors marked in summary contain bits, see
+    // ConditionalSetMarkedBit.
+    const int summaryCount = BitVectorsForMaxBitCount(bitVectorCount);
+
+    for (int s = 0; s < summaryCount; s++) {
+        BitVector summary = bitVectorTable[-1 - s];
+
+        while (summary != 0) {
+            const uint32 i = (s * BIT_SIZE_OF(BitVector)) +
+                CountTrailingZeroes(summary);
+
+            summary &= summary - 1;
+
+            BitVector bitset = bitVectorTable[i];
+
+            ASSERT(i < uint32(bitVectorCount));
+            ASSERT(bitset != 0);
+
+            // Bits in one bit vector are either scanned one by one below or,
+            // when most pixels between the first and the last bit have edges,
+            // rendered in one go by RenderDenseBits. The latter does not branch
+            // on every bit, which matters for rows crossing text or hatching.
+            const int bitRange = BIT_SIZE_OF(BitVector) -
+                CountLeadingZeroes(bitset) - CountTrailingZeroes(bitset);
+
+            if (bitRange >= DenseBitsMinRange and
+                (CountBits(bitset) * DenseBitsDivisor) >= bitRange)
+            {
+                RenderDenseBits<B, ApplyFillRule>(d, bitset, i, coverAreaTable,
+                    x, cover, spanX, spanEnd, spanAlpha, blender);
+
+                continue;
+            }
+
+            while (bitset != 0) {
+                const BitVector t = bitset & -bitset;
+                const uint32 r = CountTrailingZeroes(bitset);
+                const uint32 index = (i * BIT_SIZE_OF(BitVector)) + r;
+
+                bitset ^= t;
+
+                // Note that index is in local geometry coordinates.
+                const uint32 tableIndex = index << 1;
+                const uint32 edgeX = index + x;
+                const uint32 nextEdgeX = edgeX + 1;
+
+                // Signed area for pixel at bit index.
+                const int32 area = coverAreaTable[tableIndex + 1] +
+                    (cover << 9);
+
+                // Area converted to alpha according to fill rule.
+                const uint32 alpha = ApplyFillRule(area);
+
+                if (spanEnd == edgeX) {
+                    // No gap between previous span and current pixel.
+                    if (alpha == 0) {
+                        if (spanAlpha != 0) {
+                            blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
+                        }
+
+                        spanX = nextEdgeX;
+                        spanEnd = spanX;
+                        spanAlpha = 0;
+                    } else if (spanAlpha == alpha) {
+                        spanEnd = nextEdgeX;
+                    } else {
+                        // Alpha is not zero, but not equal to previous span
+                        // alpha.
+                        if (spanAlpha != 0) {
+                            blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
+                        }
+
+                        spanX = edgeX;
+                        spanEnd = nextEdgeX;
+                        spanAlpha = alpha;
+                    }
+                } else {
+                    ASSERT(spanEnd < edgeX);
+
+                    // There is a gap between last filled pixel and the new one.
+                    if (cover == 0) {
+                        // Empty gap.
+                        // Fill span if there is one and reset current span.
+                        if (spanAlpha != 0) {
+                            blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
+                        }
+
+                        spanX = edgeX;
+                        spanEnd = nextEdgeX;
+                        spanAlpha = alpha;
+                    } else {
+                        // Non empty gap.
+                        // Attempt to merge gap with current span.
+                        const uint32 gapAlpha = ApplyFillRule(cover << 9);
+
+                        // If alpha matches, extend current span.
+                        if (spanAlpha == gapAlpha) {
+                            if (alpha == gapAlpha) {
+                                // Current pixel alpha matches as well.
+                                spanEnd = nextEdgeX;
+                            } else {
+                                // Only gap alpha matches current span.
+                                blender.CompositeSpan(spanX, edgeX, d,
+                                    spanAlpha);
+
+                                spanX = edgeX;
+                                spanEnd = nextEdgeX;
+                                spanAlpha = alpha;
+                            }
+                        } else {
+                            if (spanAlpha != 0) {
+                                blender.CompositeSpan(spanX, spanEnd, d,
+                                    spanAlpha);
+                            }
+
+                            // Compose gap.
+                            blender.CompositeSpan(spanEnd, edgeX, d, gapAlpha);
+
+                            spanX = edgeX;
+                            spanEnd = nextEdgeX;
+                            spanAlpha = alpha;
+                        }
+                    }
+                }
+
+                cover += coverAreaTable[tableIndex];
+            }
+        }
+    }
+
+    if (spanAlpha != 0) {
+        // Composite current span.
+        blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
+    }
+
+    if (cover != 0 and spanEnd < uint32(rowLength)) {
+        // Composite anything that goes to the edge of destination image.
+        const int32 alpha = ApplyFillRule(cover << 9);
+
+        blender.CompositeSpan(spanEnd, rowLength, d, alpha);
+    }
+}
+
+
+template <typename T>
+template <typename B, FillRuleFn ApplyFillRule>
+FORCE_INLINE void Rasterizer<T>::RenderOneLineAccumulated(uint8 *image,
+    const BitVector *bitVectorTable, const int bitVectorCount,
+    const int32 *coverAreaTable, const int x, const int rowLength,
+    const int32 startCover, B blender)
+{
+    ASSERT(image != nullptr);
+    ASSERT(bitVectorTable != nullptr);
+    ASSERT(bitVectorCount > 0);
+    ASSERT(coverAreaTable != nullptr);
+    ASSERT(rowLength > 0);
+
+    // X must be aligned on tile boundary.
+    ASSERT((x & (T::TileW - 1)) == 0);
+
+    uint32 *d = reinterpret_cast<uint32 *>(image);
+
+    // Find the last bit set using summary, see ConditionalSetMarkedBit.
+    // Pixels after it have no edges and are handled the same way as in
+    // RenderOneLine.
+    int pixelCount = 0;
+
+    for (int s = BitVectorsForMaxBitCount(bitVectorCount) - 1; s >= 0; s--) {
+        const BitVector summary = bitVectorTable[-1 - s];
+
+        if (summary != 0) {
+            const int i = ((s + 1) * BIT_SIZE_OF(BitVector)) - 1 -
+                CountLeadingZeroes(summary);
+
+            ASSERT(i < bitVectorCount);
+
+            pixelCount = ((i + 1) * BIT_SIZE_OF(BitVector)) -
+                CountLeadingZeroes(bitVectorTable[i]);
+
+            break;
+        }
+    }
+
+    // Cover accumulation.
+    int32 cover = startCover;
+
+    // Span state. Span always reaches the last resolved pixel.
+    uint32 spanX = x;
+    uint32 spanAlpha = 0;
+
+    uint8 alphas[AccumulationChunkSize] ALIGNED(16);
+
+    for (int i = 0; i < pixelCount; i += AccumulationChunkSize) {
+        const int count = Min(AccumulationChunkSize, pixelCount - i);
+
+        // Rows are a multiple of tile width long, so rounding up stays
+        // within item. Additional pixels have no edges and do not change
+        // cover.
+        uint32 changes = ResolveAccumulatedAlphas<ApplyFillRule>(alphas,
+            coverAreaTable + (i << 1), (count + 3) & ~3, cover, spanAlpha);
+
+        if (count < AccumulationChunkSize) {
+            changes &= (uint32(1) << count) - 1;
+        }
+
+        // Only pixels where alpha changes end current span.
+        while (changes != 0) {
+            const uint32 j = CountTrailingZeroes(changes);
+            const uint32 edgeX = x + i + j;
+
+            changes &= changes - 1;
+
+            if (spanAlpha != 0) {
+                blender.CompositeSpan(spanX, edgeX, d, spanAlpha);
+            }
+
+            spanX = edgeX;
+            spanAlpha = alphas[j];
+        }
+    }
+
+    const uint32 spanEnd = x + pixelCount;
+
+    if (spanAlpha != 0) {
+        // Composite current span.
+        blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
+    }
+
+    if (cover != 0 and spanEnd < uint32(rowLength)) {
+        // Composite anything that goes to the edge of destination image.
+        const int32 alpha = ApplyFillRule(cover << 9);
+
+        blender.CompositeSpan(spanEnd, rowLength, d, alpha);
+    }
+}
+
+
+template <typename T>
+template <typename B, FillRuleFn ApplyFillRule>
+FORCE_INLINE void Rasterizer<T>::RenderDenseBits(uint32 *d,
+    const BitVector bitset, const uint32 bitsetIndex,
+    int32 *coverAreaTable, const int x, int32 &cover, uint32 &spanX,
+    uint32 &spanEnd, uint32 &spanAlpha, B &blender)
+{
+    ASSERT(d != nullptr);
+    ASSERT(bitset != 0);
+    ASSERT(coverAreaTable != nullptr);
+    ASSERT(spanX <= spanEnd);
+
+    const uint32 first = CountTrailingZeroes(bitset);
+    const uint32 count = BIT_SIZE_OF(BitVector) - first -
+        CountLeadingZeroes(bitset);
+
+    // Local index of the first bit and its position in destination image.
+    const uint32 index = (bitsetIndex * BIT_SIZE_OF(BitVector)) + first;
+    const uint32 edgeX = index + x;
+
+    ASSERT(spanEnd <= edgeX);
+
+    if (spanEnd < edgeX) {
+        // Gap between last processed pixel and the first bit. Handled the
+        // same way as in RenderOneLine, except that if gap has different
+        // alpha it simply becomes current span.
+        const uint32 gapAlpha = ApplyFillRule(cover << 9);
+
+        if (gapAlpha != spanAlpha) {
+            if (spanAlpha != 0) {
+                blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
+            }
+
+            spanX = spanEnd;
+            spanAlpha = gapAlpha;
+        }
+
+        spanEnd = edgeX;
+    }
+
+    // Cells of pixels without bits set were not written for this item.
+    // These are zeroed first, so every pixel in range can be read without
+    // branching on its bit. At most half of pixels in range are such, see
+    // DenseBitsDivisor.
+    int32 *t = coverAreaTable + (index << 1);
+
+    BitVector holes = ~(bitset >> first);
 
-        F24Dot8 cy = p0y - (pp / dx);
+    if (count < BIT_SIZE_OF(BitVector)) {
+        holes &= (BitVector(1) << count) - 1;
+    }
 
-        Cell(bitVectorTable, coverAreaTable, columnIndex0, rowIndex, fx0, p0y, 0, cy);
+    while (holes != 0) {
+        const uint32 i = CountTrailingZeroes(holes);
 
-        PixelIndex idx = columnIndex0 - 1;
+        holes &= holes - 1;
 
-        if (idx != columnIndex1) {
-            F24Dot8 mod = (pp % dx) - dx;
+        t[i << 1] = 0;
+        t[(i << 1) + 1] = 0;
+    }
 
-            const F24Dot8 p = F24Dot8_1 * dy;
-            const F24Dot8 lift = p / dx;
-            const F24Dot8 rem = p % dx;
+    // Calculate alpha of every pixel in range and mark pixels where alpha
+    // changes.
+    uint32 alphas[BIT_SIZE_OF(BitVector)];
+    BitVector changes = 0;
+    uint32 previous = spanAlpha;
 
-            for ( ; idx != columnIndex1; idx--) {
-                F24Dot8 delta = lift;
+    for (uint32 i = 0; i < count; i++) {
+        const int32 area = t[(i << 1) + 1] + (cover << 9);
+        const uint32 alpha = ApplyFillRule(area);
 
-                mod += rem;
+        cover += t[i << 1];
 
-                if (mod >= 0) {
-                    mod -= dx;
-                    delta++;
-                }
+        changes |= BitVector(alpha != previous) << i;
+        alphas[i] = alpha;
+        previous = alpha;
+    }
 
-                const F24Dot8 ny = cy - delta;
+    // Only pixels where alpha changes end current span.
+    while (changes != 0) {
+        const uint32 i = CountTrailingZeroes(changes);
 
-                Cell(bitVectorTable, coverAreaTable, idx, rowIndex, F24Dot8_1,
-                    cy, 0, ny);
+        changes &= changes - 1;
 
-                cy = ny;
-            }
+        if (spanAlpha != 0) {
+            blender.CompositeSpan(spanX, edgeX + i, d, spanAlpha);
         }
 
-        Cell(bitVectorTable, coverAreaTable, columnIndex1, rowIndex, F24Dot8_1, cy, fx1, p1y);
+        spanX = edgeX + i;
+        spanAlpha = alphas[i];
     }
+
+    spanEnd = edgeX + count;
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RowUpL_V(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex, const F24Dot8 p0x,
-    const F24Dot8 p0y, const F24Dot8 p1x, const F24Dot8 p1y)
+template <typename B>
+FORCE_INLINE Rasterizer<T>::SpanBlenderSkippingSpans<B>::SpanBlenderSkippingSpans(
+    const B &blender, const PixelSpan *spans, const int spanCount)
+:   Blender(blender),
+    Current(spans),
+    End(spans + spanCount)
 {
-    ASSERT(p0x >= p1x);
-    ASSERT(p0y >= 0);
-    ASSERT(p0y <= T::TileHF24Dot8);
-    ASSERT(p1y >= 0);
-    ASSERT(p1y <= T::TileHF24Dot8);
-    ASSERT(p0y >= p1y);
+}
 
-    if (LIKELY(p0x > p1x)) {
-        RowUpL(bitVectorTable, coverAreaTable, rowIndex, p0x, p0y, p1x, p1y);
-    } else {
-        const PixelIndex columnIndex = F24Dot8ToPixelIndex(p0x - FindAdjustment(p0x));
-        const F24Dot8 x = p0x - PixelIndexToF24Dot8(columnIndex);
 
-        CellVertical(bitVectorTable, coverAreaTable, columnIndex, rowIndex, x, p0y, p1y);
+template <typename T>
+template <typename B>
+FORCE_INLINE void Rasterizer<T>::SpanBlenderSkippingSpans<B>::CompositeSpan(
+    int pos, const int end, uint32 *d, const int32 alpha)
+{
+    ASSERT(pos < end);
+
+    while (pos < end) {
+        // Skip spans which end before current position.
+        while (Current < End and Current->End <= pos) {
+            Current++;
+        }
+
+        if (Current == End or end <= Current->Begin) {
+            Blender.CompositeSpan(pos, end, d, alpha);
+            return;
+        }
+
+        if (pos < Current->Begin) {
+            Blender.CompositeSpan(pos, Current->Begin, d, alpha);
+        }
+
+        pos = Current->End;
     }
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::LineDownR(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex0,
-    const PixelIndex rowIndex1, const F24Dot8 x0, const F24Dot8 y0,
-    const F24Dot8 x1, const F24Dot8 y1)
+template <typename W>
+FORCE_INLINE void Rasterizer<T>::RasterizeOneItem(const RasterizableItem *item,
+    BitVector **bitVectorTable, int32 **coverAreaTable, const int columnCount,
+    const ImageData &image, ClipMask &clipMask, LayerBuffer &layer,
+    ThreadMemory &memory)
 {
-    ASSERT(y0 < y1);
-    ASSERT(x0 < x1);
-    ASSERT(rowIndex0 < rowIndex1);
+    UpdateLayer(item, columnCount, image, layer, memory);
 
-    const F24Dot8 dx = x1 - x0;
-    const F24Dot8 dy = y1 - y0;
+    const ClipMask *clip = nullptr;
 
-    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
-    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+    if (item->Rasterizable->Clip != nullptr) {
+        // Clip path uses the same bit vectors and cover/area table, so it
+        // must be rendered before lines of item are rasterized.
+        RenderClipMask(item, bitVectorTable, coverAreaTable, columnCount,
+            image, clipMask, memory);
 
-    F24Dot8 p = (F24Dot8_1 - fy0) * dx;
-    F24Dot8 delta = p / dy;
+        clip = &clipMask;
+    }
 
-    F24Dot8 cx = x0 + delta;
+    ASSERT(item->Rasterizable->Bounds.ColumnCount <= columnCount);
 
-    RowDownR_V(bitVectorTable, coverAreaTable, rowIndex0, x0, fy0, cx,
-        F24Dot8_1);
+    const bool accumulated = PrepareOneItem(item, bitVectorTable,
+        coverAreaTable);
 
-    PixelIndex idy = rowIndex0 + 1;
+    const int bitVectorsPerRow = BitVectorsForMaxBitCount(
+        item->Rasterizable->Bounds.ColumnCount * T::TileW);
 
-    if (idy != rowIndex1) {
-        F24Dot8 mod = (p % dy) - dy;
+    // Rows without lines do not need bit vectors at all.
+    const bool hasLines = item->GetLineArray() != nullptr;
 
-        p = F24Dot8_1 * dx;
+    const int x = item->Rasterizable->Bounds.X * T::TileW;
 
-        F24Dot8 lift = p / dy;
-        F24Dot8 rem = p % dy;
+    // Y position, measured in tiles.
+    const int miny = item->Rasterizable->Bounds.Y + item->LocalRowIndex;
 
-        for ( ; idy != rowIndex1; idy++) {
-            delta = lift;
-            mod += rem;
+    // Y position, measure in pixels.
+    const int py = miny * T::TileH;
 
-            if (mod >= 0) {
-                mod -= dy;
-                delta++;
-            }
+    // Maximum y position, measured in pixels.
+    const int maxpy = py + T::TileH;
 
-            const F24Dot8 nx = cx + delta;
+    // Calculate maximum height. This can only get less than 8 when rendering
+    // the last row of the image and image height is not multiple of row
+    // height.
+    const int hh = Min(maxpy, image.Height) - py;
 
-            RowDownR_V(bitVectorTable, coverAreaTable, idy, cx, 0, nx,
-                F24Dot8_1);
+    // Items of layer are composited into layer buffer instead of destination
+    // image.
+    const ImageData target = layer.Layer == nullptr ? image :
+        ImageData(reinterpret_cast<uint8 *>(layer.Pixels), image.Width,
+            T::TileH, SIZE_OF(uint32) * layer.PixelsPerRow);
 
-            cx = nx;
+    // Start row.
+    uint8 *ptr = layer.Layer == nullptr ?
+        image.Data + (py * image.BytesPerRow) : target.Data;
+
+    const PaintShader *shader = item->Rasterizable->Shader;
+
+    if constexpr (W::SingleBlender) {
+        RenderOneItemWithBlender<W, W::MaximumAlpha>(item, bitVectorTable,
+            coverAreaTable, bitVectorsPerRow, ptr, x, py, hh, hasLines,
+            accumulated, target, clip);
+    } else if (shader != nullptr) {
+        switch (shader->Type) {
+            case PaintType::LinearGradient:
+                RenderOneItemWithBlender<SpanBlenderGradient<PaintType::LinearGradient>>(
+                    item, bitVectorTable, coverAreaTable, bitVectorsPerRow,
+                    ptr, x, py, hh, hasLines, accumulated, target, clip);
+                break;
+
+            case PaintType::RadialGradient:
+                RenderOneItemWithBlender<SpanBlenderGradient<PaintType::RadialGradient>>(
+                    item, bitVectorTable, coverAreaTable, bitVectorsPerRow,
+                    ptr, x, py, hh, hasLines, accumulated, target, clip);
+                break;
+
+            case PaintType::ImagePattern:
+                if (shader->Filter == ImageFilter::Nearest) {
+                    RenderOneItemWithBlender<SpanBlenderImage<ImageFilter::Nearest>>(
+                        item, bitVectorTable, coverAreaTable,
+                        bitVectorsPerRow, ptr, x, py, hh, hasLines,
+                        accumulated, target, clip);
+                } else {
+                    RenderOneItemWithBlender<SpanBlenderImage<ImageFilter::Bilinear>>(
+                        item, bitVectorTable, coverAreaTable,
+                        bitVectorsPerRow, ptr, x, py, hh, hasLines,
+                        accumulated, target, clip);
+                }
+                break;
         }
+    } else if (item->Rasterizable->Geometry->Mode != BlendMode::SourceOver) {
+        RenderOneItemWithBlender<SpanBlenderWithMode>(item, bitVectorTable,
+            coverAreaTable, bitVectorsPerRow, ptr, x, py, hh, hasLines,
+            accumulated, target, clip);
+    } else if constexpr (W::LinearBlending) {
+        RenderOneItemWithBlender<SpanBlenderLinear>(item, bitVectorTable,
+            coverAreaTable, bitVectorsPerRow, ptr, x, py, hh, hasLines,
+            accumulated, target, clip);
+    } else if (item->Rasterizable->Geometry->Color >= 0xff000000) {
+        RenderOneItemWithBlender<SpanBlenderOpaque>(item, bitVectorTable,
+            coverAreaTable, bitVectorsPerRow, ptr, x, py, hh, hasLines,
+            accumulated, target, clip);
+    } else {
+        RenderOneItemWithBlender<SpanBlender>(item, bitVectorTable,
+            coverAreaTable, bitVectorsPerRow, ptr, x, py, hh, hasLines,
+            accumulated, target, clip);
     }
 
-    RowDownR_V(bitVectorTable, coverAreaTable, rowIndex1, cx, 0, x1, fy1);
+    FinishOneItem(item, bitVectorTable);
 }
 
 
-/**
- * ⬈
- */
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::LineUpR(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex0,
-    const PixelIndex rowIndex1, const F24Dot8 x0, const F24Dot8 y0,
-    const F24Dot8 x1, const F24Dot8 y1)
+FORCE_INLINE void Rasterizer<T>::UpdateLayer(const RasterizableItem *item,
+    const int columnCount, const ImageData &image, LayerBuffer &layer,
+    ThreadMemory &memory)
 {
-    ASSERT(y0 > y1);
-    ASSERT(x0 < x1);
-    ASSERT(rowIndex0 > rowIndex1);
+    const RasterizableGeometry *rasterizable = item->Rasterizable;
+    const ::Layer *itemLayer = rasterizable->Geometry->Layer;
 
-    const F24Dot8 dx = x1 - x0;
-    const F24Dot8 dy = y0 - y1;
+    if (layer.Layer != nullptr and (itemLayer == nullptr or
+        rasterizable->LayerGroup != layer.Group))
+    {
+        CompositeLayer(layer, image);
+    }
 
-    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
-    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+    if (itemLayer == nullptr) {
+        return;
+    }
 
-    F24Dot8 p = fy0 * dx;
-    F24Dot8 delta = p / dy;
+    const int x = rasterizable->Bounds.X * T::TileW;
+    const int maxx = Min(image.Width,
+        x + int(rasterizable->Bounds.ColumnCount * T::TileW));
 
-    F24Dot8 cx = x0 + delta;
+    if (layer.Layer == nullptr) {
+        if (layer.Pixels == nullptr) {
+            layer.PixelsPerRow = columnCount * T::TileW;
 
-    RowUpR_V(bitVectorTable, coverAreaTable, rowIndex0, x0, fy0, cx, 0);
+            layer.Pixels = static_cast<uint32 *>(memory.TaskMalloc(
+                SIZE_OF(uint32) * T::TileH * layer.PixelsPerRow));
+        }
 
-    PixelIndex idy = rowIndex0 - 1;
+        const int py = (rasterizable->Bounds.Y + item->LocalRowIndex) *
+            T::TileH;
 
-    if (idy != rowIndex1) {
-        F24Dot8 mod = (p % dy) - dy;
+        layer.Layer = itemLayer;
+        layer.Group = rasterizable->LayerGroup;
+        layer.MinX = x;
+        layer.MaxX = x;
+        layer.Y = py;
+        layer.Height = Min(py + T::TileH, image.Height) - py;
+    }
 
-        p = F24Dot8_1 * dx;
+    // Clear pixels item can change which are not cleared yet. Cleared
+    // pixels stay contiguous.
+    for (int i = 0; i < layer.Height; i++) {
+        uint32 *d = layer.Pixels + (i * layer.PixelsPerRow);
 
-        F24Dot8 lift = p / dy;
-        F24Dot8 rem = p % dy;
+        if (x < layer.MinX) {
+            memset(d + x, 0, SIZE_OF(uint32) * (layer.MinX - x));
+        }
 
-        for ( ; idy != rowIndex1; idy--) {
-            delta = lift;
-            mod += rem;
+        if (maxx > layer.MaxX) {
+            memset(d + layer.MaxX, 0, SIZE_OF(uint32) * (maxx - layer.MaxX));
+        }
+    }
 
-            if (mod >= 0) {
-                mod -= dy;
-                delta++;
+    layer.MinX = Min(layer.MinX, x);
+    layer.MaxX = Max(layer.MaxX, maxx);
+}
+
+
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::CompositeLayer(LayerBuffer &layer,
+    const ImageData &image)
+{
+    if (layer.Layer == nullptr) {
+        return;
+    }
+
+    const BlendPixelSpanKernel kernel =
+        GetBlendModeKernels(layer.Layer->Mode).CompositePixelSpan;
+
+    const int32 opacity = layer.Layer->Opacity;
+
+    uint8 *ptr = image.Data + (layer.Y * image.BytesPerRow);
+
+    for (int i = 0; i < layer.Height; i++) {
+        const uint32 *s = layer.Pixels + (i * layer.PixelsPerRow);
+
+        uint32 *d = reinterpret_cast<uint32 *>(ptr);
+
+        // Composite runs of pixels which are not fully transparent, pixels
+        // no item of group has covered are left unchanged.
+        int x = layer.MinX;
+
+        while (x < layer.MaxX) {
+            while (x < layer.MaxX and s[x] == 0) {
+                x++;
             }
 
-            const F24Dot8 nx = cx + delta;
+            const int begin = x;
 
-            RowUpR_V(bitVectorTable, coverAreaTable, idy, cx, F24Dot8_1, nx, 0);
+            while (x < layer.MaxX and s[x] != 0) {
+                x++;
+            }
 
-            cx = nx;
+            if (begin < x) {
+                kernel(begin, x, d, opacity, s + begin);
+            }
         }
+
+        ptr += image.BytesPerRow;
     }
 
-    RowUpR_V(bitVectorTable, coverAreaTable, rowIndex1, cx, F24Dot8_1, x1, fy1);
+    layer.Layer = nullptr;
 }
 
 
-/**
- * ⬋
- */
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::LineDownL(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex0,
-    const PixelIndex rowIndex1, const F24Dot8 x0, const F24Dot8 y0,
-    const F24Dot8 x1, const F24Dot8 y1)
+FORCE_INLINE bool Rasterizer<T>::PrepareOneItem(const RasterizableItem *item,
+    BitVector **bitVectorTable, int32 **coverAreaTable)
 {
-    ASSERT(y0 < y1);
-    ASSERT(x0 > x1);
-    ASSERT(rowIndex0 < rowIndex1);
+    // A maximum number of horizontal tiles.
+    const int horizontalCount = item->Rasterizable->Bounds.ColumnCount;
 
-    const F24Dot8 dx = x0 - x1;
-    const F24Dot8 dy = y1 - y0;
+    // Rows without lines do not need bit vectors at all.
+    const bool hasLines = item->GetLineArray() != nullptr;
 
-    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
-    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+    // Rows where most pixels have edges are accumulated into cover/area
+    // rows cleared in advance, see DenseAccumulationPixelsPerLine.
+    const bool accumulated = hasLines and
+        (item->GetLineCount() * DenseAccumulationPixelsPerLine) >=
+            (horizontalCount * T::TileW);
 
-    F24Dot8 p = (F24Dot8_1 - fy0) * dx;
-    F24Dot8 delta = p / dy;
+    if (accumulated) {
+        for (int i = 0; i < T::TileH; i++) {
+            memset(coverAreaTable[i], 0,
+                SIZE_OF(int32) * 2 * horizontalCount * T::TileW);
+        }
+    }
 
-    F24Dot8 cx = x0 - delta;
+    if (hasLines) {
+        // Bit vector table is empty at this point, see RasterizeRow.
+        item->Rasterizable->IterationFunction(item, bitVectorTable,
+            coverAreaTable);
+    }
 
-    RowDownL_V(bitVectorTable, coverAreaTable, rowIndex0, x0, fy0, cx,
-        F24Dot8_1);
+    return accumulated;
+}
 
-    PixelIndex idy = rowIndex0 + 1;
 
-    if (idy != rowIndex1) {
-        F24Dot8 mod = (p % dy) - dy;
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::FinishOneItem(const RasterizableItem *item,
+    BitVector **bitVectorTable)
+{
+    if (item->GetLineArray() == nullptr) {
+        return;
+    }
 
-        p = F24Dot8_1 * dx;
+    const int bitVectorsPerRow = BitVectorsForMaxBitCount(
+        item->Rasterizable->Bounds.ColumnCount * T::TileW);
 
-        F24Dot8 lift = p / dy;
-        F24Dot8 rem = p % dy;
+    for (int i = 0; i < T::TileH; i++) {
+        ClearMarkedBitVectors(bitVectorTable[i], bitVectorsPerRow);
+    }
+}
 
-        for ( ; idy != rowIndex1; idy++) {
-            delta = lift;
-            mod += rem;
 
-            if (mod >= 0) {
-                mod -= dy;
-                delta++;
-            }
+template <typename T>
+FORCE_INLINE void Rasterizer<T>::RenderClipMask(const RasterizableItem *item,
+    BitVector **bitVectorTable, int32 **coverAreaTable, const int columnCount,
+    const ImageData &image, ClipMask &clipMask, ThreadMemory &memory)
+{
+    const RasterizableGeometry *clip = item->Rasterizable->Clip;
 
-            const F24Dot8 nx = cx - delta;
+    ASSERT(clip != nullptr);
 
-            RowDownL_V(bitVectorTable, coverAreaTable, idy, cx, 0, nx,
-                F24Dot8_1);
+    if (clipMask.Clip == clip) {
+        return;
+    }
 
-            cx = nx;
-        }
+    if (clipMask.Mask == nullptr) {
+        clipMask.PixelsPerRow = columnCount * T::TileW;
+
+        clipMask.Mask = static_cast<uint32 *>(memory.TaskMalloc(
+            SIZE_OF(uint32) * 2 * T::TileH * clipMask.PixelsPerRow));
+
+        clipMask.Coverage = clipMask.Mask + (T::TileH * clipMask.PixelsPerRow);
     }
 
-    RowDownL_V(bitVectorTable, coverAreaTable, rowIndex1, cx, 0, x1, fy1);
-}
+    // Tile row index within destination image.
+    const int row = item->Rasterizable->Bounds.Y + item->LocalRowIndex;
 
+    ASSERT(row >= int(clip->Bounds.Y));
+    ASSERT(row < int(clip->Bounds.Y + clip->Bounds.RowCount));
 
-/**
- * ⬉
- */
-template <typename T>
-FORCE_INLINE void Rasterizer<T>::LineUpL(BitVector **bitVectorTable,
-    int32 **coverAreaTable, const PixelIndex rowIndex0,
-    const PixelIndex rowIndex1, const F24Dot8 x0, const F24Dot8 y0,
-    const F24Dot8 x1, const F24Dot8 y1)
-{
-    ASSERT(y0 > y1);
-    ASSERT(x0 > x1);
-    ASSERT(rowIndex0 > rowIndex1);
+    const RasterizableItem clipItem(clip, row - clip->Bounds.Y);
 
-    const F24Dot8 dx = x0 - x1;
-    const F24Dot8 dy = y0 - y1;
+    ASSERT(clip->Bounds.ColumnCount <= columnCount);
 
-    const F24Dot8 fy0 = y0 - PixelIndexToF24Dot8(rowIndex0);
-    const F24Dot8 fy1 = y1 - PixelIndexToF24Dot8(rowIndex1);
+    const bool accumulated = PrepareOneItem(&clipItem, bitVectorTable,
+        coverAreaTable);
 
-    F24Dot8 p = fy0 * dx;
-    F24Dot8 delta = p / dy;
+    const int bitVectorsPerRow = BitVectorsForMaxBitCount(
+        clip->Bounds.ColumnCount * T::TileW);
 
-    F24Dot8 cx = x0 - delta;
+    const bool hasLines = clipItem.GetLineArray() != nullptr;
 
-    RowUpL_V(bitVectorTable, coverAreaTable, rowIndex0, x0, fy0, cx, 0);
+    const int x = clip->Bounds.X * T::TileW;
+    const int py = row * T::TileH;
+    const int hh = Min(py + T::TileH, image.Height) - py;
 
-    PixelIndex idy = rowIndex0 - 1;
+    // Clip path only changes pixels within its bounds.
+    const int maxx = Min(image.Width,
+        x + int(clip->Bounds.ColumnCount * T::TileW));
+
+    for (int i = 0; i < hh; i++) {
+        memset(clipMask.Mask + (i * clipMask.PixelsPerRow) + x, 0,
+            SIZE_OF(uint32) * (maxx - x));
+    }
+
+    const ImageData mask(reinterpret_cast<uint8 *>(clipMask.Mask),
+        image.Width, T::TileH, SIZE_OF(uint32) * clipMask.PixelsPerRow);
+
+    RenderOneItemWithBlender<SpanBlenderCoverage>(&clipItem, bitVectorTable,
+        coverAreaTable, bitVectorsPerRow, mask.Data, x, py, hh, hasLines,
+        accumulated, mask, nullptr);
+
+    FinishOneItem(&clipItem, bitVectorTable);
+
+    clipMask.Clip = clip;
+    clipMask.MinX = x;
+    clipMask.MaxX = maxx;
+}
+
+
+template <typename T>
+template <typename B>
+FORCE_INLINE B Rasterizer<T>::CreateBlender(
+    const RasterizableGeometry *rasterizable, const int y)
+{
+    if constexpr (B::UsesShader) {
+        ASSERT(rasterizable->Shader != nullptr);
+
+        return B(*rasterizable->Shader, y);
+    } else if constexpr (B::UsesBlendMode) {
+        return B(rasterizable->Geometry->Color, rasterizable->Geometry->Mode);
+    } else {
+        return B(rasterizable->Geometry->Color);
+    }
+}
 
-    if (idy != rowIndex1) {
-        F24Dot8 mod = (p % dy) - dy;
 
-        p = F24Dot8_1 * dx;
+template <typename T>
+template <typename B, int32 MaximumAlpha>
+FORCE_INLINE void Rasterizer<T>::RenderOneItemWithBlender(
+    const RasterizableItem *item, BitVector **bitVectorTable,
+    int32 **coverAreaTable, const int bitVectorsPerRow, uint8 *ptr,
+    const int x, const int y, const int height, const bool hasLines,
+    const bool accumulated, const ImageData &image, const ClipMask *clip)
+{
+    STATIC_ASSERT(MaximumAlpha == 255 or MaximumAlpha == 65535);
 
-        F24Dot8 lift = p / dy;
-        F24Dot8 rem = p % dy;
+    if (clip != nullptr) {
+        RenderOneClippedItem<B, MaximumAlpha>(item, bitVectorTable,
+            coverAreaTable, bitVectorsPerRow, ptr, x, y, height, hasLines,
+            accumulated, image, *clip);
 
-        for ( ; idy != rowIndex1; idy--) {
-            delta = lift;
-            mod += rem;
+        return;
+    }
 
-            if (mod >= 0) {
-                mod -= dy;
-                delta++;
-            }
+    constexpr FillRuleFn nonZero = MaximumAlpha == 255 ?
+        AreaToAlphaNonZero : AreaToAlphaNonZero16;
 
-            const F24Dot8 nx = cx - delta;
+    constexpr FillRuleFn evenOdd = MaximumAlpha == 255 ?
+        AreaToAlphaEvenOdd : AreaToAlphaEvenOdd16;
 
-            RowUpL_V(bitVectorTable, coverAreaTable, idy, cx, F24Dot8_1, nx, 0);
+    const FillRule rule = item->Rasterizable->Geometry->Rule;
 
-            cx = nx;
+    if (not hasLines) {
+        if (rule == FillRule::NonZero) {
+            RenderOneItemWithoutLines<B, nonZero>(item, ptr, x, y, height,
+                image);
+        } else {
+            RenderOneItemWithoutLines<B, evenOdd>(item, ptr, x, y, height,
+                image);
         }
+
+        return;
     }
 
-    RowUpL_V(bitVectorTable, coverAreaTable, rowIndex1, cx, F24Dot8_1, x1, fy1);
+    if (rule == FillRule::NonZero) {
+        RenderOneItem<B, nonZero>(item, bitVectorTable, coverAreaTable,
+            bitVectorsPerRow, ptr, x, y, height, accumulated, image);
+    } else {
+        RenderOneItem<B, evenOdd>(item, bitVectorTable, coverAreaTable,
+            bitVectorsPerRow, ptr, x, y, height, accumulated, image);
+    }
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RasterizeLine(const F24Dot8 X0,
-    const F24Dot8 Y0, const F24Dot8 X1, const F24Dot8 Y1,
-    BitVector **bitVectorTable, int32 **coverAreaTable)
+template <typename B, int32 MaximumAlpha>
+FORCE_INLINE void Rasterizer<T>::RenderOneClippedItem(
+    const RasterizableItem *item, BitVector **bitVectorTable,
+    int32 **coverAreaTable, const int bitVectorsPerRow, uint8 *ptr,
+    const int x, const int y, const int height, const bool hasLines,
+    const bool accumulated, const ImageData &image, const ClipMask &clip)
 {
-    ASSERT(Y0 != Y1);
-    ASSERT(bitVectorTable != nullptr);
-    ASSERT(coverAreaTable != nullptr);
+    ASSERT(clip.Clip == item->Rasterizable->Clip);
+    ASSERT(clip.Coverage != nullptr);
 
-    if (X0 == X1) {
-        const PixelIndex columnIndex = F24Dot8ToPixelIndex(X0 - FindAdjustment(X0));
+    // Item only changes pixels within its bounds.
+    const int maxx = Min(image.Width,
+        x + int(item->Rasterizable->Bounds.ColumnCount * T::TileW));
 
-        // Special case, vertical line, simplifies this thing a lot.
-        if (Y0 < Y1) {
-            // Line is going down ↓
-            return Vertical_Down(bitVectorTable, coverAreaTable, columnIndex, Y0, Y1, X0);
-        } else {
-            // Line is going up ↑
-            return Vertical_Up(bitVectorTable, coverAreaTable, columnIndex, Y0, Y1, X0);
-        }
+    for (int i = 0; i < height; i++) {
+        memset(clip.Coverage + (i * clip.PixelsPerRow) + x, 0,
+            SIZE_OF(uint32) * (maxx - x));
     }
 
-    if (Y0 < Y1) {
-        // Line is going down ↓
-        const PixelIndex rowIndex0 = F24Dot8ToPixelIndex(Y0);
-        const PixelIndex rowIndex1 = F24Dot8ToPixelIndex(Y1 - 1);
+    const ImageData coverage(reinterpret_cast<uint8 *>(clip.Coverage),
+        image.Width, T::TileH, SIZE_OF(uint32) * clip.PixelsPerRow);
 
-        ASSERT(rowIndex0 <= rowIndex1);
+    // Lines of item must be rendered even if nothing is visible, this
+    // leaves cover/area table empty for the next item.
+    RenderOneItemWithBlender<SpanBlenderCoverage>(item, bitVectorTable,
+        coverAreaTable, bitVectorsPerRow, coverage.Data, x, y, height,
+        hasLines, accumulated, coverage, nullptr);
 
-        if (rowIndex0 == rowIndex1) {
-            // Entire line is completely within horizontal band. For curves
-            // this is common case.
-            const F24Dot8 ty = PixelIndexToF24Dot8(rowIndex0);
-            const F24Dot8 y0 = Y0 - ty;
-            const F24Dot8 y1 = Y1 - ty;
+    const int minx = Max(x, clip.MinX);
+    const int end = Min(maxx, clip.MaxX);
 
-            if (X0 < X1) {
-                return RowDownR(bitVectorTable, coverAreaTable, rowIndex0,
-                    X0, y0, X1, y1);
-            } else {
-                return RowDownL(bitVectorTable, coverAreaTable, rowIndex0,
-                    X0, y0, X1, y1);
-            }
-        } else if (X0 < X1) {
-            // Line is going from left to right →
-            return LineDownR(bitVectorTable, coverAreaTable, rowIndex0,
-                rowIndex1, X0, Y0, X1, Y1);
-        } else {
-            // Line is going right to left ←
-            return LineDownL(bitVectorTable, coverAreaTable, rowIndex0,
-                rowIndex1, X0, Y0, X1, Y1);
-        }
-    } else {
-        // Line is going up ↑
-        const PixelIndex rowIndex0 = F24Dot8ToPixelIndex(Y0 - 1);
-        const PixelIndex rowIndex1 = F24Dot8ToPixelIndex(Y1);
+    for (int i = 0; i < height and minx < end; i++) {
+        const B blender = CreateBlender<B>(item->Rasterizable, y + i);
+        const uint32 *c = clip.Coverage + (i * clip.PixelsPerRow);
+        const uint32 *m = clip.Mask + (i * clip.PixelsPerRow);
 
-        ASSERT(rowIndex1 <= rowIndex0);
+        uint32 *d = reinterpret_cast<uint32 *>(ptr);
 
-        if (rowIndex0 == rowIndex1) {
-            // Entire line is completely within horizontal band. For curves
-            // this is common case.
-            const F24Dot8 ty = PixelIndexToF24Dot8(rowIndex0);
-            const F24Dot8 y0 = Y0 - ty;
-            const F24Dot8 y1 = Y1 - ty;
+        // Composite runs of pixels with the same alpha. Multiplying by 257
+        // maps 8 bit coverage to 16 bits exactly.
+        constexpr int32 scale = MaximumAlpha / 255;
 
-            if (X0 < X1) {
-                return RowUpR(bitVectorTable, coverAreaTable, rowIndex0,
-                    X0, y0, X1, y1);
-            } else {
-                return RowUpL(bitVectorTable, coverAreaTable, rowIndex0,
-                    X0, y0, X1, y1);
+        int spanX = minx;
+        int32 spanAlpha = Mul255(int32(c[minx]), int32(m[minx])) * scale;
+
+        for (int j = minx + 1; j < end; j++) {
+            const int32 alpha = Mul255(int32(c[j]), int32(m[j])) * scale;
+
+            if (alpha != spanAlpha) {
+                if (spanAlpha != 0) {
+                    blender.CompositeSpan(spanX, j, d, spanAlpha);
+                }
+
+                spanX = j;
+                spanAlpha = alpha;
             }
-        } else if (X0 < X1) {
-            // Line is going from left to right →
-            return LineUpR(bitVectorTable, coverAreaTable, rowIndex0,
-                rowIndex1, X0, Y0, X1, Y1);
-        } else {
-            // Line is going right to left ←
-            return LineUpL(bitVectorTable, coverAreaTable, rowIndex0,
-                rowIndex1, X0, Y0, X1, Y1);
         }
+
+        if (spanAlpha != 0) {
+            blender.CompositeSpan(spanX, end, d, spanAlpha);
+        }
+
+        ptr += image.BytesPerRow;
     }
 }
 
 
 template <typename T>
 template <typename B, FillRuleFn ApplyFillRule>
-FORCE_INLINE void Rasterizer<T>::RenderOneLine(uint8 *image,
-    const BitVector *bitVectorTable, const int bitVectorCount,
-    const int32 *coverAreaTable, const int x, const int rowLength,
-    const int32 startCover, const uint32 color)
+FORCE_INLINE void Rasterizer<T>::RenderOneItem(const RasterizableItem *item,
+    BitVector **bitVectorTable, int32 **coverAreaTable,
+    const int bitVectorsPerRow, uint8 *ptr, const int x, const int y,
+    const int height, const bool accumulated, const ImageData &image)
 {
-    ASSERT(image != nullptr);
-    ASSERT(bitVectorTable != nullptr);
-    ASSERT(bitVectorCount > 0);
-    ASSERT(coverAreaTable != nullptr);
-    ASSERT(rowLength > 0);
+    ASSERT(item != nullptr);
+    ASSERT(ptr != nullptr);
+    ASSERT(height > 0);
+    ASSERT(height <= T::TileH);
 
-    // X must be aligned on tile boundary.
-    ASSERT((x & (T::TileW - 1)) == 0);
+    // Pointer to backdrop.
+    const int32 *coversStart = item->GetActualCovers();
 
-    const B blender(color);
+    const RasterizableGeometry *rasterizable = item->Rasterizable;
+    const SolidTileRunList *runs = item->GetSolidTileRuns();
 
-    uint32 *d = reinterpret_cast<uint32 *>(image);
+    if (runs == nullptr or runs->Count == 0) {
+        for (int i = 0; i < height; i++) {
+            const B blender = CreateBlender<B>(rasterizable, y + i);
 
-    // Cover accumulation.
-    int32 cover = startCover;
+            RenderOneItemLine<B, ApplyFillRule>(ptr, bitVectorTable[i],
+                bitVectorsPerRow, coverAreaTable[i], x, image.Width,
+                coversStart[i], accumulated, blender);
 
-    // Span state.
-    uint32 spanX = x;
-    uint32 spanEnd = x;
-    uint32 spanAlpha = 0;
+            ptr += image.BytesPerRow;
+        }
 
-    for (uint32 i = 0; i < bitVectorCount; i++) {
-        BitVector bitset = bitVectorTable[i];
+        return;
+    }
 
-        while (bitset != 0) {
-            const BitVector t = bitset & -bitset;
-            const uint32 r = CountTrailingZeroes(bitset);
-            const uint32 index = (i * BIT_SIZE_OF(BitVector)) + r;
+    // Convert solid tile runs to pixel spans, joining adjacent runs and
+    // dropping anything beyond the right edge of destination image.
+    PixelSpan spans[MaximumSolidTileRunsPerRow];
 
-            bitset ^= t;
+    int spanCount = 0;
 
-            // Note that index is in local geometry coordinates.
-            const uint32 tableIndex = index << 1;
-            const uint32 edgeX = index + x;
-            const uint32 nextEdgeX = edgeX + 1;
+    for (int i = 0; i < runs->Count; i++) {
+        const int begin = x + (runs->Runs[i].Begin * T::TileW);
+        const int end = Min(x + int(runs->Runs[i].End * T::TileW),
+            image.Width);
 
-            // Signed area for pixel at bit index.
-            const int32 area = coverAreaTable[tableIndex + 1] + (cover << 9);
+        if (begin >= end) {
+            break;
+        }
 
-            // Area converted to alpha according to fill rule.
-            const uint32 alpha = ApplyFillRule(area);
+        if (spanCount > 0 and spans[spanCount - 1].End == begin) {
+            spans[spanCount - 1].End = end;
+        } else {
+            spans[spanCount].Begin = begin;
+            spans[spanCount].End = end;
+            spanCount++;
+        }
+    }
 
-            if (spanEnd == edgeX) {
-                // No gap between previous span and current pixel.
-                if (alpha == 0) {
-                    if (spanAlpha != 0) {
-                        blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
-                    }
+    // Solid tiles have full alpha on every scanline, fill them first.
+    constexpr int32 solidAlpha = ApplyFillRule(256 << 9);
 
-                    spanX = nextEdgeX;
-                    spanEnd = spanX;
-                    spanAlpha = 0;
-                } else if (spanAlpha == alpha) {
-                    spanEnd = nextEdgeX;
-                } else {
-                    // Alpha is not zero, but not equal to previous span
-                    // alpha.
-                    if (spanAlpha != 0) {
-                        blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
-                    }
+    uint8 *solid = ptr;
 
-                    spanX = edgeX;
-                    spanEnd = nextEdgeX;
-                    spanAlpha = alpha;
-                }
-            } else {
-                ASSERT(spanEnd < edgeX);
-
-                // There is a gap between last filled pixel and the new one.
-                if (cover == 0) {
-                    // Empty gap.
-                    // Fill span if there is one and reset current span.
-                    if (spanAlpha != 0) {
-                        blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
-                    }
+    for (int i = 0; i < height; i++) {
+        const B blender = CreateBlender<B>(rasterizable, y + i);
 
-                    spanX = edgeX;
-                    spanEnd = nextEdgeX;
-                    spanAlpha = alpha;
-                } else {
-                    // Non empty gap.
-                    // Attempt to merge gap with current span.
-                    const uint32 gapAlpha = ApplyFillRule(cover << 9);
-
-                    // If alpha matches, extend current span.
-                    if (spanAlpha == gapAlpha) {
-                        if (alpha == gapAlpha) {
-                            // Current pixel alpha matches as well.
-                            spanEnd = nextEdgeX;
-                        } else {
-                            // Only gap alpha matches current span.
-                            blender.CompositeSpan(spanX, edgeX, d, spanAlpha);
+        uint32 *d = reinterpret_cast<uint32 *>(solid);
 
-                            spanX = edgeX;
-                            spanEnd = nextEdgeX;
-                            spanAlpha = alpha;
-                        }
-                    } else {
-                        if (spanAlpha != 0) {
-                            blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
-                        }
+        for (int j = 0; j < spanCount; j++) {
+            blender.CompositeSpan(spans[j].Begin, spans[j].End, d,
+                solidAlpha);
+        }
 
-                        // Compose gap.
-                        blender.CompositeSpan(spanEnd, edgeX, d, gapAlpha);
+        solid += image.BytesPerRow;
+    }
 
-                        spanX = edgeX;
-                        spanEnd = nextEdgeX;
-                        spanAlpha = alpha;
-                    }
-                }
-            }
+    // Then render everything else.
+    for (int i = 0; i < height; i++) {
+        const SpanBlenderSkippingSpans<B> blenderSkippingSpans(
+            CreateBlender<B>(rasterizable, y + i), spans, spanCount);
 
-            cover += coverAreaTable[tableIndex];
-        }
-    }
+        RenderOneItemLine<SpanBlenderSkippingSpans<B>, ApplyFillRule>(ptr,
+            bitVectorTable[i], bitVectorsPerRow, coverAreaTable[i], x,
+            image.Width, coversStart[i], accumulated, blenderSkippingSpans);
 
-    if (spanAlpha != 0) {
-        // Composite current span.
-        blender.CompositeSpan(spanX, spanEnd, d, spanAlpha);
+        ptr += image.BytesPerRow;
     }
+}
 
-    if (cover != 0 and spanEnd < rowLength) {
-        // Composite anything that goes to the edge of destination image.
-        const int32 alpha = ApplyFillRule(cover << 9);
 
-        blender.CompositeSpan(spanEnd, rowLength, d, alpha);
+template <typename T>
+template <typename B, FillRuleFn ApplyFillRule>
+FORCE_INLINE void Rasterizer<T>::RenderOneItemLine(uint8 *image,
+    const BitVector *bitVectorTable, const int bitVectorCount,
+    int32 *coverAreaTable, const int x, const int rowLength,
+    const int32 startCover, const bool accumulated, B blender)
+{
+    if constexpr (ApplyFillRule(256 << 9) == 255) {
+        if (accumulated) {
+            RenderOneLineAccumulated<B, ApplyFillRule>(image, bitVectorTable,
+                bitVectorCount, coverAreaTable, x, rowLength, startCover,
+                blender);
+
+            return;
+        }
     }
+
+    RenderOneLine<B, ApplyFillRule>(image, bitVectorTable, bitVectorCount,
+        coverAreaTable, x, rowLength, startCover, blender);
 }
 
 
 template <typename T>
-FORCE_INLINE void Rasterizer<T>::RasterizeOneItem(const RasterizableItem *item,
-    BitVector **bitVectorTable, int32 **coverAreaTable, const int columnCount,
-    const ImageData &image)
+template <typename B, FillRuleFn ApplyFillRule>
+FORCE_INLINE void Rasterizer<T>::RenderOneItemWithoutLines(
+    const RasterizableItem *item, uint8 *ptr, const int x, const int y,
+    const int height, const ImageData &image)
 {
-    // A maximum number of horizontal tiles.
-    const int horizontalCount = item->Rasterizable->Bounds.ColumnCount;
+    ASSERT(item != nullptr);
+    ASSERT(ptr != nullptr);
+    ASSERT(height > 0);
+    ASSERT(height <= T::TileH);
+    ASSERT(x < image.Width);
 
-    ASSERT(horizontalCount <= columnCount);
+    const int32 *coversStart = item->GetActualCovers();
 
-    const int bitVectorsPerRow = BitVectorsForMaxBitCount(
-        horizontalCount * T::TileW);
+    for (int i = 0; i < height; i++) {
+        const int32 cover = coversStart[i];
 
-    // Erase bit vector table.
-    for (int i = 0; i < T::TileH; i++) {
-        memset(bitVectorTable[i], 0, SIZE_OF(BitVector) * bitVectorsPerRow);
+        if (cover != 0) {
+            const uint32 alpha = ApplyFillRule(cover << 9);
+
+            if (alpha != 0) {
+                const B blender = CreateBlender<B>(item->Rasterizable, y + i);
+
+                blender.CompositeSpan(x, image.Width,
+                    reinterpret_cast<uint32 *>(ptr), alpha);
+            }
+        }
+
+        ptr += image.BytesPerRow;
     }
+}
 
-    item->Rasterizable->IterationFunction(item, bitVectorTable, coverAreaTable);
 
-    // Pointer to backdrop.
-    const int32 *coversStart = item->GetActualCovers();
+template <typename T>
+FORCE_INLINE const bool *Rasterizer<T>::FindOccludedItems(
+    const RowItemList<RasterizableItem> *rowList, const TileIndex columnCount,
+    ThreadMemory &memory)
+{
+    ASSERT(rowList != nullptr);
 
-    const int x = item->Rasterizable->Bounds.X * T::TileW;
+    int itemCount = 0;
 
-    // Y position, measured in tiles.
-    const int miny = item->Rasterizable->Bounds.Y + item->LocalRowIndex;
+    for (const auto *b = rowList->First; b != nullptr; b = b->Next) {
+        itemCount += b->Count;
+    }
 
-    // Y position, measure in pixels.
-    const int py = miny * T::TileH;
+    if (itemCount < 2) {
+        // A single item is never hidden.
+        return nullptr;
+    }
 
-    // Maximum y position, measured in pixels.
-    const int maxpy = py + T::TileH;
+    bool *occluded = static_cast<bool *>(
+        memory.TaskMalloc(SIZE_OF(bool) * itemCount));
 
-    // Start row.
-    uint8 *ptr = image.Data + (py * image.BytesPerRow);
+    // One bit for each tile column of destination image. Bit is set once
+    // tile is known to be completely covered by opaque item.
+    BitVector *solid = memory.TaskMallocArrayZeroFill<BitVector>(
+        BitVectorsForMaxBitCount(columnCount));
 
-    // Calculate maximum height. This can only get less than 8 when rendering
-    // the last row of the image and image height is not multiple of row
-    // height.
-    const int hh = Min(maxpy, image.Height) - py;
+    int index = itemCount;
 
-    // Fill color.
-    const uint32 color = item->Rasterizable->Geometry->Color;
-    const FillRule rule = item->Rasterizable->Geometry->Rule;
+    // Walk items from top to bottom.
+    for (const auto *b = rowList->Last; b != nullptr; b = b->Previous) {
+        for (int i = b->Count - 1; i >= 0; i--) {
+            const RasterizableItem *item = b->Items + i;
+            const TileBounds &bounds = item->Rasterizable->Bounds;
 
-    if (color >= 0xff000000) {
-        if (rule == FillRule::NonZero) {
-            for (int i = 0; i < hh; i++) {
-                RenderOneLine<SpanBlenderOpaque, AreaToAlphaNonZero>(ptr,
-                    bitVectorTable[i], bitVectorsPerRow, coverAreaTable[i], x,
-                    image.Width, coversStart[i], color);
+            index--;
 
-                ptr += image.BytesPerRow;
+            if (BitRangeIsSet(solid, bounds.X, bounds.X + bounds.ColumnCount)) {
+                occluded[index] = true;
+                continue;
             }
-        } else {
-            for (int i = 0; i < hh; i++) {
-                RenderOneLine<SpanBlenderOpaque, AreaToAlphaEvenOdd>(ptr,
-                    bitVectorTable[i], bitVectorsPerRow, coverAreaTable[i], x,
-                    image.Width, coversStart[i], color);
 
-                ptr += image.BytesPerRow;
-            }
-        }
-    } else {
-        if (rule == FillRule::NonZero) {
-            for (int i = 0; i < hh; i++) {
-                RenderOneLine<SpanBlender, AreaToAlphaNonZero>(ptr,
-                    bitVectorTable[i], bitVectorsPerRow, coverAreaTable[i], x,
-                    image.Width, coversStart[i], color);
+            occluded[index] = false;
+
+            const SolidTileRunList *runs = item->GetSolidTileRuns();
+            const Geometry *geometry = item->Rasterizable->Geometry;
+
+            // Only opaque items hide anything below them. Clear and source
+            // blend modes replace destination regardless of color.
+            const bool opaque = geometry->Paint != nullptr ?
+                geometry->Paint->Opaque : geometry->Color >= 0xff000000;
+
+            const bool hides = geometry->Mode == BlendMode::SourceOver ?
+                opaque : geometry->Mode == BlendMode::Clear or
+                geometry->Mode == BlendMode::Source;
 
-                ptr += image.BytesPerRow;
+            // Solid tiles of clipped items are not solid after clipping.
+            // Items of layers are composited with layer opacity and blend
+            // mode, they do not hide anything.
+            if (runs == nullptr or not hides or
+                item->Rasterizable->Clip != nullptr or
+                geometry->Layer != nullptr)
+            {
+                continue;
             }
-        } else {
-            for (int i = 0; i < hh; i++) {
-                RenderOneLine<SpanBlender, AreaToAlphaEvenOdd>(ptr,
-                    bitVectorTable[i], bitVectorsPerRow, coverAreaTable[i], x,
-                    image.Width, coversStart[i], color);
 
-                ptr += image.BytesPerRow;
+            for (int r = 0; r < runs->Count; r++) {
+                SetBitRange(solid, bounds.X + runs->Runs[r].Begin,
+                    bounds.X + runs->Runs[r].End);
             }
         }
     }
+
+    ASSERT(index == 0);
+
+    return occluded;
 }
 
 
@@ -1728,21 +4306,27 @@ FORCE_INLINE void Rasterizer<T>::RasterizeOneItem(const RasterizableItem *item,
  * Rasterize all items in one row.
  */
 template <typename T>
+template <typename W>
 FORCE_INLINE void Rasterizer<T>::RasterizeRow(
     const RowItemList<RasterizableItem> *rowList, ThreadMemory &memory,
-    const ImageData &image)
+    const ImageData &image, const RasterizerOptions &options)
 {
     // How many columns can fit into image.
     const TileIndex columnCount = CalculateColumnCount<T>(image.Width);
 
-    // Create bit vector arrays.
+    // Create bit vector arrays. Each row starts with summary, see
+    // ConditionalSetMarkedBit. Bit vectors are cleared once here, after that
+    // each item clears only bit vectors it has set.
     const int bitVectorsPerRow = BitVectorsForMaxBitCount(
         columnCount * T::TileW);
-    const int bitVectorCount = bitVectorsPerRow * T::TileH;
+    const int summaryCount = BitVectorsForMaxBitCount(bitVectorsPerRow);
+    const int bitVectorCount = (summaryCount + bitVectorsPerRow) * T::TileH;
 
     BitVector *bitVectors = static_cast<BitVector *>(
         memory.TaskMalloc(SIZE_OF(BitVector) * bitVectorCount));
 
+    memset(bitVectors, 0, SIZE_OF(BitVector) * bitVectorCount);
+
     // Create cover/area table.
     const int coverAreaIntsPerRow = columnCount * T::TileW * 2;
     const int coverAreaIntCount = coverAreaIntsPerRow * T::TileH;
@@ -1755,13 +4339,31 @@ FORCE_INLINE void Rasterizer<T>::RasterizeRow(
     int32 *coverAreaTable[T::TileH] ALIGNED(64);
 
     for (int i = 0; i < T::TileH; i++) {
-        bitVectorTable[i] = bitVectors;
+        bitVectorTable[i] = bitVectors + summaryCount;
         coverAreaTable[i] = coverArea;
 
-        bitVectors += bitVectorsPerRow;
+        bitVectors += summaryCount + bitVectorsPerRow;
         coverArea += coverAreaIntsPerRow;
     }
 
+    ClipMask clipMask;
+    LayerBuffer layer;
+
+    if (options.OcclusionCulling) {
+        // Find which items are hidden first and then rasterize the rest.
+        const bool *occluded = FindOccludedItems(rowList, columnCount, memory);
+
+        if (occluded != nullptr) {
+            RasterizeVisibleItems<W>(rowList, occluded, bitVectorTable,
+                coverAreaTable, columnCount, image, clipMask, layer, memory,
+                options.Statistics);
+
+            // Layer group can end with the last item in row.
+            CompositeLayer(layer, image);
+            return;
+        }
+    }
+
     // Rasterize all items, from bottom to top that were added to this row.
     const typename RowItemList<RasterizableItem>::Block *b = rowList->First;
 
@@ -1771,10 +4373,72 @@ FORCE_INLINE void Rasterizer<T>::RasterizeRow(
         const RasterizableItem *e = b->Items + count;
 
         while (itm < e) {
-            RasterizeOneItem(itm++, bitVectorTable, coverAreaTable,
-                columnCount, image);
+            RasterizeOneItem<W>(itm++, bitVectorTable, coverAreaTable,
+                columnCount, image, clipMask, layer, memory);
         }
 
         b = b->Next;
     }
+
+    // Layer group can end with the last item in row.
+    CompositeLayer(layer, image);
+
+    if (options.Statistics != nullptr) {
+        // Counted in a separate pass so that loop above stays the same when
+        // statistics are not collected.
+        int tileCount = 0;
+
+        for (b = rowList->First; b != nullptr; b = b->Next) {
+            for (int i = 0; i < b->Count; i++) {
+                tileCount += b->Items[i].Rasterizable->Bounds.ColumnCount;
+            }
+        }
+
+        options.Statistics->CompositedTileCount += tileCount;
+    }
+}
+
+
+template <typename T>
+template <typename W>
+FORCE_INLINE void Rasterizer<T>::RasterizeVisibleItems(
+    const RowItemList<RasterizableItem> *rowList, const bool *occluded,
+    BitVector **bitVectorTable, int32 **coverAreaTable,
+    const int columnCount, const ImageData &image, ClipMask &clipMask,
+    LayerBuffer &layer, ThreadMemory &memory,
+    RasterizerStatistics *statistics)
+{
+    ASSERT(rowList != nullptr);
+    ASSERT(occluded != nullptr);
+
+    const typename RowItemList<RasterizableItem>::Block *b = rowList->First;
+
+    int tileCount = 0;
+    int culledTileCount = 0;
+
+    while (b != nullptr) {
+        const int count = b->Count;
+        const RasterizableItem *itm = b->Items;
+        const RasterizableItem *e = b->Items + count;
+
+        while (itm < e) {
+            if (*occluded++) {
+                culledTileCount += itm->Rasterizable->Bounds.ColumnCount;
+            } else {
+                tileCount += itm->Rasterizable->Bounds.ColumnCount;
+
+                RasterizeOneItem<W>(itm, bitVectorTable, coverAreaTable,
+                    columnCount, image, clipMask, layer, memory);
+            }
+
+            itm++;
+        }
+
+        b = b->Next;
+    }
+
+    if (statistics != nullptr) {
+        statistics->CompositedTileCount += tileCount;
+        statistics->CulledTileCount += culledTileCount;
+    }
 }
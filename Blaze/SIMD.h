@@ -2,13 +2,37 @@
 #pragma once
 
 
+#include "Dispatch.h"
 #include "F24Dot8.h"
 #include "F24Dot8Point.h"
 #include "Matrix.h"
 
 
+// Generic version is always available so backends can fall back to it.
+#include "SIMD_generic.h"
+
 #ifdef SIMD_NEON
 #include "SIMD_neon.h"
+#elif defined SIMD_WASM
+#include "SIMD_wasm.h"
+#elif defined RUNTIME_DISPATCH
+#include "SIMD_x86.h"
+
+static FORCE_INLINE void FloatPointsToF24Dot8Points(const Matrix &matrix,
+    F24Dot8Point *dst, const FloatPoint *src, const int count,
+    const F24Dot8Point origin, const F24Dot8Point size)
+{
+    const MatrixComplexity complexity = matrix.DetermineComplexity();
+
+    Dispatch.FloatPointsToF24Dot8Points[int(complexity)](matrix, dst, src,
+        count, origin, size);
+}
 #else
-#include "SIMD_generic.h"
+static FORCE_INLINE void FloatPointsToF24Dot8Points(const Matrix &matrix,
+    F24Dot8Point *dst, const FloatPoint *src, const int count,
+    const F24Dot8Point origin, const F24Dot8Point size)
+{
+    FloatPointsToF24Dot8Points_generic(matrix, dst, src, count, origin,
+        size);
+}
 #endif
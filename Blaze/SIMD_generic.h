@@ -1,6 +1,10 @@
 
-#include "Linearizer.h"
+#include "F24Dot8.h"
+#include "F24Dot8Point.h"
+#include "FloatPoint.h"
+#include "Matrix.h"
 #include "SIMD.h"
+#include "Utils.h"
 
 
 static FORCE_INLINE F24Dot8 RoundTo24Dot8(const double v) {
@@ -8,7 +12,13 @@ static FORCE_INLINE F24Dot8 RoundTo24Dot8(const double v) {
 }
 
 
-static FORCE_INLINE void FloatPointsToF24Dot8Points(const Matrix &matrix,
+/**
+ * Converts points to F24Dot8 format, transforming them by a given matrix,
+ * subtracting origin and clamping to [0, size] range. Plain C++ version
+ * which works on any processor. Backends in SIMD_neon.h and SIMD_x86.h
+ * implement the same conversion using vector instructions.
+ */
+static FORCE_INLINE void FloatPointsToF24Dot8Points_generic(const Matrix &matrix,
     F24Dot8Point *dst, const FloatPoint *src, const int count,
     const F24Dot8Point origin, const F24Dot8Point size)
 {
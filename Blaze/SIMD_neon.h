@@ -5,11 +5,6 @@
 #include <arm_neon.h>
 
 
-static FORCE_INLINE F24Dot8 RoundTo24Dot8(const double v) {
-    return static_cast<F24Dot8>(Round(v));
-}
-
-
 static FORCE_INLINE void FloatToF24Dot8Points_ScaleOnly_neon(const Matrix &matrix,
     F24Dot8Point *dst, const FloatPoint *src, const int count,
     const F24Dot8Point origin, const F24Dot8Point size)
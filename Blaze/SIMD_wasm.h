@@ -0,0 +1,168 @@
+
+#include "SIMD.h"
+#include "Utils.h"
+
+#include <wasm_simd128.h>
+
+
+// Point conversion for WebAssembly with SIMD128 extension. Each vector holds
+// x and y of one point, two points are converted per iteration.
+//
+// Rounding is done the same way as in SIMD_x86.h: 0.49999999999999994 (the
+// largest double less than 0.5) with the sign of value is added and the
+// result is truncated. This matches Round used by generic version for all
+// values that fit into F24Dot8, so the output is identical.
+
+
+template <MatrixComplexity Complexity>
+static FORCE_INLINE v128_t TransformPoint_wasm(const v128_t v,
+    const v128_t a, const v128_t b, const v128_t c)
+{
+    if constexpr (Complexity == MatrixComplexity::Identity) {
+        return wasm_f64x2_mul(v, a);
+    } else if constexpr (Complexity == MatrixComplexity::TranslationOnly) {
+        return wasm_f64x2_mul(wasm_f64x2_add(v, c), a);
+    } else if constexpr (Complexity == MatrixComplexity::ScaleOnly) {
+        return wasm_f64x2_mul(v, a);
+    } else if constexpr (Complexity == MatrixComplexity::TranslationScale) {
+        return wasm_f64x2_add(wasm_f64x2_mul(v, a), c);
+    } else {
+        // x' = m00 * x + m10 * y + m20
+        // y' = m11 * y + m01 * x + m21
+        const v128_t swapped = wasm_i64x2_shuffle(v, v, 1, 0);
+
+        return wasm_f64x2_add(wasm_f64x2_add(wasm_f64x2_mul(v, a),
+            wasm_f64x2_mul(swapped, b)), c);
+    }
+}
+
+
+/**
+ * Rounds two doubles to the nearest integers, halfway cases away from zero.
+ * Results are returned in the lower half of vector.
+ */
+static FORCE_INLINE v128_t RoundToInt_wasm(const v128_t v) {
+    const v128_t sign = wasm_v128_and(v, wasm_f64x2_splat(-0.0));
+    const v128_t half = wasm_v128_or(sign,
+        wasm_f64x2_splat(0.49999999999999994));
+
+    return wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_add(v, half));
+}
+
+
+template <MatrixComplexity Complexity>
+static void FloatPointsToF24Dot8Points_wasm(const Matrix &matrix,
+    F24Dot8Point *dst, const FloatPoint *src, const int count,
+    const F24Dot8Point origin, const F24Dot8Point size)
+{
+    // Multiplier, cross multiplier and translation. Unused ones stay zero.
+    double a[2] = { 256.0, 256.0 };
+    double b[2] = { 0.0, 0.0 };
+    double c[2] = { 0.0, 0.0 };
+
+    if constexpr (Complexity == MatrixComplexity::TranslationOnly) {
+        c[0] = matrix.M31();
+        c[1] = matrix.M32();
+    } else if constexpr (Complexity == MatrixComplexity::ScaleOnly) {
+        a[0] = matrix.M11() * 256.0;
+        a[1] = matrix.M22() * 256.0;
+    } else if constexpr (Complexity == MatrixComplexity::TranslationScale or
+        Complexity == MatrixComplexity::Complex)
+    {
+        Matrix m(matrix);
+
+        m.PreScale(256.0, 256.0);
+
+        a[0] = m.M11();
+        a[1] = m.M22();
+        b[0] = m.M21();
+        b[1] = m.M12();
+        c[0] = m.M31();
+        c[1] = m.M32();
+    }
+
+    const v128_t va = wasm_f64x2_make(a[0], a[1]);
+    const v128_t vb = wasm_f64x2_make(b[0], b[1]);
+    const v128_t vc = wasm_f64x2_make(c[0], c[1]);
+
+    const v128_t o = wasm_i32x4_make(origin.X, origin.Y, origin.X, origin.Y);
+    const v128_t max = wasm_i32x4_make(size.X, size.Y, size.X, size.Y);
+    const v128_t zero = wasm_i32x4_splat(0);
+
+    // Do 2 points at a time.
+    const int iterations = count >> 1;
+    const FloatPoint *s = src;
+    F24Dot8Point *d = dst;
+
+    for (int i = 0; i < iterations; i++) {
+        const v128_t v0 = wasm_v128_load(s);
+        const v128_t v1 = wasm_v128_load(s + 1);
+
+        s += 2;
+
+        const v128_t i0 = RoundToInt_wasm(
+            TransformPoint_wasm<Complexity>(v0, va, vb, vc));
+
+        const v128_t i1 = RoundToInt_wasm(
+            TransformPoint_wasm<Complexity>(v1, va, vb, vc));
+
+        // Apply origin translation and clamp.
+        const v128_t p = wasm_i32x4_sub(wasm_i64x2_shuffle(i0, i1, 0, 2), o);
+
+        wasm_v128_store(d, wasm_i32x4_max(zero, wasm_i32x4_min(p, max)));
+
+        d += 2;
+    }
+
+    if ((count & 1) != 0) {
+        const v128_t v = wasm_v128_load(s);
+
+        const v128_t i0 = RoundToInt_wasm(
+            TransformPoint_wasm<Complexity>(v, va, vb, vc));
+
+        const v128_t p = wasm_i32x4_sub(i0, o);
+
+        wasm_v128_store64_lane(d, wasm_i32x4_max(zero,
+            wasm_i32x4_min(p, max)), 0);
+    }
+}
+
+
+static FORCE_INLINE void FloatPointsToF24Dot8Points(const Matrix &matrix,
+    F24Dot8Point *dst, const FloatPoint *src, const int count,
+    const F24Dot8Point origin, const F24Dot8Point size)
+{
+    const MatrixComplexity complexity = matrix.DetermineComplexity();
+
+    switch (complexity) {
+        case MatrixComplexity::Identity: {
+            FloatPointsToF24Dot8Points_wasm<MatrixComplexity::Identity>(
+                matrix, dst, src, count, origin, size);
+            break;
+        }
+
+        case MatrixComplexity::TranslationOnly: {
+            FloatPointsToF24Dot8Points_wasm<MatrixComplexity::TranslationOnly>(
+                matrix, dst, src, count, origin, size);
+            break;
+        }
+
+        case MatrixComplexity::ScaleOnly: {
+            FloatPointsToF24Dot8Points_wasm<MatrixComplexity::ScaleOnly>(
+                matrix, dst, src, count, origin, size);
+            break;
+        }
+
+        case MatrixComplexity::TranslationScale: {
+            FloatPointsToF24Dot8Points_wasm<MatrixComplexity::TranslationScale>(
+                matrix, dst, src, count, origin, size);
+            break;
+        }
+
+        case MatrixComplexity::Complex: {
+            FloatPointsToF24Dot8Points_wasm<MatrixComplexity::Complex>(
+                matrix, dst, src, count, origin, size);
+            break;
+        }
+    }
+}
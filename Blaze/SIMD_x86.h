@@ -0,0 +1,255 @@
+
+#include "SIMD.h"
+#include "Utils.h"
+
+#include <immintrin.h>
+
+
+// Point conversion kernels for x86-64 processors. SSE4.1 version converts two
+// points per iteration, AVX2 version converts four. Kernels are selected at
+// runtime, see Dispatch.h.
+//
+// Generic version rounds using Round, which rounds halfway cases away from
+// zero. Here 0.49999999999999994 (the largest double less than 0.5) with the
+// sign of value is added and the result is truncated. For all values that
+// fit into F24Dot8 this gives exactly the same results. Transformation
+// steps are done in the same order as in generic version, so the output is
+// identical.
+
+
+/**
+ * Coefficients for transforming vectors of points stored as x, y pairs. How
+ * these are used depends on matrix complexity, see TransformPoints_sse41.
+ */
+struct PointTransform_x86 final {
+    double A[2];
+    double B[2];
+    double C[2];
+};
+
+
+template <MatrixComplexity Complexity>
+static FORCE_INLINE PointTransform_x86 CreatePointTransform_x86(const Matrix &matrix) {
+    PointTransform_x86 t = {
+        { 256.0, 256.0 },
+        { 0.0, 0.0 },
+        { 0.0, 0.0 }
+    };
+
+    if constexpr (Complexity == MatrixComplexity::TranslationOnly) {
+        t.C[0] = matrix.M31();
+        t.C[1] = matrix.M32();
+    } else if constexpr (Complexity == MatrixComplexity::ScaleOnly) {
+        t.A[0] = matrix.M11() * 256.0;
+        t.A[1] = matrix.M22() * 256.0;
+    } else if constexpr (Complexity == MatrixComplexity::TranslationScale) {
+        Matrix m(matrix);
+
+        m.PreScale(256.0, 256.0);
+
+        t.A[0] = m.M11();
+        t.A[1] = m.M22();
+        t.C[0] = m.M31();
+        t.C[1] = m.M32();
+    } else if constexpr (Complexity == MatrixComplexity::Complex) {
+        Matrix m(matrix);
+
+        m.PreScale(256.0, 256.0);
+
+        t.A[0] = m.M11();
+        t.A[1] = m.M22();
+        t.B[0] = m.M21();
+        t.B[1] = m.M12();
+        t.C[0] = m.M31();
+        t.C[1] = m.M32();
+    }
+
+    return t;
+}
+
+
+/**
+ * Transforms one point. Vector holds x and y.
+ */
+template <MatrixComplexity Complexity>
+TARGET("sse4.1")
+static FORCE_INLINE __m128d TransformPoints_sse41(const __m128d v,
+    const __m128d a, const __m128d b, const __m128d c)
+{
+    if constexpr (Complexity == MatrixComplexity::Identity) {
+        return _mm_mul_pd(v, a);
+    } else if constexpr (Complexity == MatrixComplexity::TranslationOnly) {
+        return _mm_mul_pd(_mm_add_pd(v, c), a);
+    } else if constexpr (Complexity == MatrixComplexity::ScaleOnly) {
+        return _mm_mul_pd(v, a);
+    } else if constexpr (Complexity == MatrixComplexity::TranslationScale) {
+        return _mm_add_pd(_mm_mul_pd(v, a), c);
+    } else {
+        // x' = m00 * x + m10 * y + m20
+        // y' = m11 * y + m01 * x + m21
+        const __m128d swapped = _mm_shuffle_pd(v, v, 1);
+
+        return _mm_add_pd(_mm_add_pd(_mm_mul_pd(v, a),
+            _mm_mul_pd(swapped, b)), c);
+    }
+}
+
+
+/**
+ * Rounds two doubles to the nearest integers, halfway cases away from zero.
+ * Results are returned in the lower half of vector.
+ */
+TARGET("sse4.1")
+static FORCE_INLINE __m128i RoundToInt_sse41(const __m128d v) {
+    const __m128d sign = _mm_and_pd(v, _mm_set1_pd(-0.0));
+    const __m128d half = _mm_or_pd(sign, _mm_set1_pd(0.49999999999999994));
+
+    return _mm_cvttpd_epi32(_mm_add_pd(v, half));
+}
+
+
+template <MatrixComplexity Complexity>
+TARGET("sse4.1")
+static void FloatPointsToF24Dot8Points_sse41(const Matrix &matrix,
+    F24Dot8Point *dst, const FloatPoint *src, const int count,
+    const F24Dot8Point origin, const F24Dot8Point size)
+{
+    const PointTransform_x86 t = CreatePointTransform_x86<Complexity>(matrix);
+
+    const __m128d a = _mm_loadu_pd(t.A);
+    const __m128d b = _mm_loadu_pd(t.B);
+    const __m128d c = _mm_loadu_pd(t.C);
+
+    const __m128i o = _mm_setr_epi32(origin.X, origin.Y, origin.X, origin.Y);
+    const __m128i max = _mm_setr_epi32(size.X, size.Y, size.X, size.Y);
+    const __m128i zero = _mm_setzero_si128();
+
+    // Do 2 points at a time.
+    const int iterations = count >> 1;
+    const double *ptr = reinterpret_cast<const double *>(src);
+    __m128i *dm = reinterpret_cast<__m128i *>(dst);
+
+    for (int i = 0; i < iterations; i++) {
+        const __m128d v0 = _mm_loadu_pd(ptr);
+        const __m128d v1 = _mm_loadu_pd(ptr + 2);
+
+        ptr += 4;
+
+        const __m128i i0 = RoundToInt_sse41(
+            TransformPoints_sse41<Complexity>(v0, a, b, c));
+
+        const __m128i i1 = RoundToInt_sse41(
+            TransformPoints_sse41<Complexity>(v1, a, b, c));
+
+        // Apply origin translation and clamp.
+        const __m128i p = _mm_sub_epi32(_mm_unpacklo_epi64(i0, i1), o);
+
+        _mm_storeu_si128(dm, _mm_max_epi32(zero, _mm_min_epi32(p, max)));
+
+        dm++;
+    }
+
+    if ((count & 1) != 0) {
+        const __m128d v = _mm_loadu_pd(ptr);
+
+        const __m128i i0 = RoundToInt_sse41(
+            TransformPoints_sse41<Complexity>(v, a, b, c));
+
+        const __m128i p = _mm_sub_epi32(i0, o);
+
+        _mm_storel_epi64(dm, _mm_max_epi32(zero, _mm_min_epi32(p, max)));
+    }
+}
+
+
+/**
+ * Transforms two points. Vector holds x and y of the first point followed
+ * by x and y of the second point.
+ */
+template <MatrixComplexity Complexity>
+TARGET("avx2")
+static FORCE_INLINE __m256d TransformPoints_avx2(const __m256d v,
+    const __m256d a, const __m256d b, const __m256d c)
+{
+    if constexpr (Complexity == MatrixComplexity::Identity) {
+        return _mm256_mul_pd(v, a);
+    } else if constexpr (Complexity == MatrixComplexity::TranslationOnly) {
+        return _mm256_mul_pd(_mm256_add_pd(v, c), a);
+    } else if constexpr (Complexity == MatrixComplexity::ScaleOnly) {
+        return _mm256_mul_pd(v, a);
+    } else if constexpr (Complexity == MatrixComplexity::TranslationScale) {
+        return _mm256_add_pd(_mm256_mul_pd(v, a), c);
+    } else {
+        const __m256d swapped = _mm256_permute_pd(v, 0b0101);
+
+        return _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(v, a),
+            _mm256_mul_pd(swapped, b)), c);
+    }
+}
+
+
+TARGET("avx2")
+static FORCE_INLINE __m128i RoundToInt_avx2(const __m256d v) {
+    const __m256d sign = _mm256_and_pd(v, _mm256_set1_pd(-0.0));
+    const __m256d half = _mm256_or_pd(sign,
+        _mm256_set1_pd(0.49999999999999994));
+
+    return _mm256_cvttpd_epi32(_mm256_add_pd(v, half));
+}
+
+
+template <MatrixComplexity Complexity>
+TARGET("avx2")
+static void FloatPointsToF24Dot8Points_avx2(const Matrix &matrix,
+    F24Dot8Point *dst, const FloatPoint *src, const int count,
+    const F24Dot8Point origin, const F24Dot8Point size)
+{
+    const PointTransform_x86 t = CreatePointTransform_x86<Complexity>(matrix);
+
+    const __m256d a = _mm256_setr_pd(t.A[0], t.A[1], t.A[0], t.A[1]);
+    const __m256d b = _mm256_setr_pd(t.B[0], t.B[1], t.B[0], t.B[1]);
+    const __m256d c = _mm256_setr_pd(t.C[0], t.C[1], t.C[0], t.C[1]);
+
+    const __m256i o = _mm256_setr_epi32(origin.X, origin.Y, origin.X,
+        origin.Y, origin.X, origin.Y, origin.X, origin.Y);
+
+    const __m256i max = _mm256_setr_epi32(size.X, size.Y, size.X, size.Y,
+        size.X, size.Y, size.X, size.Y);
+
+    const __m256i zero = _mm256_setzero_si256();
+
+    // Do 4 points at a time.
+    const int iterations = count >> 2;
+    const double *ptr = reinterpret_cast<const double *>(src);
+    __m256i *dm = reinterpret_cast<__m256i *>(dst);
+
+    for (int i = 0; i < iterations; i++) {
+        const __m256d v0 = _mm256_loadu_pd(ptr);
+        const __m256d v1 = _mm256_loadu_pd(ptr + 4);
+
+        ptr += 8;
+
+        const __m128i i0 = RoundToInt_avx2(
+            TransformPoints_avx2<Complexity>(v0, a, b, c));
+
+        const __m128i i1 = RoundToInt_avx2(
+            TransformPoints_avx2<Complexity>(v1, a, b, c));
+
+        // Apply origin translation and clamp.
+        const __m256i p = _mm256_sub_epi32(_mm256_set_m128i(i1, i0), o);
+
+        _mm256_storeu_si256(dm, _mm256_max_epi32(zero,
+            _mm256_min_epi32(p, max)));
+
+        dm++;
+    }
+
+    // Convert the remaining 0 to 3 points.
+    const int remainder = count & 3;
+
+    if (remainder != 0) {
+        FloatPointsToF24Dot8Points_sse41<Complexity>(matrix,
+            dst + (count - remainder), src + (count - remainder), remainder,
+            origin, size);
+    }
+}
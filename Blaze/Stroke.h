@@ -0,0 +1,108 @@
+#pragma once
+
+
+#include "IntRect.h"
+#include "Utils.h"
+
+
+/**
+ * Determines shape of stroke outline where two segments meet.
+ */
+enum class LineJoin : uint8 {
+
+    /**
+     * Outer edges of both segments are extended until they meet, unless
+     * miter length exceeds miter limit. Then segments are joined with bevel.
+     */
+    Miter = 0,
+
+    /**
+     * Segments are joined with circular arc.
+     */
+    Round,
+
+    /**
+     * Outer corners of segments are connected with a straight line.
+     */
+    Bevel
+};
+
+
+/**
+ * Determines shape of stroke outline at both ends of open subpaths.
+ */
+enum class LineCap : uint8 {
+
+    /**
+     * Stroke ends exactly at the end point.
+     */
+    Butt = 0,
+
+    /**
+     * Stroke ends with half circle centered at the end point.
+     */
+    Round,
+
+    /**
+     * Stroke is extended past the end point by half of its width.
+     */
+    Square
+};
+
+
+/**
+ * Stroke parameters. Geometry with stroke is filled with outline of its
+ * path instead of the path itself. Stroke width is measured in path
+ * coordinates, outline is transformed together with path.
+ */
+struct Stroke final {
+
+    /**
+     * Constructs stroke.
+     *
+     * @param width Stroke width. Must be greater than 0.
+     *
+     * @param join Shape of outline where segments meet.
+     *
+     * @param cap Shape of outline at both ends of open subpaths.
+     *
+     * @param miterLimit Maximum ratio of miter length to stroke width for
+     * miter joins. Sharper joins are beveled. Must be at least 1.
+     */
+    constexpr explicit Stroke(const double width,
+        const LineJoin join = LineJoin::Miter,
+        const LineCap cap = LineCap::Butt, const double miterLimit = 4)
+    :   Width(width),
+        Join(join),
+        Cap(cap),
+        MiterLimit(miterLimit)
+    {
+    }
+
+
+    /**
+     * Returns path bounds expanded by the maximum distance outline can reach
+     * away from path.
+     */
+    IntRect ExpandBounds(const IntRect &bounds) const;
+
+
+    const double Width = 1;
+    const LineJoin Join = LineJoin::Miter;
+    const LineCap Cap = LineCap::Butt;
+    const double MiterLimit = 4;
+};
+
+
+FORCE_INLINE IntRect Stroke::ExpandBounds(const IntRect &bounds) const {
+    // Miter tip is at most miter limit times half width away from path,
+    // corner of square cap is √2 times half width away.
+    const double factor = Max(Join == LineJoin::Miter ? MiterLimit : 1.0,
+        Cap == LineCap::Square ? 1.4142135623730951 : 1.0);
+
+    const int outset = int(Ceil(Width * 0.5 * factor));
+
+    return IntRect(bounds.MinX - outset, bounds.MinY - outset,
+        bounds.MaxX - bounds.MinX + (outset * 2),
+        bounds.MaxY - bounds.MinY + (outset * 2));
+}
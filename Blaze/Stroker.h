@@ -0,0 +1,726 @@
+#pragma once
+
+
+#include "FloatPoint.h"
+#include "Matrix.h"
+#include "PathTag.h"
+#include "Stroke.h"
+#include "Utils.h"
+
+
+/**
+ * Converts path into outline of its stroke. Outline is produced as a set of
+ * small closed polygons, one for each segment, join and cap, all wound in
+ * the same direction. Filled with non-zero fill rule, together they cover
+ * exactly the stroke, so polygons never need to be merged into one path.
+ *
+ * Polygons only share edges and do not overlap, since coverage of pixels
+ * where two overlapping polygons both have edges is counted twice. Joins
+ * cover the gap on the outer side of a turn, and on the inner side corners
+ * of both segments are moved to the point where their inner edges meet. If
+ * either segment is too short to reach that point, as with sharp turns or
+ * segments shorter than stroke width, inner corners stay at the ends of
+ * segments and segments overlap, making edge pixels near that join a bit
+ * darker. The same applies to paths crossing themselves.
+ *
+ * Segment is passed to sink once the join at its end is known, the first
+ * segment of contour waits until contour ends. Outline is never stored and
+ * stroker does not allocate any memory.
+ *
+ * Path is stroked in its own coordinates and polygon points are then
+ * transformed by matrix, so stroke width is transformed together with path.
+ * Curves are flattened into lines before stroking, with flattening
+ * tolerance measured in destination coordinates.
+ *
+ * Sink S must have the following function, accepting transformed points.
+ *
+ *   void AddPolygon(const FloatPoint *points, const int count);
+ */
+template <typename S>
+struct Stroker final {
+
+    /**
+     * Maximum number of steps of one arc of round join or round cap.
+     */
+    static constexpr int MaximumArcStepCount = 128;
+
+
+    /**
+     * Maximum number of points of one polygon passed to sink. Arcs have
+     * center point and one more point than steps.
+     */
+    static constexpr int MaximumPolygonPointCount = MaximumArcStepCount + 2;
+
+
+    /**
+     * Maximum distance between curve and lines it is flattened into, in
+     * destination pixels.
+     */
+    static constexpr double FlatteningTolerance = 0.25;
+
+
+    /**
+     * Maximum number of lines one curve is flattened into.
+     */
+    static constexpr int MaximumFlatteningStepCount = 1024;
+
+
+    Stroker(S &sink, const Stroke &stroke, const Matrix &matrix);
+
+
+    /**
+     * Strokes path. Tags and points are the same as in Geometry.
+     */
+    void StrokePath(const PathTag *tags, const FloatPoint *points,
+        const int tagCount);
+
+private:
+
+    /**
+     * Segment waiting for joins at both of its ends. Corners are indexed by
+     * side, 0 is the side PerpendicularVector of direction points to.
+     */
+    struct Segment final {
+        FloatPoint Start;
+        FloatPoint End;
+        FloatPoint Direction;
+        double Length = 0;
+        FloatPoint StartCorners[2];
+        FloatPoint EndCorners[2];
+
+        // Length of each side cut off by joins moving inner corners.
+        double Trims[2] = { 0, 0 };
+    };
+
+private:
+    void MoveTo(const FloatPoint p);
+
+
+    /**
+     * Adds line from the current point to a given point.
+     *
+     * @param join Join between previous segment and this line.
+     */
+    void LineTo(const FloatPoint p, const LineJoin join);
+
+
+    /**
+     * Flattens quadratic curve starting at the current point into lines.
+     * Lines within curve are joined with round joins.
+     */
+    void QuadraticTo(const FloatPoint p[3]);
+
+
+    /**
+     * Flattens cubic curve starting at the current point into lines. Lines
+     * within curve are joined with round joins.
+     */
+    void CubicTo(const FloatPoint p[4]);
+
+
+    /**
+     * Adds line back to the first point of contour and joins it with the
+     * first segment.
+     */
+    void Close();
+
+
+    /**
+     * Adds caps at both ends of open contour, if it has any segments.
+     */
+    void EndContour();
+
+
+    /**
+     * Returns a number of lines to flatten curve into.
+     *
+     * @param deviation Degree-dependent multiple of the largest second
+     * difference of control points, bounding distance between curve and
+     * lines.
+     */
+    int GetFlatteningStepCount(const double deviation) const;
+
+
+    /**
+     * Adds polygon covering a single segment, between its corners.
+     */
+    void AddSegment(const Segment &segment);
+
+
+    /**
+     * Adds polygon filling the gap between two segments meeting at a given
+     * point, on the outer side of the turn. Moves corners of both segments
+     * on the inner side of the turn to the point where their inner edges
+     * meet, if both segments are long enough.
+     *
+     * @param s0 Segment ending at point.
+     *
+     * @param s1 Segment starting at point.
+     */
+    void AddJoin(const FloatPoint p, Segment &s0, Segment &s1,
+        const LineJoin join);
+
+
+    /**
+     * Adds cap at the end of open contour.
+     *
+     * @param d Unit direction pointing away from contour.
+     */
+    void AddCap(const FloatPoint p, const FloatPoint d);
+
+
+    /**
+     * Adds cap for contour which has no segments of non-zero length.
+     */
+    void AddDot(const FloatPoint p);
+
+
+    /**
+     * Adds circular sector. Arc goes from center + u towards center + w and
+     * continues for a given angle. Vectors u and w must be perpendicular and
+     * have equal length.
+     */
+    void AddArc(const FloatPoint center, const FloatPoint u,
+        const FloatPoint w, const double angle);
+
+
+    /**
+     * Transforms polygon points, reverses them if needed so that all
+     * polygons have the same winding and passes polygon to sink.
+     */
+    void AddPolygon(FloatPoint *points, const int count);
+
+private:
+    S &mSink;
+    const Matrix &mMatrix;
+    const double mHalfWidth;
+    const LineJoin mJoin;
+    const LineCap mCap;
+    const double mMiterLimit;
+
+    // Flattening tolerance in path coordinates.
+    double mTolerance = 0;
+
+    // Maximum angle of one arc step.
+    double mArcStep = 0;
+
+    // The first point of contour and the current point.
+    FloatPoint mStart;
+    FloatPoint mPoint;
+
+    // The first segment of contour, its start corner can still be moved by
+    // join closing contour. Valid if contour has at least two segments.
+    Segment mFirst;
+
+    // The last segment of contour, waiting for join at its end.
+    Segment mLast;
+
+    // True if contour has at least one segment of non-zero length.
+    bool mHasSegments = false;
+
+    // True if contour has at least two segments of non-zero length, so the
+    // first one is stored in mFirst.
+    bool mHasFirstSegment = false;
+
+    // True if contour has at least one segment, including zero length ones.
+    // Such contours are drawn as dots with round and square caps.
+    bool mHasZeroLengthSegments = false;
+};
+
+
+static FORCE_INLINE FloatPoint ScalePoint(const FloatPoint p, const double s) {
+    return FloatPoint {
+        p.X * s,
+        p.Y * s
+    };
+}
+
+
+/**
+ * Returns vector rotated by 90 degrees from X axis towards Y axis.
+ */
+static FORCE_INLINE FloatPoint PerpendicularVector(const FloatPoint v) {
+    return FloatPoint {
+        -v.Y,
+        v.X
+    };
+}
+
+
+template <typename S>
+FORCE_INLINE Stroker<S>::Stroker(S &sink, const Stroke &stroke,
+    const Matrix &matrix)
+:   mSink(sink),
+    mMatrix(matrix),
+    mHalfWidth(stroke.Width * 0.5),
+    mJoin(stroke.Join),
+    mCap(stroke.Cap),
+    mMiterLimit(stroke.MiterLimit)
+{
+    ASSERT(stroke.Width > 0);
+    ASSERT(stroke.MiterLimit >= 1);
+
+    // The largest length of unit vector transformed by matrix, so that
+    // tolerance is not exceeded in any direction.
+    const double sx = (matrix.M11() * matrix.M11()) +
+        (matrix.M12() * matrix.M12());
+    const double sy = (matrix.M21() * matrix.M21()) +
+        (matrix.M22() * matrix.M22());
+
+    const double scale = Sqrt(Max(sx, sy));
+
+    mTolerance = scale > 0 ? FlatteningTolerance / scale : 1.0;
+
+    // Arc step which keeps chord within tolerance from arc.
+    if (mTolerance < mHalfWidth) {
+        mArcStep = 2.0 * Acos(1.0 - (mTolerance / mHalfWidth));
+    } else {
+        mArcStep = 1.5707963267948966;
+    }
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::StrokePath(const PathTag *tags,
+    const FloatPoint *points, const int tagCount)
+{
+    ASSERT(tags != nullptr);
+    ASSERT(points != nullptr);
+    ASSERT(tagCount > 0);
+
+    FloatPoint segment[4];
+
+    MoveTo(*points++);
+
+    for (int i = 1; i < tagCount; i++) {
+        switch (tags[i]) {
+            case PathTag::Move: {
+                MoveTo(points[0]);
+
+                points++;
+
+                break;
+            }
+
+            case PathTag::Line: {
+                LineTo(points[0], mJoin);
+
+                points++;
+
+                break;
+            }
+
+            case PathTag::Quadratic: {
+                segment[0] = mPoint;
+                segment[1] = points[0];
+                segment[2] = points[1];
+
+                points += 2;
+
+                QuadraticTo(segment);
+
+                break;
+            }
+
+            case PathTag::Cubic: {
+                segment[0] = mPoint;
+                segment[1] = points[0];
+                segment[2] = points[1];
+                segment[3] = points[2];
+
+                points += 3;
+
+                CubicTo(segment);
+
+                break;
+            }
+
+            case PathTag::Close: {
+                Close();
+
+                break;
+            }
+        }
+    }
+
+    EndContour();
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::MoveTo(const FloatPoint p) {
+    EndContour();
+
+    mStart = p;
+    mPoint = p;
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::LineTo(const FloatPoint p, const LineJoin join) {
+    const FloatPoint v = p - mPoint;
+    const double length = Sqrt((v.X * v.X) + (v.Y * v.Y));
+
+    if (not (length > 0)) {
+        mHasZeroLengthSegments = true;
+        return;
+    }
+
+    const FloatPoint d = ScalePoint(v, 1.0 / length);
+    const FloatPoint n = ScalePoint(PerpendicularVector(d), mHalfWidth);
+
+    Segment segment;
+
+    segment.Start = mPoint;
+    segment.End = p;
+    segment.Direction = d;
+    segment.Length = length;
+    segment.StartCorners[0] = mPoint + n;
+    segment.StartCorners[1] = mPoint - n;
+    segment.EndCorners[0] = p + n;
+    segment.EndCorners[1] = p - n;
+
+    if (mHasSegments) {
+        AddJoin(mPoint, mLast, segment, join);
+
+        if (mHasFirstSegment) {
+            AddSegment(mLast);
+        } else {
+            mFirst = mLast;
+            mHasFirstSegment = true;
+        }
+    } else {
+        mHasSegments = true;
+    }
+
+    mLast = segment;
+    mPoint = p;
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::QuadraticTo(const FloatPoint p[3]) {
+    const FloatPoint dd = p[0] - ScalePoint(p[1], 2) + p[2];
+
+    const int n = GetFlatteningStepCount(
+        0.25 * Sqrt((dd.X * dd.X) + (dd.Y * dd.Y)));
+
+    for (int i = 1; i <= n; i++) {
+        const double t = double(i) / double(n);
+        const double mt = 1.0 - t;
+
+        const FloatPoint q = ScalePoint(p[0], mt * mt) +
+            ScalePoint(p[1], 2.0 * mt * t) + ScalePoint(p[2], t * t);
+
+        LineTo(q, i == 1 ? mJoin : LineJoin::Round);
+    }
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::CubicTo(const FloatPoint p[4]) {
+    const FloatPoint dd0 = p[0] - ScalePoint(p[1], 2) + p[2];
+    const FloatPoint dd1 = p[1] - ScalePoint(p[2], 2) + p[3];
+
+    const double dd = Max((dd0.X * dd0.X) + (dd0.Y * dd0.Y),
+        (dd1.X * dd1.X) + (dd1.Y * dd1.Y));
+
+    const int n = GetFlatteningStepCount(0.75 * Sqrt(dd));
+
+    for (int i = 1; i <= n; i++) {
+        const double t = double(i) / double(n);
+        const double mt = 1.0 - t;
+
+        const FloatPoint q = ScalePoint(p[0], mt * mt * mt) +
+            ScalePoint(p[1], 3.0 * mt * mt * t) +
+            ScalePoint(p[2], 3.0 * mt * t * t) +
+            ScalePoint(p[3], t * t * t);
+
+        LineTo(q, i == 1 ? mJoin : LineJoin::Round);
+    }
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::Close() {
+    if (mHasSegments) {
+        LineTo(mStart, mJoin);
+
+        Segment &first = mHasFirstSegment ? mFirst : mLast;
+
+        AddJoin(mStart, mLast, first, mJoin);
+
+        if (mHasFirstSegment) {
+            AddSegment(mFirst);
+        }
+
+        AddSegment(mLast);
+    } else if (mHasZeroLengthSegments) {
+        AddDot(mStart);
+    }
+
+    // Segments following close without move start at the same point.
+    mPoint = mStart;
+    mHasSegments = false;
+    mHasFirstSegment = false;
+    mHasZeroLengthSegments = false;
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::EndContour() {
+    if (mHasSegments) {
+        const Segment &first = mHasFirstSegment ? mFirst : mLast;
+
+        if (mHasFirstSegment) {
+            AddSegment(mFirst);
+        }
+
+        AddSegment(mLast);
+        AddCap(mStart, ScalePoint(first.Direction, -1));
+        AddCap(mPoint, mLast.Direction);
+    } else if (mHasZeroLengthSegments) {
+        AddDot(mPoint);
+    }
+
+    mHasSegments = false;
+    mHasFirstSegment = false;
+    mHasZeroLengthSegments = false;
+}
+
+
+template <typename S>
+FORCE_INLINE int Stroker<S>::GetFlatteningStepCount(const double deviation) const {
+    // Wang's formula.
+    const double n = Ceil(Sqrt(deviation / mTolerance));
+
+    if (not (n > 1)) {
+        return 1;
+    }
+
+    return int(Min(n, double(MaximumFlatteningStepCount)));
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::AddSegment(const Segment &segment) {
+    // End points are kept between corners, inner corner moved along the
+    // edge meets the next segment at the same point.
+    FloatPoint polygon[6] = {
+        segment.Start,
+        segment.StartCorners[0],
+        segment.EndCorners[0],
+        segment.End,
+        segment.EndCorners[1],
+        segment.StartCorners[1]
+    };
+
+    AddPolygon(polygon, 6);
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::AddJoin(const FloatPoint p, Segment &s0,
+    Segment &s1, const LineJoin join)
+{
+    const FloatPoint d0 = s0.Direction;
+    const FloatPoint d1 = s1.Direction;
+
+    const double cross = (d0.X * d1.Y) - (d0.Y * d1.X);
+    const double dot = (d0.X * d1.X) + (d0.Y * d1.Y);
+
+    if (dot > 0 and Abs(cross) < 1e-9) {
+        // Segments continue in the same direction.
+        return;
+    }
+
+    // Outer side is opposite to the side path turns to.
+    const double side = cross > 0 ? -mHalfWidth : mHalfWidth;
+
+    const FloatPoint n0 = ScalePoint(PerpendicularVector(d0), side);
+    const FloatPoint n1 = ScalePoint(PerpendicularVector(d1), side);
+
+    // Inner edges meet at distance of half width × tan(θ / 2) from ends of
+    // segments, where θ is the angle between segment directions. Corner is
+    // only moved if it stays within both segments, taking corners already
+    // moved on the same side into account.
+    if (dot > -1.0) {
+        const int inner = cross > 0 ? 0 : 1;
+        const double trim = (mHalfWidth * Abs(cross)) / (1.0 + dot);
+
+        if (trim <= (s0.Length - s0.Trims[inner]) and
+            trim <= (s1.Length - s1.Trims[inner]))
+        {
+            const FloatPoint corner = p -
+                ScalePoint(n0 + n1, 1.0 / (1.0 + dot));
+
+            s0.EndCorners[inner] = corner;
+            s1.StartCorners[inner] = corner;
+            s0.Trims[inner] += trim;
+            s1.Trims[inner] += trim;
+        }
+    }
+
+    if (join == LineJoin::Round) {
+        AddArc(p, n0, ScalePoint(d0, mHalfWidth), Atan2(Abs(cross), dot));
+        return;
+    }
+
+    // Miter length relative to stroke width is 1 / cos(θ / 2), where θ is
+    // the angle between segment directions.
+    if (join == LineJoin::Miter and
+        ((1.0 + dot) * mMiterLimit * mMiterLimit) >= 2.0)
+    {
+        const FloatPoint tip = p + ScalePoint(n0 + n1, 1.0 / (1.0 + dot));
+
+        FloatPoint polygon[4] = {
+            p,
+            p + n0,
+            tip,
+            p + n1
+        };
+
+        AddPolygon(polygon, 4);
+
+        return;
+    }
+
+    FloatPoint polygon[3] = {
+        p,
+        p + n0,
+        p + n1
+    };
+
+    AddPolygon(polygon, 3);
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::AddCap(const FloatPoint p, const FloatPoint d) {
+    const FloatPoint n = ScalePoint(PerpendicularVector(d), mHalfWidth);
+
+    switch (mCap) {
+        case LineCap::Butt: {
+            break;
+        }
+
+        case LineCap::Round: {
+            AddArc(p, n, ScalePoint(d, mHalfWidth), 3.1415926535897932);
+            break;
+        }
+
+        case LineCap::Square: {
+            const FloatPoint e = ScalePoint(d, mHalfWidth);
+
+            FloatPoint polygon[4] = {
+                p + n,
+                p + n + e,
+                p - n + e,
+                p - n
+            };
+
+            AddPolygon(polygon, 4);
+
+            break;
+        }
+    }
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::AddDot(const FloatPoint p) {
+    const FloatPoint x = FloatPoint { mHalfWidth, 0 };
+    const FloatPoint y = FloatPoint { 0, mHalfWidth };
+
+    switch (mCap) {
+        case LineCap::Butt: {
+            break;
+        }
+
+        case LineCap::Round: {
+            AddArc(p, x, y, 3.1415926535897932);
+            AddArc(p, ScalePoint(x, -1), ScalePoint(y, -1),
+                3.1415926535897932);
+            break;
+        }
+
+        case LineCap::Square: {
+            FloatPoint polygon[4] = {
+                p - x - y,
+                p + x - y,
+                p + x + y,
+                p - x + y
+            };
+
+            AddPolygon(polygon, 4);
+
+            break;
+        }
+    }
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::AddArc(const FloatPoint center,
+    const FloatPoint u, const FloatPoint w, const double angle)
+{
+    const int n = Clamp(int(Ceil(angle / mArcStep)), 1,
+        MaximumArcStepCount);
+
+    const double step = angle / double(n);
+    const double c = Cos(step);
+    const double s = Sin(step);
+
+    FloatPoint polygon[MaximumPolygonPointCount];
+
+    polygon[0] = center;
+
+    // Cosine and sine of the current angle, rotated by one step each time.
+    double ca = 1;
+    double sa = 0;
+
+    for (int i = 0; i <= n; i++) {
+        polygon[i + 1] = center + ScalePoint(u, ca) + ScalePoint(w, sa);
+
+        const double nc = (ca * c) - (sa * s);
+        const double ns = (sa * c) + (ca * s);
+
+        ca = nc;
+        sa = ns;
+    }
+
+    AddPolygon(polygon, n + 2);
+}
+
+
+template <typename S>
+FORCE_INLINE void Stroker<S>::AddPolygon(FloatPoint *points, const int count) {
+    ASSERT(points != nullptr);
+    ASSERT(count >= 3);
+    ASSERT(count <= MaximumPolygonPointCount);
+
+    for (int i = 0; i < count; i++) {
+        points[i] = mMatrix.Map(points[i]);
+    }
+
+    // Twice the signed area.
+    double area = 0;
+
+    FloatPoint previous = points[count - 1];
+
+    for (int i = 0; i < count; i++) {
+        area += (previous.X * points[i].Y) - (points[i].X * previous.Y);
+        previous = points[i];
+    }
+
+    if (area < 0) {
+        for (int i = 0, j = count - 1; i < j; i++, j--) {
+            const FloatPoint t = points[i];
+
+            points[i] = points[j];
+            points[j] = t;
+        }
+    }
+
+    mSink.AddPolygon(points, count);
+}
@@ -200,6 +200,15 @@ public:
     LineArrayX32Y16Block *FrameNewX32Y16Block(LineArrayX32Y16Block *next);
 
 
+    /**
+     * Returns new delta encoded line array block. Returned memory is not
+     * zero-filled.
+     *
+     * Line blocks are always allocated from frame memory.
+     */
+    LineArrayDeltaBlock *FrameNewDeltaBlock(LineArrayDeltaBlock *next);
+
+
     /**
      * Resets frame memory. All allocations made during frame
      * by thread this memory belongs to will become invalid once
@@ -313,6 +322,11 @@ FORCE_INLINE LineArrayX32Y16Block *ThreadMemory::FrameNewX32Y16Block(LineArrayX3
 }
 
 
+FORCE_INLINE LineArrayDeltaBlock *ThreadMemory::FrameNewDeltaBlock(LineArrayDeltaBlock *next) {
+    return mFrameLineBlockAllocator.NewDeltaBlock(next);
+}
+
+
 FORCE_INLINE void ThreadMemory::ResetFrameMemory() {
     mFrameLineBlockAllocator.Clear();
     mFrameAllocator.Free();
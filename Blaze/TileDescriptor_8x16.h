@@ -2,6 +2,7 @@
 #pragma once
 
 
+#include "CoverOps.h"
 #include "F24Dot8.h"
 #include "TileBounds.h"
 
@@ -101,81 +102,18 @@ struct TileDescriptor_8x16 final {
     }
 
 
-    static constexpr bool CoverArrayContainsOnlyZeroes(const int32 *t) {
-        ASSERT(t != nullptr);
-
-        // Combine all 16 values.
-        const int32 v =
-            t[0] | t[1] | t[2] | t[3] | t[4] | t[5] | t[6] | t[7] |
-            t[8] | t[9] | t[10] | t[11] | t[12] | t[13] | t[14] | t[15];
-
-        // Zero means there are no non-zero values there.
-        return v == 0;
+    static bool CoverArrayContainsOnlyZeroes(const int32 *t) {
+        return CoversContainOnlyZeroes<TileH>(t);
     }
 
 
     static void FillStartCovers(int32 *p, const int32 value) {
-        ASSERT(p != nullptr);
-
-        p[0] = value;
-        p[1] = value;
-        p[2] = value;
-        p[3] = value;
-        p[4] = value;
-        p[5] = value;
-        p[6] = value;
-        p[7] = value;
-        p[8] = value;
-        p[9] = value;
-        p[10] = value;
-        p[11] = value;
-        p[12] = value;
-        p[13] = value;
-        p[14] = value;
-        p[15] = value;
+        FillCovers<TileH>(p, value);
     }
 
 
     static void AccumulateStartCovers(int32 *p, const int32 value) {
-        const int32 p0 = p[0];
-        const int32 p1 = p[1];
-        const int32 p2 = p[2];
-        const int32 p3 = p[3];
-
-        p[0] = value + p0;
-        p[1] = value + p1;
-        p[2] = value + p2;
-        p[3] = value + p3;
-
-        const int32 p4 = p[4];
-        const int32 p5 = p[5];
-        const int32 p6 = p[6];
-        const int32 p7 = p[7];
-
-        p[4] = value + p4;
-        p[5] = value + p5;
-        p[6] = value + p6;
-        p[7] = value + p7;
-
-        const int32 p8 = p[8];
-        const int32 p9 = p[9];
-        const int32 p10 = p[10];
-        const int32 p11 = p[11];
-
-        p[8] = value + p8;
-        p[9] = value + p9;
-        p[10] = value + p10;
-        p[11] = value + p11;
-
-        const int32 p12 = p[12];
-        const int32 p13 = p[13];
-        const int32 p14 = p[14];
-        const int32 p15 = p[15];
-
-        p[12] = value + p12;
-        p[13] = value + p13;
-        p[14] = value + p14;
-        p[15] = value + p15;
+        AccumulateCovers<TileH>(p, value);
     }
 
 
@@ -2,6 +2,7 @@
 #pragma once
 
 
+#include "CoverOps.h"
 #include "F24Dot8.h"
 #include "TileBounds.h"
 
@@ -101,139 +102,18 @@ struct TileDescriptor_8x32 final {
     }
 
 
-    static constexpr bool CoverArrayContainsOnlyZeroes(const int32 *t) {
-        ASSERT(t != nullptr);
-
-        // Combine all 32 values.
-        const int32 v =
-            t[0] | t[1] | t[2] | t[3] | t[4] | t[5] | t[6] | t[7] |
-            t[8] | t[9] | t[10] | t[11] | t[12] | t[13] | t[14] | t[15] |
-            t[16] | t[17] | t[18] | t[19] | t[20] | t[21] | t[22] | t[23] |
-            t[24] | t[25] | t[26] | t[27] | t[28] | t[29] | t[30] | t[31];
-
-        // Zero means there are no non-zero values there.
-        return v == 0;
+    static bool CoverArrayContainsOnlyZeroes(const int32 *t) {
+        return CoversContainOnlyZeroes<TileH>(t);
     }
 
 
     static void FillStartCovers(int32 *p, const int32 value) {
-        ASSERT(p != nullptr);
-
-        p[0] = value;
-        p[1] = value;
-        p[2] = value;
-        p[3] = value;
-        p[4] = value;
-        p[5] = value;
-        p[6] = value;
-        p[7] = value;
-        p[8] = value;
-        p[9] = value;
-        p[10] = value;
-        p[11] = value;
-        p[12] = value;
-        p[13] = value;
-        p[14] = value;
-        p[15] = value;
-        p[16] = value;
-        p[17] = value;
-        p[18] = value;
-        p[19] = value;
-        p[20] = value;
-        p[21] = value;
-        p[22] = value;
-        p[23] = value;
-        p[24] = value;
-        p[25] = value;
-        p[26] = value;
-        p[27] = value;
-        p[28] = value;
-        p[29] = value;
-        p[30] = value;
-        p[31] = value;
+        FillCovers<TileH>(p, value);
     }
 
 
     static void AccumulateStartCovers(int32 *p, const int32 value) {
-        const int32 p0 = p[0];
-        const int32 p1 = p[1];
-        const int32 p2 = p[2];
-        const int32 p3 = p[3];
-
-        p[0] = value + p0;
-        p[1] = value + p1;
-        p[2] = value + p2;
-        p[3] = value + p3;
-
-        const int32 p4 = p[4];
-        const int32 p5 = p[5];
-        const int32 p6 = p[6];
-        const int32 p7 = p[7];
-
-        p[4] = value + p4;
-        p[5] = value + p5;
-        p[6] = value + p6;
-        p[7] = value + p7;
-
-        const int32 p8 = p[8];
-        const int32 p9 = p[9];
-        const int32 p10 = p[10];
-        const int32 p11 = p[11];
-
-        p[8] = value + p8;
-        p[9] = value + p9;
-        p[10] = value + p10;
-        p[11] = value + p11;
-
-        const int32 p12 = p[12];
-        const int32 p13 = p[13];
-        const int32 p14 = p[14];
-        const int32 p15 = p[15];
-
-        p[12] = value + p12;
-        p[13] = value + p13;
-        p[14] = value + p14;
-        p[15] = value + p15;
-
-        const int32 p16 = p[16];
-        const int32 p17 = p[17];
-        const int32 p18 = p[18];
-        const int32 p19 = p[19];
-
-        p[16] = value + p16;
-        p[17] = value + p17;
-        p[18] = value + p18;
-        p[19] = value + p19;
-
-        const int32 p20 = p[20];
-        const int32 p21 = p[21];
-        const int32 p22 = p[22];
-        const int32 p23 = p[23];
-
-        p[20] = value + p20;
-        p[21] = value + p21;
-        p[22] = value + p22;
-        p[23] = value + p23;
-
-        const int32 p24 = p[24];
-        const int32 p25 = p[25];
-        const int32 p26 = p[26];
-        const int32 p27 = p[27];
-
-        p[24] = value + p24;
-        p[25] = value + p25;
-        p[26] = value + p26;
-        p[27] = value + p27;
-
-        const int32 p28 = p[28];
-        const int32 p29 = p[29];
-        const int32 p30 = p[30];
-        const int32 p31 = p[31];
-
-        p[28] = value + p28;
-        p[29] = value + p29;
-        p[30] = value + p30;
-        p[31] = value + p31;
+        AccumulateCovers<TileH>(p, value);
     }
 
 
@@ -75,6 +75,15 @@ STATIC_ASSERT(SIZE_OF(uint64) == 8);
 #endif
 
 
+// Allows using instructions of a specific instruction set in one function
+// without enabling them for the whole program.
+#ifdef __GNUC__
+#define TARGET(p) __attribute__((target(p)))
+#else
+#define TARGET(p)
+#endif
+
+
 #define DISABLE_COPY_AND_ASSIGN(c) \
     c(const c &a) = delete; \
     void operator=(const c &a);
@@ -168,6 +177,14 @@ static FORCE_INLINE double Sqrt(const double v) {
 }
 
 
+/**
+ * Returns x raised to the power of y.
+ */
+static FORCE_INLINE double Pow(const double x, const double y) {
+    return pow(x, y);
+}
+
+
 /**
  * Returns value clamped to range between minimum and maximum values.
  */
@@ -377,3 +394,20 @@ static FORCE_INLINE float Tan(const float v) {
 static FORCE_INLINE double Tan(const double v) {
     return tan(v);
 }
+
+
+/**
+ * Returns arc cosine of a given number.
+ */
+static FORCE_INLINE double Acos(const double v) {
+    return acos(v);
+}
+
+
+/**
+ * Returns angle between positive X axis and vector (x, y), in range from -π
+ * to π.
+ */
+static FORCE_INLINE double Atan2(const double y, const double x) {
+    return atan2(y, x);
+}
@@ -48,7 +48,7 @@ Matrix ViewData::GetMatrix() const
     CVDisplayLinkRef mDisplayLink;
     CAMetalLayer *mMetalLayer;
 
-    DestinationImage<TileDescriptor_8x16> mImage;
+    DestinationImage mImage;
 
     id<MTLTexture> mTexture;
     id<MTLRenderPipelineState>mPS;
@@ -0,0 +1,149 @@
+
+#include <cstdio>
+#include <cstdlib>
+#include "BenchmarkBlaze.h"
+#include "BenchmarkBlendModes.h"
+#include "BenchmarkClipPaths.h"
+#include "BenchmarkImagePattern.h"
+#include "BenchmarkLineEncoding.h"
+#include "BenchmarkLinearBlending.h"
+#include "BenchmarkLinearizer.h"
+#include "BenchmarkOcclusionCulling.h"
+#include "BenchmarkPixelFormat.h"
+#include "BenchmarkPointConversion.h"
+#include "BenchmarkStroke.h"
+#include "BenchmarkTileShape.h"
+#include "SyntheticScene.h"
+
+
+// Headless benchmark meant to be run with node. The same source is built
+// twice by build-benchmark script, once with SIMD128 kernels and once with
+// generic kernels, so both can be compared on the same machine.
+
+
+#ifdef SIMD_WASM
+static const char *VariantName = "simd128";
+static const char *OutputName = "benchmark-simd128.png";
+static const char *RuntimeOutputName = "benchmark-simd128-runtime.png";
+#else
+static const char *VariantName = "generic";
+static const char *OutputName = "benchmark-generic.png";
+static const char *RuntimeOutputName = "benchmark-generic-runtime.png";
+#endif
+
+
+static uint8 *ReadFile(const char *path, uint64 &size)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == nullptr) {
+        return nullptr;
+    }
+
+    fseek(file, 0, SEEK_END);
+
+    const long length = ftell(file);
+
+    fseek(file, 0, SEEK_SET);
+
+    uint8 *data = static_cast<uint8 *>(malloc(length));
+
+    size = fread(data, 1, length, file);
+
+    fclose(file);
+
+    return data;
+}
+
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("Usage: node benchmark-%s.js <file.vectorimage> [scale]\n",
+            VariantName);
+        return 1;
+    }
+
+    const char *path = argv[1];
+    const double scale = argc > 2 ? atof(argv[2]) : 1.0;
+
+    uint64 size = 0;
+    uint8 *data = ReadFile(path, size);
+
+    if (data == nullptr) {
+        printf("Cannot read %s\n", path);
+        return 1;
+    }
+
+    VectorImage image;
+
+    image.Parse(data, size);
+
+    free(data);
+
+    BenchmarkBlaze blaze;
+
+    const double ms = blaze.Run(image, scale, OutputName);
+
+    printf("%s, %s: %.3f ms per frame\n", VariantName, path, ms);
+
+    BenchmarkBlazeRuntime runtime;
+
+    const double runtimeMs = runtime.Run(image, scale, RuntimeOutputName);
+
+    printf("%s, %s: %.3f ms per frame, %s tiles selected at runtime\n",
+        VariantName, path, runtimeMs,
+        GetTileShapeName(runtime.GetTileShape()));
+
+    RunPointConversionBenchmark(image.GetGeometries(),
+        image.GetGeometryCount(), path);
+
+    const IntRect bounds = image.GetBounds();
+
+    if (bounds.MaxX > 0 and bounds.MaxY > 0) {
+        RunLinearizerBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), IntSize { bounds.MaxX, bounds.MaxY },
+            path);
+
+        RunLineEncodingBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), bounds, scale, path);
+
+        RunLinearBlendingBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), bounds, scale, path);
+
+        RunTileShapeBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), bounds, scale, path);
+
+        RunImagePatternBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), bounds, scale, path);
+
+        RunBlendModeBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), bounds, scale, path);
+
+        RunClipPathBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), bounds, scale, path);
+
+        RunOcclusionCullingBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), bounds, scale, path);
+
+        RunPixelFormatBenchmark(image.GetGeometries(),
+            image.GetGeometryCount(), bounds, scale, path);
+    }
+
+    // Synthetic scenes reproduce workloads sample images may not have.
+    SyntheticScene ui;
+
+    SyntheticScene::CreateUserInterface(ui, 1920, 1080);
+
+    RunOcclusionCullingBenchmark(ui.GetGeometries(), ui.GetGeometryCount(),
+        ui.GetBounds(), scale, "ui");
+
+    SyntheticScene map;
+
+    SyntheticScene::CreateMap(map, 1920, 1080);
+
+    RunStrokeBenchmark(map.GetGeometries(), map.GetGeometryCount(),
+        map.GetBounds(), scale, "map");
+
+    return 0;
+}
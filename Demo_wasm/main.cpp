@@ -199,7 +199,7 @@ private:
     WebGLProgram mProgram;
     WebGLTexturedQuad mTexturedQuad;
 
-    DestinationImage<TileDescriptor_16x8> mImage;
+    DestinationImage mImage;
     VectorImage mVectorImage;
     Matrix mCoordinateSystemMatrix;
     FloatPoint mTranslation;